@@ -0,0 +1,13 @@
+// Set 0 of every bindless pipeline: BindlessTable's arrays, indexed by the
+// handles the table returned. Include after
+//     #extension GL_EXT_nonuniform_qualifier : require
+// and wrap a handle in nonuniformEXT() when it varies within a draw or dispatch.
+// Storage buffers are declared by the including shader, one block array per
+// element type, all at BINDLESS_STORAGE_BUFFER_BINDING.
+
+#define BINDLESS_SAMPLED_IMAGE_BINDING 0  // BindlessTable::SAMPLED_IMAGE_BINDING
+#define BINDLESS_STORAGE_BUFFER_BINDING 1 // BindlessTable::STORAGE_BUFFER_BINDING
+#define BINDLESS_SAMPLER_BINDING 2        // BindlessTable::SAMPLER_BINDING
+
+layout(set = 0, binding = BINDLESS_SAMPLED_IMAGE_BINDING) uniform texture2D bindlessTextures[];
+layout(set = 0, binding = BINDLESS_SAMPLER_BINDING) uniform sampler bindlessSamplers[];
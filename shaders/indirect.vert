@@ -0,0 +1,60 @@
+#version 450
+
+// Compiled twice: as is, reading the objects through a descriptor set of its
+// own, and with -DBINDLESS, reading them through the BindlessTable
+#ifdef BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#include "bindless.glsl"
+#endif
+
+// Same triangle as shader.vert, indexed through a 3-entry index buffer
+vec2 positions[3] = vec2[](
+    vec2(0.0, -0.5),
+    vec2(0.5, 0.5),
+    vec2(-0.5, 0.5)
+);
+
+// Matches GpuObject in GpuCuller.h (std430)
+struct Object {
+    vec4 boundingSphere;
+    vec4 offsetScale; // xy: position, z: scale
+    vec4 color;
+};
+
+// Every object of the scene; the culling pass puts the object index in firstInstance
+#ifdef BINDLESS
+layout(std430, set = 0, binding = BINDLESS_STORAGE_BUFFER_BINDING) readonly buffer Objects {
+    Object objects[];
+} objectBuffers[];
+
+layout(push_constant) uniform View {
+    mat4 viewProjection;
+    uint objectBuffer; // Handle of the object buffer in the table
+} view;
+#else
+layout(std430, set = 0, binding = 0) readonly buffer Objects {
+    Object objects[];
+};
+
+layout(push_constant) uniform View {
+    mat4 viewProjection;
+} view;
+#endif
+
+layout(location = 0) out vec4 fragColor;
+
+// Output position to the rasterizer
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main() {
+#ifdef BINDLESS
+    Object object = objectBuffers[view.objectBuffer].objects[gl_InstanceIndex];
+#else
+    Object object = objects[gl_InstanceIndex];
+#endif
+    vec2 position = positions[gl_VertexIndex] * object.offsetScale.z + object.offsetScale.xy;
+    gl_Position = view.viewProjection * vec4(position, 0.0, 1.0);
+    fragColor = object.color;
+}
@@ -0,0 +1,26 @@
+// Unpacks the quantized .vkmesh vertex formats QuantizeMesh writes. The
+// vertex input formats (GpuMesh::ToVkFormat) already turn every one of them
+// into floats; what is left is undoing the encodings:
+//   Float16x4 position   -> vec4, w = 1: use as is
+//   Float16x2 texcoord   -> vec2: use as is
+//   Octahedral16x2 normal -> vec2 in [-1, 1]: DecodeOctahedral
+//   Unorm10x3_2 tangent  -> vec4 in [0, 1]: DecodeBiasedTangent
+//   Unorm8x4 color       -> vec4 in [0, 1]: use as is
+// Must match EncodeOctahedral and QuantizeMesh in src/assets/MeshOptimizer.cpp.
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (normal.z < 0.0) {
+        // Lower hemisphere: unfold the corners
+        vec2 signs = vec2(encoded.x >= 0.0 ? 1.0 : -1.0, encoded.y >= 0.0 ? 1.0 : -1.0);
+        normal.xy = (1.0 - abs(normal.yx)) * signs;
+    }
+    return normalize(normal);
+}
+
+// xyz: unit tangent; w: bitangent sign (+1 or -1)
+vec4 DecodeBiasedTangent(vec4 encoded)
+{
+    return vec4(normalize(encoded.xyz * 2.0 - 1.0), encoded.w * 2.0 - 1.0);
+}
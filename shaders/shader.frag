@@ -1,9 +1,11 @@
 #version 450
 
+// Per-draw color from the vertex shader
+layout(location = 0) in vec4 fragColor;
+
 // Output color for the fragment
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    // Output a constant orange color
-    outColor = vec4(1.0, 0.5, 0.0, 1.0);
-} 
\ No newline at end of file
+    outColor = fragColor;
+}
@@ -7,6 +7,14 @@ vec2 positions[3] = vec2[](
     vec2(-0.5, 0.5)
 );
 
+// Per-draw constants from the uniform ring, selected with a dynamic offset
+layout(set = 0, binding = 0) uniform DrawData {
+    vec4 offsetScale; // xy: NDC offset, z: scale
+    vec4 color;
+} draw;
+
+layout(location = 0) out vec4 fragColor;
+
 // Output position to the rasterizer
 out gl_PerVertex {
     vec4 gl_Position;
@@ -14,5 +22,7 @@ out gl_PerVertex {
 
 void main() {
     // Use the built-in gl_VertexIndex to select the vertex
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-} 
\ No newline at end of file
+    vec2 position = positions[gl_VertexIndex] * draw.offsetScale.z + draw.offsetScale.xy;
+    gl_Position = vec4(position, 0.0, 1.0);
+    fragColor = draw.color;
+}
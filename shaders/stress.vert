@@ -0,0 +1,43 @@
+#version 450
+
+// Same triangle as shader.vert, drawn once per instance of the stress scene
+vec2 positions[3] = vec2[](
+    vec2(0.0, -0.5),
+    vec2(0.5, 0.5),
+    vec2(-0.5, 0.5)
+);
+
+// Structure-of-arrays sections of scene.stride floats: x | y | rotation
+// (see StressScene.h)
+layout(std430, set = 0, binding = 0) readonly buffer Instances {
+    float instanceData[];
+};
+
+// RGBA8 per instance
+layout(std430, set = 0, binding = 1) readonly buffer Colors {
+    uint colors[];
+};
+
+// Matches DrawConstants in StressScene.cpp
+layout(push_constant) uniform Scene {
+    float scale;
+    uint stride;
+} scene;
+
+layout(location = 0) out vec4 fragColor;
+
+// Output position to the rasterizer
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+void main() {
+    uint i = uint(gl_InstanceIndex);
+    vec2 center = vec2(instanceData[i], instanceData[scene.stride + i]);
+    float angle = instanceData[2u * scene.stride + i];
+    float s = sin(angle);
+    float c = cos(angle);
+    vec2 local = positions[gl_VertexIndex] * scene.scale;
+    gl_Position = vec4(center + vec2(c * local.x - s * local.y, s * local.x + c * local.y), 0.0, 1.0);
+    fragColor = unpackUnorm4x8(colors[i]);
+}
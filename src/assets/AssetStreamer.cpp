@@ -0,0 +1,287 @@
+#include "AssetStreamer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace VulkanApp::Assets {
+
+AssetStreamer::AssetStreamer()
+{
+    _ioThread = std::thread([this]() { IoLoop(); });
+    _decodeThread = std::thread([this]() { DecodeLoop(); });
+}
+
+AssetStreamer::~AssetStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _readAvailable.notify_all();
+    _decodeAvailable.notify_all();
+    _ioThread.join();
+    _decodeThread.join();
+}
+
+StreamRequestId AssetStreamer::Request(std::string path, float priority, AssetDecoder decoder,
+                                       AssetReadyCallback onReady)
+{
+    StreamRequestId id = INVALID_STREAM_REQUEST;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        id = _nextId++;
+        PendingRequest& request = _pending[id];
+        request.path = std::move(path);
+        request.priority = priority;
+        request.stage = Stage::WaitingForRead;
+        request.decoder = std::move(decoder);
+        request.onReady = std::move(onReady);
+        request.requested = Clock::now();
+        _readQueue.insert({priority, id});
+        _stats.requested++;
+    }
+    _readAvailable.notify_one();
+    return id;
+}
+
+bool AssetStreamer::Cancel(StreamRequestId id)
+{
+    if (auto upload = _uploads.find(id); upload != _uploads.end()) {
+        _uploadQueue.erase({upload->second.priority, id});
+        // Part of it may already sit in the staging ring
+        if (_retire && upload->second.asset) {
+            _retire(std::move(upload->second.asset));
+        }
+        _uploads.erase(upload);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats.cancelled++;
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (auto decoded = std::find_if(_decoded.begin(), _decoded.end(), [id](const Decoded& d) { return d.id == id; });
+        decoded != _decoded.end()) {
+        _decoded.erase(decoded); // Nothing uploaded yet
+        _stats.cancelled++;
+        return true;
+    }
+    auto pending = _pending.find(id);
+    if (pending == _pending.end() || pending->second.cancelled) {
+        return false;
+    }
+    PendingRequest& request = pending->second;
+    _stats.cancelled++;
+    switch (request.stage) {
+        case Stage::WaitingForRead:
+            _readQueue.erase({request.priority, id});
+            _pending.erase(pending);
+            break;
+        case Stage::WaitingForDecode:
+            _decodeQueue.erase({request.priority, id});
+            _pending.erase(pending); // Unmaps the file
+            break;
+        case Stage::Reading:
+        case Stage::Decoding:
+            request.cancelled = true; // The worker drops it when done
+            break;
+    }
+    return true;
+}
+
+void AssetStreamer::SetPriority(StreamRequestId id, float priority)
+{
+    if (auto upload = _uploads.find(id); upload != _uploads.end()) {
+        _uploadQueue.erase({upload->second.priority, id});
+        upload->second.priority = priority;
+        _uploadQueue.insert({priority, id});
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (Decoded& decoded : _decoded) {
+        if (decoded.id == id) {
+            decoded.priority = priority;
+            return;
+        }
+    }
+    auto pending = _pending.find(id);
+    if (pending == _pending.end()) {
+        return;
+    }
+    PendingRequest& request = pending->second;
+    std::set<QueueKey>* queue = request.stage == Stage::WaitingForRead     ? &_readQueue
+                                : request.stage == Stage::WaitingForDecode ? &_decodeQueue
+                                                                           : nullptr;
+    if (queue != nullptr) {
+        queue->erase({request.priority, id});
+        queue->insert({priority, id});
+    }
+    request.priority = priority;
+}
+
+void AssetStreamer::IoLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _readAvailable.wait(lock, [this]() { return _stopping || !_readQueue.empty(); });
+        if (_stopping) {
+            return;
+        }
+        StreamRequestId id = _readQueue.begin()->id;
+        _readQueue.erase(_readQueue.begin());
+        PendingRequest& request = _pending.at(id); // Node stays put while unlocked
+        request.stage = Stage::Reading;
+        std::string path = request.path;
+        lock.unlock();
+
+        // Map and fault in every page here, off the frame loop
+        MappedFile file;
+        std::string error;
+        uint64_t pageSum = 0;
+        try {
+            file = MappedFile(path);
+            file.Prefetch(0, file.GetSize());
+            std::span<const std::byte> bytes = file.GetBytes();
+            for (size_t offset = 0; offset < bytes.size(); offset += PAGE_SIZE) {
+                pageSum += static_cast<uint8_t>(bytes[offset]);
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        volatile uint64_t keepTouches = pageSum; // The reads must not be optimized away
+        static_cast<void>(keepTouches);
+
+        lock.lock();
+        if (request.cancelled) {
+            _pending.erase(id);
+            continue;
+        }
+        if (!error.empty()) {
+            std::cerr << "Asset stream of " << path << " failed: " << error << std::endl;
+            _decoded.push_back({id, request.priority, nullptr, std::move(request.onReady), request.requested});
+            _pending.erase(id);
+            continue;
+        }
+        _stats.bytesRead += file.GetSize();
+        request.file = std::move(file);
+        request.stage = Stage::WaitingForDecode;
+        _decodeQueue.insert({request.priority, id});
+        _decodeAvailable.notify_one();
+    }
+}
+
+void AssetStreamer::DecodeLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _decodeAvailable.wait(lock, [this]() { return _stopping || !_decodeQueue.empty(); });
+        if (_stopping) {
+            return;
+        }
+        StreamRequestId id = _decodeQueue.begin()->id;
+        _decodeQueue.erase(_decodeQueue.begin());
+        PendingRequest& request = _pending.at(id);
+        request.stage = Stage::Decoding;
+        MappedFile file = std::move(request.file);
+        AssetDecoder decoder = std::move(request.decoder);
+        lock.unlock();
+
+        std::unique_ptr<StreamedAsset> asset;
+        std::string error;
+        try {
+            asset = decoder(std::move(file));
+            if (!asset) {
+                error = "decoder returned nothing";
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        lock.lock();
+        if (request.cancelled) {
+            _pending.erase(id); // Never uploaded, so the asset can go right away
+            continue;
+        }
+        if (!error.empty()) {
+            std::cerr << "Asset decode of " << request.path << " failed: " << error << std::endl;
+        }
+        _decoded.push_back({id, request.priority, std::move(asset), std::move(request.onReady), request.requested});
+        _pending.erase(id);
+    }
+}
+
+void AssetStreamer::Update(uint64_t byteBudget)
+{
+    std::vector<Decoded> decoded;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        decoded.swap(_decoded);
+    }
+    for (Decoded& entry : decoded) {
+        if (!entry.asset) {
+            Finish(entry); // Failed: report it right away
+            continue;
+        }
+        _uploadQueue.insert({entry.priority, entry.id});
+        StreamRequestId id = entry.id;
+        _uploads.emplace(id, std::move(entry));
+    }
+
+    uint64_t remaining = byteBudget;
+    uint64_t uploaded = 0; // Can exceed byteBudget by a piece an asset would not split
+    for (auto key = _uploadQueue.begin(); key != _uploadQueue.end();) {
+        Decoded& upload = _uploads.at(key->id);
+        // No Upload call once the budget is gone: an asset would still hand off a piece it cannot split
+        uint64_t handedOff = upload.asset->IsUploaded() || remaining == 0 ? 0 : upload.asset->Upload(remaining);
+        uploaded += handedOff;
+        remaining -= std::min(handedOff, remaining);
+        if (upload.asset->IsUploaded()) {
+            Decoded finished = std::move(upload);
+            _uploads.erase(key->id);
+            key = _uploadQueue.erase(key);
+            Finish(finished);
+            continue;
+        }
+        if (handedOff == 0 || remaining == 0) {
+            break; // Budget spent or the upload path is full; lower priorities wait
+        }
+        ++key;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.lastUpdateBytes = uploaded;
+    _stats.bytesUploaded += _stats.lastUpdateBytes;
+}
+
+void AssetStreamer::Finish(Decoded& decoded)
+{
+    double latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - decoded.requested).count();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (decoded.asset) {
+            _stats.completed++;
+            _stats.latencySumMs += latencyMs;
+            _stats.latencyMaxMs = std::max(_stats.latencyMaxMs, latencyMs);
+        } else {
+            _stats.failed++;
+        }
+    }
+    if (decoded.onReady) {
+        decoded.onReady(decoded.id, std::move(decoded.asset));
+    }
+}
+
+AssetStreamer::Stats AssetStreamer::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats stats = _stats;
+    stats.waitingForRead = static_cast<uint32_t>(_readQueue.size());
+    stats.waitingForDecode = static_cast<uint32_t>(_decodeQueue.size());
+    stats.inFlight = static_cast<uint32_t>(_pending.size() - _readQueue.size() - _decodeQueue.size());
+    stats.uploading = static_cast<uint32_t>(_uploads.size() + _decoded.size());
+    return stats;
+}
+
+} // namespace VulkanApp::Assets
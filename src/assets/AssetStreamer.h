@@ -0,0 +1,172 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/MappedFile.h"
+
+namespace VulkanApp::Assets {
+
+using StreamRequestId = uint64_t;
+constexpr StreamRequestId INVALID_STREAM_REQUEST = 0;
+
+// Request priorities: higher is served first. Use one key per streamer so the
+// values are comparable.
+inline float PriorityFromDistance(float distance) { return -distance; }
+inline float PriorityFromScreenSize(float screenPixels) { return screenPixels; }
+
+// What a decoder produces: CPU-side data the render thread then moves to the
+// GPU a budgeted piece at a time
+class StreamedAsset {
+public:
+    virtual ~StreamedAsset() = default;
+
+    // Render thread. Hands at most maxBytes to the GPU upload path and returns
+    // the bytes handed off; 0 means it could not make progress this frame
+    // (e.g. the staging ring is full). A piece the asset cannot split (a whole
+    // texture level) may go over maxBytes when it is the first one handed off.
+    virtual uint64_t Upload(uint64_t maxBytes) = 0;
+    // Everything has been handed off
+    virtual bool IsUploaded() const = 0;
+};
+
+// Decode worker: turns the mapped file into an asset. Throws std::runtime_error on bad data.
+using AssetDecoder = std::function<std::unique_ptr<StreamedAsset>(MappedFile file)>;
+// Render thread, from Update: the asset is fully handed off, or null if it could not be read or decoded
+using AssetReadyCallback = std::function<void(StreamRequestId id, std::unique_ptr<StreamedAsset> asset)>;
+// Render thread: takes assets cancelled after part of them was uploaded, so
+// they can be destroyed once the GPU is done with them
+using AssetRetireFunction = std::function<void(std::unique_ptr<StreamedAsset> asset)>;
+
+// Loads assets off the frame loop in three stages:
+//   1. I/O thread: maps the file and faults every page in, so no later stage
+//      touches the disk
+//   2. decode worker: runs the request's decoder on the mapping
+//   3. render thread (Update): hands decoded assets to the GPU upload path,
+//      at most byteBudget bytes per frame
+// Each stage serves the highest-priority request it holds; priorities can
+// change while a request waits. Cancel drops a request at any stage. Request,
+// Cancel, SetPriority and Update are render-thread calls; none of them waits
+// on I/O or decoding, they only take a mutex the workers hold for queue
+// operations.
+class AssetStreamer {
+public:
+    static constexpr size_t PAGE_SIZE = 4096; // Stride of the I/O thread's page touches
+
+    struct Stats {
+        // Queue depth per stage, as of the call
+        uint32_t waitingForRead = 0;
+        uint32_t waitingForDecode = 0;
+        uint32_t inFlight = 0;  // Being read or decoded right now
+        uint32_t uploading = 0; // Decoded, waiting for upload budget
+        uint64_t requested = 0;
+        uint64_t completed = 0; // Handed to the ready callback with an asset
+        uint64_t failed = 0;
+        uint64_t cancelled = 0;
+        uint64_t bytesRead = 0;
+        uint64_t bytesUploaded = 0;
+        uint64_t lastUpdateBytes = 0; // Handed off by the last Update, overrun included
+        // Request to ready, over completed requests
+        double latencySumMs = 0.0;
+        double latencyMaxMs = 0.0;
+    };
+
+    AssetStreamer();
+    ~AssetStreamer(); // Drops everything still queued, then joins the workers
+
+    AssetStreamer(const AssetStreamer&) = delete;
+    AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+    // Assets cancelled mid-upload go here; by default they are destroyed at once
+    void SetRetireFunction(AssetRetireFunction retire) { _retire = std::move(retire); }
+
+    StreamRequestId Request(std::string path, float priority, AssetDecoder decoder, AssetReadyCallback onReady);
+    // Returns false if the request already completed (or never existed). The
+    // ready callback is never called for a cancelled request.
+    bool Cancel(StreamRequestId id);
+    void SetPriority(StreamRequestId id, float priority);
+
+    // Render thread, once per frame before the upload flush: delivers failed
+    // requests and hands decoded assets up to byteBudget bytes, highest
+    // priority first. The budget is soft: it can be overrun by one piece an
+    // asset cannot split, and the stats count the bytes actually handed off.
+    void Update(uint64_t byteBudget);
+
+    Stats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Stage {
+        WaitingForRead,
+        Reading,
+        WaitingForDecode,
+        Decoding,
+    };
+
+    // Ordered by priority (highest first), then by request order
+    struct QueueKey {
+        float priority;
+        StreamRequestId id;
+
+        bool operator<(const QueueKey& other) const
+        {
+            return priority != other.priority ? priority > other.priority : id < other.id;
+        }
+    };
+
+    // Owned by the workers' side until decoded (guarded by _mutex)
+    struct PendingRequest {
+        std::string path;
+        float priority;
+        Stage stage;
+        bool cancelled = false; // Set while a worker holds it; the worker drops it
+        AssetDecoder decoder;
+        AssetReadyCallback onReady;
+        MappedFile file;
+        Clock::time_point requested;
+    };
+
+    // Decoded (or failed) and handed to the render thread
+    struct Decoded {
+        StreamRequestId id;
+        float priority;
+        std::unique_ptr<StreamedAsset> asset; // Null if reading or decoding failed
+        AssetReadyCallback onReady;
+        Clock::time_point requested;
+    };
+
+    void IoLoop();
+    void DecodeLoop();
+    void Finish(Decoded& decoded); // Render thread
+
+    mutable std::mutex _mutex;
+    std::condition_variable _readAvailable;
+    std::condition_variable _decodeAvailable;
+    bool _stopping = false;
+    StreamRequestId _nextId = 1;
+    std::unordered_map<StreamRequestId, PendingRequest> _pending;
+    std::set<QueueKey> _readQueue;
+    std::set<QueueKey> _decodeQueue;
+    std::vector<Decoded> _decoded; // Waiting to be picked up by Update
+    Stats _stats;
+
+    // Render thread only
+    std::unordered_map<StreamRequestId, Decoded> _uploads;
+    std::set<QueueKey> _uploadQueue;
+    AssetRetireFunction _retire;
+
+    std::thread _ioThread;
+    std::thread _decodeThread;
+};
+
+} // namespace VulkanApp::Assets
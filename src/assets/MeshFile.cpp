@@ -0,0 +1,387 @@
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace VulkanApp::Assets {
+
+static_assert(std::endian::native == std::endian::little, ".vkmesh files are little-endian and read in place");
+
+namespace {
+uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// offset + size lies within fileSize, without overflowing
+bool InFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+void Fail(const std::string& path, const std::string& what)
+{
+    throw std::runtime_error("Error: " + path + " is not a valid .vkmesh file: " + what + "!");
+}
+
+struct Bounds {
+    float min[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::max()};
+    float max[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                    std::numeric_limits<float>::lowest()};
+
+    void Add(const float* position)
+    {
+        for (int c = 0; c < 3; c++) {
+            min[c] = std::min(min[c], position[c]);
+            max[c] = std::max(max[c], position[c]);
+        }
+    }
+
+    // An empty box collapses to the origin
+    void CopyTo(float outMin[3], float outMax[3]) const
+    {
+        bool empty = min[0] > max[0];
+        for (int c = 0; c < 3; c++) {
+            outMin[c] = empty ? 0.0f : min[c];
+            outMax[c] = empty ? 0.0f : max[c];
+        }
+    }
+};
+
+bool IsPositionFormat(VertexFormat format)
+{
+    return format == VertexFormat::Float32x3 || format == VertexFormat::Float16x4;
+}
+
+// Position of a vertex in a Float32x3 or Float16x4 stream
+std::array<float, 3> ReadPosition(VertexFormat format, const std::byte* data, int64_t vertex)
+{
+    std::array<float, 3> position;
+    if (format == VertexFormat::Float16x4) {
+        uint16_t half[4];
+        std::memcpy(half, data + vertex * sizeof(half), sizeof(half));
+        for (int c = 0; c < 3; c++) {
+            position[c] = HalfToFloat(half[c]);
+        }
+    } else {
+        std::memcpy(position.data(), data + vertex * sizeof(float) * 3, sizeof(float) * 3);
+    }
+    return position;
+}
+} // namespace
+
+uint32_t GetVertexFormatSize(VertexFormat format)
+{
+    switch (format) {
+        case VertexFormat::Float32x2: return 8;
+        case VertexFormat::Float32x3: return 12;
+        case VertexFormat::Float32x4: return 16;
+        case VertexFormat::Float16x2: return 4;
+        case VertexFormat::Float16x4: return 8;
+        case VertexFormat::Octahedral16x2: return 4;
+        case VertexFormat::Unorm10x3_2: return 4;
+        case VertexFormat::Unorm8x4: return 4;
+    }
+    return 0;
+}
+
+const char* GetVertexFormatName(VertexFormat format)
+{
+    switch (format) {
+        case VertexFormat::Float32x2: return "Float32x2";
+        case VertexFormat::Float32x3: return "Float32x3";
+        case VertexFormat::Float32x4: return "Float32x4";
+        case VertexFormat::Float16x2: return "Float16x2";
+        case VertexFormat::Float16x4: return "Float16x4";
+        case VertexFormat::Octahedral16x2: return "Octahedral16x2";
+        case VertexFormat::Unorm10x3_2: return "Unorm10x3_2";
+        case VertexFormat::Unorm8x4: return "Unorm8x4";
+    }
+    return "unknown";
+}
+
+const char* GetVertexSemanticName(VertexSemantic semantic)
+{
+    switch (semantic) {
+        case VertexSemantic::Position: return "position";
+        case VertexSemantic::Normal: return "normal";
+        case VertexSemantic::TexCoord0: return "texcoord0";
+        case VertexSemantic::Color: return "color";
+        case VertexSemantic::Tangent: return "tangent";
+    }
+    return "unknown";
+}
+
+uint16_t FloatToHalf(float value)
+{
+    const uint32_t bits = std::bit_cast<uint32_t>(value);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) {
+        return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u)); // Inf or NaN
+    }
+    if (magnitude >= 0x477FF000u) {
+        return static_cast<uint16_t>(sign | 0x7C00u); // Rounds past the largest half
+    }
+    if (magnitude < 0x38800000u) {
+        // Subnormal half: shift the mantissa (with its implicit bit) into place, rounding to even
+        if (magnitude < 0x33000000u) {
+            return static_cast<uint16_t>(sign);
+        }
+        const uint32_t exponent = magnitude >> 23;
+        const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        const uint32_t shift = 126 - exponent; // 14..24
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+    // Normal: rebias the exponent and round the mantissa to 10 bits, to even
+    uint32_t half = (magnitude - 0x38000000u) >> 13;
+    const uint32_t rest = magnitude & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) {
+        half++;
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t value)
+{
+    const uint32_t sign = uint32_t(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1Fu;
+    const uint32_t mantissa = value & 0x3FFu;
+    if (exponent == 0) {
+        // Zero or subnormal: mantissa * 2^-24
+        const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        return sign ? -magnitude : magnitude;
+    }
+    if (exponent == 0x1F) {
+        return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+const MeshData::Stream* MeshData::FindStream(VertexSemantic semantic) const
+{
+    for (const Stream& stream : streams) {
+        if (stream.semantic == semantic) {
+            return &stream;
+        }
+    }
+    return nullptr;
+}
+
+// --- Writing ---
+
+void WriteMeshFile(const MeshData& mesh, const std::string& path)
+{
+    const MeshData::Stream* positions = mesh.FindStream(VertexSemantic::Position);
+    if (positions == nullptr || !IsPositionFormat(positions->format)) {
+        throw std::runtime_error("Error: a mesh needs a Float32x3 or Float16x4 position stream to be written!");
+    }
+    for (const MeshData::Stream& stream : mesh.streams) {
+        uint32_t size = GetVertexFormatSize(stream.format);
+        if (size == 0 || stream.data.size() != static_cast<size_t>(mesh.vertexCount) * size) {
+            throw std::runtime_error(std::string("Error: mesh stream ") + GetVertexSemanticName(stream.semantic) +
+                                     " does not hold one attribute per vertex!");
+        }
+    }
+    auto position = [&](int64_t vertex) { return ReadPosition(positions->format, positions->data.data(), vertex); };
+
+    // Bounds per submesh from the vertices it references, and of the whole mesh
+    std::vector<MeshSubmesh> submeshes = mesh.submeshes;
+    Bounds meshBounds;
+    for (MeshSubmesh& submesh : submeshes) {
+        if (uint64_t(submesh.firstIndex) + submesh.indexCount > mesh.indices.size()) {
+            throw std::runtime_error("Error: mesh submesh exceeds the index buffer!");
+        }
+        Bounds bounds;
+        for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; i++) {
+            int64_t vertex = int64_t(mesh.indices[i]) + submesh.vertexOffset;
+            if (vertex < 0 || vertex >= mesh.vertexCount) {
+                throw std::runtime_error("Error: mesh index " + std::to_string(i) + " is out of range!");
+            }
+            bounds.Add(position(vertex).data());
+        }
+        bounds.CopyTo(submesh.boundsMin, submesh.boundsMax);
+    }
+    for (uint32_t v = 0; v < mesh.vertexCount; v++) {
+        meshBounds.Add(position(v).data());
+    }
+
+    const bool narrow = mesh.vertexCount <= 65536 &&
+                        std::all_of(submeshes.begin(), submeshes.end(),
+                                    [](const MeshSubmesh& submesh) { return submesh.vertexOffset == 0; });
+    const IndexType indexType = narrow ? IndexType::Uint16 : IndexType::Uint32;
+
+    MeshFileHeader header{};
+    std::memcpy(header.magic, MESH_FILE_MAGIC, sizeof(header.magic));
+    header.version = MESH_FILE_VERSION;
+    header.headerSize = sizeof(MeshFileHeader);
+    header.vertexCount = mesh.vertexCount;
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.indexType = static_cast<uint32_t>(indexType);
+    header.streamCount = static_cast<uint32_t>(mesh.streams.size());
+    header.submeshCount = static_cast<uint32_t>(submeshes.size());
+    meshBounds.CopyTo(header.boundsMin, header.boundsMax);
+
+    // Layout: header, tables, then aligned data sections
+    uint64_t offset = sizeof(MeshFileHeader);
+    header.streamTableOffset = offset;
+    offset += sizeof(MeshStreamDesc) * mesh.streams.size();
+    header.submeshTableOffset = offset;
+    offset += sizeof(MeshSubmesh) * submeshes.size();
+    header.indexDataOffset = AlignUp(offset, MESH_SECTION_ALIGNMENT);
+    header.indexDataSize = uint64_t(header.indexCount) * static_cast<uint32_t>(indexType);
+    offset = header.indexDataOffset + header.indexDataSize;
+    std::vector<MeshStreamDesc> streams(mesh.streams.size());
+    for (size_t i = 0; i < mesh.streams.size(); i++) {
+        streams[i].semantic = static_cast<uint32_t>(mesh.streams[i].semantic);
+        streams[i].format = static_cast<uint32_t>(mesh.streams[i].format);
+        streams[i].stride = GetVertexFormatSize(mesh.streams[i].format);
+        streams[i].dataOffset = AlignUp(offset, MESH_SECTION_ALIGNMENT);
+        streams[i].dataSize = mesh.streams[i].data.size();
+        offset = streams[i].dataOffset + streams[i].dataSize;
+    }
+    header.fileSize = offset;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+    uint64_t written = 0;
+    auto write = [&](const void* data, uint64_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        written += size;
+    };
+    auto padTo = [&](uint64_t target) {
+        static const char zeros[MESH_SECTION_ALIGNMENT] = {};
+        write(zeros, target - written);
+    };
+    write(&header, sizeof(header));
+    write(streams.data(), sizeof(MeshStreamDesc) * streams.size());
+    write(submeshes.data(), sizeof(MeshSubmesh) * submeshes.size());
+    padTo(header.indexDataOffset);
+    if (narrow) {
+        std::vector<uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+        write(indices.data(), header.indexDataSize);
+    } else {
+        write(mesh.indices.data(), header.indexDataSize);
+    }
+    for (size_t i = 0; i < streams.size(); i++) {
+        padTo(streams[i].dataOffset);
+        write(mesh.streams[i].data.data(), streams[i].dataSize);
+    }
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
+
+// --- Reading ---
+
+MeshFile::MeshFile(const std::string& path)
+    : MeshFile(MappedFile(path))
+{
+}
+
+MeshFile::MeshFile(MappedFile file)
+    : _file(std::move(file))
+{
+    Validate();
+}
+
+// Every offset, size and count is checked against the mapping before anything
+// is read through it, so a truncated or corrupt file fails here, not later
+void MeshFile::Validate()
+{
+    const std::string& path = _file.GetPath();
+    std::span<const std::byte> bytes = _file.GetBytes();
+    const uint64_t fileSize = bytes.size();
+    if (fileSize < sizeof(MeshFileHeader)) {
+        Fail(path, "shorter than the header");
+    }
+    _header = reinterpret_cast<const MeshFileHeader*>(bytes.data());
+    const MeshFileHeader& header = *_header;
+    if (std::memcmp(header.magic, MESH_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        Fail(path, "bad magic");
+    }
+    if (header.version != MESH_FILE_VERSION) {
+        Fail(path, "version " + std::to_string(header.version) + ", expected " + std::to_string(MESH_FILE_VERSION));
+    }
+    if (header.headerSize != sizeof(MeshFileHeader) || header.fileSize != fileSize) {
+        Fail(path, "header or file size mismatch (truncated?)");
+    }
+    if (header.indexType != static_cast<uint32_t>(IndexType::Uint16) &&
+        header.indexType != static_cast<uint32_t>(IndexType::Uint32)) {
+        Fail(path, "unknown index type");
+    }
+
+    const uint64_t streamTableSize = uint64_t(header.streamCount) * sizeof(MeshStreamDesc);
+    const uint64_t submeshTableSize = uint64_t(header.submeshCount) * sizeof(MeshSubmesh);
+    if (!InFile(header.streamTableOffset, streamTableSize, fileSize) || header.streamTableOffset % 8 != 0 ||
+        !InFile(header.submeshTableOffset, submeshTableSize, fileSize) || header.submeshTableOffset % 4 != 0) {
+        Fail(path, "tables out of bounds");
+    }
+    if (!InFile(header.indexDataOffset, header.indexDataSize, fileSize) ||
+        header.indexDataOffset % MESH_SECTION_ALIGNMENT != 0 ||
+        header.indexDataSize != uint64_t(header.indexCount) * header.indexType) {
+        Fail(path, "index data out of bounds");
+    }
+
+    _streams = {reinterpret_cast<const MeshStreamDesc*>(bytes.data() + header.streamTableOffset), header.streamCount};
+    _submeshes = {reinterpret_cast<const MeshSubmesh*>(bytes.data() + header.submeshTableOffset),
+                  header.submeshCount};
+    for (const MeshStreamDesc& stream : _streams) {
+        uint32_t size = GetVertexFormatSize(static_cast<VertexFormat>(stream.format));
+        if (size == 0 || stream.stride < size) {
+            Fail(path, "unknown vertex format or bad stride");
+        }
+        if (!InFile(stream.dataOffset, stream.dataSize, fileSize) || stream.dataOffset % MESH_SECTION_ALIGNMENT != 0 ||
+            stream.dataSize != uint64_t(header.vertexCount) * stream.stride) {
+            Fail(path, std::string(GetVertexSemanticName(static_cast<VertexSemantic>(stream.semantic))) +
+                           " stream out of bounds");
+        }
+    }
+    for (const MeshSubmesh& submesh : _submeshes) {
+        if (uint64_t(submesh.firstIndex) + submesh.indexCount > header.indexCount) {
+            Fail(path, "submesh exceeds the index data");
+        }
+    }
+    const MeshStreamDesc* positions = FindStream(VertexSemantic::Position);
+    if (positions == nullptr || !IsPositionFormat(static_cast<VertexFormat>(positions->format))) {
+        Fail(path, "no Float32x3 or Float16x4 position stream");
+    }
+}
+
+const MeshStreamDesc* MeshFile::FindStream(VertexSemantic semantic) const
+{
+    for (const MeshStreamDesc& stream : _streams) {
+        if (stream.semantic == static_cast<uint32_t>(semantic)) {
+            return &stream;
+        }
+    }
+    return nullptr;
+}
+
+std::span<const std::byte> MeshFile::GetStreamData(const MeshStreamDesc& stream) const
+{
+    return _file.GetBytes().subspan(stream.dataOffset, stream.dataSize);
+}
+
+std::span<const std::byte> MeshFile::GetIndexData() const
+{
+    return _file.GetBytes().subspan(_header->indexDataOffset, _header->indexDataSize);
+}
+
+} // namespace VulkanApp::Assets
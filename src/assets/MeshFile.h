@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../core/MappedFile.h"
+
+namespace VulkanApp::Assets {
+
+// .vkmesh: binary mesh container read in place from a memory mapping.
+// Little-endian; the tables follow the header, and every data section starts
+// on a MESH_SECTION_ALIGNMENT boundary so it can be copied into a staging
+// buffer as-is:
+//   MeshFileHeader
+//   MeshStreamDesc[streamCount]
+//   MeshSubmesh[submeshCount]
+//   index data (indexCount indices of indexType)
+//   vertex stream data, one section per stream (vertexCount * stride bytes)
+// Streams are non-interleaved, one attribute each, so a depth-only pass can
+// bind positions alone. Bump MESH_FILE_VERSION on any layout change; readers
+// reject other versions and the converter regenerates the files.
+constexpr char MESH_FILE_MAGIC[8] = {'V', 'K', 'M', 'E', 'S', 'H', '\0', '\0'};
+constexpr uint32_t MESH_FILE_VERSION = 1;
+constexpr uint64_t MESH_SECTION_ALIGNMENT = 256; // Covers copy offset and atom size alignments in practice
+
+enum class VertexSemantic : uint32_t {
+    Position = 0,
+    Normal = 1,
+    TexCoord0 = 2,
+    Color = 3,
+    Tangent = 4,
+};
+
+// Quantized formats come from MeshOptimizer's QuantizeMesh; each maps to a
+// vertex input format the shader reads as float (see shaders/mesh_decode.glsl)
+enum class VertexFormat : uint32_t {
+    Float32x2 = 1,
+    Float32x3 = 2,
+    Float32x4 = 3,
+    Float16x2 = 4,
+    Float16x4 = 5,      // Positions: xyz, w = 1
+    Octahedral16x2 = 6, // Unit vectors, octahedral map in snorm16
+    Unorm10x3_2 = 7,    // Unit vectors biased to [0, 1] in xyz, w in the 2-bit alpha (A2B10G10R10)
+    Unorm8x4 = 8,
+};
+
+enum class IndexType : uint32_t {
+    Uint16 = 2, // Value = bytes per index
+    Uint32 = 4,
+};
+
+// Bytes of one attribute of the format (0 for an unknown format)
+uint32_t GetVertexFormatSize(VertexFormat format);
+const char* GetVertexFormatName(VertexFormat format);
+const char* GetVertexSemanticName(VertexSemantic semantic);
+
+// IEEE half precision, round to nearest even; out-of-range values become infinity
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+struct MeshFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize; // sizeof(MeshFileHeader)
+    uint64_t fileSize;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t indexType; // IndexType
+    uint32_t streamCount;
+    uint32_t submeshCount;
+    uint32_t flags; // Reserved, 0
+    float boundsMin[3]; // Object-space AABB of every position
+    float boundsMax[3];
+    uint64_t streamTableOffset;
+    uint64_t submeshTableOffset;
+    uint64_t indexDataOffset;
+    uint64_t indexDataSize;
+};
+static_assert(sizeof(MeshFileHeader) == 104, "MeshFileHeader is part of the file format");
+
+struct MeshStreamDesc {
+    uint32_t semantic; // VertexSemantic
+    uint32_t format;   // VertexFormat
+    uint32_t stride;   // Bytes between vertices
+    uint32_t reserved;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+static_assert(sizeof(MeshStreamDesc) == 32, "MeshStreamDesc is part of the file format");
+
+// A range of the index buffer drawn with one material
+struct MeshSubmesh {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t vertexOffset;   // Added to every index (vkCmdDrawIndexed's vertexOffset)
+    uint32_t materialIndex; // Order of first use in the source file
+    float boundsMin[3];
+    float boundsMax[3];
+};
+static_assert(sizeof(MeshSubmesh) == 40, "MeshSubmesh is part of the file format");
+
+// A mesh in memory, as produced by importers and consumed by WriteMeshFile.
+// Indices are always 32-bit here; the writer narrows them when they fit.
+struct MeshData {
+    struct Stream {
+        VertexSemantic semantic;
+        VertexFormat format;
+        std::vector<std::byte> data; // vertexCount tightly packed attributes
+    };
+
+    uint32_t vertexCount = 0;
+    std::vector<Stream> streams;
+    std::vector<uint32_t> indices;
+    std::vector<MeshSubmesh> submeshes; // Bounds are filled in by WriteMeshFile
+
+    const Stream* FindStream(VertexSemantic semantic) const;
+};
+
+// Writes mesh as a .vkmesh file. Needs a Float32x3 or Float16x4 position stream; picks
+// 16-bit indices when every vertex is reachable with them. Throws
+// std::runtime_error on invalid input or I/O failure.
+void WriteMeshFile(const MeshData& mesh, const std::string& path);
+
+// A validated, memory-mapped .vkmesh. Accessors return views into the mapping:
+// nothing is parsed, converted or copied. Moveable, not copyable.
+class MeshFile {
+public:
+    // Maps and validates the file; throws std::runtime_error if it is not a
+    // well-formed .vkmesh of this version
+    explicit MeshFile(const std::string& path);
+    explicit MeshFile(MappedFile file);
+
+    const MeshFileHeader& GetHeader() const { return *_header; }
+    uint32_t GetVertexCount() const { return _header->vertexCount; }
+    uint32_t GetIndexCount() const { return _header->indexCount; }
+    IndexType GetIndexType() const { return static_cast<IndexType>(_header->indexType); }
+
+    std::span<const MeshStreamDesc> GetStreams() const { return _streams; }
+    const MeshStreamDesc* FindStream(VertexSemantic semantic) const;
+    std::span<const std::byte> GetStreamData(const MeshStreamDesc& stream) const;
+    std::span<const MeshSubmesh> GetSubmeshes() const { return _submeshes; }
+    std::span<const std::byte> GetIndexData() const;
+
+    const MappedFile& GetMappedFile() const { return _file; }
+    size_t GetFileSize() const { return _file.GetSize(); }
+
+private:
+    void Validate();
+
+    MappedFile _file;
+    const MeshFileHeader* _header = nullptr;
+    std::span<const MeshStreamDesc> _streams;
+    std::span<const MeshSubmesh> _submeshes;
+};
+
+} // namespace VulkanApp::Assets
@@ -0,0 +1,581 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace VulkanApp::Assets {
+
+namespace {
+constexpr uint32_t FORSYTH_CACHE_SIZE = 32; // Simulated LRU cache of the vertex cache optimizer
+constexpr uint32_t FETCH_CACHE_LINES = 256; // Direct-mapped cache AnalyzeMesh fetches through: 16 KiB
+constexpr uint32_t FETCH_LINE_SIZE = 64;
+constexpr uint32_t UNUSED_VERTEX = std::numeric_limits<uint32_t>::max();
+constexpr size_t NO_TRIANGLE = std::numeric_limits<size_t>::max();
+
+void CheckIndices(std::span<const uint32_t> indices, uint32_t vertexCount)
+{
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (indices[i] >= vertexCount) {
+            throw std::runtime_error("Error: mesh index " + std::to_string(i) + " is out of range!");
+        }
+    }
+}
+
+// Indices with each submesh's vertexOffset applied
+std::vector<uint32_t> AbsoluteIndices(const MeshData& mesh)
+{
+    std::vector<uint32_t> indices = mesh.indices;
+    for (const MeshSubmesh& submesh : mesh.submeshes) {
+        if (uint64_t(submesh.firstIndex) + submesh.indexCount > indices.size()) {
+            throw std::runtime_error("Error: mesh submesh exceeds the index buffer!");
+        }
+        for (uint32_t i = submesh.firstIndex; i < submesh.firstIndex + submesh.indexCount; i++) {
+            int64_t vertex = int64_t(indices[i]) + submesh.vertexOffset;
+            if (vertex < 0 || vertex >= mesh.vertexCount) {
+                throw std::runtime_error("Error: mesh index " + std::to_string(i) + " is out of range!");
+            }
+            indices[i] = static_cast<uint32_t>(vertex);
+        }
+    }
+    CheckIndices(indices, mesh.vertexCount);
+    return indices;
+}
+
+// FIFO post-transform cache; Clear() is O(1)
+class FifoCache {
+public:
+    FifoCache(uint32_t vertexCount, uint32_t size)
+        : _inserted(vertexCount, 0), _size(size), _time(uint64_t(size) + 1)
+    {
+    }
+
+    // 1 on a miss (the vertex is shaded and inserted), 0 on a hit
+    uint32_t Access(uint32_t vertex)
+    {
+        if (_time - _inserted[vertex] > _size) {
+            _inserted[vertex] = _time++;
+            return 1;
+        }
+        return 0;
+    }
+
+    void Clear() { _time += uint64_t(_size) + 1; }
+
+private:
+    std::vector<uint64_t> _inserted; // Miss count when the vertex last went in
+    uint64_t _size;
+    uint64_t _time;
+};
+
+// Triangles using each vertex; the first counts[v] of a vertex's entries are
+// the ones not emitted yet
+struct Adjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> counts;
+    std::vector<uint32_t> triangles;
+
+    Adjacency(std::span<const uint32_t> indices, size_t triangleCount, uint32_t vertexCount)
+        : offsets(vertexCount + 1, 0), counts(vertexCount, 0), triangles(triangleCount * 3)
+    {
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            counts[indices[i]]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            offsets[v + 1] = offsets[v] + counts[v];
+        }
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::span<uint32_t> Live(uint32_t vertex) { return {triangles.data() + offsets[vertex], counts[vertex]}; }
+
+    void Remove(uint32_t vertex, uint32_t triangle)
+    {
+        std::span<uint32_t> live = Live(vertex);
+        *std::find(live.begin(), live.end(), triangle) = live.back();
+        counts[vertex]--;
+    }
+};
+
+// Forsyth's vertex score: recently used vertices and vertices with few
+// triangles left score higher. Tabulated, as it is evaluated ~100 times per triangle.
+constexpr uint32_t VALENCE_TABLE_SIZE = 32;
+
+struct ScoreTables {
+    std::array<float, FORSYTH_CACHE_SIZE> cache;
+    std::array<float, VALENCE_TABLE_SIZE> valence;
+
+    ScoreTables()
+    {
+        for (uint32_t position = 0; position < FORSYTH_CACHE_SIZE; position++) {
+            // The last triangle's three vertices score the same, so the next
+            // triangle is not forced to share an edge with it
+            cache[position] = position < 3 ? 0.75f
+                                           : std::pow(1.0f - static_cast<float>(position - 3) / (FORSYTH_CACHE_SIZE - 3),
+                                                      1.5f);
+        }
+        for (uint32_t live = 1; live < VALENCE_TABLE_SIZE; live++) {
+            valence[live] = 2.0f / std::sqrt(static_cast<float>(live));
+        }
+    }
+};
+
+float VertexScore(const ScoreTables& tables, int32_t cachePosition, uint32_t liveTriangles)
+{
+    if (liveTriangles == 0) {
+        return -1.0f; // Nothing left to draw with it
+    }
+    float score = cachePosition >= 0 ? tables.cache[cachePosition] : 0.0f;
+    return score + (liveTriangles < VALENCE_TABLE_SIZE ? tables.valence[liveTriangles]
+                                                       : 2.0f / std::sqrt(static_cast<float>(liveTriangles)));
+}
+
+struct Vec3 {
+    double x = 0.0, y = 0.0, z = 0.0;
+
+    Vec3 operator+(const Vec3& o) const { return {x + o.x, y + o.y, z + o.z}; }
+    Vec3 operator-(const Vec3& o) const { return {x - o.x, y - o.y, z - o.z}; }
+    Vec3 operator*(double s) const { return {x * s, y * s, z * s}; }
+    double Dot(const Vec3& o) const { return x * o.x + y * o.y + z * o.z; }
+    Vec3 Cross(const Vec3& o) const { return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x}; }
+    double Length() const { return std::sqrt(Dot(*this)); }
+};
+
+Vec3 LoadPosition(const float* positions, uint32_t vertex)
+{
+    const float* p = positions + size_t(vertex) * 3;
+    return {p[0], p[1], p[2]};
+}
+
+float SignNotZero(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+uint32_t ToUnorm(float value, uint32_t max)
+{
+    return static_cast<uint32_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * static_cast<float>(max)));
+}
+
+// Re-encodes every attribute of stream: encode(const float* source, std::byte* destination)
+template <typename Encode>
+void Reencode(MeshData::Stream& stream, uint32_t vertexCount, VertexFormat format, Encode encode)
+{
+    const uint32_t sourceSize = GetVertexFormatSize(stream.format);
+    const uint32_t size = GetVertexFormatSize(format);
+    std::vector<std::byte> data(size_t(vertexCount) * size);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        float source[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        std::memcpy(source, stream.data.data() + size_t(v) * sourceSize, sourceSize);
+        encode(source, data.data() + size_t(v) * size);
+    }
+    stream.format = format;
+    stream.data = std::move(data);
+}
+} // namespace
+
+// --- Analysis ---
+
+MeshCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    CheckIndices(indices, vertexCount);
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    uint64_t misses = 0;
+    uint64_t uniqueVertices = 0;
+    for (uint32_t index : indices) {
+        misses += cache.Access(index);
+        if (!referenced[index]) {
+            referenced[index] = true;
+            uniqueVertices++;
+        }
+    }
+    MeshCacheStats stats;
+    const size_t triangleCount = indices.size() / 3;
+    stats.acmr = triangleCount > 0 ? static_cast<float>(double(misses) / triangleCount) : 0.0f;
+    stats.atvr = uniqueVertices > 0 ? static_cast<float>(double(misses) / uniqueVertices) : 0.0f;
+    return stats;
+}
+
+MeshCacheStats AnalyzeMesh(const MeshData& mesh)
+{
+    const std::vector<uint32_t> indices = AbsoluteIndices(mesh);
+    MeshCacheStats stats = AnalyzeVertexCache(indices, mesh.vertexCount);
+
+    // Each stream fetched through its own cache, as if from a 256-byte aligned buffer
+    std::vector<bool> referenced(mesh.vertexCount, false);
+    uint64_t referencedBytes = 0;
+    uint64_t fetchedBytes = 0;
+    uint64_t vertexSize = 0;
+    for (const MeshData::Stream& stream : mesh.streams) {
+        vertexSize += GetVertexFormatSize(stream.format);
+    }
+    for (uint32_t index : indices) {
+        if (!referenced[index]) {
+            referenced[index] = true;
+            referencedBytes += vertexSize;
+        }
+    }
+    for (const MeshData::Stream& stream : mesh.streams) {
+        const uint64_t stride = GetVertexFormatSize(stream.format);
+        std::array<uint64_t, FETCH_CACHE_LINES> lines;
+        lines.fill(std::numeric_limits<uint64_t>::max());
+        for (uint32_t index : indices) {
+            const uint64_t first = index * stride / FETCH_LINE_SIZE;
+            const uint64_t last = (index * stride + stride - 1) / FETCH_LINE_SIZE;
+            for (uint64_t line = first; line <= last; line++) {
+                uint64_t& slot = lines[line % FETCH_CACHE_LINES];
+                if (slot != line) {
+                    slot = line;
+                    fetchedBytes += FETCH_LINE_SIZE;
+                }
+            }
+        }
+    }
+    stats.overfetch = referencedBytes > 0 ? static_cast<float>(double(fetchedBytes) / referencedBytes) : 0.0f;
+    return stats;
+}
+
+// --- Optimization ---
+
+// Greedy: emits the best-scoring triangle among those using a cached vertex,
+// then rescores only the cache's vertices and their triangles, so the cost is
+// linear in the triangle count. When the cache holds no usable triangle, the
+// next triangle in input order starts a new strip.
+void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount)
+{
+    CheckIndices(indices, vertexCount);
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    static const ScoreTables tables;
+    Adjacency adjacency(indices, triangleCount, vertexCount);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = VertexScore(tables, -1, adjacency.counts[v]);
+    }
+    auto triangleScore = [&](size_t triangle) {
+        const uint32_t* corners = indices.data() + triangle * 3;
+        return vertexScore[corners[0]] + vertexScore[corners[1]] + vertexScore[corners[2]];
+    };
+
+    size_t best = 0;
+    for (size_t t = 1; t < triangleCount; t++) {
+        if (triangleScore(t) > triangleScore(best)) {
+            best = t;
+        }
+    }
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> nextCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+    size_t cursor = 0;
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (best == NO_TRIANGLE) {
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best = cursor;
+        }
+        const uint32_t* corners = indices.data() + best * 3;
+        output.insert(output.end(), corners, corners + 3);
+        emitted[best] = true;
+
+        // The triangle's vertices move to the front; the rest shift back and
+        // the last ones fall out
+        nextCache.clear();
+        for (int c = 0; c < 3; c++) {
+            adjacency.Remove(corners[c], static_cast<uint32_t>(best));
+            if (std::find(nextCache.begin(), nextCache.end(), corners[c]) == nextCache.end()) {
+                nextCache.push_back(corners[c]);
+            }
+        }
+        for (uint32_t vertex : cache) {
+            if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2]) {
+                nextCache.push_back(vertex);
+            }
+        }
+        for (size_t i = 0; i < nextCache.size(); i++) {
+            int32_t position = i < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+            vertexScore[nextCache[i]] = VertexScore(tables, position, adjacency.counts[nextCache[i]]);
+        }
+        nextCache.resize(std::min<size_t>(nextCache.size(), FORSYTH_CACHE_SIZE));
+        cache.swap(nextCache);
+
+        best = NO_TRIANGLE;
+        float bestScore = 0.0f;
+        for (uint32_t vertex : cache) {
+            for (uint32_t triangle : adjacency.Live(vertex)) {
+                float score = triangleScore(triangle);
+                if (best == NO_TRIANGLE || score > bestScore) {
+                    best = triangle;
+                    bestScore = score;
+                }
+            }
+        }
+    }
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+// Sander, Nehab and Barczak's linear-speed reordering: the cache-optimized
+// order is cut into clusters, and clusters facing away from the mesh centre
+// go first, so they tend to occlude the ones drawn after them. Within a
+// cluster the cache order is kept.
+void OptimizeOverdraw(std::span<uint32_t> indices, const float* positions, uint32_t vertexCount, float threshold)
+{
+    CheckIndices(indices, vertexCount);
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // Hard boundaries: triangles that miss the cache entirely start a new run
+    FifoCache cache(vertexCount, ANALYZE_CACHE_SIZE);
+    std::vector<uint32_t> misses(triangleCount);
+    std::vector<size_t> hardStarts;
+    for (size_t t = 0; t < triangleCount; t++) {
+        misses[t] = cache.Access(indices[t * 3]) + cache.Access(indices[t * 3 + 1]) + cache.Access(indices[t * 3 + 2]);
+        if (t == 0 || misses[t] == 3) {
+            hardStarts.push_back(t);
+        }
+    }
+    hardStarts.push_back(triangleCount);
+
+    // Soft boundaries: within a run, cut wherever the ACMR since the last cut
+    // (with the cache starting empty there) is back within threshold of the run's
+    std::vector<size_t> clusterStarts;
+    for (size_t run = 0; run + 1 < hardStarts.size(); run++) {
+        const size_t start = hardStarts[run];
+        const size_t end = hardStarts[run + 1];
+        uint64_t runMisses = 0;
+        for (size_t t = start; t < end; t++) {
+            runMisses += misses[t];
+        }
+        const double limit = threshold * double(runMisses) / double(end - start);
+
+        cache.Clear();
+        clusterStarts.push_back(start);
+        uint64_t clusterMisses = 0;
+        for (size_t t = start; t < end; t++) {
+            clusterMisses +=
+                cache.Access(indices[t * 3]) + cache.Access(indices[t * 3 + 1]) + cache.Access(indices[t * 3 + 2]);
+            if (t + 1 < end && double(clusterMisses) <= limit * double(t + 1 - clusterStarts.back())) {
+                clusterStarts.push_back(t + 1);
+                clusterMisses = 0;
+                cache.Clear();
+            }
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+    const size_t clusterCount = clusterStarts.size() - 1;
+
+    // Area-weighted centroids and normals
+    std::vector<Vec3> clusterCentroid(clusterCount);
+    std::vector<Vec3> clusterNormal(clusterCount);
+    std::vector<double> clusterArea(clusterCount, 0.0);
+    Vec3 meshCentroid;
+    double meshArea = 0.0;
+    for (size_t cluster = 0; cluster < clusterCount; cluster++) {
+        for (size_t t = clusterStarts[cluster]; t < clusterStarts[cluster + 1]; t++) {
+            Vec3 a = LoadPosition(positions, indices[t * 3]);
+            Vec3 b = LoadPosition(positions, indices[t * 3 + 1]);
+            Vec3 c = LoadPosition(positions, indices[t * 3 + 2]);
+            Vec3 normal = (b - a).Cross(c - a); // Length = twice the area
+            double area = normal.Length();
+            Vec3 centroid = (a + b + c) * (area / 3.0);
+            clusterCentroid[cluster] = clusterCentroid[cluster] + centroid;
+            clusterNormal[cluster] = clusterNormal[cluster] + normal;
+            clusterArea[cluster] += area;
+        }
+        meshCentroid = meshCentroid + clusterCentroid[cluster];
+        meshArea += clusterArea[cluster];
+    }
+    if (meshArea > 0.0) {
+        meshCentroid = meshCentroid * (1.0 / meshArea);
+    }
+
+    std::vector<double> sortKey(clusterCount, 0.0);
+    for (size_t cluster = 0; cluster < clusterCount; cluster++) {
+        double normalLength = clusterNormal[cluster].Length();
+        if (clusterArea[cluster] > 0.0 && normalLength > 0.0) {
+            Vec3 centroid = clusterCentroid[cluster] * (1.0 / clusterArea[cluster]);
+            sortKey[cluster] = (centroid - meshCentroid).Dot(clusterNormal[cluster]) / normalLength;
+        }
+    }
+    std::vector<size_t> order(clusterCount);
+    for (size_t cluster = 0; cluster < clusterCount; cluster++) {
+        order[cluster] = cluster;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for (size_t cluster : order) {
+        output.insert(output.end(), indices.begin() + clusterStarts[cluster] * 3,
+                      indices.begin() + clusterStarts[cluster + 1] * 3);
+    }
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void OptimizeVertexFetch(MeshData& mesh)
+{
+    std::vector<uint32_t> indices = AbsoluteIndices(mesh);
+    std::vector<uint32_t> remap(mesh.vertexCount, UNUSED_VERTEX);
+    uint32_t nextVertex = 0;
+    for (size_t i = 0; i < indices.size(); i++) {
+        uint32_t& target = remap[indices[i]];
+        if (target == UNUSED_VERTEX) {
+            target = nextVertex++;
+        }
+        mesh.indices[i] = target;
+    }
+    for (MeshData::Stream& stream : mesh.streams) {
+        const uint32_t size = GetVertexFormatSize(stream.format);
+        std::vector<std::byte> data(size_t(nextVertex) * size);
+        for (uint32_t v = 0; v < mesh.vertexCount; v++) {
+            if (remap[v] != UNUSED_VERTEX) {
+                std::memcpy(data.data() + size_t(remap[v]) * size, stream.data.data() + size_t(v) * size, size);
+            }
+        }
+        stream.data = std::move(data);
+    }
+    mesh.vertexCount = nextVertex;
+    for (MeshSubmesh& submesh : mesh.submeshes) {
+        submesh.vertexOffset = 0;
+    }
+}
+
+void OptimizeMesh(MeshData& mesh, float overdrawThreshold)
+{
+    const MeshData::Stream* positions = mesh.FindStream(VertexSemantic::Position);
+    if (positions == nullptr || positions->format != VertexFormat::Float32x3) {
+        throw std::runtime_error("Error: mesh optimization needs a Float32x3 position stream!");
+    }
+    // Triangles never move between submeshes, so each is optimized on its own
+    mesh.indices = AbsoluteIndices(mesh);
+    for (MeshSubmesh& submesh : mesh.submeshes) {
+        submesh.vertexOffset = 0;
+    }
+    const float* position = reinterpret_cast<const float*>(positions->data.data());
+    auto optimize = [&](std::span<uint32_t> indices) {
+        OptimizeVertexCache(indices, mesh.vertexCount);
+        OptimizeOverdraw(indices, position, mesh.vertexCount, overdrawThreshold);
+    };
+    if (mesh.submeshes.empty()) {
+        optimize(mesh.indices);
+    }
+    for (const MeshSubmesh& submesh : mesh.submeshes) {
+        optimize(std::span<uint32_t>(mesh.indices).subspan(submesh.firstIndex, submesh.indexCount));
+    }
+    OptimizeVertexFetch(mesh);
+}
+
+// --- Quantization ---
+
+void EncodeOctahedral(const float normal[3], int16_t out[2])
+{
+    const float length = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+    float x = length > 0.0f ? normal[0] / length : 0.0f;
+    float y = length > 0.0f ? normal[1] / length : 0.0f;
+    if (length > 0.0f && normal[2] < 0.0f) {
+        // Lower hemisphere: fold onto the corners of the square
+        float foldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+        y = (1.0f - std::abs(x)) * SignNotZero(y);
+        x = foldedX;
+    }
+    out[0] = static_cast<int16_t>(std::lround(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+    out[1] = static_cast<int16_t>(std::lround(std::clamp(y, -1.0f, 1.0f) * 32767.0f));
+}
+
+void DecodeOctahedral(const int16_t encoded[2], float out[3])
+{
+    // As VK_FORMAT_R16G16_SNORM reads it
+    float x = std::max(encoded[0] / 32767.0f, -1.0f);
+    float y = std::max(encoded[1] / 32767.0f, -1.0f);
+    float z = 1.0f - std::abs(x) - std::abs(y);
+    if (z < 0.0f) {
+        float unfoldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+        y = (1.0f - std::abs(x)) * SignNotZero(y);
+        x = unfoldedX;
+    }
+    const float length = std::sqrt(x * x + y * y + z * z);
+    out[0] = x / length;
+    out[1] = y / length;
+    out[2] = z / length;
+}
+
+void QuantizeMesh(MeshData& mesh, const QuantizeOptions& options)
+{
+    for (MeshData::Stream& stream : mesh.streams) {
+        if (stream.data.size() != size_t(mesh.vertexCount) * GetVertexFormatSize(stream.format)) {
+            throw std::runtime_error(std::string("Error: mesh stream ") + GetVertexSemanticName(stream.semantic) +
+                                     " does not hold one attribute per vertex!");
+        }
+        switch (stream.semantic) {
+            case VertexSemantic::Position:
+                if (options.positions && stream.format == VertexFormat::Float32x3) {
+                    Reencode(stream, mesh.vertexCount, VertexFormat::Float16x4, [](const float* p, std::byte* out) {
+                        const uint16_t half[4] = {FloatToHalf(p[0]), FloatToHalf(p[1]), FloatToHalf(p[2]),
+                                                  FloatToHalf(1.0f)};
+                        std::memcpy(out, half, sizeof(half));
+                    });
+                }
+                break;
+            case VertexSemantic::Normal:
+                if (options.normals && stream.format == VertexFormat::Float32x3) {
+                    Reencode(stream, mesh.vertexCount, VertexFormat::Octahedral16x2,
+                             [](const float* n, std::byte* out) {
+                                 int16_t encoded[2];
+                                 EncodeOctahedral(n, encoded);
+                                 std::memcpy(out, encoded, sizeof(encoded));
+                             });
+                }
+                break;
+            case VertexSemantic::TexCoord0:
+                if (options.texCoords && stream.format == VertexFormat::Float32x2) {
+                    Reencode(stream, mesh.vertexCount, VertexFormat::Float16x2, [](const float* uv, std::byte* out) {
+                        const uint16_t half[2] = {FloatToHalf(uv[0]), FloatToHalf(uv[1])};
+                        std::memcpy(out, half, sizeof(half));
+                    });
+                }
+                break;
+            case VertexSemantic::Color:
+                if (options.colors && (stream.format == VertexFormat::Float32x3 ||
+                                       stream.format == VertexFormat::Float32x4)) {
+                    Reencode(stream, mesh.vertexCount, VertexFormat::Unorm8x4, [](const float* c, std::byte* out) {
+                        for (int i = 0; i < 4; i++) {
+                            out[i] = static_cast<std::byte>(ToUnorm(c[i], 255));
+                        }
+                    });
+                }
+                break;
+            case VertexSemantic::Tangent:
+                if (options.tangents && stream.format == VertexFormat::Float32x4) {
+                    // A2B10G10R10: x in the low bits, handedness in the top two
+                    Reencode(stream, mesh.vertexCount, VertexFormat::Unorm10x3_2, [](const float* t, std::byte* out) {
+                        float length = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+                        float scale = length > 0.0f ? 0.5f / length : 0.0f;
+                        uint32_t packed = ToUnorm(t[0] * scale + 0.5f, 1023) | ToUnorm(t[1] * scale + 0.5f, 1023) << 10 |
+                                          ToUnorm(t[2] * scale + 0.5f, 1023) << 20 | (t[3] < 0.0f ? 0u : 3u) << 30;
+                        std::memcpy(out, &packed, sizeof(packed));
+                    });
+                }
+                break;
+        }
+    }
+}
+
+} // namespace VulkanApp::Assets
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "MeshFile.h"
+
+namespace VulkanApp::Assets {
+
+// Import-time mesh optimization, run by MeshConverter before writing a
+// .vkmesh (and usable on any MeshData):
+//   1. OptimizeVertexCache: reorders each submesh's triangles for the
+//      post-transform vertex cache (Forsyth's linear-speed algorithm)
+//   2. OptimizeOverdraw: splits that order into clusters where it costs little
+//      cache efficiency and sorts them front-facing-outward first (Sander et
+//      al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw")
+//   3. OptimizeVertexFetch: renumbers vertices in order of first use, so the
+//      vertex streams are read front to back
+//   4. QuantizeMesh: narrows the vertex formats (see QuantizeOptions)
+// AnalyzeMesh simulates the caches, so every step can be checked on the CPU.
+
+struct MeshCacheStats {
+    // Average cache miss ratio: post-transform cache misses per triangle
+    // (0.5 is ideal for a regular grid, 3 is no reuse)
+    float acmr = 0.0f;
+    // Average transform to vertex ratio: misses per referenced vertex (1 is ideal)
+    float atvr = 0.0f;
+    // Bytes fetched from memory per byte of referenced vertex data, over every
+    // stream (1 is ideal)
+    float overfetch = 0.0f;
+};
+
+struct QuantizeOptions {
+    bool positions = true;    // Float32x3 -> Float16x4 (w = 1); exact to ~1/2048 of the magnitude
+    bool normals = true;      // Float32x3 -> Octahedral16x2
+    bool tangents = true;     // Float32x4 -> Unorm10x3_2 (w = handedness)
+    bool texCoords = true;    // Float32x2 -> Float16x2 (wrapping UVs keep working)
+    bool colors = true;       // Float32x4 -> Unorm8x4
+};
+
+// Post-transform cache simulated by AnalyzeMesh: FIFO, as on most GPUs
+constexpr uint32_t ANALYZE_CACHE_SIZE = 16;
+
+MeshCacheStats AnalyzeMesh(const MeshData& mesh);
+// Cache misses of an index list with a FIFO cache of cacheSize entries
+MeshCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount,
+                                  uint32_t cacheSize = ANALYZE_CACHE_SIZE);
+
+// Index-list steps; both keep every triangle and its winding
+void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount);
+// Run after OptimizeVertexCache. positions: vertexCount Float32x3 positions.
+// A cluster ends where the cache starts over, or where its ACMR so far is
+// within threshold of the whole run's, so 1.05 gives up at most ~5% of cache
+// efficiency for sorting freedom.
+void OptimizeOverdraw(std::span<uint32_t> indices, const float* positions, uint32_t vertexCount,
+                      float threshold = 1.05f);
+// Renumbers vertices by first use in the index buffer and drops unreferenced
+// ones; every stream is permuted. Clears submesh vertex offsets.
+void OptimizeVertexFetch(MeshData& mesh);
+
+// Steps 1-3 on every submesh. Needs a Float32x3 position stream.
+void OptimizeMesh(MeshData& mesh, float overdrawThreshold = 1.05f);
+
+// Re-encodes the selected streams; streams already quantized are left alone
+void QuantizeMesh(MeshData& mesh, const QuantizeOptions& options = {});
+
+// Normal encoding used by QuantizeMesh, and its decoder (also in
+// shaders/mesh_decode.glsl) to measure the error
+void EncodeOctahedral(const float normal[3], int16_t out[2]);
+void DecodeOctahedral(const int16_t encoded[2], float out[3]);
+
+} // namespace VulkanApp::Assets
@@ -0,0 +1,245 @@
+#include "ObjParser.h"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/MappedFile.h"
+
+namespace VulkanApp::Assets {
+
+namespace {
+struct VertexKey {
+    int32_t position;
+    int32_t texCoord; // -1 when absent
+    int32_t normal;   // -1 when absent
+
+    bool operator==(const VertexKey&) const = default;
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const
+    {
+        uint64_t hash = uint32_t(key.position);
+        hash = hash * 0x9E3779B97F4A7C15ull ^ uint32_t(key.texCoord);
+        hash = hash * 0x9E3779B97F4A7C15ull ^ uint32_t(key.normal);
+        return static_cast<size_t>(hash ^ (hash >> 29));
+    }
+};
+
+class LineReader {
+public:
+    LineReader(std::string_view line, size_t lineNumber)
+        : _rest(line), _lineNumber(lineNumber)
+    {
+    }
+
+    // Next whitespace-separated token, empty at the end of the line
+    std::string_view Token()
+    {
+        size_t start = _rest.find_first_not_of(" \t\r");
+        if (start == std::string_view::npos) {
+            _rest = {};
+            return {};
+        }
+        size_t end = _rest.find_first_of(" \t\r", start);
+        std::string_view token = _rest.substr(start, end - start);
+        _rest = end == std::string_view::npos ? std::string_view{} : _rest.substr(end);
+        return token;
+    }
+
+    float Float()
+    {
+        std::string_view token = Token();
+        float value = 0.0f;
+        auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (token.empty() || error != std::errc() || end != token.data() + token.size()) {
+            Fail("expected a number");
+        }
+        return value;
+    }
+
+    [[noreturn]] void Fail(const char* what) const
+    {
+        throw std::runtime_error("Error: OBJ line " + std::to_string(_lineNumber) + ": " + what + "!");
+    }
+
+private:
+    std::string_view _rest;
+    size_t _lineNumber;
+};
+
+// Resolves one 1-based (or negative, relative) OBJ index against count
+// elements read so far; an empty field is absent (-1)
+int32_t ResolveIndex(std::string_view field, size_t count, const LineReader& reader)
+{
+    if (field.empty()) {
+        return -1;
+    }
+    int64_t index = 0;
+    auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), index);
+    if (error != std::errc() || end != field.data() + field.size() || index == 0) {
+        reader.Fail("bad face index");
+    }
+    int64_t resolved = index > 0 ? index - 1 : int64_t(count) + index;
+    if (resolved < 0 || resolved >= int64_t(count)) {
+        reader.Fail("face index out of range");
+    }
+    return static_cast<int32_t>(resolved);
+}
+
+template <typename T>
+void Append(std::vector<std::byte>& data, const T* values, size_t count)
+{
+    size_t offset = data.size();
+    data.resize(offset + sizeof(T) * count);
+    std::memcpy(data.data() + offset, values, sizeof(T) * count);
+}
+} // namespace
+
+MeshData ParseObj(std::string_view text)
+{
+    std::vector<float> positions;
+    std::vector<float> texCoords;
+    std::vector<float> normals;
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertexLookup;
+    std::vector<VertexKey> vertices;
+    std::vector<std::string> materials;
+    uint32_t currentMaterial = 0;
+    bool anyTexCoord = false;
+    bool anyNormal = false;
+
+    MeshData mesh;
+    auto startSubmesh = [&]() {
+        // Reuse an empty trailing submesh rather than leaving it behind
+        if (mesh.submeshes.empty() || mesh.submeshes.back().indexCount != 0) {
+            mesh.submeshes.push_back({});
+        }
+        mesh.submeshes.back().firstIndex = static_cast<uint32_t>(mesh.indices.size());
+        mesh.submeshes.back().materialIndex = currentMaterial;
+    };
+    startSubmesh();
+
+    std::vector<uint32_t> polygon;
+    size_t lineNumber = 0;
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(position, end - position);
+        position = end + 1;
+        lineNumber++;
+        if (size_t comment = line.find('#'); comment != std::string_view::npos) {
+            line = line.substr(0, comment);
+        }
+
+        LineReader reader(line, lineNumber);
+        std::string_view keyword = reader.Token();
+        if (keyword == "v") {
+            for (int c = 0; c < 3; c++) {
+                positions.push_back(reader.Float());
+            }
+        } else if (keyword == "vt") {
+            float u = reader.Float();
+            float v = reader.Float();
+            texCoords.push_back(u);
+            texCoords.push_back(1.0f - v);
+        } else if (keyword == "vn") {
+            for (int c = 0; c < 3; c++) {
+                normals.push_back(reader.Float());
+            }
+        } else if (keyword == "f") {
+            polygon.clear();
+            for (std::string_view corner = reader.Token(); !corner.empty(); corner = reader.Token()) {
+                size_t slash1 = corner.find('/');
+                size_t slash2 = slash1 == std::string_view::npos ? slash1 : corner.find('/', slash1 + 1);
+                VertexKey key;
+                key.position = ResolveIndex(corner.substr(0, slash1), positions.size() / 3, reader);
+                key.texCoord = slash1 == std::string_view::npos
+                                   ? -1
+                                   : ResolveIndex(corner.substr(slash1 + 1, slash2 - slash1 - 1), texCoords.size() / 2,
+                                                  reader);
+                key.normal = slash2 == std::string_view::npos
+                                 ? -1
+                                 : ResolveIndex(corner.substr(slash2 + 1), normals.size() / 3, reader);
+                if (key.position < 0) {
+                    reader.Fail("face corner without a position");
+                }
+                anyTexCoord |= key.texCoord >= 0;
+                anyNormal |= key.normal >= 0;
+
+                auto [it, inserted] = vertexLookup.try_emplace(key, static_cast<uint32_t>(vertices.size()));
+                if (inserted) {
+                    vertices.push_back(key);
+                }
+                polygon.push_back(it->second);
+            }
+            if (polygon.size() < 3) {
+                reader.Fail("face with fewer than 3 corners");
+            }
+            for (size_t i = 1; i + 1 < polygon.size(); i++) {
+                mesh.indices.insert(mesh.indices.end(), {polygon[0], polygon[i], polygon[i + 1]});
+            }
+            mesh.submeshes.back().indexCount =
+                static_cast<uint32_t>(mesh.indices.size()) - mesh.submeshes.back().firstIndex;
+        } else if (keyword == "usemtl") {
+            std::string name(reader.Token());
+            size_t index = 0;
+            while (index < materials.size() && materials[index] != name) {
+                index++;
+            }
+            if (index == materials.size()) {
+                materials.push_back(name);
+            }
+            currentMaterial = static_cast<uint32_t>(index);
+            startSubmesh();
+        } else if (keyword == "o" || keyword == "g") {
+            startSubmesh();
+        }
+    }
+    if (mesh.submeshes.back().indexCount == 0) {
+        mesh.submeshes.pop_back();
+    }
+    if (vertices.empty()) {
+        throw std::runtime_error("Error: OBJ has no faces!");
+    }
+
+    // Unpack the deduplicated vertices into one stream per attribute
+    mesh.vertexCount = static_cast<uint32_t>(vertices.size());
+    MeshData::Stream positionStream{VertexSemantic::Position, VertexFormat::Float32x3, {}};
+    MeshData::Stream normalStream{VertexSemantic::Normal, VertexFormat::Float32x3, {}};
+    MeshData::Stream texCoordStream{VertexSemantic::TexCoord0, VertexFormat::Float32x2, {}};
+    positionStream.data.reserve(vertices.size() * 12);
+    for (const VertexKey& vertex : vertices) {
+        Append(positionStream.data, &positions[size_t(vertex.position) * 3], 3);
+        if (anyNormal) {
+            const float zero[3] = {0.0f, 0.0f, 0.0f};
+            Append(normalStream.data, vertex.normal >= 0 ? &normals[size_t(vertex.normal) * 3] : zero, 3);
+        }
+        if (anyTexCoord) {
+            const float zero[2] = {0.0f, 0.0f};
+            Append(texCoordStream.data, vertex.texCoord >= 0 ? &texCoords[size_t(vertex.texCoord) * 2] : zero, 2);
+        }
+    }
+    mesh.streams.push_back(std::move(positionStream));
+    if (anyNormal) {
+        mesh.streams.push_back(std::move(normalStream));
+    }
+    if (anyTexCoord) {
+        mesh.streams.push_back(std::move(texCoordStream));
+    }
+    return mesh;
+}
+
+MeshData LoadObj(const std::string& path)
+{
+    MappedFile file(path);
+    std::span<const std::byte> bytes = file.GetBytes();
+    return ParseObj({reinterpret_cast<const char*>(bytes.data()), bytes.size()});
+}
+
+} // namespace VulkanApp::Assets
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "MeshFile.h"
+
+namespace VulkanApp::Assets {
+
+// Wavefront OBJ importer producing MeshData for WriteMeshFile. Handles v, vt,
+// vn and f (polygons are fan-triangulated, negative indices are relative);
+// every distinct v/vt/vn triple becomes one vertex. A new submesh starts at
+// each o, g or usemtl that is followed by faces. Other statements (mtllib, s,
+// l, p, ...) are ignored. The texcoord V axis is flipped to Vulkan's top-left
+// origin. Throws std::runtime_error naming the line on malformed input.
+MeshData ParseObj(std::string_view text);
+
+// Maps and parses an OBJ file
+MeshData LoadObj(const std::string& path);
+
+} // namespace VulkanApp::Assets
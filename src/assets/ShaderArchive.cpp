@@ -0,0 +1,275 @@
+#include "ShaderArchive.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace VulkanApp::Assets {
+
+static_assert(std::endian::native == std::endian::little, ".vkshaders archives are little-endian and read in place");
+
+namespace {
+uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// offset + size lies within fileSize, without overflowing
+bool InFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+// The enum fields hold values the reader casts without a check
+bool IsShaderStage(uint32_t stage)
+{
+    switch (static_cast<ShaderStage>(stage)) {
+        case ShaderStage::Vertex:
+        case ShaderStage::TessellationControl:
+        case ShaderStage::TessellationEvaluation:
+        case ShaderStage::Geometry:
+        case ShaderStage::Fragment:
+        case ShaderStage::Compute:
+            return true;
+    }
+    return false;
+}
+
+bool IsDescriptorType(uint32_t type)
+{
+    return type <= static_cast<uint32_t>(DescriptorType::StorageBuffer);
+}
+
+void Fail(const std::string& name, const std::string& what)
+{
+    throw std::runtime_error("Error: " + name + " is not a valid .vkshaders archive: " + what + "!");
+}
+
+// The fixed-size name fields are nul-terminated within their array
+std::string_view FieldString(const char* field, size_t size)
+{
+    return {field, strnlen(field, size)};
+}
+
+void CopyField(char* field, size_t size, const std::string& value, const char* what)
+{
+    if (value.size() >= size) {
+        throw std::runtime_error(std::string("Error: shader ") + what + " '" + value + "' is longer than " +
+                                 std::to_string(size - 1) + " characters!");
+    }
+    std::memcpy(field, value.data(), value.size());
+}
+} // namespace
+
+// FNV-1a over whole words rather than bytes: SPIR-V is a word stream, and
+// this is four times faster with the same sensitivity to a changed word
+uint64_t HashShaderCode(std::span<const uint32_t> code)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (uint32_t word : code) {
+        hash = (hash ^ word) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// --- Writing ---
+
+std::vector<std::byte> BuildShaderArchive(std::vector<ShaderSource> shaders)
+{
+    std::sort(shaders.begin(), shaders.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+    for (size_t i = 1; i < shaders.size(); i++) {
+        if (shaders[i].name == shaders[i - 1].name) {
+            throw std::runtime_error("Error: shader '" + shaders[i].name + "' is packed twice!");
+        }
+    }
+
+    ShaderArchiveHeader header{};
+    std::memcpy(header.magic, SHADER_ARCHIVE_MAGIC, sizeof(header.magic));
+    header.version = SHADER_ARCHIVE_VERSION;
+    header.headerSize = sizeof(ShaderArchiveHeader);
+    header.shaderCount = static_cast<uint32_t>(shaders.size());
+
+    std::vector<ShaderArchiveEntry> entries(shaders.size());
+    std::vector<ShaderArchiveBinding> bindings;
+    for (size_t i = 0; i < shaders.size(); i++) {
+        const ShaderReflection reflection = ReflectSpirv(shaders[i].code);
+        ShaderArchiveEntry& entry = entries[i];
+        CopyField(entry.name, sizeof(entry.name), shaders[i].name, "name");
+        CopyField(entry.entryPoint, sizeof(entry.entryPoint), reflection.entryPoint, "entry point");
+        entry.codeHash = HashShaderCode(shaders[i].code);
+        entry.codeSize = shaders[i].code.size() * sizeof(uint32_t);
+        entry.stage = static_cast<uint32_t>(reflection.stage);
+        entry.firstBinding = static_cast<uint32_t>(bindings.size());
+        entry.bindingCount = static_cast<uint32_t>(reflection.bindings.size());
+        entry.pushConstantSize = reflection.pushConstantSize;
+        std::copy_n(reflection.localSize, 3, entry.localSize);
+        for (const ShaderBinding& binding : reflection.bindings) {
+            bindings.push_back({binding.set, binding.binding, static_cast<uint32_t>(binding.type), binding.count});
+        }
+    }
+    header.bindingCount = static_cast<uint32_t>(bindings.size());
+
+    uint64_t offset = sizeof(ShaderArchiveHeader);
+    header.shaderTableOffset = offset;
+    offset += sizeof(ShaderArchiveEntry) * entries.size();
+    header.bindingTableOffset = offset;
+    offset += sizeof(ShaderArchiveBinding) * bindings.size();
+    for (ShaderArchiveEntry& entry : entries) {
+        entry.codeOffset = AlignUp(offset, SHADER_CODE_ALIGNMENT);
+        offset = entry.codeOffset + entry.codeSize;
+    }
+    header.fileSize = AlignUp(offset, SHADER_CODE_ALIGNMENT);
+
+    std::vector<std::byte> archive(header.fileSize); // Zero-filled, so padding needs no writes
+    std::memcpy(archive.data(), &header, sizeof(header));
+    std::memcpy(archive.data() + header.shaderTableOffset, entries.data(), sizeof(ShaderArchiveEntry) * entries.size());
+    std::memcpy(archive.data() + header.bindingTableOffset, bindings.data(),
+                sizeof(ShaderArchiveBinding) * bindings.size());
+    for (size_t i = 0; i < shaders.size(); i++) {
+        std::memcpy(archive.data() + entries[i].codeOffset, shaders[i].code.data(), entries[i].codeSize);
+    }
+    return archive;
+}
+
+void WriteShaderArchive(std::span<const std::byte> archive, const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+    file.write(reinterpret_cast<const char*>(archive.data()), static_cast<std::streamsize>(archive.size()));
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
+
+// --- Reading ---
+
+ShaderArchive::ShaderArchive(const std::string& path)
+    : ShaderArchive(MappedFile(path))
+{
+}
+
+ShaderArchive::ShaderArchive(MappedFile file)
+    : _file(std::move(file)),
+      _name(_file.GetPath()),
+      _bytes(_file.GetBytes())
+{
+    Validate();
+}
+
+ShaderArchive::ShaderArchive(std::span<const std::byte> bytes, std::string name)
+    : _name(std::move(name)),
+      _bytes(bytes)
+{
+    Validate();
+}
+
+// As with .vkmesh, every offset, size and count is checked before anything is
+// read through it. Hashing the code as well costs about 0.4 ms per megabyte
+// and catches a stale or corrupted archive at startup rather than in the driver.
+void ShaderArchive::Validate()
+{
+    const uint64_t fileSize = _bytes.size();
+    if (fileSize < sizeof(ShaderArchiveHeader)) {
+        Fail(_name, "shorter than the header");
+    }
+    if (reinterpret_cast<uintptr_t>(_bytes.data()) % alignof(ShaderArchiveEntry) != 0) {
+        Fail(_name, "misaligned in memory");
+    }
+    _header = reinterpret_cast<const ShaderArchiveHeader*>(_bytes.data());
+    const ShaderArchiveHeader& header = *_header;
+    if (std::memcmp(header.magic, SHADER_ARCHIVE_MAGIC, sizeof(header.magic)) != 0) {
+        Fail(_name, "bad magic");
+    }
+    if (header.version != SHADER_ARCHIVE_VERSION) {
+        Fail(_name, "version " + std::to_string(header.version) + ", expected " +
+                        std::to_string(SHADER_ARCHIVE_VERSION));
+    }
+    if (header.headerSize != sizeof(ShaderArchiveHeader) || header.fileSize != fileSize) {
+        Fail(_name, "header or file size mismatch (truncated?)");
+    }
+
+    const uint64_t shaderTableSize = uint64_t(header.shaderCount) * sizeof(ShaderArchiveEntry);
+    const uint64_t bindingTableSize = uint64_t(header.bindingCount) * sizeof(ShaderArchiveBinding);
+    if (!InFile(header.shaderTableOffset, shaderTableSize, fileSize) || header.shaderTableOffset % 8 != 0 ||
+        !InFile(header.bindingTableOffset, bindingTableSize, fileSize) || header.bindingTableOffset % 4 != 0) {
+        Fail(_name, "tables out of bounds");
+    }
+    _shaders = {reinterpret_cast<const ShaderArchiveEntry*>(_bytes.data() + header.shaderTableOffset),
+                header.shaderCount};
+    _bindings = {reinterpret_cast<const ShaderArchiveBinding*>(_bytes.data() + header.bindingTableOffset),
+                 header.bindingCount};
+
+    for (size_t i = 0; i < _shaders.size(); i++) {
+        const ShaderArchiveEntry& shader = _shaders[i];
+        const std::string_view name = FieldString(shader.name, sizeof(shader.name));
+        if (name.empty() || name.size() == sizeof(shader.name) ||
+            FieldString(shader.entryPoint, sizeof(shader.entryPoint)).size() == sizeof(shader.entryPoint)) {
+            Fail(_name, "unterminated shader name");
+        }
+        if (i > 0 && FieldString(_shaders[i - 1].name, sizeof(shader.name)) >= name) {
+            Fail(_name, "shader table not sorted by name");
+        }
+        if (!InFile(shader.codeOffset, shader.codeSize, fileSize) || shader.codeOffset % SHADER_CODE_ALIGNMENT != 0 ||
+            shader.codeSize == 0 || shader.codeSize % sizeof(uint32_t) != 0) {
+            Fail(_name, std::string(name) + " code out of bounds");
+        }
+        if (uint64_t(shader.firstBinding) + shader.bindingCount > header.bindingCount) {
+            Fail(_name, std::string(name) + " bindings out of bounds");
+        }
+        if (!IsShaderStage(shader.stage)) {
+            Fail(_name, std::string(name) + " has unknown stage " + std::to_string(shader.stage));
+        }
+        for (const ShaderArchiveBinding& binding : GetBindings(shader)) {
+            if (!IsDescriptorType(binding.descriptorType)) {
+                Fail(_name, std::string(name) + " has unknown descriptor type " +
+                                std::to_string(binding.descriptorType));
+            }
+        }
+        if (HashShaderCode(GetCode(shader)) != shader.codeHash) {
+            Fail(_name, std::string(name) + " code hash mismatch");
+        }
+    }
+}
+
+const ShaderArchiveEntry* ShaderArchive::Find(std::string_view name) const
+{
+    auto it = std::lower_bound(_shaders.begin(), _shaders.end(), name, [](const ShaderArchiveEntry& shader, auto key) {
+        return FieldString(shader.name, sizeof(shader.name)) < key;
+    });
+    if (it == _shaders.end() || FieldString(it->name, sizeof(it->name)) != name) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+std::span<const uint32_t> ShaderArchive::GetCode(const ShaderArchiveEntry& shader) const
+{
+    return {reinterpret_cast<const uint32_t*>(_bytes.data() + shader.codeOffset), shader.codeSize / sizeof(uint32_t)};
+}
+
+std::span<const ShaderArchiveBinding> ShaderArchive::GetBindings(const ShaderArchiveEntry& shader) const
+{
+    return _bindings.subspan(shader.firstBinding, shader.bindingCount);
+}
+
+ShaderReflection ShaderArchive::GetReflection(const ShaderArchiveEntry& shader) const
+{
+    ShaderReflection reflection;
+    reflection.stage = static_cast<ShaderStage>(shader.stage);
+    reflection.entryPoint = FieldString(shader.entryPoint, sizeof(shader.entryPoint));
+    for (const ShaderArchiveBinding& binding : GetBindings(shader)) {
+        reflection.bindings.push_back(
+            {binding.set, binding.binding, static_cast<DescriptorType>(binding.descriptorType), binding.count});
+    }
+    reflection.pushConstantSize = shader.pushConstantSize;
+    std::copy_n(shader.localSize, 3, reflection.localSize);
+    return reflection;
+}
+
+} // namespace VulkanApp::Assets
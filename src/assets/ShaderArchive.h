@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../core/MappedFile.h"
+#include "SpirvReflection.h"
+
+namespace VulkanApp::Assets {
+
+// .vkshaders: every compiled shader of the application in one indexed blob,
+// built by ShaderPacker at build time and embedded into the executable (or
+// memory-mapped). Little-endian:
+//   ShaderArchiveHeader
+//   ShaderArchiveEntry[shaderCount], sorted by name for binary search
+//   ShaderArchiveBinding[bindingCount], each shader's bindings in one run
+//   SPIR-V code, one section per shader on a SHADER_CODE_ALIGNMENT boundary
+// Entries carry the reflection the pipeline layouts are derived from and an
+// FNV-1a hash of their code, which readers verify.
+// Bump SHADER_ARCHIVE_VERSION on any layout change.
+constexpr char SHADER_ARCHIVE_MAGIC[8] = {'V', 'K', 'S', 'H', 'A', 'D', 'E', 'R'};
+constexpr uint32_t SHADER_ARCHIVE_VERSION = 1;
+constexpr uint64_t SHADER_CODE_ALIGNMENT = 16;
+constexpr size_t SHADER_NAME_SIZE = 64;        // Including the terminating nul
+constexpr size_t SHADER_ENTRY_POINT_SIZE = 32; // Including the terminating nul
+
+struct ShaderArchiveHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize; // sizeof(ShaderArchiveHeader)
+    uint64_t fileSize;
+    uint32_t shaderCount;
+    uint32_t bindingCount;
+    uint64_t shaderTableOffset;
+    uint64_t bindingTableOffset;
+};
+static_assert(sizeof(ShaderArchiveHeader) == 48, "ShaderArchiveHeader is part of the file format");
+
+struct ShaderArchiveEntry {
+    char name[SHADER_NAME_SIZE];              // Source file name, e.g. "shader.vert"
+    char entryPoint[SHADER_ENTRY_POINT_SIZE];
+    uint64_t codeHash; // HashShaderCode of the code section
+    uint64_t codeOffset;
+    uint64_t codeSize; // Bytes, a multiple of 4
+    uint32_t stage;    // ShaderStage
+    uint32_t firstBinding;
+    uint32_t bindingCount;
+    uint32_t pushConstantSize;
+    uint32_t localSize[3];
+    uint32_t reserved;
+};
+static_assert(sizeof(ShaderArchiveEntry) == 152, "ShaderArchiveEntry is part of the file format");
+
+struct ShaderArchiveBinding {
+    uint32_t set;
+    uint32_t binding;
+    uint32_t descriptorType; // DescriptorType
+    uint32_t count;          // 0 = runtime-sized array
+};
+static_assert(sizeof(ShaderArchiveBinding) == 16, "ShaderArchiveBinding is part of the file format");
+
+// FNV-1a 64 over the code's words
+uint64_t HashShaderCode(std::span<const uint32_t> code);
+
+// One compiled module, as handed to BuildShaderArchive
+struct ShaderSource {
+    std::string name;
+    std::vector<uint32_t> code;
+};
+
+// Reflects every shader and lays out the archive. Throws std::runtime_error on
+// duplicate or over-long names and on code ReflectSpirv rejects.
+std::vector<std::byte> BuildShaderArchive(std::vector<ShaderSource> shaders);
+void WriteShaderArchive(std::span<const std::byte> archive, const std::string& path);
+
+// A validated .vkshaders, read in place from a mapping or from bytes embedded in
+// the executable. Code and tables are views into those bytes. Moveable, not copyable.
+class ShaderArchive {
+public:
+    // Validates the archive, including every code hash and enum field; throws
+    // std::runtime_error if it is not a well-formed .vkshaders of this version
+    explicit ShaderArchive(const std::string& path);
+    explicit ShaderArchive(MappedFile file);
+    // bytes must outlive the archive; name is used in error messages
+    ShaderArchive(std::span<const std::byte> bytes, std::string name);
+
+    ShaderArchive(ShaderArchive&&) noexcept = default;
+    ShaderArchive& operator=(ShaderArchive&&) noexcept = default;
+
+    std::span<const ShaderArchiveEntry> GetShaders() const { return _shaders; }
+    // nullptr if the archive holds no shader of that name
+    const ShaderArchiveEntry* Find(std::string_view name) const;
+
+    std::span<const uint32_t> GetCode(const ShaderArchiveEntry& shader) const;
+    std::span<const ShaderArchiveBinding> GetBindings(const ShaderArchiveEntry& shader) const;
+    ShaderReflection GetReflection(const ShaderArchiveEntry& shader) const;
+
+    const std::string& GetName() const { return _name; }
+    size_t GetSize() const { return _bytes.size(); }
+
+private:
+    void Validate();
+
+    MappedFile _file; // Not open for embedded archives
+    std::string _name;
+    std::span<const std::byte> _bytes;
+    const ShaderArchiveHeader* _header = nullptr;
+    std::span<const ShaderArchiveEntry> _shaders;
+    std::span<const ShaderArchiveBinding> _bindings;
+};
+
+} // namespace VulkanApp::Assets
@@ -0,0 +1,420 @@
+#include "SpirvReflection.h"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace VulkanApp::Assets {
+
+namespace {
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+constexpr size_t SPIRV_HEADER_WORDS = 5;
+
+// The subset of the SPIR-V grammar reflection reads
+enum Op : uint32_t {
+    OpEntryPoint = 15,
+    OpExecutionMode = 16,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+};
+
+enum Decoration : uint32_t {
+    DecorationBlock = 2,
+    DecorationBufferBlock = 3,
+    DecorationRowMajor = 4,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35,
+};
+
+enum StorageClass : uint32_t {
+    StorageClassUniformConstant = 0,
+    StorageClassUniform = 2,
+    StorageClassPushConstant = 9,
+    StorageClassStorageBuffer = 12,
+};
+
+constexpr uint32_t EXECUTION_MODE_LOCAL_SIZE = 17;
+constexpr uint32_t MAX_TYPE_DEPTH = 64; // Nesting of structs, arrays and vectors; deeper is a cycle
+constexpr uint32_t DIM_BUFFER = 5;
+
+struct Member {
+    uint32_t offset = 0;
+    uint32_t matrixStride = 0;
+    bool rowMajor = false;
+};
+
+// Everything reflection needs about an id, filled in one pass over the module
+struct Id {
+    uint32_t opcode = 0;
+    std::vector<uint32_t> operands; // The instruction's words after the result id
+    uint32_t set = UINT32_MAX;
+    uint32_t binding = UINT32_MAX;
+    uint32_t arrayStride = 0;
+    bool block = false;
+    bool bufferBlock = false;
+    std::map<uint32_t, Member> members; // By member index, as decorated
+};
+
+[[noreturn]] void Fail(const std::string& what)
+{
+    throw std::runtime_error("Error: SPIR-V reflection failed: " + what + "!");
+}
+
+class Reflector {
+public:
+    explicit Reflector(std::span<const uint32_t> code)
+    {
+        if (code.size() < SPIRV_HEADER_WORDS || code[0] != SPIRV_MAGIC) {
+            Fail("not a SPIR-V module");
+        }
+        // The id bound sizes the id table, so it is checked before allocating:
+        // every id is defined by an instruction, which takes at least one word
+        if (code[3] > code.size()) {
+            Fail("id bound " + std::to_string(code[3]) + " exceeds the module's " + std::to_string(code.size()) +
+                 " words");
+        }
+        _ids.resize(code[3]);
+        _wordCount = code.size();
+        for (size_t word = SPIRV_HEADER_WORDS; word < code.size();) {
+            const uint32_t wordCount = code[word] >> 16;
+            if (wordCount == 0 || word + wordCount > code.size()) {
+                Fail("truncated instruction");
+            }
+            Parse(code[word] & 0xFFFF, code.subspan(word + 1, wordCount - 1));
+            word += wordCount;
+        }
+    }
+
+    ShaderReflection Reflect() const
+    {
+        if (!_hasEntryPoint) {
+            Fail("no entry point");
+        }
+        ShaderReflection reflection = _reflection;
+        for (uint32_t variable : _variables) {
+            const Id& id = _ids[variable];
+            const uint32_t storageClass = id.operands[2];
+            const Id& pointer = Get(id.operands[0]);
+            if (pointer.opcode != OpTypePointer) {
+                Fail("variable " + std::to_string(variable) + " does not have a pointer type");
+            }
+            const uint32_t pointee = pointer.operands[1];
+            if (storageClass == StorageClassPushConstant) {
+                reflection.pushConstantSize = std::max(reflection.pushConstantSize, SizeOf(pointee, nullptr));
+                continue;
+            }
+            if (id.set == UINT32_MAX || id.binding == UINT32_MAX) {
+                continue; // Stage inputs and outputs, builtins
+            }
+            reflection.bindings.push_back(Describe(id, storageClass, pointee));
+        }
+        std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const auto& a, const auto& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+        return reflection;
+    }
+
+private:
+    void Parse(uint32_t opcode, std::span<const uint32_t> operands)
+    {
+        auto need = [&](size_t count) {
+            if (operands.size() < count) {
+                Fail("instruction " + std::to_string(opcode) + " is too short");
+            }
+        };
+        switch (opcode) {
+            case OpEntryPoint:
+                need(3);
+                if (!_hasEntryPoint) {
+                    _hasEntryPoint = true;
+                    _entryPoint = operands[1];
+                    _reflection.stage = ToStage(operands[0]);
+                    _reflection.entryPoint = ReadString(operands.subspan(2));
+                }
+                return;
+            case OpExecutionMode:
+                need(2);
+                if (operands[0] == _entryPoint && operands[1] == EXECUTION_MODE_LOCAL_SIZE) {
+                    need(5);
+                    std::copy_n(operands.begin() + 2, 3, _reflection.localSize);
+                }
+                return;
+            case OpDecorate: {
+                need(2);
+                Id& target = Get(operands[0]);
+                const uint32_t literal = operands.size() > 2 ? operands[2] : 0;
+                switch (operands[1]) {
+                    case DecorationBlock: target.block = true; break;
+                    case DecorationBufferBlock: target.bufferBlock = true; break;
+                    case DecorationArrayStride: target.arrayStride = literal; break;
+                    case DecorationBinding: target.binding = literal; break;
+                    case DecorationDescriptorSet: target.set = literal; break;
+                }
+                return;
+            }
+            case OpMemberDecorate: {
+                need(3);
+                Id& target = Get(operands[0]);
+                // Every member is an operand of the struct, so no index reaches the word count
+                if (operands[1] >= _wordCount) {
+                    Fail("member " + std::to_string(operands[1]) + " of id " + std::to_string(operands[0]) +
+                         " out of bounds");
+                }
+                Member& member = target.members[operands[1]];
+                const uint32_t literal = operands.size() > 3 ? operands[3] : 0;
+                switch (operands[2]) {
+                    case DecorationOffset: member.offset = literal; break;
+                    case DecorationMatrixStride: member.matrixStride = literal; break;
+                    case DecorationRowMajor: member.rowMajor = true; break;
+                }
+                return;
+            }
+            case OpTypeInt:
+            case OpTypeFloat:
+            case OpTypeVector:
+            case OpTypeMatrix:
+            case OpTypeImage:
+            case OpTypeSampler:
+            case OpTypeSampledImage:
+            case OpTypeArray:
+            case OpTypeRuntimeArray:
+            case OpTypeStruct:
+            case OpTypePointer:
+                need(1 + MinTypeOperands(opcode));
+                Define(operands[0], opcode, operands.subspan(1));
+                return;
+            case OpConstant:
+            case OpVariable:
+                need(3); // Result type first, then the result id
+                Define(operands[1], opcode, operands);
+                if (opcode == OpVariable) {
+                    _variables.push_back(operands[1]);
+                }
+                return;
+        }
+    }
+
+    void Define(uint32_t result, uint32_t opcode, std::span<const uint32_t> operands)
+    {
+        Id& id = Get(result);
+        if (id.opcode != 0) {
+            Fail("id " + std::to_string(result) + " defined twice");
+        }
+        id.opcode = opcode;
+        id.operands.assign(operands.begin(), operands.end());
+    }
+
+    Id& Get(uint32_t id)
+    {
+        if (id >= _ids.size()) {
+            Fail("id " + std::to_string(id) + " out of bounds");
+        }
+        return _ids[id];
+    }
+
+    const Id& Get(uint32_t id) const
+    {
+        if (id >= _ids.size() || _ids[id].opcode == 0) {
+            Fail("id " + std::to_string(id) + " is not defined");
+        }
+        return _ids[id];
+    }
+
+    // Operands after the result id that reflection reads from a type instruction
+    static size_t MinTypeOperands(uint32_t opcode)
+    {
+        switch (opcode) {
+            case OpTypeInt: return 2;          // Width, signedness
+            case OpTypeFloat: return 1;        // Width
+            case OpTypeVector: return 2;       // Component type, count
+            case OpTypeMatrix: return 2;       // Column type, count
+            case OpTypeImage: return 7;        // Sampled type, Dim, Depth, Arrayed, MS, Sampled, format
+            case OpTypeSampledImage: return 1; // Image type
+            case OpTypeArray: return 2;        // Element type, length
+            case OpTypeRuntimeArray: return 1; // Element type
+            case OpTypePointer: return 2;      // Storage class, pointee
+        }
+        return 0; // OpTypeSampler, OpTypeStruct (any number of members)
+    }
+
+    static ShaderStage ToStage(uint32_t executionModel)
+    {
+        switch (executionModel) {
+            case 0: return ShaderStage::Vertex;
+            case 1: return ShaderStage::TessellationControl;
+            case 2: return ShaderStage::TessellationEvaluation;
+            case 3: return ShaderStage::Geometry;
+            case 4: return ShaderStage::Fragment;
+            case 5: return ShaderStage::Compute;
+        }
+        Fail("unsupported execution model " + std::to_string(executionModel));
+    }
+
+    // Nul-terminated UTF-8, four characters per word, little-endian
+    static std::string ReadString(std::span<const uint32_t> words)
+    {
+        std::string text;
+        for (uint32_t word : words) {
+            for (int byte = 0; byte < 4; byte++) {
+                const char c = static_cast<char>((word >> (8 * byte)) & 0xFF);
+                if (c == '\0') {
+                    return text;
+                }
+                text.push_back(c);
+            }
+        }
+        Fail("unterminated string");
+    }
+
+    uint32_t ArrayLength(const Id& array) const
+    {
+        const Id& length = Get(array.operands[1]);
+        if (length.opcode != OpConstant || length.operands.size() < 3) {
+            Fail("array length is not a constant");
+        }
+        return length.operands[2];
+    }
+
+    // Bytes the type occupies in a buffer block, following its explicit layout
+    // decorations. member supplies the matrix decorations of a struct member.
+    uint32_t SizeOf(uint32_t typeId, const Member* member, uint32_t depth = 0) const
+    {
+        if (depth > MAX_TYPE_DEPTH) {
+            Fail("type " + std::to_string(typeId) + " nests too deeply");
+        }
+        const Id& type = Get(typeId);
+        switch (type.opcode) {
+            case OpTypeInt:
+            case OpTypeFloat:
+                return type.operands[0] / 8;
+            case OpTypeVector:
+                return SizeOf(type.operands[0], nullptr, depth + 1) * type.operands[1];
+            case OpTypeMatrix: {
+                if (member == nullptr || member->matrixStride == 0) {
+                    Fail("matrix without a MatrixStride");
+                }
+                const uint32_t columns = type.operands[1];
+                const Id& column = Get(type.operands[0]);
+                if (column.opcode != OpTypeVector) {
+                    Fail("matrix column type " + std::to_string(type.operands[0]) + " is not a vector");
+                }
+                const uint32_t rows = column.operands[1];
+                return member->matrixStride * (member->rowMajor ? rows : columns);
+            }
+            case OpTypeArray:
+                if (type.arrayStride == 0) {
+                    Fail("array without an ArrayStride");
+                }
+                return type.arrayStride * ArrayLength(type);
+            case OpTypeStruct: {
+                uint32_t size = 0;
+                for (size_t i = 0; i < type.operands.size(); i++) {
+                    const auto decorated = type.members.find(static_cast<uint32_t>(i));
+                    const Member* layout = decorated != type.members.end() ? &decorated->second : nullptr;
+                    const uint32_t offset = layout ? layout->offset : 0;
+                    size = std::max(size, offset + SizeOf(type.operands[i], layout, depth + 1));
+                }
+                return size;
+            }
+        }
+        Fail("type " + std::to_string(typeId) + " has no size in a buffer block");
+    }
+
+    ShaderBinding Describe(const Id& variable, uint32_t storageClass, uint32_t typeId) const
+    {
+        ShaderBinding binding{variable.set, variable.binding, DescriptorType::Sampler, 1};
+        const Id* type = &Get(typeId);
+        if (type->opcode == OpTypeArray) {
+            binding.count = ArrayLength(*type);
+            type = &Get(type->operands[0]);
+        } else if (type->opcode == OpTypeRuntimeArray) {
+            binding.count = 0;
+            type = &Get(type->operands[0]);
+        }
+
+        if (storageClass == StorageClassStorageBuffer) {
+            binding.type = DescriptorType::StorageBuffer;
+        } else if (storageClass == StorageClassUniform) {
+            // Before SPIR-V 1.3 storage buffers were Uniform + BufferBlock
+            binding.type = type->bufferBlock ? DescriptorType::StorageBuffer : DescriptorType::UniformBuffer;
+        } else if (storageClass == StorageClassUniformConstant) {
+            switch (type->opcode) {
+                case OpTypeSampler: binding.type = DescriptorType::Sampler; break;
+                case OpTypeSampledImage: binding.type = DescriptorType::CombinedImageSampler; break;
+                case OpTypeImage: {
+                    const bool buffer = type->operands[1] == DIM_BUFFER;
+                    const bool storage = type->operands[5] == 2; // Sampled = 2: read/write without a sampler
+                    binding.type = buffer ? (storage ? DescriptorType::StorageTexelBuffer : DescriptorType::UniformTexelBuffer)
+                                          : (storage ? DescriptorType::StorageImage : DescriptorType::SampledImage);
+                    break;
+                }
+                default:
+                    Fail("unsupported resource at set " + std::to_string(binding.set) + " binding " +
+                         std::to_string(binding.binding));
+            }
+        } else {
+            Fail("unsupported storage class " + std::to_string(storageClass));
+        }
+        return binding;
+    }
+
+    std::vector<Id> _ids;
+    size_t _wordCount = 0;
+    std::vector<uint32_t> _variables;
+    bool _hasEntryPoint = false;
+    uint32_t _entryPoint = 0;
+    ShaderReflection _reflection;
+};
+} // namespace
+
+const char* GetShaderStageName(ShaderStage stage)
+{
+    switch (stage) {
+        case ShaderStage::Vertex: return "vertex";
+        case ShaderStage::TessellationControl: return "tessellation control";
+        case ShaderStage::TessellationEvaluation: return "tessellation evaluation";
+        case ShaderStage::Geometry: return "geometry";
+        case ShaderStage::Fragment: return "fragment";
+        case ShaderStage::Compute: return "compute";
+    }
+    return "unknown";
+}
+
+const char* GetDescriptorTypeName(DescriptorType type)
+{
+    switch (type) {
+        case DescriptorType::Sampler: return "sampler";
+        case DescriptorType::CombinedImageSampler: return "combined image sampler";
+        case DescriptorType::SampledImage: return "sampled image";
+        case DescriptorType::StorageImage: return "storage image";
+        case DescriptorType::UniformTexelBuffer: return "uniform texel buffer";
+        case DescriptorType::StorageTexelBuffer: return "storage texel buffer";
+        case DescriptorType::UniformBuffer: return "uniform buffer";
+        case DescriptorType::StorageBuffer: return "storage buffer";
+    }
+    return "unknown";
+}
+
+ShaderReflection ReflectSpirv(std::span<const uint32_t> code)
+{
+    return Reflector(code).Reflect();
+}
+
+} // namespace VulkanApp::Assets
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace VulkanApp::Assets {
+
+// Pipeline stage of a shader; the values are VkShaderStageFlagBits, without
+// making the asset code depend on Vulkan
+enum class ShaderStage : uint32_t {
+    Vertex = 0x01,
+    TessellationControl = 0x02,
+    TessellationEvaluation = 0x04,
+    Geometry = 0x08,
+    Fragment = 0x10,
+    Compute = 0x20,
+};
+
+// Kind of resource a binding holds; the values are VkDescriptorType. Whether
+// a buffer is bound with a dynamic offset is not visible in SPIR-V.
+enum class DescriptorType : uint32_t {
+    Sampler = 0,
+    CombinedImageSampler = 1,
+    SampledImage = 2,
+    StorageImage = 3,
+    UniformTexelBuffer = 4,
+    StorageTexelBuffer = 5,
+    UniformBuffer = 6,
+    StorageBuffer = 7,
+};
+
+const char* GetShaderStageName(ShaderStage stage);
+const char* GetDescriptorTypeName(DescriptorType type);
+
+struct ShaderBinding {
+    uint32_t set;
+    uint32_t binding;
+    DescriptorType type;
+    uint32_t count; // Array size; 0 for a runtime-sized array (bindless tables)
+
+    bool operator==(const ShaderBinding& other) const = default;
+};
+
+// The resource interface of one SPIR-V module: what a pipeline layout needs
+struct ShaderReflection {
+    ShaderStage stage = ShaderStage::Vertex;
+    std::string entryPoint;
+    std::vector<ShaderBinding> bindings; // Sorted by set, then binding
+    uint32_t pushConstantSize = 0;       // Bytes of the push constant block, 0 without one
+    uint32_t localSize[3] = {1, 1, 1};   // Workgroup size of a compute shader
+};
+
+// Reads the first entry point, every descriptor-decorated variable and the push
+// constant block of a SPIR-V module. Throws std::runtime_error on malformed
+// code or resources it cannot describe (e.g. specialization-constant array sizes).
+ShaderReflection ReflectSpirv(std::span<const uint32_t> code);
+
+} // namespace VulkanApp::Assets
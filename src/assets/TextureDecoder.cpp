@@ -0,0 +1,399 @@
+#include "TextureDecoder.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace VulkanApp::Assets {
+
+namespace {
+using Texels = uint8_t[16 * 4];
+
+// --- BC1-BC5 ---
+
+uint16_t Load16(const std::byte* data)
+{
+    uint16_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t Load32(const std::byte* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t Load64(const std::byte* data)
+{
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// RGB565 to RGBA8, replicating the high bits into the low ones
+std::array<uint8_t, 4> Expand565(uint16_t color)
+{
+    uint32_t r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+    return {static_cast<uint8_t>(r << 3 | r >> 2), static_cast<uint8_t>(g << 2 | g >> 4),
+            static_cast<uint8_t>(b << 3 | b >> 2), 255};
+}
+
+// The BC1 color block, also the color half of BC2 and BC3 (which always use
+// the four-color mode). Writes RGB, and alpha only for BC1's transparent texels.
+void DecodeColorBlock(const std::byte* block, Texels texels, bool fourColorsOnly)
+{
+    const uint16_t color0 = Load16(block);
+    const uint16_t color1 = Load16(block + 2);
+    const uint32_t indices = Load32(block + 4);
+    std::array<std::array<uint8_t, 4>, 4> palette = {Expand565(color0), Expand565(color1)};
+    for (int c = 0; c < 3; c++) {
+        uint32_t a = palette[0][c], b = palette[1][c];
+        if (color0 > color1 || fourColorsOnly) {
+            palette[2][c] = static_cast<uint8_t>((2 * a + b + 1) / 3);
+            palette[3][c] = static_cast<uint8_t>((a + 2 * b + 1) / 3);
+        } else {
+            palette[2][c] = static_cast<uint8_t>((a + b + 1) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    palette[2][3] = 255;
+    palette[3][3] = color0 > color1 || fourColorsOnly ? 255 : 0; // Transparent black
+    for (int i = 0; i < 16; i++) {
+        std::memcpy(texels + i * 4, palette[(indices >> (2 * i)) & 3].data(), 4);
+    }
+}
+
+// An 8-byte BC4 block (also BC3's alpha and each BC5 channel) into one channel
+void DecodeChannelBlock(const std::byte* block, Texels texels, int channel)
+{
+    const uint32_t value0 = static_cast<uint8_t>(block[0]);
+    const uint32_t value1 = static_cast<uint8_t>(block[1]);
+    const uint64_t indices = Load64(block) >> 16;
+    uint8_t palette[8] = {static_cast<uint8_t>(value0), static_cast<uint8_t>(value1)};
+    if (value0 > value1) {
+        for (uint32_t i = 1; i < 7; i++) {
+            palette[i + 1] = static_cast<uint8_t>(((7 - i) * value0 + i * value1 + 3) / 7);
+        }
+    } else {
+        for (uint32_t i = 1; i < 5; i++) {
+            palette[i + 1] = static_cast<uint8_t>(((5 - i) * value0 + i * value1 + 2) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    for (int i = 0; i < 16; i++) {
+        texels[i * 4 + channel] = palette[(indices >> (3 * i)) & 7];
+    }
+}
+
+// --- BC7 ---
+
+// Subset of each texel, bit i (2-subset) or bits 2i..2i+1 (3-subset) per partition
+constexpr uint16_t BC7_PARTITIONS_2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8,
+    0xFF00, 0xFFF0, 0xF000, 0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110,
+    0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C, 0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696,
+    0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660, 0x0272, 0x04E4, 0x4E40, 0x2720,
+    0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+constexpr uint32_t BC7_PARTITIONS_3[64] = {
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+    0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+    0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+    0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+    0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+    0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+// Anchor texel of subset 1 (2-subset), and of subsets 1 and 2 (3-subset); subset 0's is texel 0
+constexpr uint8_t BC7_ANCHORS_2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2,  8, 2,  2, 8,  8,  15, 2,  8,  2,  2,
+    8,  8,  2,  2,  15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,  2,  15, 15, 6, 6, 2,  6,  8,  15, 15, 2,  2,
+    15, 15, 15, 15, 15, 2,  2,  15,
+};
+
+constexpr uint8_t BC7_ANCHORS_3A[64] = {
+    3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6,  6,  5, 3,  3, 3,  3, 8,  15, 3,  3,  6,  10, 5, 8,  8,  6,  8,  5, 15, 15,
+    8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15, 3, 15, 5,  5,  5,  8,  5,  10, 5, 10, 8,  13, 15, 12, 3, 3,
+};
+
+constexpr uint8_t BC7_ANCHORS_3B[64] = {
+    15, 8, 8, 3,  15, 15, 3,  8,  15, 15, 15, 15, 15, 15, 15, 8,  15, 8,  15, 3,  15, 8,  15, 8,
+    3,  15, 6, 10, 15, 15, 10, 8,  15, 3,  15, 10, 10, 8,  9,  10, 6,  15, 8,  15, 3,  6,  6,  8,
+    15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3,  15, 15, 8,
+};
+
+struct Bc7Mode {
+    uint8_t subsets;
+    uint8_t partitionBits;
+    uint8_t rotationBits;
+    uint8_t indexSelectionBits;
+    uint8_t colorBits;
+    uint8_t alphaBits;
+    uint8_t endpointPBits; // One p-bit per endpoint
+    uint8_t sharedPBits;   // One p-bit per subset
+    uint8_t indexBits;
+    uint8_t index2Bits;    // Second index set (modes 4 and 5)
+};
+
+constexpr Bc7Mode BC7_MODES[8] = {
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0}, {2, 6, 0, 0, 6, 0, 0, 1, 3, 0}, {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0}, {1, 0, 2, 1, 5, 6, 0, 0, 2, 3}, {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0}, {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+constexpr uint8_t BC7_WEIGHTS_2[4] = {0, 21, 43, 64};
+constexpr uint8_t BC7_WEIGHTS_3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+constexpr uint8_t BC7_WEIGHTS_4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+class BitReader {
+public:
+    explicit BitReader(const std::byte* block)
+        : _low(Load64(block)), _high(Load64(block + 8))
+    {
+    }
+
+    // count <= 32
+    uint32_t Read(uint32_t count)
+    {
+        if (count == 0) {
+            return 0; // Absent fields, possibly at the end of the block
+        }
+        uint64_t bits;
+        if (_position >= 64) {
+            bits = _high >> (_position - 64);
+        } else if (_position == 0) {
+            bits = _low;
+        } else {
+            bits = _low >> _position | _high << (64 - _position);
+        }
+        _position += count;
+        return static_cast<uint32_t>(bits & ((uint64_t(1) << count) - 1));
+    }
+
+private:
+    uint64_t _low;
+    uint64_t _high;
+    uint32_t _position = 0;
+};
+
+uint8_t Interpolate(uint32_t endpoint0, uint32_t endpoint1, uint32_t weight)
+{
+    return static_cast<uint8_t>(((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6);
+}
+
+uint32_t Weight(uint32_t indexBits, uint32_t index)
+{
+    return indexBits == 2 ? BC7_WEIGHTS_2[index] : indexBits == 3 ? BC7_WEIGHTS_3[index] : BC7_WEIGHTS_4[index];
+}
+
+void DecodeBc7Block(const std::byte* block, Texels texels)
+{
+    const uint32_t firstByte = static_cast<uint8_t>(block[0]);
+    if (firstByte == 0) {
+        std::memset(texels, 0, sizeof(Texels)); // Reserved mode: transparent black
+        return;
+    }
+    const uint32_t modeIndex = static_cast<uint32_t>(std::countr_zero(firstByte));
+    const Bc7Mode& mode = BC7_MODES[modeIndex];
+    BitReader bits(block);
+    bits.Read(modeIndex + 1);
+    const uint32_t partition = bits.Read(mode.partitionBits);
+    const uint32_t rotation = bits.Read(mode.rotationBits);
+    const uint32_t indexSelection = bits.Read(mode.indexSelectionBits);
+
+    // Endpoints [subset][endpoint][channel]: all reds, then greens, blues, alphas
+    uint32_t endpoints[3][2][4] = {};
+    for (int c = 0; c < 3; c++) {
+        for (uint32_t s = 0; s < mode.subsets; s++) {
+            endpoints[s][0][c] = bits.Read(mode.colorBits);
+            endpoints[s][1][c] = bits.Read(mode.colorBits);
+        }
+    }
+    for (uint32_t s = 0; s < mode.subsets && mode.alphaBits > 0; s++) {
+        endpoints[s][0][3] = bits.Read(mode.alphaBits);
+        endpoints[s][1][3] = bits.Read(mode.alphaBits);
+    }
+    uint32_t pBits[3][2] = {};
+    for (uint32_t s = 0; s < mode.subsets; s++) {
+        if (mode.endpointPBits) {
+            pBits[s][0] = bits.Read(1);
+            pBits[s][1] = bits.Read(1);
+        } else if (mode.sharedPBits) {
+            pBits[s][0] = pBits[s][1] = bits.Read(1);
+        }
+    }
+    // Unquantize: append the p-bit, then replicate the high bits down to 8 bits
+    const bool hasPBits = mode.endpointPBits || mode.sharedPBits;
+    for (uint32_t s = 0; s < mode.subsets; s++) {
+        for (int e = 0; e < 2; e++) {
+            for (int c = 0; c < 4; c++) {
+                uint32_t precision = c < 3 ? mode.colorBits : mode.alphaBits;
+                if (precision == 0) {
+                    endpoints[s][e][c] = 255; // No alpha in this mode
+                    continue;
+                }
+                uint32_t value = endpoints[s][e][c];
+                if (hasPBits) {
+                    value = value << 1 | pBits[s][e];
+                    precision++;
+                }
+                value <<= 8 - precision;
+                endpoints[s][e][c] = value | value >> precision;
+            }
+        }
+    }
+
+    uint32_t subsetOf[16];
+    bool anchor[16] = {};
+    for (uint32_t i = 0; i < 16; i++) {
+        subsetOf[i] = GetBc7Subset(mode.subsets, partition, i);
+    }
+    for (uint32_t s = 0; s < mode.subsets; s++) {
+        anchor[GetBc7AnchorTexel(mode.subsets, partition, s)] = true;
+    }
+    // Anchor texels store their index without its top bit, which is always 0
+    uint32_t indices[16];
+    uint32_t indices2[16] = {};
+    for (int i = 0; i < 16; i++) {
+        indices[i] = bits.Read(mode.indexBits - (anchor[i] ? 1 : 0));
+    }
+    for (int i = 0; i < 16 && mode.index2Bits > 0; i++) {
+        indices2[i] = bits.Read(mode.index2Bits - (i == 0 ? 1 : 0));
+    }
+
+    for (int i = 0; i < 16; i++) {
+        const uint32_t (&endpoint)[2][4] = endpoints[subsetOf[i]];
+        uint32_t colorWeight = Weight(mode.indexBits, indices[i]);
+        uint32_t alphaWeight = colorWeight;
+        if (mode.index2Bits > 0) {
+            // Mode 4's index selection bit swaps which set drives color
+            colorWeight = indexSelection ? Weight(mode.index2Bits, indices2[i]) : Weight(mode.indexBits, indices[i]);
+            alphaWeight = indexSelection ? Weight(mode.indexBits, indices[i]) : Weight(mode.index2Bits, indices2[i]);
+        }
+        uint8_t* texel = texels + i * 4;
+        for (int c = 0; c < 3; c++) {
+            texel[c] = Interpolate(endpoint[0][c], endpoint[1][c], colorWeight);
+        }
+        texel[3] = Interpolate(endpoint[0][3], endpoint[1][3], alphaWeight);
+        if (rotation != 0) {
+            std::swap(texel[3], texel[rotation - 1]); // 1: red, 2: green, 3: blue
+        }
+    }
+}
+} // namespace
+
+uint32_t GetBc7Subset(uint32_t subsetCount, uint32_t partition, uint32_t texel)
+{
+    switch (subsetCount) {
+        case 2: return (BC7_PARTITIONS_2[partition] >> texel) & 1;
+        case 3: return (BC7_PARTITIONS_3[partition] >> (2 * texel)) & 3;
+        default: return 0;
+    }
+}
+
+uint32_t GetBc7AnchorTexel(uint32_t subsetCount, uint32_t partition, uint32_t subset)
+{
+    if (subset == 0) {
+        return 0;
+    }
+    if (subsetCount == 2) {
+        return BC7_ANCHORS_2[partition];
+    }
+    return subset == 1 ? BC7_ANCHORS_3A[partition] : BC7_ANCHORS_3B[partition];
+}
+
+TextureFormat GetDecodedFormat(TextureFormat format)
+{
+    return GetTextureFormatInfo(format).srgb ? TextureFormat::Rgba8Srgb : TextureFormat::Rgba8Unorm;
+}
+
+void DecodeBlock(TextureFormat format, const std::byte* block, uint8_t texels[16 * 4])
+{
+    switch (format) {
+        case TextureFormat::Bc1RgbUnorm:
+        case TextureFormat::Bc1RgbSrgb:
+            DecodeColorBlock(block, texels, false);
+            for (int i = 0; i < 16; i++) {
+                texels[i * 4 + 3] = 255; // The RGB variants have no transparent texels
+            }
+            return;
+        case TextureFormat::Bc1RgbaUnorm:
+        case TextureFormat::Bc1RgbaSrgb:
+            DecodeColorBlock(block, texels, false);
+            return;
+        case TextureFormat::Bc2Unorm:
+        case TextureFormat::Bc2Srgb: {
+            DecodeColorBlock(block + 8, texels, true);
+            const uint64_t alpha = Load64(block);
+            for (int i = 0; i < 16; i++) {
+                texels[i * 4 + 3] = static_cast<uint8_t>(((alpha >> (4 * i)) & 15) * 17);
+            }
+            return;
+        }
+        case TextureFormat::Bc3Unorm:
+        case TextureFormat::Bc3Srgb:
+            DecodeColorBlock(block + 8, texels, true);
+            DecodeChannelBlock(block, texels, 3);
+            return;
+        case TextureFormat::Bc4Unorm:
+        case TextureFormat::Bc5Unorm:
+            for (int i = 0; i < 16; i++) {
+                texels[i * 4 + 1] = texels[i * 4 + 2] = 0;
+                texels[i * 4 + 3] = 255;
+            }
+            DecodeChannelBlock(block, texels, 0);
+            if (format == TextureFormat::Bc5Unorm) {
+                DecodeChannelBlock(block + 8, texels, 1);
+            }
+            return;
+        case TextureFormat::Bc7Unorm:
+        case TextureFormat::Bc7Srgb:
+            DecodeBc7Block(block, texels);
+            return;
+        case TextureFormat::Rgba8Unorm:
+        case TextureFormat::Rgba8Srgb:
+            break;
+    }
+    throw std::runtime_error(std::string("Error: ") + GetTextureFormatName(format) + " is not a block-compressed format!");
+}
+
+std::vector<std::byte> DecodeTextureLevel(TextureFormat format, std::span<const std::byte> data, uint32_t width,
+                                          uint32_t height)
+{
+    const TextureFormatInfo info = GetTextureFormatInfo(format);
+    if (!info.compressed) {
+        throw std::runtime_error(std::string("Error: ") + GetTextureFormatName(format) + " is not a block-compressed format!");
+    }
+    if (data.size() < GetTextureLevelSize(format, width, height)) {
+        throw std::runtime_error("Error: texture level data is shorter than its " + std::to_string(width) + "x" +
+                                 std::to_string(height) + " texels!");
+    }
+    std::vector<std::byte> texels(size_t(width) * height * 4);
+    const uint32_t blocksWide = (width + 3) / 4;
+    const uint32_t blocksHigh = (height + 3) / 4;
+    uint8_t block[16 * 4];
+    for (uint32_t by = 0; by < blocksHigh; by++) {
+        for (uint32_t bx = 0; bx < blocksWide; bx++) {
+            DecodeBlock(format, data.data() + (size_t(by) * blocksWide + bx) * info.blockBytes, block);
+            // Edge blocks hang over the level; only the texels inside it are kept
+            const uint32_t rows = std::min(4u, height - by * 4);
+            const uint32_t columns = std::min(4u, width - bx * 4);
+            for (uint32_t y = 0; y < rows; y++) {
+                std::memcpy(texels.data() + ((size_t(by) * 4 + y) * width + bx * 4) * 4, block + y * 16, columns * 4);
+            }
+        }
+    }
+    return texels;
+}
+
+} // namespace VulkanApp::Assets
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "TextureFile.h"
+
+namespace VulkanApp::Assets {
+
+// CPU decoder for the block-compressed TextureFormats, the fallback for
+// devices that cannot sample them (GpuTexture picks it). Output is RGBA8:
+// BC4 decodes to (r, 0, 0, 1) and BC5 to (r, g, 0, 1), as the GPU samples
+// them. Decoding costs bandwidth and 4-8x the memory the compressed format
+// would have, so it is a compatibility path, not a default.
+
+// RGBA8 format the decoder produces for format: sRGB formats stay sRGB
+TextureFormat GetDecodedFormat(TextureFormat format);
+
+// Decodes one 4x4 block to 16 RGBA8 texels, row by row
+void DecodeBlock(TextureFormat format, const std::byte* block, uint8_t texels[16 * 4]);
+
+// Decodes a width x height level (GetTextureLevelSize bytes) to tightly packed
+// RGBA8. Throws std::runtime_error if data is too short or format is not compressed.
+std::vector<std::byte> DecodeTextureLevel(TextureFormat format, std::span<const std::byte> data, uint32_t width,
+                                          uint32_t height);
+
+// BC7 partition tables (subsetCount 1-3, partition 0-63, texel 0-15), exposed
+// so the tables can be checked: the subset a texel belongs to, and the anchor
+// texel whose index is stored without its top bit
+uint32_t GetBc7Subset(uint32_t subsetCount, uint32_t partition, uint32_t texel);
+uint32_t GetBc7AnchorTexel(uint32_t subsetCount, uint32_t partition, uint32_t subset);
+
+} // namespace VulkanApp::Assets
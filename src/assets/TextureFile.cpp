@@ -0,0 +1,183 @@
+#include "TextureFile.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace VulkanApp::Assets {
+
+static_assert(std::endian::native == std::endian::little, "KTX2 files are little-endian and read in place");
+
+namespace {
+constexpr uint8_t KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+// The fixed part of a KTX2 file, followed by one Ktx2LevelIndex per level
+struct Ktx2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount; // 0 = only the base level, mipmaps to be generated
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header is the KTX2 file header");
+
+struct Ktx2LevelIndex {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+static_assert(sizeof(Ktx2LevelIndex) == 24, "Ktx2LevelIndex is part of the KTX2 file format");
+
+// offset + size lies within fileSize, without overflowing
+bool InFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+void Fail(const std::string& path, const std::string& what)
+{
+    throw std::runtime_error("Error: " + path + " is not a supported KTX2 texture: " + what + "!");
+}
+
+const Ktx2LevelIndex& LevelIndex(const MappedFile& file, uint32_t level)
+{
+    return reinterpret_cast<const Ktx2LevelIndex*>(file.GetBytes().data() + sizeof(Ktx2Header))[level];
+}
+} // namespace
+
+TextureFormatInfo GetTextureFormatInfo(TextureFormat format)
+{
+    switch (format) {
+        case TextureFormat::Rgba8Unorm: return {1, 4, false, false};
+        case TextureFormat::Rgba8Srgb: return {1, 4, false, true};
+        case TextureFormat::Bc1RgbUnorm: return {4, 8, true, false};
+        case TextureFormat::Bc1RgbSrgb: return {4, 8, true, true};
+        case TextureFormat::Bc1RgbaUnorm: return {4, 8, true, false};
+        case TextureFormat::Bc1RgbaSrgb: return {4, 8, true, true};
+        case TextureFormat::Bc2Unorm: return {4, 16, true, false};
+        case TextureFormat::Bc2Srgb: return {4, 16, true, true};
+        case TextureFormat::Bc3Unorm: return {4, 16, true, false};
+        case TextureFormat::Bc3Srgb: return {4, 16, true, true};
+        case TextureFormat::Bc4Unorm: return {4, 8, true, false};
+        case TextureFormat::Bc5Unorm: return {4, 16, true, false};
+        case TextureFormat::Bc7Unorm: return {4, 16, true, false};
+        case TextureFormat::Bc7Srgb: return {4, 16, true, true};
+    }
+    return {1, 0, false, false};
+}
+
+const char* GetTextureFormatName(TextureFormat format)
+{
+    switch (format) {
+        case TextureFormat::Rgba8Unorm: return "RGBA8";
+        case TextureFormat::Rgba8Srgb: return "RGBA8 sRGB";
+        case TextureFormat::Bc1RgbUnorm: return "BC1 RGB";
+        case TextureFormat::Bc1RgbSrgb: return "BC1 RGB sRGB";
+        case TextureFormat::Bc1RgbaUnorm: return "BC1 RGBA";
+        case TextureFormat::Bc1RgbaSrgb: return "BC1 RGBA sRGB";
+        case TextureFormat::Bc2Unorm: return "BC2";
+        case TextureFormat::Bc2Srgb: return "BC2 sRGB";
+        case TextureFormat::Bc3Unorm: return "BC3";
+        case TextureFormat::Bc3Srgb: return "BC3 sRGB";
+        case TextureFormat::Bc4Unorm: return "BC4";
+        case TextureFormat::Bc5Unorm: return "BC5";
+        case TextureFormat::Bc7Unorm: return "BC7";
+        case TextureFormat::Bc7Srgb: return "BC7 sRGB";
+    }
+    return "unknown";
+}
+
+uint64_t GetTextureLevelSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+    TextureFormatInfo info = GetTextureFormatInfo(format);
+    uint64_t blocksWide = (uint64_t(width) + info.blockSize - 1) / info.blockSize;
+    uint64_t blocksHigh = (uint64_t(height) + info.blockSize - 1) / info.blockSize;
+    return blocksWide * blocksHigh * info.blockBytes;
+}
+
+TextureFile::TextureFile(const std::string& path)
+    : TextureFile(MappedFile(path))
+{
+}
+
+TextureFile::TextureFile(MappedFile file)
+    : _file(std::move(file))
+{
+    Validate();
+}
+
+// Every offset and size is checked against the mapping before the levels are
+// read through it; the data format descriptor and key/value data are not needed
+void TextureFile::Validate()
+{
+    const std::string& path = _file.GetPath();
+    std::span<const std::byte> bytes = _file.GetBytes();
+    const uint64_t fileSize = bytes.size();
+    if (fileSize < sizeof(Ktx2Header)) {
+        Fail(path, "shorter than the header");
+    }
+    Ktx2Header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        Fail(path, "bad identifier");
+    }
+    _format = static_cast<TextureFormat>(header.vkFormat);
+    if (GetTextureFormatInfo(_format).blockBytes == 0) {
+        Fail(path, "unsupported format " + std::to_string(header.vkFormat));
+    }
+    if (header.supercompressionScheme != 0) {
+        Fail(path, "supercompressed (scheme " + std::to_string(header.supercompressionScheme) + ")");
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount > 1 ||
+        header.faceCount != 1) {
+        Fail(path, "not a single 2D image");
+    }
+    _width = header.pixelWidth;
+    _height = header.pixelHeight;
+    _levelCount = std::max(header.levelCount, 1u);
+    if (_levelCount > static_cast<uint32_t>(std::bit_width(std::max(_width, _height)))) {
+        Fail(path, "more levels than the mip chain has");
+    }
+    if (!InFile(sizeof(Ktx2Header), uint64_t(_levelCount) * sizeof(Ktx2LevelIndex), fileSize)) {
+        Fail(path, "level index out of bounds");
+    }
+    for (uint32_t level = 0; level < _levelCount; level++) {
+        const Ktx2LevelIndex& index = LevelIndex(_file, level);
+        uint64_t expected = GetTextureLevelSize(_format, GetLevelWidth(level), GetLevelHeight(level));
+        if (index.byteLength != expected || index.uncompressedByteLength != expected ||
+            !InFile(index.byteOffset, index.byteLength, fileSize)) {
+            Fail(path, "level " + std::to_string(level) + " out of bounds or of the wrong size");
+        }
+    }
+}
+
+uint32_t TextureFile::GetLevelWidth(uint32_t level) const
+{
+    return std::max(_width >> level, 1u);
+}
+
+uint32_t TextureFile::GetLevelHeight(uint32_t level) const
+{
+    return std::max(_height >> level, 1u);
+}
+
+std::span<const std::byte> TextureFile::GetLevelData(uint32_t level) const
+{
+    const Ktx2LevelIndex& index = LevelIndex(_file, level);
+    return _file.GetBytes().subspan(index.byteOffset, index.byteLength);
+}
+
+} // namespace VulkanApp::Assets
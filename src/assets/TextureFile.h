@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "../core/MappedFile.h"
+
+namespace VulkanApp::Assets {
+
+// Texel formats a texture can be stored in. The values are the VkFormat
+// values KTX2 stores (so GpuTexture casts them), without making the asset
+// code depend on Vulkan.
+enum class TextureFormat : uint32_t {
+    Rgba8Unorm = 37,    // VK_FORMAT_R8G8B8A8_UNORM
+    Rgba8Srgb = 43,     // VK_FORMAT_R8G8B8A8_SRGB
+    Bc1RgbUnorm = 131,  // VK_FORMAT_BC1_RGB_UNORM_BLOCK: 8 bytes per 4x4 block
+    Bc1RgbSrgb = 132,
+    Bc1RgbaUnorm = 133, // 1-bit alpha
+    Bc1RgbaSrgb = 134,
+    Bc2Unorm = 135,     // 16 bytes per block from here on; explicit 4-bit alpha
+    Bc2Srgb = 136,
+    Bc3Unorm = 137,     // Interpolated alpha
+    Bc3Srgb = 138,
+    Bc4Unorm = 139,     // One channel (roughness, masks); 8 bytes per block
+    Bc5Unorm = 141,     // Two channels (tangent-space normals)
+    Bc7Unorm = 145,     // High-quality RGB(A)
+    Bc7Srgb = 146,
+};
+
+struct TextureFormatInfo {
+    uint32_t blockSize;  // Texels per block side: 4 for BCn, 1 for uncompressed
+    uint32_t blockBytes; // Bytes per block (per texel when uncompressed)
+    bool compressed;
+    bool srgb;
+};
+
+// Zero blockBytes for an unknown format
+TextureFormatInfo GetTextureFormatInfo(TextureFormat format);
+const char* GetTextureFormatName(TextureFormat format);
+// Bytes of one width x height level, tightly packed in whole blocks
+uint64_t GetTextureLevelSize(TextureFormat format, uint32_t width, uint32_t height);
+
+// A validated, memory-mapped KTX2 texture (the Khronos container for GPU
+// texture formats): one 2D image, no array layers or cube faces, no
+// supercompression, so every level is stored ready to copy into an image.
+// KTX2 places the smallest level first in the file, so streaming levels in
+// file order gives a usable texture after the first few kilobytes.
+// Moveable, not copyable.
+class TextureFile {
+public:
+    // Maps and validates the file; throws std::runtime_error if it is not a
+    // KTX2 texture of a supported kind
+    explicit TextureFile(const std::string& path);
+    explicit TextureFile(MappedFile file);
+
+    TextureFormat GetFormat() const { return _format; }
+    uint32_t GetWidth() const { return _width; }
+    uint32_t GetHeight() const { return _height; }
+    uint32_t GetLevelCount() const { return _levelCount; }
+    uint32_t GetLevelWidth(uint32_t level) const;
+    uint32_t GetLevelHeight(uint32_t level) const;
+    // Level 0 is the full-resolution image
+    std::span<const std::byte> GetLevelData(uint32_t level) const;
+
+    const MappedFile& GetMappedFile() const { return _file; }
+    size_t GetFileSize() const { return _file.GetSize(); }
+
+private:
+    void Validate();
+
+    MappedFile _file;
+    TextureFormat _format = TextureFormat::Rgba8Unorm;
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+    uint32_t _levelCount = 0;
+};
+
+} // namespace VulkanApp::Assets
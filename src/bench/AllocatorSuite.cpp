@@ -0,0 +1,190 @@
+// Allocator suite: drives TlsfAllocator (the placement core of
+// VulkanMemoryAllocator) with a randomized alloc/free workload shaped like
+// buffer and image requests, timing every call and checking invariants.
+
+#include "CpuSuites.h"
+
+#include "vulkan/TlsfAllocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t ARENA_SIZE = 256ull * 1024 * 1024; // Four default device memory blocks
+constexpr uint32_t OPS_PER_SAMPLE = 1000;
+
+struct LiveAllocation
+{
+  uint32_t handle;
+  uint64_t offset;
+  uint64_t size;
+};
+
+// Mostly small buffers, some medium images, a few large ones
+uint64_t RandomSize(std::mt19937_64& rng)
+{
+  uint32_t bucket = rng() % 100;
+  if (bucket < 70) return 256 + rng() % (64 * 1024);
+  if (bucket < 95) return 64 * 1024 + rng() % (1024 * 1024);
+  return 1024 * 1024 + rng() % (8 * 1024 * 1024);
+}
+
+uint64_t RandomAlignment(std::mt19937_64& rng)
+{
+  static constexpr uint64_t alignments[] = {4, 16, 64, 256, 1024, 4096, 65536};
+  return alignments[rng() % std::size(alignments)];
+}
+
+bool CheckNoOverlap(std::vector<LiveAllocation> live)
+{
+  std::sort(live.begin(), live.end(), [](const LiveAllocation& a, const LiveAllocation& b) { return a.offset < b.offset; });
+  for (size_t i = 1; i < live.size(); i++)
+  {
+    if (live[i - 1].offset + live[i - 1].size > live[i].offset)
+    {
+      return false;
+    }
+  }
+  return live.empty() || live.back().offset + live.back().size <= ARENA_SIZE;
+}
+
+// Exact-fit, exhaustion and full coalescing behaviour
+bool RunEdgeCases()
+{
+  TlsfAllocator allocator(ARENA_SIZE);
+  uint64_t offset = 0;
+  uint32_t whole = allocator.allocate(ARENA_SIZE, 1, offset);
+  if (whole == TlsfAllocator::INVALID_HANDLE || offset != 0) return false;
+  if (allocator.allocate(1, 1, offset) != TlsfAllocator::INVALID_HANDLE) return false;
+  allocator.free(whole);
+
+  // Interleaved frees must coalesce back into a single range
+  std::vector<uint32_t> handles;
+  for (uint32_t i = 0; i < 1024; i++)
+  {
+    handles.push_back(allocator.allocate(ARENA_SIZE / 1024, 256, offset));
+    if (handles.back() == TlsfAllocator::INVALID_HANDLE || offset != i * (ARENA_SIZE / 1024)) return false;
+  }
+  for (size_t i = 0; i < handles.size(); i += 2) allocator.free(handles[i]);
+  if (allocator.getStats().freeBlockCount != 512) return false;
+  for (size_t i = 1; i < handles.size(); i += 2) allocator.free(handles[i]);
+
+  TlsfAllocator::Stats stats = allocator.getStats();
+  return allocator.validate() && stats.freeBlockCount == 1 && stats.largestFreeBlock == ARENA_SIZE &&
+         stats.usedBytes == 0;
+}
+
+} // namespace
+
+bool RunAllocatorSuite(BenchReport& report, uint32_t iterations)
+{
+  bool passed = RunEdgeCases();
+  if (!passed)
+  {
+    std::cerr << "Allocator edge-case checks FAILED" << std::endl;
+  }
+
+  TlsfAllocator allocator(ARENA_SIZE);
+  std::mt19937_64 rng(42);
+  std::vector<LiveAllocation> live;
+
+  MetricSeries allocNs{"tlsf_alloc_ns", {}};
+  MetricSeries freeNs{"tlsf_free_ns", {}};
+  MetricSeries fragmentation{"tlsf_fragmentation", {}};
+  MetricSeries occupancy{"tlsf_occupancy", {}};
+  uint64_t failedAllocations = 0;
+  uint64_t totalAllocations = 0;
+  uint64_t usedBytes = 0; // Tracked here: getStats() walks the free lists
+
+  // Target ~75% occupancy: allocate-biased below it, free-biased above
+  for (uint32_t sample = 0; sample < iterations && passed; sample++)
+  {
+    double allocTime = 0.0, freeTime = 0.0;
+    uint32_t allocOps = 0, freeOps = 0;
+    for (uint32_t op = 0; op < OPS_PER_SAMPLE; op++)
+    {
+      double used = static_cast<double>(usedBytes) / ARENA_SIZE;
+      bool doAlloc = live.empty() || (rng() % 100) < (used < 0.75 ? 70u : 30u);
+      if (doAlloc)
+      {
+        uint64_t size = RandomSize(rng);
+        uint64_t alignment = RandomAlignment(rng);
+        uint64_t offset = 0;
+        auto start = Clock::now();
+        uint32_t handle = allocator.allocate(size, alignment, offset);
+        allocTime += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        allocOps++;
+        totalAllocations++;
+        if (handle == TlsfAllocator::INVALID_HANDLE)
+        {
+          failedAllocations++;
+          continue;
+        }
+        if (offset % alignment != 0)
+        {
+          std::cerr << "Allocator returned a misaligned offset" << std::endl;
+          passed = false;
+        }
+        live.push_back({handle, offset, size});
+        usedBytes += size;
+      }
+      else
+      {
+        size_t index = rng() % live.size();
+        auto start = Clock::now();
+        allocator.free(live[index].handle);
+        freeTime += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        freeOps++;
+        usedBytes -= live[index].size;
+        live[index] = live.back();
+        live.pop_back();
+      }
+    }
+
+    if (allocOps > 0) allocNs.samples.push_back(allocTime / allocOps);
+    if (freeOps > 0) freeNs.samples.push_back(freeTime / freeOps);
+    TlsfAllocator::Stats stats = allocator.getStats();
+    fragmentation.samples.push_back(stats.fragmentation());
+    occupancy.samples.push_back(static_cast<double>(stats.usedBytes) / ARENA_SIZE);
+
+    if (!allocator.validate() || !CheckNoOverlap(live))
+    {
+      std::cerr << "Allocator invariants violated after sample " << sample << std::endl;
+      passed = false;
+    }
+  }
+
+  // Everything freed must coalesce back into one block
+  for (const LiveAllocation& allocation : live)
+  {
+    allocator.free(allocation.handle);
+  }
+  TlsfAllocator::Stats finalStats = allocator.getStats();
+  if (passed && (finalStats.freeBlockCount != 1 || finalStats.usedBytes != 0))
+  {
+    std::cerr << "Allocator did not coalesce after freeing everything" << std::endl;
+    passed = false;
+  }
+
+  report.config.emplace_back("arena_bytes", std::to_string(ARENA_SIZE));
+  report.config.emplace_back("ops_per_sample", std::to_string(OPS_PER_SAMPLE));
+  report.config.emplace_back("allocations", std::to_string(totalAllocations));
+  report.config.emplace_back("failed_allocations", std::to_string(failedAllocations));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  for (MetricSeries* series : {&allocNs, &freeNs, &fragmentation, &occupancy})
+  {
+    report.metrics.emplace_back(series->name, Summarize(series->samples));
+  }
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
@@ -0,0 +1,233 @@
+// Barrier suite: BarrierBatcher state tracking on fake handles (no device).
+// Checks that transitions are derived from the tracked state, that covered
+// reads are dropped and repeated uses collapse into one barrier per resource,
+// then times Use* calls on a synthetic multi-pass frame and reports how many
+// barriers each sync point needs against one barrier per use.
+
+#include "CpuSuites.h"
+
+#include "rendering/BarrierBatcher.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using VulkanApp::Rendering::BarrierBatcher;
+
+constexpr uint32_t FRAME_IMAGES = 64;
+constexpr uint32_t FRAME_BUFFERS = 64;
+constexpr uint32_t FRAME_PASSES = 32;
+constexpr uint32_t USES_PER_PASS = 24;
+
+// Non-dispatchable handles are pointers on 64-bit platforms and uint64_t elsewhere
+template <typename Handle>
+Handle FakeHandle(uint64_t id)
+{
+  if constexpr (std::is_pointer_v<Handle>)
+  {
+    return reinterpret_cast<Handle>(static_cast<uintptr_t>(id));
+  }
+  else
+  {
+    return static_cast<Handle>(id);
+  }
+}
+
+constexpr const char* SUITE = "Barrier";
+
+bool RunStateChecks()
+{
+  bool passed = true;
+  const VkImage color = FakeHandle<VkImage>(1);
+  const VkImage depth = FakeHandle<VkImage>(2);
+  const VkBuffer buffer = FakeHandle<VkBuffer>(3);
+  const VkPipelineStageFlags2KHR colorStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+  const VkPipelineStageFlags2KHR fragment = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+  const VkPipelineStageFlags2KHR compute = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+
+  BarrierBatcher batcher;
+
+  // First use of an untracked image: UNDEFINED -> attachment, nothing to wait for
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, colorStage, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR);
+  const auto& first = batcher.GetPendingImageBarriers();
+  passed = Check(SUITE, first.size() == 1 && first[0].oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && first[0].srcStageMask == 0,
+                 "first use transitions with an empty source scope") && passed;
+  batcher.ClearPending();
+
+  // Write -> sampled read: layout change waiting on the attachment write
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, fragment, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+  const auto& toRead = batcher.GetPendingImageBarriers();
+  passed = Check(SUITE, toRead.size() == 1 && toRead[0].oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL &&
+                            toRead[0].srcStageMask == colorStage &&
+                            toRead[0].srcAccessMask == VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+                 "read after write waits on the write") && passed;
+  batcher.ClearPending();
+
+  // The same read again is already ordered: dropped
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, fragment, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+  passed = Check(SUITE, !batcher.HasPending(), "covered read is dropped") && passed;
+
+  // A read in a new stage, same layout, needs only an execution/memory dependency
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, compute, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+  passed = Check(SUITE, batcher.GetPendingImageBarriers().size() == 1 &&
+                            batcher.GetPendingImageBarriers()[0].oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
+                            batcher.GetPendingImageBarriers()[0].dstStageMask == compute,
+                 "read in a new stage is ordered") && passed;
+  batcher.ClearPending();
+
+  // Write after reads: waits on every read stage, no source access (WAR)
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, colorStage, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR);
+  const auto& war = batcher.GetPendingImageBarriers();
+  passed = Check(SUITE, war.size() == 1 && (war[0].srcStageMask & fragment) && (war[0].srcStageMask & compute),
+                 "write after read waits on all readers") && passed;
+  batcher.ClearPending();
+
+  // Two uses before a flush collapse: one barrier from the old state to the last layout
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+                   VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_GENERAL, compute, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR);
+  const auto& collapsed = batcher.GetPendingImageBarriers();
+  passed = Check(SUITE, collapsed.size() == 1 && collapsed[0].oldLayout == VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL &&
+                            collapsed[0].newLayout == VK_IMAGE_LAYOUT_GENERAL &&
+                            collapsed[0].dstStageMask == (VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR | compute),
+                 "uses in one batch collapse") && passed;
+  passed = Check(SUITE, batcher.GetImageState(color)->layout == VK_IMAGE_LAYOUT_GENERAL,
+                 "state follows the last use") && passed;
+  batcher.ClearPending();
+
+  // Several resources at one sync point share the batch
+  BarrierBatcher::ResourceState depthState;
+  depthState.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+  depthState.writeStages = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR;
+  depthState.writeAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR;
+  batcher.TrackImage(depth, VK_IMAGE_ASPECT_DEPTH_BIT, depthState);
+  batcher.UseImage(depth, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, fragment, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, fragment, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+  batcher.UseBuffer(buffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+  passed = Check(SUITE, batcher.GetPendingImageBarriers().size() == 2 &&
+                            batcher.GetPendingImageBarriers()[0].subresourceRange.aspectMask == VK_IMAGE_ASPECT_DEPTH_BIT,
+                 "resources share one sync point") && passed;
+  passed = Check(SUITE, batcher.GetPendingBufferBarriers().empty(), "first buffer write needs no barrier") && passed;
+  batcher.ClearPending();
+
+  // Buffer write -> read is a memory dependency; a repeated read is dropped
+  batcher.UseBuffer(buffer, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR);
+  const auto& bufferRead = batcher.GetPendingBufferBarriers();
+  passed = Check(SUITE, bufferRead.size() == 1 && bufferRead[0].srcAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR &&
+                            bufferRead[0].size == VK_WHOLE_SIZE,
+                 "buffer read after write") && passed;
+  batcher.ClearPending();
+  batcher.UseBuffer(buffer, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR);
+  passed = Check(SUITE, !batcher.HasPending(), "covered buffer read is dropped") && passed;
+
+  // Discarding transitions from UNDEFINED even when the layout is unchanged
+  batcher.UseImage(color, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, colorStage, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR, true);
+  passed = Check(SUITE, batcher.GetPendingImageBarriers().size() == 1 &&
+                            batcher.GetPendingImageBarriers()[0].oldLayout == VK_IMAGE_LAYOUT_UNDEFINED,
+                 "discard transitions from UNDEFINED") && passed;
+  batcher.ClearPending();
+
+  batcher.Forget(color);
+  passed = Check(SUITE, batcher.GetImageState(color) == nullptr, "forgotten images are untracked") && passed;
+  return passed;
+}
+
+// A frame of passes, each reading some resources the earlier passes wrote and
+// writing others; returns the time per Use call in ns
+double RunFrame(BarrierBatcher& batcher, std::mt19937& rng, uint64_t& syncPoints)
+{
+  const std::array<VkImageLayout, 3> readLayouts = {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+                                                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL};
+  const std::array<VkPipelineStageFlags2KHR, 3> stages = {VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+                                                          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                                                          VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR};
+  uint32_t uses = 0;
+  auto start = Clock::now();
+  for (uint32_t pass = 0; pass < FRAME_PASSES; pass++)
+  {
+    for (uint32_t use = 0; use < USES_PER_PASS; use++)
+    {
+      uint32_t kind = rng() % 3;
+      bool write = rng() % 4 == 0;
+      if (rng() % 2 == 0)
+      {
+        VkImage image = FakeHandle<VkImage>(1 + rng() % FRAME_IMAGES);
+        if (write)
+        {
+          batcher.UseImage(image, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                           VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR);
+        }
+        else
+        {
+          batcher.UseImage(image, readLayouts[kind], stages[kind], VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR);
+        }
+      }
+      else
+      {
+        VkBuffer buffer = FakeHandle<VkBuffer>(1000 + rng() % FRAME_BUFFERS);
+        batcher.UseBuffer(buffer, stages[kind],
+                          write ? VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR : VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR);
+      }
+      uses++;
+    }
+    if (batcher.HasPending())
+    {
+      syncPoints++;
+    }
+    batcher.ClearPending(); // Stands in for Flush: one call per pass
+  }
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / uses;
+}
+
+} // namespace
+
+bool RunBarrierSuite(BenchReport& report, uint32_t iterations)
+{
+  bool passed = RunStateChecks();
+  if (!passed)
+  {
+    std::cerr << "Barrier state checks FAILED" << std::endl;
+  }
+
+  MetricSeries useTime{"barrier_use_ns", {}};
+  MetricSeries barriersPerSync{"barriers_per_sync_point", {}};
+  std::mt19937 rng(1234);
+  BarrierBatcher batcher;
+  uint64_t pendingBarriers = 0;
+  for (uint32_t sample = 0; sample < iterations; sample++)
+  {
+    BarrierBatcher::Stats before = batcher.GetStats();
+    uint64_t syncPoints = 0;
+    useTime.samples.push_back(RunFrame(batcher, rng, syncPoints));
+    const BarrierBatcher::Stats& after = batcher.GetStats();
+    // Barriers queued = uses that were neither dropped nor collapsed
+    uint64_t queued = (after.uses - before.uses) - (after.dropped - before.dropped) - (after.collapsed - before.collapsed);
+    pendingBarriers += queued;
+    barriersPerSync.samples.push_back(syncPoints ? static_cast<double>(queued) / syncPoints : 0.0);
+  }
+
+  const BarrierBatcher::Stats& stats = batcher.GetStats();
+  report.config.emplace_back("frame_passes", std::to_string(FRAME_PASSES));
+  report.config.emplace_back("uses_per_pass", std::to_string(USES_PER_PASS));
+  report.config.emplace_back("resources", std::to_string(FRAME_IMAGES + FRAME_BUFFERS));
+  report.config.emplace_back("uses", std::to_string(stats.uses));
+  report.config.emplace_back("barriers_queued", std::to_string(pendingBarriers));
+  report.config.emplace_back("dropped", std::to_string(stats.dropped));
+  report.config.emplace_back("collapsed", std::to_string(stats.collapsed));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(useTime.name, Summarize(useTime.samples));
+  report.metrics.emplace_back(barriersPerSync.name, Summarize(barriersPerSync.samples));
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
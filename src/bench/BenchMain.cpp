@@ -0,0 +1,416 @@
+// VulkanAppBench: drives Renderer::DrawFrame for a fixed number of frames or a
+// fixed duration and reports frame-time distributions as a table and as JSON.
+
+#include "FrameStats.h"
+#include "CpuSuites.h"
+
+#include "core/AppConfig.h"
+#include "core/JobSystem.h"
+#include "platform/Window.h"
+#include "vulkan/VulkanInstance.h"
+#include "vulkan/VulkanDevice.h"
+#include "vulkan/VulkanMemoryAllocator.h"
+#include "vulkan/VulkanPipelineCache.h"
+#include "vulkan/VulkanSwapChain.h"
+#include "vulkan/VulkanOffscreenTarget.h"
+#include "rendering/Renderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using VulkanApp::Bench::BenchReport;
+using VulkanApp::Bench::MetricSeries;
+
+constexpr uint32_t DEFAULT_BENCH_FRAMES = 1000;
+
+struct BenchOptions
+{
+  AppConfig app;
+  uint32_t warmupFrames = 60;   // Excluded from the statistics
+  double durationSeconds = 0.0; // Measure for this long instead of a frame count
+  std::string jsonPath = "bench_results.json";
+  std::string label;            // Free-form tag, e.g. the commit being measured
+  std::string suite = "frames"; // "frames" renders; the others are CPU-only (see CpuSuites.h)
+  uint32_t iterations = 1000;   // Samples taken by CPU-only suites
+};
+
+void PrintBenchUsage(const std::string& programName)
+{
+  PrintUsage(programName);
+  std::cerr << "Benchmark options:\n"
+            << "  --warmup N              Unmeasured frames before sampling (default 60)\n"
+            << "  --duration SECONDS      Measure for a fixed time instead of --frames\n"
+            << "  --json PATH             Output file (default bench_results.json)\n"
+            << "  --label TEXT            Tag stored in the JSON report\n"
+            << "  --suite NAME            frames (default), rendergraph (headless device), or CPU-only allocator, jobs, barriers, bindless, meshload, meshopt, streaming, textures or shaders\n"
+            << "  --iterations N          Samples for CPU-only suites (default 1000)\n";
+}
+
+// A measurement time: the whole value must parse to a finite, positive number
+double ParseSeconds(std::string_view option, const char* value)
+{
+  if (value == nullptr)
+  {
+    throw std::runtime_error("Missing value for " + std::string(option));
+  }
+  double seconds = 0.0;
+  size_t pos = 0;
+  try
+  {
+    seconds = std::stod(value, &pos);
+  }
+  catch (const std::exception&)
+  {
+    pos = 0;
+  }
+  if (pos == 0 || value[pos] != '\0' || !std::isfinite(seconds) || seconds <= 0.0)
+  {
+    throw std::runtime_error("Invalid value for " + std::string(option) + ": " + value);
+  }
+  return seconds;
+}
+
+BenchOptions ParseBenchOptions(int argc, char** argv)
+{
+  BenchOptions options;
+  for (int i = 1; i < argc; i++)
+  {
+    std::string_view arg = argv[i];
+    const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    bool hasValue = next != nullptr;
+
+    if (arg == "--warmup") { options.warmupFrames = ParseUnsigned(arg, next); i++; }
+    else if (arg == "--duration") { options.durationSeconds = ParseSeconds(arg, next); i++; }
+    else if (arg == "--json" && hasValue) { options.jsonPath = next; i++; }
+    else if (arg == "--label" && hasValue) { options.label = next; i++; }
+    else if (arg == "--suite" && hasValue) { options.suite = next; i++; }
+    else if (arg == "--iterations") { options.iterations = ParseUnsigned(arg, next); i++; }
+    else if (!ParseAppOption(options.app, i, argc, argv))
+    {
+      throw std::runtime_error("Unknown or incomplete argument: " + std::string(arg));
+    }
+  }
+
+  // A benchmark always terminates: default to a frame count unless timed
+  if (!options.app.frameCount)
+  {
+    options.app.frameCount = options.durationSeconds > 0.0 ? 0 : DEFAULT_BENCH_FRAMES;
+  }
+  FinalizeAppConfig(options.app);
+  if (options.suite != "frames" && options.suite != "allocator" && options.suite != "jobs" &&
+      options.suite != "rendergraph" &&
+      options.suite != "barriers" && options.suite != "bindless" && options.suite != "meshload" &&
+      options.suite != "meshopt" && options.suite != "streaming" && options.suite != "textures" &&
+      options.suite != "shaders")
+  {
+    throw std::runtime_error("Unknown suite: " + options.suite);
+  }
+  return options;
+}
+
+const char* PresentModeName(VkPresentModeKHR mode)
+{
+  switch (mode)
+  {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR: return "immediate";
+    case VK_PRESENT_MODE_MAILBOX_KHR: return "mailbox";
+    case VK_PRESENT_MODE_FIFO_KHR: return "fifo";
+    default: return "other";
+  }
+}
+
+int WriteReport(const BenchOptions& options, const BenchReport& report)
+{
+  VulkanApp::Bench::PrintReport(report);
+
+  std::ofstream jsonFile(options.jsonPath);
+  if (!jsonFile)
+  {
+    std::cerr << "Failed to open " << options.jsonPath << " for writing." << std::endl;
+    return EXIT_FAILURE;
+  }
+  VulkanApp::Bench::WriteJsonReport(jsonFile, report);
+  std::cout << "\nJSON report written to " << options.jsonPath << std::endl;
+  return EXIT_SUCCESS;
+}
+
+// Suites without a window: CPU-only, except that rendergraph creates a headless device
+int RunCpuSuite(const BenchOptions& options)
+{
+  BenchReport report;
+  report.config = {
+      {"label", options.label},
+      {"suite", options.suite},
+      {"iterations", std::to_string(options.iterations)},
+  };
+
+  bool passed = false;
+  if (options.suite == "jobs")
+  {
+    passed = VulkanApp::Bench::RunJobSuite(report, options.iterations);
+  }
+  else if (options.suite == "rendergraph")
+  {
+    passed = VulkanApp::Bench::RunRenderGraphSuite(report, options.iterations);
+  }
+  else if (options.suite == "barriers")
+  {
+    passed = VulkanApp::Bench::RunBarrierSuite(report, options.iterations);
+  }
+  else if (options.suite == "bindless")
+  {
+    passed = VulkanApp::Bench::RunBindlessSuite(report, options.iterations);
+  }
+  else if (options.suite == "meshload")
+  {
+    passed = VulkanApp::Bench::RunMeshLoadSuite(report, options.iterations);
+  }
+  else if (options.suite == "meshopt")
+  {
+    passed = VulkanApp::Bench::RunMeshOptSuite(report, options.iterations);
+  }
+  else if (options.suite == "streaming")
+  {
+    passed = VulkanApp::Bench::RunStreamingSuite(report, options.iterations);
+  }
+  else if (options.suite == "textures")
+  {
+    passed = VulkanApp::Bench::RunTextureSuite(report, options.iterations);
+  }
+  else if (options.suite == "shaders")
+  {
+    passed = VulkanApp::Bench::RunShaderSuite(report, options.iterations);
+  }
+  else
+  {
+    passed = VulkanApp::Bench::RunAllocatorSuite(report, options.iterations);
+  }
+
+  int result = WriteReport(options, report);
+  return passed ? result : EXIT_FAILURE;
+}
+
+int RunBenchmark(const BenchOptions& options)
+{
+  const AppConfig& config = options.app;
+  const uint32_t frameCount = *config.frameCount; // Set by ParseBenchOptions
+
+  // Same construction order as Application::InitVulkan
+  std::unique_ptr<Window> window;
+  if (!config.headless)
+  {
+    window = std::make_unique<Window>(config.width, config.height, "Vulkan App Bench");
+  }
+  VulkanInstance instance(window.get());
+  VulkanDevice device(instance);
+  VulkanPipelineCache pipelineCache(device, config.pipelineCachePath);
+  JobSystem jobSystem(config.jobThreads);
+
+  std::unique_ptr<PresentTarget> presentTarget;
+  if (config.headless)
+  {
+    presentTarget = std::make_unique<VulkanOffscreenTarget>(
+        device, VkExtent2D{config.width, config.height}, config.framesInFlight);
+  }
+  else
+  {
+    presentTarget = std::make_unique<VulkanSwapChain>(device, *window, instance.getSurface(), config.presentMode,
+                                                      config.swapchainImages);
+  }
+
+  VulkanApp::Rendering::RendererSettings settings;
+  settings.maxFramesInFlight = config.framesInFlight;
+  settings.drawCount = config.drawCount;
+  settings.pipelineCompileThreads = config.pipelineCompileThreads;
+  settings.lowLatency = config.lowLatency;
+  settings.dynamicRendering = config.dynamicRendering;
+  settings.gpuCulling = config.gpuCulling;
+  settings.bindless = config.bindless;
+  settings.stressInstances = config.stressInstances;
+  settings.stressGpuAnimation = config.stressGpuAnimation;
+  settings.streamBudget = static_cast<uint64_t>(config.streamBudgetMiB) * 1024 * 1024;
+  VulkanApp::Rendering::Renderer renderer(device, *presentTarget, pipelineCache, jobSystem, settings);
+  renderer.Init();
+
+  MetricSeries cpuFrame{"cpu_frame_ms", {}};
+  MetricSeries fenceWait{"fence_wait_ms", {}};
+  MetricSeries acquire{"acquire_ms", {}};
+  MetricSeries sceneUpdate{"scene_update_ms", {}}; // Stress scene CPU animation
+  MetricSeries streamUpdate{"stream_update_ms", {}}; // AssetStreamer hand-off to uploads
+  MetricSeries record{"record_ms", {}};
+  MetricSeries submit{"submit_ms", {}};
+  MetricSeries present{"present_ms", {}};
+  MetricSeries gpu{"gpu_ms", {}};
+  MetricSeries pacingWait{"pacing_wait_ms", {}};
+  MetricSeries inputLatency{"input_latency_ms", {}}; // Input sampled -> on screen (or GPU done)
+  std::vector<MetricSeries> gpuScopes; // "gpu_<scope>_ms", in first-seen order
+
+  std::cout << "Benchmark: " << options.warmupFrames << " warmup frames, then ";
+  if (frameCount != 0) std::cout << frameCount << " frames" << std::endl;
+  else std::cout << options.durationSeconds << " seconds" << std::endl;
+
+  uint32_t frame = 0;
+  uint32_t measuredFrames = 0;
+  uint32_t framesWithoutPipeline = 0;
+  Clock::time_point measureStart = Clock::now();
+  while (!window || !window->shouldClose())
+  {
+    bool measuring = frame >= options.warmupFrames;
+    if (measuring && measuredFrames == 0)
+    {
+      measureStart = Clock::now();
+    }
+    if (measuring)
+    {
+      double elapsed = std::chrono::duration<double>(Clock::now() - measureStart).count();
+      if (frameCount != 0 ? measuredFrames >= frameCount : elapsed >= options.durationSeconds)
+      {
+        break;
+      }
+    }
+
+    // Pacing sleeps are reported separately, not as CPU frame time
+    renderer.PaceFrameStart();
+    auto frameStart = Clock::now();
+    if (window)
+    {
+      glfwPollEvents();
+    }
+    renderer.MarkInputSampled();
+    renderer.DrawFrame();
+    if (renderer.GetLastFrameTimings().drawsSkipped)
+    {
+      framesWithoutPipeline++; // Includes warmup: this is the startup hitch being hidden
+    }
+    double frameMs = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+
+    if (measuring)
+    {
+      const auto& timings = renderer.GetLastFrameTimings();
+      cpuFrame.samples.push_back(frameMs);
+      fenceWait.samples.push_back(timings.fenceWaitMs);
+      acquire.samples.push_back(timings.acquireMs);
+      if (renderer.GetStressScene())
+      {
+        sceneUpdate.samples.push_back(timings.sceneUpdateMs);
+      }
+      streamUpdate.samples.push_back(timings.streamUpdateMs);
+      record.samples.push_back(timings.recordMs);
+      submit.samples.push_back(timings.submitMs);
+      present.samples.push_back(timings.presentMs);
+      pacingWait.samples.push_back(timings.pacingWaitMs);
+      if (timings.latencyValid)
+      {
+        inputLatency.samples.push_back(timings.inputLatencyMs);
+      }
+      if (timings.gpuValid)
+      {
+        gpu.samples.push_back(timings.gpuMs);
+        for (const auto& scope : renderer.GetGpuProfiler().GetLatestFrame()->scopes)
+        {
+          std::string name = "gpu_" + scope.name + "_ms";
+          auto it = std::find_if(gpuScopes.begin(), gpuScopes.end(),
+                                 [&](const MetricSeries& series) { return series.name == name; });
+          if (it == gpuScopes.end())
+          {
+            it = gpuScopes.insert(gpuScopes.end(), MetricSeries{name, {}});
+          }
+          it->samples.push_back(scope.gpuMs);
+        }
+      }
+      measuredFrames++;
+    }
+    frame++;
+  }
+  double measuredSeconds = std::chrono::duration<double>(Clock::now() - measureStart).count();
+  vkDeviceWaitIdle(device.getDevice());
+
+  const VulkanApp::Rendering::GpuCuller* gpuCuller = renderer.GetGpuCuller();
+  const VulkanApp::Rendering::StressScene* stressScene = renderer.GetStressScene();
+  const VulkanApp::Assets::AssetStreamer::Stats streamStats = renderer.GetAssetStreamer().GetStats();
+  BenchReport report;
+  report.config = {
+      {"label", options.label},
+      {"device", device.getProperties().deviceName},
+      {"headless", config.headless ? "true" : "false"},
+      {"resolution", std::to_string(config.width) + "x" + std::to_string(config.height)},
+      {"frames_in_flight", std::to_string(config.framesInFlight)},
+      {"present_mode", config.headless ? "offscreen" : PresentModeName(config.presentMode)},
+      {"swapchain_images", std::to_string(presentTarget->getImages().size())},
+      {"low_latency", config.lowLatency ? "true" : "false"},
+      {"present_wait", renderer.GetFramePacer().UsesPresentWait() ? "true" : "false"},
+      {"dynamic_rendering", renderer.GetRenderGraph().UsesDynamicRendering() ? "true" : "false"},
+      {"draw_count", std::to_string(config.drawCount)},
+      {"gpu_culling", gpuCuller ? "true" : "false"},
+      {"draw_indirect_count", gpuCuller && gpuCuller->GetStats().drawIndirectCount ? "true" : "false"},
+      {"bindless", renderer.GetBindlessTable() ? "true" : "false"},
+      {"visible_objects", gpuCuller ? std::to_string(gpuCuller->GetStats().visibleObjects) : "n/a"},
+      {"stress_instances", std::to_string(stressScene ? stressScene->GetStats().instances : 0)},
+      {"stress_animation", stressScene ? (stressScene->GetStats().gpuAnimation ? "gpu" : "cpu") : "n/a"},
+      {"stress_bytes_per_frame", stressScene ? std::to_string(stressScene->GetStats().bytesPerFrame) : "n/a"},
+      {"stream_budget_mb", std::to_string(config.streamBudgetMiB)},
+      {"streamed_assets", std::to_string(streamStats.completed)},
+      {"stream_latency_max_ms", std::to_string(streamStats.latencyMaxMs)},
+      // Run twice to compare: the first run writes the cache, the second starts warm
+      {"pipeline_cache", config.pipelineCachePath.empty() ? "disabled" : (pipelineCache.isWarm() ? "warm" : "cold")},
+      {"pipeline_creation_ms", std::to_string(renderer.GetPipelineCreationMs())},
+      {"compile_threads", std::to_string(renderer.GetPipelineCompiler().GetThreadCount())},
+      {"frames_without_pipeline", std::to_string(framesWithoutPipeline)},
+      {"record_threads", std::to_string(renderer.GetRecordThreadCount())},
+      {"jobs_stolen", std::to_string(jobSystem.GetStats().jobsStolen)},
+      {"device_memory_objects", std::to_string(device.getAllocator().getStats().deviceMemoryCount)},
+      {"warmup_frames", std::to_string(options.warmupFrames)},
+      {"measured_frames", std::to_string(measuredFrames)},
+      {"measured_seconds", std::to_string(measuredSeconds)},
+      {"fps", std::to_string(measuredSeconds > 0.0 ? measuredFrames / measuredSeconds : 0.0)},
+  };
+  for (const MetricSeries* series : {&cpuFrame, &fenceWait, &acquire, &sceneUpdate, &streamUpdate, &record, &submit,
+                                       &present, &gpu, &pacingWait, &inputLatency})
+  {
+    report.metrics.emplace_back(series->name, VulkanApp::Bench::Summarize(series->samples));
+  }
+  for (const MetricSeries& series : gpuScopes)
+  {
+    report.metrics.emplace_back(series.name, VulkanApp::Bench::Summarize(series.samples));
+  }
+
+  return WriteReport(options, report);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  BenchOptions options;
+  try
+  {
+    options = ParseBenchOptions(argc, argv);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    PrintBenchUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    return options.suite == "frames" ? RunBenchmark(options) : RunCpuSuite(options);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "FATAL ERROR: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,116 @@
+// Bindless suite: the BindlessTable's slot free lists (no device). Checks
+// that released slots are reused most recent first, that a full array and a
+// release of a handle that is not live are rejected, double releases included,
+// then times register/release churn on an array the size of the table's
+// storage buffer array.
+
+#include "CpuSuites.h"
+
+#include "rendering/BindlessTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using VulkanApp::Rendering::BindlessHandle;
+using VulkanApp::Rendering::BindlessSlotArray;
+using VulkanApp::Rendering::BindlessTable;
+
+constexpr uint32_t CHURN_LIVE = 16384;     // Handles kept registered during the churn
+constexpr uint32_t CHURN_OPERATIONS = 4096; // Release/register pairs per sample
+
+constexpr const char* SUITE = "Bindless";
+
+bool RunSlotChecks()
+{
+  bool passed = true;
+  BindlessSlotArray slots(4);
+  const BindlessHandle first = slots.Allocate("test");
+  const BindlessHandle second = slots.Allocate("test");
+  const BindlessHandle third = slots.Allocate("test");
+  passed &= Check(SUITE, first == 0 && second == 1 && third == 2, "fresh slots are handed out in order");
+  passed &= Check(SUITE, slots.GetLiveCount() == 3 && slots.IsLive(second), "registered slots are live");
+
+  slots.Free(second);
+  passed &= Check(SUITE, !slots.IsLive(second) && slots.GetLiveCount() == 2, "released slot is no longer live");
+  passed &= Check(SUITE, Throws([&] { slots.Free(second); }), "rejects a double release");
+  passed &= Check(SUITE, slots.GetLiveCount() == 2, "a rejected release leaves the count alone");
+  passed &= Check(SUITE, slots.Allocate("test") == second, "released slot is reused first");
+  passed &= Check(SUITE, slots.Allocate("test") == 3, "then the array grows");
+  passed &= Check(SUITE, Throws([&] { slots.Allocate("test"); }), "rejects a full array");
+
+  BindlessSlotArray fresh(4);
+  fresh.Allocate("test");
+  passed &= Check(SUITE, Throws([&] { fresh.Free(2); }), "rejects a handle that was never registered");
+  passed &= Check(SUITE, Throws([&] { fresh.Free(Rendering::INVALID_BINDLESS_HANDLE); }), "rejects the invalid handle");
+
+  // Two releases of one handle must never give two owners the same slot
+  BindlessSlotArray shared(8);
+  const BindlessHandle handle = shared.Allocate("test");
+  shared.Free(handle);
+  Throws([&] { shared.Free(handle); });
+  const BindlessHandle a = shared.Allocate("test");
+  const BindlessHandle b = shared.Allocate("test");
+  passed &= Check(SUITE, a != b && shared.IsLive(a) && shared.IsLive(b), "double release does not duplicate a slot");
+  return passed;
+}
+
+// Releases a random live handle and registers a new one, as streaming assets
+// come and go; returns ns per pair
+double RunChurn(BindlessSlotArray& slots, std::vector<BindlessHandle>& live, std::mt19937& rng)
+{
+  auto start = Clock::now();
+  for (uint32_t i = 0; i < CHURN_OPERATIONS; i++)
+  {
+    BindlessHandle& handle = live[rng() % live.size()];
+    slots.Free(handle);
+    handle = slots.Allocate("storage buffer");
+  }
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / CHURN_OPERATIONS;
+}
+
+} // namespace
+
+bool RunBindlessSuite(BenchReport& report, uint32_t iterations)
+{
+  bool passed = RunSlotChecks();
+  if (!passed)
+  {
+    std::cerr << "Bindless slot checks FAILED" << std::endl;
+  }
+
+  BindlessSlotArray slots(BindlessTable::MAX_STORAGE_BUFFERS);
+  std::vector<BindlessHandle> live(CHURN_LIVE);
+  for (BindlessHandle& handle : live)
+  {
+    handle = slots.Allocate("storage buffer");
+  }
+  MetricSeries churnTime{"slot_churn_ns", {}};
+  std::mt19937 rng(1234);
+  for (uint32_t sample = 0; sample < iterations; sample++)
+  {
+    churnTime.samples.push_back(RunChurn(slots, live, rng));
+  }
+  // LIFO reuse keeps the live slots packed into the first CHURN_LIVE
+  const BindlessHandle highest = *std::max_element(live.begin(), live.end());
+  passed &= Check(SUITE, slots.GetLiveCount() == CHURN_LIVE && highest < CHURN_LIVE, "churn keeps the array dense");
+
+  report.config.emplace_back("capacity", std::to_string(slots.GetCapacity()));
+  report.config.emplace_back("live_handles", std::to_string(CHURN_LIVE));
+  report.config.emplace_back("churn_per_sample", std::to_string(CHURN_OPERATIONS));
+  report.config.emplace_back("highest_slot", std::to_string(highest));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(churnTime.name, Summarize(churnTime.samples));
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "FrameStats.h"
+
+namespace VulkanApp::Bench {
+
+// CPU-only benchmark suites selected with --suite. They need no GPU, run the
+// engine's algorithms on synthetic workloads and also check their invariants:
+// each returns false (and the bench exits non-zero) if a check failed.
+
+// One invariant of a suite: reports it on stderr, prefixed by the suite's
+// name, if it does not hold, and returns condition so checks can be and-ed
+inline bool Check(const char* suite, bool condition, const char* what)
+{
+  if (!condition)
+  {
+    std::cerr << suite << " check failed: " << what << std::endl;
+  }
+  return condition;
+}
+
+// True if function throws std::runtime_error, which is how the engine rejects bad input
+template <typename Function>
+bool Throws(Function&& function)
+{
+  try
+  {
+    function();
+  }
+  catch (const std::runtime_error&)
+  {
+    return true;
+  }
+  return false;
+}
+
+// Milliseconds since start, on the clock every suite times with
+inline double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A report value with a fixed number of decimals
+inline std::string Format(double value, int decimals = 2)
+{
+  std::ostringstream text;
+  text << std::fixed << std::setprecision(decimals) << value;
+  return text.str();
+}
+
+// TLSF placement: alloc/free latency, fragmentation under churn, coalescing
+bool RunAllocatorSuite(BenchReport& report, uint32_t iterations);
+
+// JobSystem: per-job overhead, dependency chains, ParallelFor scaling by thread count
+bool RunJobSuite(BenchReport& report, uint32_t iterations);
+
+// RenderGraph: culling, aliasing and first-use barrier checks, steady and recompile cost.
+// Unlike the others it needs a GPU: it creates a headless device.
+bool RunRenderGraphSuite(BenchReport& report, uint32_t iterations);
+
+// BarrierBatcher: state-tracking checks, Use* cost and barriers per sync point
+bool RunBarrierSuite(BenchReport& report, uint32_t iterations);
+
+// BindlessTable slots: reuse, exhaustion and double-release checks, register/release churn cost
+bool RunBindlessSuite(BenchReport& report, uint32_t iterations);
+
+// Mesh loading: OBJ parse against mapped .vkmesh, format round trip and rejection checks
+bool RunMeshLoadSuite(BenchReport& report, uint32_t iterations);
+
+// MeshOptimizer: ACMR, ATVR and overfetch before and after, quantization error, optimization cost
+bool RunMeshOptSuite(BenchReport& report, uint32_t iterations);
+
+// AssetStreamer: priority, cancellation and budget checks, Update cost, latency and queue depth
+bool RunStreamingSuite(BenchReport& report, uint32_t iterations);
+
+// Textures: KTX2 round trip and rejection checks, BCn decode checks, parse and CPU decode cost
+bool RunTextureSuite(BenchReport& report, uint32_t iterations);
+
+// Shaders: SPIR-V reflection and .vkshaders round trip and rejection checks, reflection and archive load cost
+bool RunShaderSuite(BenchReport& report, uint32_t iterations);
+
+} // namespace VulkanApp::Bench
@@ -0,0 +1,129 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+namespace VulkanApp::Bench {
+
+namespace
+{
+std::string EscapeJson(const std::string& text)
+{
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (char c : text)
+  {
+    switch (c)
+    {
+      case '"': escaped += "\\\""; break;
+      case '\\': escaped += "\\\\"; break;
+      case '\n': escaped += "\\n"; break;
+      case '\t': escaped += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+          escaped += buffer;
+        }
+        else
+        {
+          escaped += c;
+        }
+    }
+  }
+  return escaped;
+}
+
+// JSON has no NaN/Inf, so empty metrics report zeros
+double JsonNumber(double value)
+{
+  return std::isfinite(value) ? value : 0.0;
+}
+} // namespace
+
+double Percentile(const std::vector<double>& sorted, double p)
+{
+  if (sorted.empty())
+  {
+    return 0.0;
+  }
+  double rank = std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(sorted.size() - 1);
+  size_t lower = static_cast<size_t>(std::floor(rank));
+  size_t upper = std::min(lower + 1, sorted.size() - 1);
+  double fraction = rank - static_cast<double>(lower);
+  return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+}
+
+StatSummary Summarize(std::vector<double> samples)
+{
+  StatSummary summary;
+  summary.count = samples.size();
+  if (samples.empty())
+  {
+    return summary;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  summary.min = samples.front();
+  summary.max = samples.back();
+  summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+  summary.p50 = Percentile(samples, 50.0);
+  summary.p95 = Percentile(samples, 95.0);
+  summary.p99 = Percentile(samples, 99.0);
+  return summary;
+}
+
+void WriteJsonReport(std::ostream& out, const BenchReport& report)
+{
+  out << std::setprecision(6) << std::fixed;
+  out << "{\n  \"config\": {";
+  for (size_t i = 0; i < report.config.size(); i++)
+  {
+    out << (i ? ",\n    " : "\n    ") << '"' << EscapeJson(report.config[i].first) << "\": \""
+        << EscapeJson(report.config[i].second) << '"';
+  }
+  out << "\n  },\n  \"metrics\": {";
+  for (size_t i = 0; i < report.metrics.size(); i++)
+  {
+    const StatSummary& s = report.metrics[i].second;
+    out << (i ? ",\n    " : "\n    ") << '"' << EscapeJson(report.metrics[i].first) << "\": {"
+        << "\"count\": " << s.count
+        << ", \"min\": " << JsonNumber(s.min)
+        << ", \"mean\": " << JsonNumber(s.mean)
+        << ", \"p50\": " << JsonNumber(s.p50)
+        << ", \"p95\": " << JsonNumber(s.p95)
+        << ", \"p99\": " << JsonNumber(s.p99)
+        << ", \"max\": " << JsonNumber(s.max) << "}";
+  }
+  out << "\n  }\n}\n";
+}
+
+void PrintReport(const BenchReport& report)
+{
+  std::cout << "\n--- Benchmark Configuration ---" << std::endl;
+  for (const auto& [key, value] : report.config)
+  {
+    std::cout << "  " << std::left << std::setw(20) << key << value << std::endl;
+  }
+
+  std::cout << "\n--- Results (units in metric names) ---" << std::endl;
+  std::cout << std::left << std::setw(20) << "metric" << std::right
+            << std::setw(8) << "count" << std::setw(10) << "min" << std::setw(10) << "mean"
+            << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99"
+            << std::setw(10) << "max" << std::endl;
+  std::cout << std::fixed << std::setprecision(3);
+  for (const auto& [name, s] : report.metrics)
+  {
+    std::cout << std::left << std::setw(20) << name << std::right
+              << std::setw(8) << s.count << std::setw(10) << s.min << std::setw(10) << s.mean
+              << std::setw(10) << s.p50 << std::setw(10) << s.p95 << std::setw(10) << s.p99
+              << std::setw(10) << s.max << std::endl;
+  }
+}
+
+} // namespace VulkanApp::Bench
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+// Distribution summary of one metric, all values in the metric's unit
+struct StatSummary
+{
+  size_t count = 0;
+  double min = 0.0;
+  double mean = 0.0;
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+  double max = 0.0;
+};
+
+// Per-frame samples of a named metric (e.g. "cpu_frame_ms")
+struct MetricSeries
+{
+  std::string name;
+  std::vector<double> samples;
+};
+
+// Linearly interpolated percentile (p in [0, 100]) of an ascending-sorted range
+double Percentile(const std::vector<double>& sorted, double p);
+
+// Sorts a copy of the samples and computes min/mean/percentiles/max
+StatSummary Summarize(std::vector<double> samples);
+
+// Everything needed to compare a run against another commit
+struct BenchReport
+{
+  std::vector<std::pair<std::string, std::string>> config; // Pre-formatted values
+  std::vector<std::pair<std::string, StatSummary>> metrics;
+};
+
+// Machine-readable output: {"config": {...}, "metrics": {"name": {"min": ...}}}
+void WriteJsonReport(std::ostream& out, const BenchReport& report);
+
+// Human-readable table on stdout
+void PrintReport(const BenchReport& report);
+
+} // namespace VulkanApp::Bench
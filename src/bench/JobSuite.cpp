@@ -0,0 +1,205 @@
+// Job suite: per-job overhead of JobSystem (queue, steal, counter), dependency
+// chain latency, and ParallelFor scaling with worker count on a fixed
+// CPU-bound workload. Checks that every job runs exactly once, that RunAfter
+// ordering holds and that parallel results match the serial ones.
+
+#include "CpuSuites.h"
+
+#include "core/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t JOBS_PER_SAMPLE = 1000;
+constexpr uint32_t CHAIN_LENGTH = 100;
+constexpr uint32_t SCALING_ELEMENTS = 1u << 18;
+constexpr uint32_t SCALING_GRAIN = 1024;
+
+double NanosecondsSince(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// Stand-in for per-element engine work (culling, transforms): ~tens of ns each
+double ElementWork(uint32_t i)
+{
+  double x = static_cast<double>(i) * 0.001;
+  return std::sqrt(x) * std::sin(x) + std::cos(x * 0.5);
+}
+
+// Empty jobs from the main thread, which helps while waiting
+bool MeasureOverhead(JobSystem& jobs, uint32_t iterations, MetricSeries& overhead)
+{
+  std::atomic<uint32_t> executed{0};
+  for (uint32_t sample = 0; sample < iterations; sample++)
+  {
+    executed = 0;
+    JobCounter counter;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < JOBS_PER_SAMPLE; i++)
+    {
+      jobs.Run([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); }, &counter);
+    }
+    jobs.Wait(counter);
+    overhead.samples.push_back(NanosecondsSince(start) / JOBS_PER_SAMPLE);
+    if (executed != JOBS_PER_SAMPLE)
+    {
+      std::cerr << "Job system ran " << executed << " of " << JOBS_PER_SAMPLE << " jobs" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Each link is queued with RunAfter on the previous link's counter
+bool MeasureChain(JobSystem& jobs, uint32_t iterations, MetricSeries& chainLatency)
+{
+  std::atomic<bool> ordered{true};
+  for (uint32_t sample = 0; sample < iterations && ordered; sample++)
+  {
+    std::vector<JobCounter> links(CHAIN_LENGTH);
+    std::atomic<uint32_t> next{0};
+    auto link = [&next, &ordered](uint32_t index) {
+      if (next.fetch_add(1) != index)
+      {
+        ordered = false;
+      }
+    };
+
+    auto start = Clock::now();
+    jobs.Run([&link]() { link(0); }, &links[0]);
+    for (uint32_t i = 1; i < CHAIN_LENGTH; i++)
+    {
+      jobs.RunAfter(links[i - 1], [&link, i]() { link(i); }, &links[i]);
+    }
+    jobs.Wait(links.back());
+    chainLatency.samples.push_back(NanosecondsSince(start) / CHAIN_LENGTH);
+    for (JobCounter& counter : links)
+    {
+      jobs.Wait(counter); // All done already; makes destroying them safe
+    }
+  }
+  if (!ordered)
+  {
+    std::cerr << "RunAfter chain executed out of order" << std::endl;
+  }
+  return ordered.load();
+}
+
+// The same ParallelFor workload per worker count; reported per count so the
+// speed-up curve can be read off the metrics
+bool MeasureScaling(uint32_t workerCount, uint32_t iterations, double expected, MetricSeries& series)
+{
+  JobSystem jobs(workerCount);
+  std::vector<double> partials(SCALING_ELEMENTS / SCALING_GRAIN + 1);
+  bool matches = true;
+  for (uint32_t sample = 0; sample < iterations; sample++)
+  {
+    std::fill(partials.begin(), partials.end(), 0.0);
+    JobCounter counter;
+    auto start = Clock::now();
+    jobs.ParallelFor(SCALING_ELEMENTS, SCALING_GRAIN, [&partials](uint32_t begin, uint32_t end) {
+      double sum = 0.0;
+      for (uint32_t i = begin; i < end; i++)
+      {
+        sum += ElementWork(i);
+      }
+      partials[begin / SCALING_GRAIN] = sum;
+    }, counter);
+    jobs.Wait(counter);
+    series.samples.push_back(NanosecondsSince(start) / 1e6);
+
+    double total = 0.0;
+    for (double partial : partials)
+    {
+      total += partial;
+    }
+    // Same ranges summed in the same order as the serial reference
+    if (total != expected)
+    {
+      matches = false;
+    }
+  }
+  if (!matches)
+  {
+    std::cerr << "ParallelFor result differs from the serial result with " << workerCount << " workers" << std::endl;
+  }
+  return matches;
+}
+
+} // namespace
+
+bool RunJobSuite(BenchReport& report, uint32_t iterations)
+{
+  bool passed = true;
+  uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  MetricSeries overhead{"job_overhead_ns", {}};
+  MetricSeries chainLatency{"job_chain_link_ns", {}};
+  JobSystem::Stats stats;
+  uint32_t defaultWorkers = 0;
+  {
+    JobSystem jobs;
+    defaultWorkers = jobs.GetWorkerCount();
+    passed = MeasureOverhead(jobs, iterations, overhead) && passed;
+    passed = MeasureChain(jobs, iterations, chainLatency) && passed;
+    stats = jobs.GetStats();
+  }
+
+  // Serial reference, summed per grain like the parallel version
+  double expected = 0.0;
+  for (uint32_t begin = 0; begin < SCALING_ELEMENTS; begin += SCALING_GRAIN)
+  {
+    double sum = 0.0;
+    for (uint32_t i = begin; i < std::min(begin + SCALING_GRAIN, SCALING_ELEMENTS); i++)
+    {
+      sum += ElementWork(i);
+    }
+    expected += sum;
+  }
+
+  // 1, 2, 4, ... workers plus the main thread, up to all hardware threads
+  std::vector<MetricSeries> scaling;
+  uint32_t scalingIterations = std::max(1u, iterations / 10);
+  for (uint32_t workers = 1;; workers = std::min(workers * 2, hardwareThreads - 1))
+  {
+    scaling.push_back({"parallel_for_" + std::to_string(workers + 1) + "t_ms", {}});
+    passed = MeasureScaling(workers, scalingIterations, expected, scaling.back()) && passed;
+    if (workers + 1 >= hardwareThreads)
+    {
+      break;
+    }
+  }
+
+  report.config.emplace_back("hardware_threads", std::to_string(hardwareThreads));
+  report.config.emplace_back("default_workers", std::to_string(defaultWorkers));
+  report.config.emplace_back("jobs_per_sample", std::to_string(JOBS_PER_SAMPLE));
+  report.config.emplace_back("chain_length", std::to_string(CHAIN_LENGTH));
+  report.config.emplace_back("parallel_for_elements", std::to_string(SCALING_ELEMENTS));
+  report.config.emplace_back("parallel_for_grain", std::to_string(SCALING_GRAIN));
+  report.config.emplace_back("jobs_executed", std::to_string(stats.jobsExecuted));
+  report.config.emplace_back("jobs_stolen", std::to_string(stats.jobsStolen));
+  report.config.emplace_back("worker_sleeps", std::to_string(stats.workerSleeps));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(overhead.name, Summarize(overhead.samples));
+  report.metrics.emplace_back(chainLatency.name, Summarize(chainLatency.samples));
+  for (const MetricSeries& series : scaling)
+  {
+    report.metrics.emplace_back(series.name, Summarize(series.samples));
+  }
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
@@ -0,0 +1,301 @@
+// Mesh load suite: level-load cost of a mesh as OBJ text against the same
+// mesh as a .vkmesh. Writes a synthetic grid OBJ to the temp directory,
+// converts it, checks the round trip and that damaged files are rejected, then
+// times reading + parsing the OBJ against mapping + validating the .vkmesh and
+// copying its sections into a staging-sized buffer (what GpuMesh hands the
+// UploadManager). Both files are read from a warm page cache.
+
+#include "CpuSuites.h"
+
+#include "assets/MeshFile.h"
+#include "assets/ObjParser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace VulkanApp::Assets;
+
+constexpr uint32_t GRID_SIZE = 320;   // Quads per side: 103k vertices, so the indices stay 32-bit
+constexpr uint32_t MAX_SAMPLES = 100; // Each sample parses the whole OBJ
+
+constexpr const char* SUITE = "Mesh load";
+
+// A wavy grid with positions, texcoords and normals, as exporters write it:
+// one v/vt/vn per grid point, quads as faces, two material groups
+std::string MakeGridObj(uint32_t size)
+{
+  std::ostringstream obj;
+  obj << std::fixed << std::setprecision(6) << "# Synthetic grid\n";
+  for (uint32_t y = 0; y <= size; y++)
+  {
+    for (uint32_t x = 0; x <= size; x++)
+    {
+      float u = static_cast<float>(x) / size;
+      float v = static_cast<float>(y) / size;
+      obj << "v " << u * 10.0f << ' ' << 0.1f * ((x * 7 + y * 13) % 17) << ' ' << v * 10.0f << '\n';
+      obj << "vt " << u << ' ' << v << '\n';
+      obj << "vn 0.000000 1.000000 0.000000\n";
+    }
+  }
+  for (uint32_t y = 0; y < size; y++)
+  {
+    if (y == 0 || y == size / 2)
+    {
+      obj << "usemtl " << (y == 0 ? "ground" : "rock") << '\n';
+    }
+    for (uint32_t x = 0; x < size; x++)
+    {
+      uint32_t a = y * (size + 1) + x + 1;
+      uint32_t b = a + 1;
+      uint32_t c = a + size + 2;
+      uint32_t d = a + size + 1;
+      obj << "f " << a << '/' << a << '/' << a << ' ' << b << '/' << b << '/' << b << ' ' << c << '/' << c << '/'
+          << c << ' ' << d << '/' << d << '/' << d << '\n';
+    }
+  }
+  return obj.str();
+}
+
+std::vector<char> ReadWholeFile(const std::string& path)
+{
+  std::ifstream file(path, std::ios::ate | std::ios::binary);
+  if (!file)
+  {
+    throw std::runtime_error("Failed to open file: " + path);
+  }
+  std::vector<char> bytes(static_cast<size_t>(file.tellg()));
+  file.seekg(0);
+  file.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  return bytes;
+}
+
+void WriteWholeFile(const std::string& path, const char* data, size_t size)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(data, static_cast<std::streamsize>(size));
+}
+
+bool Rejects(const std::string& path)
+{
+  try
+  {
+    MeshFile file(path);
+  }
+  catch (const std::runtime_error&)
+  {
+    return true;
+  }
+  return false;
+}
+
+bool SameMesh(const MeshData& mesh, const MeshFile& file)
+{
+  if (file.GetVertexCount() != mesh.vertexCount || file.GetIndexCount() != mesh.indices.size() ||
+      file.GetStreams().size() != mesh.streams.size() || file.GetSubmeshes().size() != mesh.submeshes.size())
+  {
+    return false;
+  }
+  std::span<const std::byte> indexData = file.GetIndexData();
+  for (size_t i = 0; i < mesh.indices.size(); i++)
+  {
+    uint32_t index = 0;
+    if (file.GetIndexType() == IndexType::Uint16)
+    {
+      uint16_t narrow = 0;
+      std::memcpy(&narrow, indexData.data() + i * 2, 2);
+      index = narrow;
+    }
+    else
+    {
+      std::memcpy(&index, indexData.data() + i * 4, 4);
+    }
+    if (index != mesh.indices[i]) return false;
+  }
+  for (const MeshData::Stream& stream : mesh.streams)
+  {
+    const MeshStreamDesc* desc = file.FindStream(stream.semantic);
+    if (desc == nullptr) return false;
+    std::span<const std::byte> data = file.GetStreamData(*desc);
+    if (data.size() != stream.data.size() || std::memcmp(data.data(), stream.data.data(), data.size()) != 0)
+    {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < mesh.submeshes.size(); i++)
+  {
+    const MeshSubmesh& submesh = file.GetSubmeshes()[i];
+    if (submesh.firstIndex != mesh.submeshes[i].firstIndex || submesh.indexCount != mesh.submeshes[i].indexCount ||
+        submesh.materialIndex != mesh.submeshes[i].materialIndex)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// OBJ corner cases and file damage, on small meshes in dir
+bool RunFormatChecks(const std::filesystem::path& dir)
+{
+  bool passed = true;
+
+  // Quad with negative indices: fan-triangulated, 4 shared vertices, 16-bit indices
+  MeshData quad = ParseObj("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf -4 -3 -2 -1\n");
+  passed &= Check(SUITE, quad.vertexCount == 4 && quad.indices.size() == 6, "quad triangulation");
+  passed &= Check(SUITE, quad.indices == std::vector<uint32_t>{0, 1, 2, 0, 2, 3}, "quad fan order");
+  passed &= Check(SUITE, quad.streams.size() == 1 && quad.submeshes.size() == 1, "position-only quad streams");
+  const std::string quadPath = (dir / "quad.vkmesh").string();
+  WriteMeshFile(quad, quadPath);
+  {
+    MeshFile file(quadPath);
+    passed &= Check(SUITE, file.GetIndexType() == IndexType::Uint16, "16-bit indices for a small mesh");
+    passed &= Check(SUITE, SameMesh(quad, file), "quad round trip");
+    passed &= Check(SUITE, file.GetHeader().boundsMax[0] == 1.0f && file.GetHeader().boundsMin[2] == 0.0f,
+                    "quad bounds");
+  }
+
+  // Same position with different normals must not be merged
+  MeshData split = ParseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nvn 0 0 -1\nf 1//1 2//1 3//1\nf 1//2 3//2 2//2\n");
+  passed &= Check(SUITE, split.vertexCount == 6 && split.FindStream(VertexSemantic::Normal) != nullptr,
+                  "vertex dedup by all attributes");
+
+  bool malformed = false;
+  try
+  {
+    ParseObj("v 0 0 0\nf 1 2 3\n");
+  }
+  catch (const std::runtime_error&)
+  {
+    malformed = true;
+  }
+  passed &= Check(SUITE, malformed, "out-of-range face index rejected");
+
+  // Damaged copies of the quad: truncated, bad magic, future version, section past the end
+  std::vector<char> bytes = ReadWholeFile(quadPath);
+  const std::string damagedPath = (dir / "damaged.vkmesh").string();
+  WriteWholeFile(damagedPath, bytes.data(), bytes.size() - 1);
+  passed &= Check(SUITE, Rejects(damagedPath), "truncated file rejected");
+  WriteWholeFile(damagedPath, bytes.data(), sizeof(MeshFileHeader) / 2);
+  passed &= Check(SUITE, Rejects(damagedPath), "file shorter than the header rejected");
+  std::vector<char> corrupt = bytes;
+  corrupt[0] = 'X';
+  WriteWholeFile(damagedPath, corrupt.data(), corrupt.size());
+  passed &= Check(SUITE, Rejects(damagedPath), "bad magic rejected");
+  corrupt = bytes;
+  uint32_t version = MESH_FILE_VERSION + 1;
+  std::memcpy(corrupt.data() + offsetof(MeshFileHeader, version), &version, sizeof(version));
+  WriteWholeFile(damagedPath, corrupt.data(), corrupt.size());
+  passed &= Check(SUITE, Rejects(damagedPath), "other version rejected");
+  corrupt = bytes;
+  uint64_t offset = UINT64_MAX - 8;
+  std::memcpy(corrupt.data() + sizeof(MeshFileHeader) + offsetof(MeshStreamDesc, dataOffset), &offset, sizeof(offset));
+  WriteWholeFile(damagedPath, corrupt.data(), corrupt.size());
+  passed &= Check(SUITE, Rejects(damagedPath), "overflowing stream offset rejected");
+  return passed;
+}
+
+} // namespace
+
+bool RunMeshLoadSuite(BenchReport& report, uint32_t iterations)
+{
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "VulkanAppBench_meshload";
+  std::filesystem::create_directories(dir);
+  const std::string objPath = (dir / "grid.obj").string();
+  const std::string meshPath = (dir / "grid.vkmesh").string();
+
+  bool passed = true;
+  MetricSeries objLoad{"obj_load_ms", {}};
+  MetricSeries meshMap{"mesh_map_ms", {}};
+  MetricSeries meshCopy{"mesh_copy_ms", {}};
+  uintmax_t objBytes = 0;
+  uintmax_t meshBytes = 0;
+  try
+  {
+    passed &= RunFormatChecks(dir);
+
+    const std::string obj = MakeGridObj(GRID_SIZE);
+    WriteWholeFile(objPath, obj.data(), obj.size());
+    MeshData grid = LoadObj(objPath);
+    WriteMeshFile(grid, meshPath);
+    objBytes = std::filesystem::file_size(objPath);
+    meshBytes = std::filesystem::file_size(meshPath);
+    {
+      MeshFile file(meshPath);
+      passed &= Check(SUITE, file.GetIndexType() == IndexType::Uint32, "32-bit indices past 65536 vertices");
+      passed &= Check(SUITE, grid.submeshes.size() == 2 && SameMesh(grid, file), "grid round trip");
+    }
+
+    std::vector<std::byte> staging(meshBytes);
+    const uint32_t samples = std::clamp(iterations, 1u, MAX_SAMPLES);
+    uint64_t checksum = 0; // Keeps the timed work observable
+    for (uint32_t sample = 0; sample < samples; sample++)
+    {
+      Clock::time_point start = Clock::now();
+      std::vector<char> text = ReadWholeFile(objPath);
+      MeshData parsed = ParseObj({text.data(), text.size()});
+      objLoad.samples.push_back(ElapsedMs(start));
+      checksum += parsed.indices.size();
+
+      start = Clock::now();
+      MeshFile file(meshPath);
+      meshMap.samples.push_back(ElapsedMs(start));
+
+      // Every section once, as GpuMesh streams them into the staging ring
+      start = Clock::now();
+      size_t offset = 0;
+      auto copy = [&](std::span<const std::byte> data) {
+        std::memcpy(staging.data() + offset, data.data(), data.size());
+        offset += data.size();
+      };
+      copy(file.GetIndexData());
+      for (const MeshStreamDesc& stream : file.GetStreams())
+      {
+        copy(file.GetStreamData(stream));
+      }
+      meshCopy.samples.push_back(ElapsedMs(start));
+      checksum += static_cast<uint64_t>(staging[offset / 2]);
+    }
+    passed &= Check(SUITE, checksum != 0, "timed loads produced data");
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Mesh load suite error: " << e.what() << std::endl;
+    passed = false;
+  }
+  std::error_code error;
+  std::filesystem::remove_all(dir, error);
+
+  StatSummary obj = Summarize(objLoad.samples);
+  StatSummary map = Summarize(meshMap.samples);
+  StatSummary copy = Summarize(meshCopy.samples);
+  std::ostringstream speedup;
+  double meshMs = map.p50 + copy.p50;
+  speedup << std::fixed << std::setprecision(1) << (meshMs > 0.0 ? obj.p50 / meshMs : 0.0);
+  report.config.emplace_back("grid_quads", std::to_string(GRID_SIZE * GRID_SIZE));
+  report.config.emplace_back("samples", std::to_string(objLoad.samples.size()));
+  report.config.emplace_back("obj_bytes", std::to_string(objBytes));
+  report.config.emplace_back("vkmesh_bytes", std::to_string(meshBytes));
+  report.config.emplace_back("median_speedup", speedup.str());
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(objLoad.name, obj);
+  report.metrics.emplace_back(meshMap.name, map);
+  report.metrics.emplace_back(meshCopy.name, copy);
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
@@ -0,0 +1,352 @@
+// Mesh optimization suite: MeshOptimizer on a UV sphere whose triangles and
+// vertices were shuffled, as a worst case for the caches. Reports ACMR, ATVR
+// and vertex overfetch before and after (simulated, so no GPU is needed) and
+// the bytes per vertex before and after quantization, and times each step.
+// Checks that every triangle survives with its winding, that the caches got
+// better, that vertices end up in first-use order and that the quantization
+// error stays within its format's bounds.
+
+#include "CpuSuites.h"
+
+#include "assets/MeshFile.h"
+#include "assets/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace VulkanApp::Assets;
+
+constexpr uint32_t SPHERE_SEGMENTS = 256; // 33k vertices, 65k triangles
+constexpr uint32_t SPHERE_RINGS = 128;
+constexpr uint32_t MAX_SAMPLES = 20;      // Each sample optimizes the whole mesh
+constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+// A corner as position + texcoord, which is unique per vertex of the sphere
+using Corner = std::array<float, 5>;
+using Triangle = std::array<Corner, 3>;
+
+constexpr const char* SUITE = "Mesh optimization";
+
+template <typename T>
+void Append(std::vector<std::byte>& data, const T& value)
+{
+  const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+// Unit sphere with normals, texcoords and tangents; a seam column and a
+// vertex per segment at the poles, as exporters write it. Triangles and
+// vertices come out in random order.
+MeshData MakeShuffledSphere()
+{
+  MeshData mesh;
+  MeshData::Stream positions{VertexSemantic::Position, VertexFormat::Float32x3, {}};
+  MeshData::Stream normals{VertexSemantic::Normal, VertexFormat::Float32x3, {}};
+  MeshData::Stream texCoords{VertexSemantic::TexCoord0, VertexFormat::Float32x2, {}};
+  MeshData::Stream tangents{VertexSemantic::Tangent, VertexFormat::Float32x4, {}};
+  for (uint32_t ring = 0; ring <= SPHERE_RINGS; ring++)
+  {
+    for (uint32_t segment = 0; segment <= SPHERE_SEGMENTS; segment++)
+    {
+      float u = static_cast<float>(segment) / SPHERE_SEGMENTS;
+      float v = static_cast<float>(ring) / SPHERE_RINGS;
+      float phi = u * 2.0f * std::numbers::pi_v<float>;
+      float theta = v * std::numbers::pi_v<float>;
+      float p[3] = {std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)};
+      for (float c : p) Append(positions.data, c);
+      for (float c : p) Append(normals.data, c);
+      Append(texCoords.data, u);
+      Append(texCoords.data, v);
+      float t[4] = {-std::sin(phi), 0.0f, std::cos(phi), segment % 2 == 0 ? 1.0f : -1.0f};
+      for (float c : t) Append(tangents.data, c);
+    }
+  }
+  mesh.vertexCount = (SPHERE_RINGS + 1) * (SPHERE_SEGMENTS + 1);
+  mesh.streams = {std::move(positions), std::move(normals), std::move(texCoords), std::move(tangents)};
+
+  std::vector<std::array<uint32_t, 3>> triangles;
+  auto vertex = [](uint32_t ring, uint32_t segment) { return ring * (SPHERE_SEGMENTS + 1) + segment; };
+  for (uint32_t ring = 0; ring < SPHERE_RINGS; ring++)
+  {
+    for (uint32_t segment = 0; segment < SPHERE_SEGMENTS; segment++)
+    {
+      uint32_t a = vertex(ring, segment), b = vertex(ring, segment + 1);
+      uint32_t c = vertex(ring + 1, segment), d = vertex(ring + 1, segment + 1);
+      if (ring != 0) triangles.push_back({a, b, c});               // Skip the degenerate pole triangles
+      if (ring != SPHERE_RINGS - 1) triangles.push_back({b, d, c});
+    }
+  }
+
+  std::mt19937 rng(42);
+  std::shuffle(triangles.begin(), triangles.end(), rng);
+  std::vector<uint32_t> permutation(mesh.vertexCount);
+  for (uint32_t v = 0; v < mesh.vertexCount; v++) permutation[v] = v;
+  std::shuffle(permutation.begin(), permutation.end(), rng);
+  for (const auto& triangle : triangles)
+  {
+    for (uint32_t corner : triangle) mesh.indices.push_back(permutation[corner]);
+  }
+  for (MeshData::Stream& stream : mesh.streams)
+  {
+    const uint32_t size = GetVertexFormatSize(stream.format);
+    std::vector<std::byte> data(stream.data.size());
+    for (uint32_t v = 0; v < mesh.vertexCount; v++)
+    {
+      std::memcpy(data.data() + size_t(permutation[v]) * size, stream.data.data() + size_t(v) * size, size);
+    }
+    stream.data = std::move(data);
+  }
+  mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0, 0, {}, {}});
+  return mesh;
+}
+
+// Every triangle by its corners' attributes, rotated to start at the smallest
+// corner so the winding counts but the starting corner does not
+std::vector<Triangle> TriangleSet(const MeshData& mesh)
+{
+  const float* position = reinterpret_cast<const float*>(mesh.FindStream(VertexSemantic::Position)->data.data());
+  const float* texCoord = reinterpret_cast<const float*>(mesh.FindStream(VertexSemantic::TexCoord0)->data.data());
+  std::vector<Triangle> set;
+  for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+  {
+    Triangle triangle;
+    for (int c = 0; c < 3; c++)
+    {
+      uint32_t v = mesh.indices[i + c];
+      triangle[c] = {position[v * 3], position[v * 3 + 1], position[v * 3 + 2], texCoord[v * 2], texCoord[v * 2 + 1]};
+    }
+    std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+    set.push_back(triangle);
+  }
+  std::sort(set.begin(), set.end());
+  return set;
+}
+
+bool IsFirstUseOrder(const MeshData& mesh)
+{
+  uint32_t next = 0;
+  for (uint32_t index : mesh.indices)
+  {
+    if (index > next) return false;
+    if (index == next) next++;
+  }
+  return next == mesh.vertexCount;
+}
+
+uint32_t BytesPerVertex(const MeshData& mesh)
+{
+  uint32_t size = 0;
+  for (const MeshData::Stream& stream : mesh.streams) size += GetVertexFormatSize(stream.format);
+  return size;
+}
+
+struct QuantizationError {
+  float position = 0.0f;   // Largest relative error
+  float normalDegrees = 0.0f;
+  float texCoord = 0.0f;
+  float tangentDegrees = 0.0f;
+  bool handedness = true;
+};
+
+QuantizationError MeasureQuantization(const MeshData& source, const MeshData& quantized)
+{
+  QuantizationError error;
+  auto data = [](const MeshData& mesh, VertexSemantic semantic) { return mesh.FindStream(semantic)->data.data(); };
+  auto degrees = [](const float* a, const float* b) {
+    float dot = std::clamp(a[0] * b[0] + a[1] * b[1] + a[2] * b[2], -1.0f, 1.0f);
+    return std::acos(dot) * 180.0f / std::numbers::pi_v<float>;
+  };
+  for (uint32_t v = 0; v < source.vertexCount; v++)
+  {
+    float p[3], n[3], uv[2], t[4];
+    std::memcpy(p, data(source, VertexSemantic::Position) + v * sizeof(p), sizeof(p));
+    std::memcpy(n, data(source, VertexSemantic::Normal) + v * sizeof(n), sizeof(n));
+    std::memcpy(uv, data(source, VertexSemantic::TexCoord0) + v * sizeof(uv), sizeof(uv));
+    std::memcpy(t, data(source, VertexSemantic::Tangent) + v * sizeof(t), sizeof(t));
+
+    uint16_t halfP[4], halfUv[2];
+    int16_t octahedral[2];
+    uint32_t packed;
+    std::memcpy(halfP, data(quantized, VertexSemantic::Position) + v * sizeof(halfP), sizeof(halfP));
+    std::memcpy(octahedral, data(quantized, VertexSemantic::Normal) + v * sizeof(octahedral), sizeof(octahedral));
+    std::memcpy(halfUv, data(quantized, VertexSemantic::TexCoord0) + v * sizeof(halfUv), sizeof(halfUv));
+    std::memcpy(&packed, data(quantized, VertexSemantic::Tangent) + v * sizeof(packed), sizeof(packed));
+
+    for (int c = 0; c < 3; c++)
+    {
+      float magnitude = std::max(std::abs(p[c]), 1.0f / 16384.0f); // Halves are absolute below 2^-14
+      error.position = std::max(error.position, std::abs(HalfToFloat(halfP[c]) - p[c]) / magnitude);
+    }
+    float decoded[3];
+    DecodeOctahedral(octahedral, decoded);
+    error.normalDegrees = std::max(error.normalDegrees, degrees(n, decoded));
+    for (int c = 0; c < 2; c++) error.texCoord = std::max(error.texCoord, std::abs(HalfToFloat(halfUv[c]) - uv[c]));
+    float tangent[3];
+    for (int c = 0; c < 3; c++) tangent[c] = ((packed >> (10 * c)) & 1023u) / 1023.0f * 2.0f - 1.0f;
+    float length = std::sqrt(tangent[0] * tangent[0] + tangent[1] * tangent[1] + tangent[2] * tangent[2]);
+    for (float& c : tangent) c /= length;
+    error.tangentDegrees = std::max(error.tangentDegrees, degrees(t, tangent));
+    error.handedness &= ((packed >> 30) == 3u) == (t[3] > 0.0f);
+  }
+  return error;
+}
+
+bool RunEncodingChecks()
+{
+  bool passed = true;
+  bool halvesExact = true;
+  for (uint32_t bits = 0; bits < 0x10000u; bits++)
+  {
+    uint16_t half = static_cast<uint16_t>(bits);
+    bool nan = (half & 0x7C00u) == 0x7C00u && (half & 0x3FFu) != 0;
+    halvesExact &= nan || FloatToHalf(HalfToFloat(half)) == half;
+  }
+  passed &= Check(SUITE, halvesExact, "every half survives a float round trip");
+  passed &= Check(SUITE, FloatToHalf(65520.0f) == 0x7C00u && FloatToHalf(1.0f + 2.0f / 4096.0f) == 0x3C00u &&
+                             FloatToHalf(1.0f + 6.0f / 4096.0f) == 0x3C02u,
+                  "halves overflow and round to nearest even");
+
+  std::mt19937 rng(7);
+  std::normal_distribution<float> gaussian;
+  float worstDot = 1.0f;
+  for (uint32_t i = 0; i < 100000; i++)
+  {
+    float n[3] = {gaussian(rng), gaussian(rng), gaussian(rng)};
+    float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    for (float& c : n) c /= length;
+    int16_t encoded[2];
+    float decoded[3];
+    EncodeOctahedral(n, encoded);
+    DecodeOctahedral(encoded, decoded);
+    worstDot = std::min(worstDot, n[0] * decoded[0] + n[1] * decoded[1] + n[2] * decoded[2]);
+  }
+  passed &= Check(SUITE, worstDot > 0.99999f, "octahedral normals within 0.26 degrees");
+  return passed;
+}
+
+} // namespace
+
+bool RunMeshOptSuite(BenchReport& report, uint32_t iterations)
+{
+  bool passed = true;
+  MetricSeries cacheTime{"vertex_cache_ms", {}};
+  MetricSeries overdrawTime{"overdraw_ms", {}};
+  MetricSeries fetchTime{"vertex_fetch_ms", {}};
+  MetricSeries quantizeTime{"quantize_ms", {}};
+  MeshCacheStats before;
+  MeshCacheStats afterCache;
+  MeshCacheStats after;
+  uint32_t bytesBefore = 0;
+  uint32_t bytesAfter = 0;
+  QuantizationError quantizationError;
+  size_t triangles = 0;
+  try
+  {
+    passed &= RunEncodingChecks();
+
+    const MeshData source = MakeShuffledSphere();
+    triangles = source.indices.size() / 3;
+    before = AnalyzeMesh(source);
+    bytesBefore = BytesPerVertex(source);
+    const std::vector<Triangle> sourceTriangles = TriangleSet(source);
+
+    const uint32_t samples = std::clamp(iterations, 1u, MAX_SAMPLES);
+    MeshData optimized;
+    MeshData quantized;
+    for (uint32_t sample = 0; sample < samples; sample++)
+    {
+      optimized = source;
+      std::span<uint32_t> indices(optimized.indices);
+      const float* positions =
+        reinterpret_cast<const float*>(optimized.FindStream(VertexSemantic::Position)->data.data());
+
+      Clock::time_point start = Clock::now();
+      OptimizeVertexCache(indices, optimized.vertexCount);
+      cacheTime.samples.push_back(ElapsedMs(start));
+      afterCache = AnalyzeVertexCache(indices, optimized.vertexCount);
+
+      start = Clock::now();
+      OptimizeOverdraw(indices, positions, optimized.vertexCount, OVERDRAW_THRESHOLD);
+      overdrawTime.samples.push_back(ElapsedMs(start));
+
+      start = Clock::now();
+      OptimizeVertexFetch(optimized);
+      fetchTime.samples.push_back(ElapsedMs(start));
+
+      quantized = optimized;
+      start = Clock::now();
+      QuantizeMesh(quantized);
+      quantizeTime.samples.push_back(ElapsedMs(start));
+    }
+    after = AnalyzeMesh(optimized);
+    bytesAfter = BytesPerVertex(quantized);
+    quantizationError = MeasureQuantization(optimized, quantized);
+
+    passed &= Check(SUITE, TriangleSet(optimized) == sourceTriangles, "every triangle kept with its winding");
+    passed &= Check(SUITE, IsFirstUseOrder(optimized), "vertices in first-use order");
+    passed &= Check(SUITE, after.acmr < before.acmr * 0.5f && after.acmr < 1.0f, "ACMR improved");
+    passed &= Check(SUITE, after.acmr <= afterCache.acmr * OVERDRAW_THRESHOLD * 1.05f,
+                    "overdraw order keeps the cache order");
+    passed &= Check(SUITE, after.overfetch < before.overfetch, "overfetch improved");
+    passed &= Check(SUITE, quantizationError.position <= 1.0f / 2048.0f, "half positions within half an ulp");
+    passed &= Check(SUITE, quantizationError.normalDegrees < 0.05f, "octahedral normals within 0.05 degrees");
+    passed &= Check(SUITE, quantizationError.texCoord <= 1.0f / 4096.0f, "half texcoords within 1/4096 on [0, 1]");
+    passed &= Check(SUITE, quantizationError.tangentDegrees < 0.2f && quantizationError.handedness,
+                    "10-bit tangents within 0.2 degrees, handedness kept");
+
+    // A quantized mesh is a valid .vkmesh with half positions
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "VulkanAppBench_meshopt.vkmesh";
+    WriteMeshFile(quantized, path.string());
+    {
+      MeshFile file(path.string());
+      const MeshStreamDesc* position = file.FindStream(VertexSemantic::Position);
+      passed &= Check(SUITE, position != nullptr && position->format == static_cast<uint32_t>(VertexFormat::Float16x4) &&
+                               file.GetHeader().boundsMax[1] == 1.0f && file.GetHeader().boundsMin[1] == -1.0f,
+                      "quantized mesh round trip");
+    }
+    std::error_code error;
+    std::filesystem::remove(path, error);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Mesh optimization suite error: " << e.what() << std::endl;
+    passed = false;
+  }
+
+  report.config.emplace_back("triangles", std::to_string(triangles));
+  report.config.emplace_back("samples", std::to_string(cacheTime.samples.size()));
+  report.config.emplace_back("cache_size", std::to_string(ANALYZE_CACHE_SIZE));
+  report.config.emplace_back("acmr_before", Format(before.acmr, 3));
+  report.config.emplace_back("acmr_after_cache", Format(afterCache.acmr, 3));
+  report.config.emplace_back("acmr_after", Format(after.acmr, 3));
+  report.config.emplace_back("atvr_before", Format(before.atvr, 3));
+  report.config.emplace_back("atvr_after", Format(after.atvr, 3));
+  report.config.emplace_back("overfetch_before", Format(before.overfetch, 3));
+  report.config.emplace_back("overfetch_after", Format(after.overfetch, 3));
+  report.config.emplace_back("bytes_per_vertex_before", std::to_string(bytesBefore));
+  report.config.emplace_back("bytes_per_vertex_after", std::to_string(bytesAfter));
+  report.config.emplace_back("normal_error_deg", Format(quantizationError.normalDegrees, 3));
+  report.config.emplace_back("tangent_error_deg", Format(quantizationError.tangentDegrees, 3));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(cacheTime.name, Summarize(cacheTime.samples));
+  report.metrics.emplace_back(overdrawTime.name, Summarize(overdrawTime.samples));
+  report.metrics.emplace_back(fetchTime.name, Summarize(fetchTime.samples));
+  report.metrics.emplace_back(quantizeTime.name, Summarize(quantizeTime.samples));
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
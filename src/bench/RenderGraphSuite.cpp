@@ -0,0 +1,147 @@
+// Render graph suite: compiles a small compute-only frame on a headless device
+// and checks what Compile derived: the culled pass, transients with disjoint
+// lifetimes sharing memory, and the first use of each transient waiting for
+// the previous frame's use of the same memory. Times a steady frame's Compile
+// (hashing the declaration) against a recompile after a resize.
+
+#include "CpuSuites.h"
+
+#include "rendering/RenderGraph.h"
+#include "vulkan/DeletionQueue.h"
+#include "vulkan/VulkanDevice.h"
+#include "vulkan/VulkanInstance.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using VulkanApp::Rendering::RenderGraph;
+using VulkanApp::Rendering::RGImageDesc;
+using VulkanApp::Rendering::RGPassType;
+using VulkanApp::Rendering::RGResource;
+
+constexpr uint32_t MAX_SAMPLES = 200; // Each recompile creates images and memory
+
+constexpr const char* SUITE = "Render graph";
+
+// Produce writes A; Filter reads A and writes B; Resolve reads B and writes C;
+// Readback reads C and has side effects. A and C never overlap, so they share a
+// slot. Unused writes D, which nothing reads, and is culled.
+void DeclareFrame(RenderGraph& graph, VkExtent2D extent)
+{
+  const RGImageDesc desc{VK_FORMAT_R8G8B8A8_UNORM, extent};
+  const auto execute = [](RenderGraph::PassContext&) {};
+  RGResource a = VulkanApp::Rendering::RG_INVALID_RESOURCE;
+  RGResource b = a;
+  RGResource c = a;
+
+  graph.Reset();
+  graph.AddPass("Produce", RGPassType::Compute,
+                [&](RenderGraph::PassBuilder& pass) {
+                  a = pass.CreateImage("A", desc);
+                  pass.WriteStorage(a);
+                },
+                execute);
+  graph.AddPass("Filter", RGPassType::Compute,
+                [&](RenderGraph::PassBuilder& pass) {
+                  pass.ReadStorage(a);
+                  b = pass.CreateImage("B", desc);
+                  pass.WriteStorage(b);
+                },
+                execute);
+  graph.AddPass("Resolve", RGPassType::Compute,
+                [&](RenderGraph::PassBuilder& pass) {
+                  pass.ReadStorage(b);
+                  c = pass.CreateImage("C", desc);
+                  pass.WriteStorage(c);
+                },
+                execute);
+  graph.AddPass("Readback", RGPassType::Compute,
+                [&](RenderGraph::PassBuilder& pass) {
+                  pass.ReadStorage(c);
+                  pass.SetSideEffects();
+                },
+                execute);
+  graph.AddPass("Unused", RGPassType::Compute,
+                [&](RenderGraph::PassBuilder& pass) { pass.WriteStorage(pass.CreateImage("D", desc)); }, execute);
+}
+
+bool RunCompileChecks(RenderGraph& graph, DeletionQueue& deletionQueue)
+{
+  bool passed = true;
+  DeclareFrame(graph, {256, 256});
+  graph.Compile(deletionQueue, 0);
+  const RenderGraph::Stats& stats = graph.GetStats();
+  passed &= Check(SUITE, stats.declaredPasses == 5 && stats.culledPasses == 1, "culls the pass nobody reads");
+  passed &= Check(SUITE, stats.aliasedBytes > 0, "transients with disjoint lifetimes share memory");
+
+  // The frame's first writer of A reuses memory the previous frame's Resolve
+  // (as C) may still be reading and writing on the queue
+  const RenderGraph::BarrierScope first = graph.GetBarrierScope("Produce");
+  passed &= Check(SUITE, first.barriers == 1 && (first.srcStages & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) != 0,
+                  "a transient's first barrier waits for the previous frame");
+  const RenderGraph::BarrierScope handOver = graph.GetBarrierScope("Resolve");
+  passed &= Check(SUITE, (handOver.srcStages & VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT) != 0,
+                  "an aliased transient waits for the previous occupant");
+
+  DeclareFrame(graph, {256, 256});
+  graph.Compile(deletionQueue, 1);
+  passed &= Check(SUITE, graph.GetStats().compiles == 1, "an unchanged declaration is not recompiled");
+  return passed;
+}
+
+} // namespace
+
+bool RunRenderGraphSuite(BenchReport& report, uint32_t iterations)
+{
+  bool passed = true;
+  MetricSeries steadyTime{"steady_compile_us", {}};
+  MetricSeries recompileTime{"recompile_us", {}};
+  std::string deviceName = "n/a";
+  try
+  {
+    VulkanInstance instance(nullptr);
+    VulkanDevice device(instance);
+    deviceName = device.getProperties().deviceName;
+    DeletionQueue deletionQueue; // Nothing is submitted, so retired images can go at once
+    RenderGraph graph(device);
+    passed &= RunCompileChecks(graph, deletionQueue);
+
+    const uint32_t samples = std::clamp(iterations, 1u, MAX_SAMPLES);
+    uint64_t frameNumber = 2;
+    for (uint32_t sample = 0; sample < samples; sample++, frameNumber++)
+    {
+      VkExtent2D extent = sample % 2 == 0 ? VkExtent2D{512, 512} : VkExtent2D{256, 256};
+      Clock::time_point start = Clock::now();
+      DeclareFrame(graph, extent);
+      graph.Compile(deletionQueue, frameNumber);
+      recompileTime.samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+      deletionQueue.flush(frameNumber);
+
+      start = Clock::now();
+      DeclareFrame(graph, extent);
+      graph.Compile(deletionQueue, frameNumber);
+      steadyTime.samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Render graph suite error: " << e.what() << std::endl;
+    passed = false;
+  }
+
+  report.config.emplace_back("device", deviceName);
+  report.config.emplace_back("samples", std::to_string(recompileTime.samples.size()));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(steadyTime.name, Summarize(steadyTime.samples));
+  report.metrics.emplace_back(recompileTime.name, Summarize(recompileTime.samples));
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
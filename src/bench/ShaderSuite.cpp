@@ -0,0 +1,465 @@
+// Shader suite: SPIR-V reflection and the .vkshaders archive. Reflects
+// hand-assembled compute, vertex and fragment modules covering every
+// descriptor type, runtime arrays and explicit push constant layouts, round
+// trips them through an archive (embedded bytes and a mapped file), and checks
+// that corrupt archives are rejected. Times reflection and the archive load,
+// which validates and hashes every shader as the renderer does at startup.
+
+#include "CpuSuites.h"
+
+#include "assets/ShaderArchive.h"
+#include "assets/SpirvReflection.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace VulkanApp::Assets;
+
+constexpr uint32_t ARCHIVE_SHADERS = 64;    // Shaders in the timed archive
+constexpr uint32_t ARCHIVE_SHADER_WORDS = 2048; // 8 KB each, typical of the app's compiled shaders
+constexpr uint32_t MAX_SAMPLES = 1000;
+
+constexpr const char* SUITE = "Shader";
+
+// The opcodes, decorations and enums the test modules use, from the SPIR-V spec
+enum : uint32_t
+{
+  OpNop = 0,
+  OpEntryPoint = 15,
+  OpExecutionMode = 16,
+  OpTypeInt = 21,
+  OpTypeFloat = 22,
+  OpTypeVector = 23,
+  OpTypeMatrix = 24,
+  OpTypeImage = 25,
+  OpTypeSampler = 26,
+  OpTypeSampledImage = 27,
+  OpTypeArray = 28,
+  OpTypeRuntimeArray = 29,
+  OpTypeStruct = 30,
+  OpTypePointer = 32,
+  OpConstant = 43,
+  OpVariable = 59,
+  OpDecorate = 71,
+  OpMemberDecorate = 72,
+
+  Block = 2,
+  BufferBlock = 3,
+  RowMajor = 4,
+  ColMajor = 5,
+  ArrayStride = 6,
+  MatrixStride = 7,
+  BuiltIn = 11,
+  Binding = 33,
+  DescriptorSet = 34,
+  Offset = 35,
+
+  UniformConstant = 0,
+  Input = 1,
+  Uniform = 2,
+  PushConstant = 9,
+  StorageBuffer = 12,
+};
+
+// Just enough of an assembler to write the modules glslc would emit for the
+// resource declarations under test; function bodies are irrelevant to reflection
+class SpirvBuilder
+{
+public:
+  uint32_t Id() { return _bound++; }
+
+  void Op(uint32_t opcode, std::initializer_list<uint32_t> operands) { Op(opcode, std::vector<uint32_t>(operands)); }
+
+  void Op(uint32_t opcode, const std::vector<uint32_t>& operands)
+  {
+    _words.push_back(static_cast<uint32_t>(operands.size() + 1) << 16 | opcode);
+    _words.insert(_words.end(), operands.begin(), operands.end());
+  }
+
+  void EntryPoint(uint32_t executionModel, uint32_t function, const std::string& name)
+  {
+    std::vector<uint32_t> operands = {executionModel, function};
+    std::vector<uint32_t> text((name.size() + 4) / 4, 0);
+    std::memcpy(text.data(), name.data(), name.size());
+    operands.insert(operands.end(), text.begin(), text.end());
+    Op(OpEntryPoint, operands);
+  }
+
+  // A variable of type pointee in storageClass, decorated with set and binding
+  uint32_t Resource(uint32_t storageClass, uint32_t pointee, uint32_t set, uint32_t binding)
+  {
+    uint32_t variable = Variable(storageClass, pointee);
+    Op(OpDecorate, {variable, DescriptorSet, set});
+    Op(OpDecorate, {variable, Binding, binding});
+    return variable;
+  }
+
+  uint32_t Variable(uint32_t storageClass, uint32_t pointee)
+  {
+    uint32_t pointer = Id();
+    Op(OpTypePointer, {pointer, storageClass, pointee});
+    uint32_t variable = Id();
+    Op(OpVariable, {pointer, variable, storageClass});
+    return variable;
+  }
+
+  // A Block-decorated struct with the members at the given offsets
+  uint32_t Struct(std::initializer_list<uint32_t> members, std::initializer_list<uint32_t> offsets,
+                  uint32_t decoration = Block)
+  {
+    uint32_t type = Id();
+    std::vector<uint32_t> operands = {type};
+    operands.insert(operands.end(), members.begin(), members.end());
+    Op(OpTypeStruct, operands);
+    Op(OpDecorate, {type, decoration});
+    uint32_t member = 0;
+    for (uint32_t offset : offsets)
+    {
+      Op(OpMemberDecorate, {type, member++, Offset, offset});
+    }
+    return type;
+  }
+
+  void Pad(uint32_t words)
+  {
+    while (_words.size() < words)
+    {
+      Op(OpNop, {});
+    }
+  }
+
+  std::vector<uint32_t> Finish()
+  {
+    std::vector<uint32_t> code = {0x07230203, 0x00010300, 0, _bound, 0};
+    code.insert(code.end(), _words.begin(), _words.end());
+    return code;
+  }
+
+private:
+  uint32_t _bound = 1;
+  std::vector<uint32_t> _words;
+};
+
+// Scalar and vector types every module starts with
+struct Types
+{
+  uint32_t uint32;
+  uint32_t float32;
+  uint32_t vec4;
+  uint32_t mat4;
+
+  explicit Types(SpirvBuilder& spirv)
+      : uint32(spirv.Id()), float32(spirv.Id()), vec4(spirv.Id()), mat4(spirv.Id())
+  {
+    spirv.Op(OpTypeInt, {uint32, 32, 0});
+    spirv.Op(OpTypeFloat, {float32, 32});
+    spirv.Op(OpTypeVector, {vec4, float32, 4});
+    spirv.Op(OpTypeMatrix, {mat4, vec4, 4});
+  }
+};
+
+// cull.comp's interface: three storage buffers and a 108-byte push constant block
+std::vector<uint32_t> MakeComputeModule(uint32_t padWords = 0)
+{
+  SpirvBuilder spirv;
+  const uint32_t main = spirv.Id();
+  spirv.EntryPoint(5, main, "main");
+  spirv.Op(OpExecutionMode, {main, 17, 64, 1, 1});
+  Types types(spirv);
+
+  uint32_t elements = spirv.Id();
+  spirv.Op(OpTypeRuntimeArray, {elements, types.vec4});
+  spirv.Op(OpDecorate, {elements, ArrayStride, 16});
+  for (uint32_t binding = 0; binding < 3; binding++)
+  {
+    spirv.Resource(StorageBuffer, spirv.Struct({elements}, {0}), 0, binding);
+  }
+
+  uint32_t constants = spirv.Struct({types.mat4, types.vec4, types.vec4, types.uint32, types.uint32, types.uint32},
+                                    {0, 64, 80, 96, 100, 104});
+  spirv.Op(OpMemberDecorate, {constants, 0, ColMajor});
+  spirv.Op(OpMemberDecorate, {constants, 0, MatrixStride, 16});
+  spirv.Variable(PushConstant, constants);
+
+  // gl_GlobalInvocationID: an input without a binding
+  uint32_t uvec3 = spirv.Id();
+  spirv.Op(OpTypeVector, {uvec3, types.uint32, 3});
+  spirv.Op(OpDecorate, {spirv.Variable(Input, uvec3), BuiltIn, 28});
+  spirv.Pad(padWords);
+  return spirv.Finish();
+}
+
+// A uniform block, an old-style BufferBlock storage buffer, a bindless storage
+// buffer table in set 1 and a row-major matrix followed by an array in push constants
+std::vector<uint32_t> MakeVertexModule()
+{
+  SpirvBuilder spirv;
+  spirv.EntryPoint(0, spirv.Id(), "main");
+  Types types(spirv);
+
+  uint32_t frame = spirv.Struct({types.mat4, types.vec4}, {0, 64});
+  spirv.Op(OpMemberDecorate, {frame, 0, MatrixStride, 16});
+  spirv.Resource(Uniform, frame, 0, 0);
+
+  uint32_t elements = spirv.Id();
+  spirv.Op(OpTypeRuntimeArray, {elements, types.vec4});
+  spirv.Op(OpDecorate, {elements, ArrayStride, 16});
+  spirv.Resource(Uniform, spirv.Struct({elements}, {0}, BufferBlock), 0, 1);
+
+  uint32_t table = spirv.Id();
+  spirv.Op(OpTypeRuntimeArray, {table, spirv.Struct({elements}, {0})});
+  spirv.Resource(StorageBuffer, table, 1, 0);
+
+  uint32_t two = spirv.Id();
+  spirv.Op(OpConstant, {types.uint32, two, 2});
+  uint32_t floats = spirv.Id();
+  spirv.Op(OpTypeArray, {floats, types.float32, two});
+  spirv.Op(OpDecorate, {floats, ArrayStride, 4});
+  uint32_t constants = spirv.Struct({types.mat4, floats}, {0, 64});
+  spirv.Op(OpMemberDecorate, {constants, 0, RowMajor});
+  spirv.Op(OpMemberDecorate, {constants, 0, MatrixStride, 16});
+  spirv.Variable(PushConstant, constants);
+  return spirv.Finish();
+}
+
+// One binding of every image, sampler and texel buffer kind
+std::vector<uint32_t> MakeFragmentModule()
+{
+  SpirvBuilder spirv;
+  spirv.EntryPoint(4, spirv.Id(), "fsMain");
+  Types types(spirv);
+
+  auto image = [&](uint32_t dim, uint32_t sampled, uint32_t format) {
+    uint32_t type = spirv.Id();
+    spirv.Op(OpTypeImage, {type, types.float32, dim, 0, 0, 0, sampled, format});
+    return type;
+  };
+  const uint32_t texture2d = image(1, 1, 0);
+  uint32_t combined = spirv.Id();
+  spirv.Op(OpTypeSampledImage, {combined, texture2d});
+  uint32_t four = spirv.Id();
+  spirv.Op(OpConstant, {types.uint32, four, 4});
+  uint32_t combinedArray = spirv.Id();
+  spirv.Op(OpTypeArray, {combinedArray, combined, four});
+  uint32_t sampler = spirv.Id();
+  spirv.Op(OpTypeSampler, {sampler});
+
+  spirv.Resource(UniformConstant, combinedArray, 0, 0);
+  spirv.Resource(UniformConstant, image(1, 2, 1), 0, 1);
+  spirv.Resource(UniformConstant, image(5, 1, 0), 0, 2);
+  spirv.Resource(UniformConstant, sampler, 0, 3);
+  spirv.Resource(UniformConstant, texture2d, 0, 4);
+  spirv.Resource(UniformConstant, image(5, 2, 1), 0, 5);
+  return spirv.Finish();
+}
+
+// Word offset of the first instruction with the opcode
+size_t FindInstruction(const std::vector<uint32_t>& code, uint32_t opcode)
+{
+  size_t word = 5;
+  while (word < code.size() && (code[word] & 0xFFFF) != opcode)
+  {
+    word += code[word] >> 16;
+  }
+  return word;
+}
+
+bool SameReflection(const ShaderReflection& a, const ShaderReflection& b)
+{
+  return a.stage == b.stage && a.entryPoint == b.entryPoint && a.bindings == b.bindings &&
+         a.pushConstantSize == b.pushConstantSize && std::equal(a.localSize, a.localSize + 3, b.localSize);
+}
+
+bool RunReflectionChecks()
+{
+  bool passed = true;
+  const ShaderReflection compute = ReflectSpirv(MakeComputeModule());
+  passed &= Check(SUITE, compute.stage == ShaderStage::Compute && compute.entryPoint == "main",
+                  "compute stage and entry point");
+  passed &= Check(SUITE, compute.localSize[0] == 64 && compute.localSize[1] == 1 && compute.localSize[2] == 1,
+                  "compute local size");
+  passed &= Check(SUITE, compute.bindings == std::vector<ShaderBinding>{{0, 0, DescriptorType::StorageBuffer, 1},
+                                                                        {0, 1, DescriptorType::StorageBuffer, 1},
+                                                                        {0, 2, DescriptorType::StorageBuffer, 1}},
+                  "compute storage buffers");
+  passed &= Check(SUITE, compute.pushConstantSize == 108, "push constant size from member offsets");
+
+  const ShaderReflection vertex = ReflectSpirv(MakeVertexModule());
+  passed &= Check(SUITE, vertex.stage == ShaderStage::Vertex, "vertex stage");
+  passed &= Check(SUITE, vertex.bindings == std::vector<ShaderBinding>{{0, 0, DescriptorType::UniformBuffer, 1},
+                                                                       {0, 1, DescriptorType::StorageBuffer, 1},
+                                                                       {1, 0, DescriptorType::StorageBuffer, 0}},
+                  "uniform, BufferBlock and runtime array bindings");
+  passed &= Check(SUITE, vertex.pushConstantSize == 72, "row-major matrix and array strides in push constants");
+
+  const ShaderReflection fragment = ReflectSpirv(MakeFragmentModule());
+  passed &= Check(SUITE, fragment.stage == ShaderStage::Fragment && fragment.entryPoint == "fsMain",
+                  "fragment stage and entry point");
+  passed &= Check(SUITE, fragment.bindings == std::vector<ShaderBinding>{{0, 0, DescriptorType::CombinedImageSampler, 4},
+                                                                         {0, 1, DescriptorType::StorageImage, 1},
+                                                                         {0, 2, DescriptorType::UniformTexelBuffer, 1},
+                                                                         {0, 3, DescriptorType::Sampler, 1},
+                                                                         {0, 4, DescriptorType::SampledImage, 1},
+                                                                         {0, 5, DescriptorType::StorageTexelBuffer, 1}},
+                  "image, sampler and texel buffer bindings");
+  passed &= Check(SUITE, fragment.pushConstantSize == 0, "no push constants");
+
+  std::vector<uint32_t> code = MakeComputeModule();
+  passed &= Check(SUITE, Throws([&] { ReflectSpirv(std::span(code).first(4)); }), "rejects a short header");
+  passed &= Check(SUITE, Throws([&] { ReflectSpirv(std::span(code).first(code.size() - 1)); }),
+                  "rejects a truncated instruction");
+  code[3] = 0x40000000; // Would size the id table at gigabytes
+  passed &= Check(SUITE, Throws([&] { ReflectSpirv(code); }), "rejects an id bound beyond the module");
+  code[0] = 0;
+  passed &= Check(SUITE, Throws([&] { ReflectSpirv(code); }), "rejects a bad magic number");
+
+  for (uint32_t index : {0xFFFFFFFFu, 0x10000000u}) // Would wrap, or size the member table at gigabytes
+  {
+    code = MakeComputeModule();
+    code[FindInstruction(code, OpMemberDecorate) + 2] = index;
+    passed &= Check(SUITE, Throws([&] { ReflectSpirv(code); }), "rejects a member index beyond the module");
+  }
+  code = MakeComputeModule();
+  const uint32_t scalar = code[FindInstruction(code, OpTypeInt) + 1];
+  code[FindInstruction(code, OpVariable) + 1] = scalar;
+  passed &= Check(SUITE, Throws([&] { ReflectSpirv(code); }), "rejects a variable whose type is not a pointer");
+  code = MakeComputeModule();
+  const size_t pointer = FindInstruction(code, OpTypePointer);
+  code[pointer] = 3 << 16 | OpTypePointer; // Result id and storage class, but no pointee
+  code[pointer + 3] = 1 << 16 | OpNop;
+  passed &= Check(SUITE, Throws([&] { ReflectSpirv(code); }), "rejects a pointer type without a pointee");
+  code = MakeComputeModule();
+  code[FindInstruction(code, OpTypeFloat) + 1] = scalar;
+  passed &= Check(SUITE, Throws([&] { ReflectSpirv(code); }), "rejects an id defined twice");
+  return passed;
+}
+
+bool RunArchiveChecks(const std::filesystem::path& dir)
+{
+  bool passed = true;
+  std::vector<ShaderSource> sources = {
+      {"stress.comp", MakeComputeModule()}, {"shader.vert", MakeVertexModule()}, {"shader.frag", MakeFragmentModule()}};
+  std::vector<std::byte> bytes = BuildShaderArchive(sources);
+
+  // The code is a view into the archive's bytes, at an aligned offset
+  auto checkArchive = [&](const ShaderArchive& archive, const char* what) {
+    bool ok = archive.GetShaders().size() == sources.size() && archive.Find("missing.vert") == nullptr &&
+              archive.Find("shader") == nullptr;
+    const auto* base = reinterpret_cast<const std::byte*>(archive.GetShaders().data()) - sizeof(ShaderArchiveHeader);
+    for (const ShaderSource& source : sources)
+    {
+      const ShaderArchiveEntry* shader = archive.Find(source.name);
+      ok = ok && shader != nullptr && std::ranges::equal(archive.GetCode(*shader), source.code) &&
+           reinterpret_cast<const std::byte*>(archive.GetCode(*shader).data()) == base + shader->codeOffset &&
+           shader->codeOffset % SHADER_CODE_ALIGNMENT == 0 &&
+           shader->codeHash == HashShaderCode(source.code) &&
+           SameReflection(archive.GetReflection(*shader), ReflectSpirv(source.code));
+    }
+    return Check(SUITE, ok, what);
+  };
+  passed &= checkArchive(ShaderArchive(bytes, "embedded"), "embedded archive round trip");
+  const std::string path = (dir / "shaders.vkshaders").string();
+  WriteShaderArchive(bytes, path);
+  passed &= checkArchive(ShaderArchive(path), "mapped archive round trip");
+  passed &= Check(SUITE, ShaderArchive(bytes, "embedded").GetShaders().front().name == std::string("shader.frag"),
+                  "shaders sorted by name");
+
+  auto rejects = [&](std::vector<std::byte> corrupt, const char* what) {
+    return Check(SUITE, Throws([&] { ShaderArchive(corrupt, "corrupt"); }), what);
+  };
+  std::vector<std::byte> corrupt = bytes;
+  corrupt[0] = std::byte{'X'};
+  passed &= rejects(corrupt, "rejects a bad magic");
+  passed &= rejects(std::vector<std::byte>(bytes.begin(), bytes.end() - 16), "rejects a truncated archive");
+  corrupt = bytes;
+  const ShaderArchiveEntry& last = ShaderArchive(bytes, "embedded").GetShaders().back();
+  corrupt[last.codeOffset + last.codeSize - 1] ^= std::byte{1};
+  passed &= rejects(corrupt, "rejects a code hash mismatch");
+  corrupt = bytes;
+  auto* entries = reinterpret_cast<ShaderArchiveEntry*>(corrupt.data() + sizeof(ShaderArchiveHeader));
+  std::swap(entries[0], entries[1]);
+  passed &= rejects(corrupt, "rejects an unsorted shader table");
+  corrupt = bytes;
+  entries = reinterpret_cast<ShaderArchiveEntry*>(corrupt.data() + sizeof(ShaderArchiveHeader));
+  entries[0].bindingCount = 100;
+  passed &= rejects(corrupt, "rejects bindings out of bounds");
+  corrupt = bytes;
+  entries = reinterpret_cast<ShaderArchiveEntry*>(corrupt.data() + sizeof(ShaderArchiveHeader));
+  entries[0].stage = 0x03; // Two stages at once
+  passed &= rejects(corrupt, "rejects an unknown stage");
+  corrupt = bytes;
+  const auto* header = reinterpret_cast<const ShaderArchiveHeader*>(corrupt.data());
+  auto* bindings = reinterpret_cast<ShaderArchiveBinding*>(corrupt.data() + header->bindingTableOffset);
+  bindings[header->bindingCount - 1].descriptorType = 8; // Past StorageBuffer
+  passed &= rejects(corrupt, "rejects an unknown descriptor type");
+
+  sources.push_back({"shader.vert", MakeVertexModule()});
+  passed &= Check(SUITE, Throws([&] { BuildShaderArchive(sources); }), "rejects duplicate names");
+  const std::string longName(SHADER_NAME_SIZE, 'a');
+  passed &= Check(SUITE, Throws([&] { BuildShaderArchive({{longName, MakeVertexModule()}}); }), "rejects over-long names");
+  return passed;
+}
+
+} // namespace
+
+bool RunShaderSuite(BenchReport& report, uint32_t iterations)
+{
+  bool passed = true;
+  MetricSeries reflectTime{"reflect_us", {}};
+  MetricSeries loadTime{"archive_load_us", {}};
+  size_t archiveSize = 0;
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "VulkanAppBench_shaders";
+  std::filesystem::create_directories(dir);
+  try
+  {
+    passed &= RunReflectionChecks();
+    passed &= RunArchiveChecks(dir);
+
+    // An archive the size of a real application's, loaded the way the renderer does
+    std::vector<ShaderSource> sources;
+    for (uint32_t i = 0; i < ARCHIVE_SHADERS; i++)
+    {
+      sources.push_back({"shader" + std::to_string(i) + ".comp", MakeComputeModule(ARCHIVE_SHADER_WORDS)});
+    }
+    const std::vector<std::byte> bytes = BuildShaderArchive(sources);
+    archiveSize = bytes.size();
+    const uint32_t samples = std::clamp(iterations, 1u, MAX_SAMPLES);
+    for (uint32_t sample = 0; sample < samples; sample++)
+    {
+      Clock::time_point start = Clock::now();
+      ShaderReflection reflection = ReflectSpirv(sources[sample % ARCHIVE_SHADERS].code);
+      reflectTime.samples.push_back(ElapsedMs(start) * 1000.0);
+      start = Clock::now();
+      ShaderArchive archive(bytes, "embedded");
+      loadTime.samples.push_back(ElapsedMs(start) * 1000.0);
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Shader suite error: " << e.what() << std::endl;
+    passed = false;
+  }
+  std::error_code error;
+  std::filesystem::remove_all(dir, error);
+
+  report.config.emplace_back("archive_shaders", std::to_string(ARCHIVE_SHADERS));
+  report.config.emplace_back("archive_kb", Format(archiveSize / 1024.0));
+  report.config.emplace_back("samples", std::to_string(loadTime.samples.size()));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(reflectTime.name, Summarize(reflectTime.samples));
+  report.metrics.emplace_back(loadTime.name, Summarize(loadTime.samples));
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
@@ -0,0 +1,305 @@
+// Streaming suite: AssetStreamer on real files in the temp directory, with a
+// fake asset whose Upload copies into a staging-sized buffer. Checks priority
+// order, re-prioritization, cancellation at every stage, failed reads and the
+// per-frame byte budget, then simulates a frame loop that requests assets
+// every frame and reports the cost of Update on the frame thread, request
+// latency and queue depth.
+
+#include "CpuSuites.h"
+
+#include "assets/AssetStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace VulkanApp::Assets;
+
+constexpr uint32_t FILE_COUNT = 32;
+constexpr uint64_t FILE_GRANULE = 64 * 1024;         // File i is (1 + i % 16) granules
+constexpr uint64_t FRAME_BUDGET = 4ull * 1024 * 1024; // Bytes handed off per simulated frame
+constexpr uint32_t REQUESTS_PER_FRAME = 8;
+constexpr auto FRAME_TIME = std::chrono::milliseconds(1);
+constexpr auto DRAIN_TIMEOUT = std::chrono::seconds(10);
+
+constexpr const char* SUITE = "Streaming";
+
+// Uploads by copying into a buffer shared by every asset, like the staging ring
+class CopyAsset : public StreamedAsset
+{
+public:
+  CopyAsset(MappedFile file, std::vector<std::byte>& staging)
+      : _file(std::move(file)), _staging(staging)
+  {
+  }
+
+  uint64_t Upload(uint64_t maxBytes) override
+  {
+    std::span<const std::byte> bytes = _file.GetBytes();
+    uint64_t size = std::min<uint64_t>({maxBytes, bytes.size() - _offset, _staging.size()});
+    std::memcpy(_staging.data(), bytes.data() + _offset, size);
+    _offset += size;
+    return size;
+  }
+
+  bool IsUploaded() const override { return _offset == _file.GetSize(); }
+
+  // First byte of the file, which encodes its index
+  uint32_t GetTag() const { return static_cast<uint32_t>(_file.GetBytes()[0]); }
+
+private:
+  MappedFile _file;
+  std::vector<std::byte>& _staging;
+  uint64_t _offset = 0;
+};
+
+// Hands its whole file off in one piece whatever the budget, like a texture
+// level that is never split
+class WholeAsset : public StreamedAsset
+{
+public:
+  explicit WholeAsset(MappedFile file) : _file(std::move(file)) {}
+
+  uint64_t Upload(uint64_t) override
+  {
+    _uploaded = true;
+    return _file.GetSize();
+  }
+
+  bool IsUploaded() const override { return _uploaded; }
+
+private:
+  MappedFile _file;
+  bool _uploaded = false;
+};
+
+AssetDecoder MakeDecoder(std::vector<std::byte>& staging)
+{
+  return [&staging](MappedFile file) -> std::unique_ptr<StreamedAsset> {
+    if (file.GetSize() == 0)
+    {
+      throw std::runtime_error("empty file");
+    }
+    return std::make_unique<CopyAsset>(std::move(file), staging);
+  };
+}
+
+std::vector<std::string> WriteFiles(const std::filesystem::path& dir)
+{
+  std::vector<std::string> paths;
+  for (uint32_t i = 0; i < FILE_COUNT; i++)
+  {
+    std::string path = (dir / ("asset" + std::to_string(i) + ".bin")).string();
+    std::vector<char> bytes((1 + i % 16) * FILE_GRANULE, static_cast<char>(i));
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    paths.push_back(path);
+  }
+  return paths;
+}
+
+// Updates with no budget until every request has been decoded or failed
+bool WaitUntilDecoded(AssetStreamer& streamer)
+{
+  Clock::time_point deadline = Clock::now() + DRAIN_TIMEOUT;
+  while (Clock::now() < deadline)
+  {
+    streamer.Update(0);
+    AssetStreamer::Stats stats = streamer.GetStats();
+    if (stats.waitingForRead == 0 && stats.waitingForDecode == 0 && stats.inFlight == 0)
+    {
+      streamer.Update(0); // Picks up the last decoded assets
+      return true;
+    }
+    std::this_thread::sleep_for(FRAME_TIME);
+  }
+  return false;
+}
+
+bool RunOrderChecks(const std::vector<std::string>& paths, std::vector<std::byte>& staging)
+{
+  bool passed = true;
+  AssetStreamer streamer;
+  std::vector<uint32_t> readyOrder;
+  auto onReady = [&readyOrder](StreamRequestId, std::unique_ptr<StreamedAsset> asset) {
+    readyOrder.push_back(asset ? static_cast<CopyAsset&>(*asset).GetTag() : UINT32_MAX);
+  };
+
+  // Priority = index, so the expected order is descending index
+  std::vector<StreamRequestId> ids;
+  for (uint32_t i = 0; i < FILE_COUNT; i++)
+  {
+    ids.push_back(streamer.Request(paths[i], static_cast<float>(i), MakeDecoder(staging), onReady));
+  }
+  passed &= Check(SUITE, WaitUntilDecoded(streamer), "requests decoded in time");
+  passed &= Check(SUITE, readyOrder.empty(), "nothing handed off with a zero budget");
+  passed &= Check(SUITE, streamer.GetStats().uploading == FILE_COUNT, "every decoded asset waits for budget");
+
+  streamer.SetPriority(ids[0], 1000.0f); // Lowest to highest
+  passed &= Check(SUITE, streamer.Cancel(ids[5]) && streamer.Cancel(ids[6]), "cancel while waiting for upload");
+  passed &= Check(SUITE, !streamer.Cancel(ids[5]), "second cancel is a no-op");
+
+  bool withinBudget = true;
+  for (uint32_t frame = 0; frame < 4 * FILE_COUNT && streamer.GetStats().uploading > 0; frame++)
+  {
+    streamer.Update(16 * FILE_GRANULE);
+    withinBudget &= streamer.GetStats().lastUpdateBytes <= 16 * FILE_GRANULE;
+  }
+  passed &= Check(SUITE, withinBudget, "per-frame budget respected");
+
+  std::vector<uint32_t> expected = {0};
+  for (uint32_t i = FILE_COUNT - 1; i > 0; i--)
+  {
+    if (i != 5 && i != 6) expected.push_back(i);
+  }
+  passed &= Check(SUITE, readyOrder == expected, "ready order follows priority");
+  AssetStreamer::Stats stats = streamer.GetStats();
+  passed &= Check(SUITE, stats.completed == FILE_COUNT - 2 && stats.cancelled == 2, "completed and cancelled counts");
+  passed &= Check(SUITE, stats.bytesUploaded == stats.bytesRead - (6 + 7) * FILE_GRANULE, "bytes uploaded");
+  return passed;
+}
+
+bool RunCancelAndFailureChecks(const std::vector<std::string>& paths, std::vector<std::byte>& staging,
+                               const std::filesystem::path& dir)
+{
+  bool passed = true;
+  AssetStreamer streamer;
+  uint32_t ready = 0;
+  uint32_t failed = 0;
+  auto onReady = [&](StreamRequestId, std::unique_ptr<StreamedAsset> asset) { (asset ? ready : failed)++; };
+
+  // Cancelled right away, at whatever stage the workers got it to
+  for (const std::string& path : paths)
+  {
+    StreamRequestId id = streamer.Request(path, 0.0f, MakeDecoder(staging), onReady);
+    passed &= Check(SUITE, streamer.Cancel(id), "cancel right after request");
+  }
+  streamer.Request((dir / "missing.bin").string(), 0.0f, MakeDecoder(staging), onReady);
+  std::string emptyPath = (dir / "empty.bin").string();
+  std::ofstream(emptyPath, std::ios::binary | std::ios::trunc).close();
+  streamer.Request(emptyPath, 0.0f, MakeDecoder(staging), onReady);
+
+  passed &= Check(SUITE, WaitUntilDecoded(streamer), "failures reported in time");
+  streamer.Update(UINT64_MAX);
+  AssetStreamer::Stats stats = streamer.GetStats();
+  passed &= Check(SUITE, ready == 0 && failed == 2, "cancelled requests never ready, failures reported once");
+  passed &= Check(SUITE, stats.cancelled == FILE_COUNT && stats.failed == 2, "cancel and failure counts");
+  passed &= Check(SUITE, stats.inFlight == 0 && stats.uploading == 0, "queues empty after cancellation");
+
+  // Cancelled mid-upload: goes to the retire function, not the callback
+  uint32_t retired = 0;
+  streamer.SetRetireFunction([&retired](std::unique_ptr<StreamedAsset>) { retired++; });
+  StreamRequestId id = streamer.Request(paths[15], 0.0f, MakeDecoder(staging), onReady);
+  passed &= Check(SUITE, WaitUntilDecoded(streamer), "request decoded in time");
+  streamer.Update(FILE_GRANULE);
+  passed &= Check(SUITE, streamer.Cancel(id) && retired == 1 && ready == 0, "cancel mid-upload retires the asset");
+  return passed;
+}
+
+// An unsplittable piece overruns the budget; the stats must show the overrun
+bool RunOverrunChecks(const std::vector<std::string>& paths)
+{
+  bool passed = true;
+  AssetStreamer streamer;
+  uint32_t ready = 0;
+  auto decoder = [](MappedFile file) -> std::unique_ptr<StreamedAsset> {
+    return std::make_unique<WholeAsset>(std::move(file));
+  };
+  streamer.Request(paths[15], 0.0f, decoder, [&ready](StreamRequestId, std::unique_ptr<StreamedAsset>) { ready++; });
+  passed &= Check(SUITE, WaitUntilDecoded(streamer), "request decoded in time");
+  streamer.Update(FILE_GRANULE);
+  AssetStreamer::Stats stats = streamer.GetStats();
+  passed &= Check(SUITE, ready == 1 && stats.lastUpdateBytes == 16 * FILE_GRANULE &&
+                             stats.bytesUploaded == 16 * FILE_GRANULE,
+                  "budget overrun by an unsplittable piece is reported");
+  return passed;
+}
+
+} // namespace
+
+bool RunStreamingSuite(BenchReport& report, uint32_t iterations)
+{
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "VulkanAppBench_streaming";
+  std::filesystem::create_directories(dir);
+  std::vector<std::byte> staging(FRAME_BUDGET);
+
+  bool passed = true;
+  MetricSeries updateTime{"stream_update_us", {}};
+  MetricSeries latency{"stream_latency_ms", {}};
+  MetricSeries queueDepth{"stream_queue_depth", {}};
+  uint32_t frames = 0;
+  AssetStreamer::Stats finalStats;
+  const uint32_t requests = std::clamp(iterations, FILE_COUNT, 4096u);
+  try
+  {
+    std::vector<std::string> paths = WriteFiles(dir);
+    passed &= RunOrderChecks(paths, staging);
+    passed &= RunCancelAndFailureChecks(paths, staging, dir);
+    passed &= RunOverrunChecks(paths);
+
+    // Frame loop: a few requests per frame at random distances, one Update per frame
+    AssetStreamer streamer;
+    std::unordered_map<StreamRequestId, Clock::time_point> requested;
+    auto onReady = [&](StreamRequestId id, std::unique_ptr<StreamedAsset>) {
+      latency.samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - requested.at(id)).count());
+      requested.erase(id);
+    };
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> distance(1.0f, 1000.0f);
+    uint32_t issued = 0;
+    Clock::time_point deadline = Clock::now() + DRAIN_TIMEOUT * 6;
+    while ((issued < requests || !requested.empty()) && Clock::now() < deadline)
+    {
+      for (uint32_t i = 0; i < REQUESTS_PER_FRAME && issued < requests; i++, issued++)
+      {
+        StreamRequestId id = streamer.Request(paths[rng() % FILE_COUNT], PriorityFromDistance(distance(rng)),
+                                              MakeDecoder(staging), onReady);
+        requested[id] = Clock::now();
+      }
+      Clock::time_point start = Clock::now();
+      streamer.Update(FRAME_BUDGET);
+      updateTime.samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+      AssetStreamer::Stats stats = streamer.GetStats();
+      queueDepth.samples.push_back(stats.waitingForRead + stats.waitingForDecode + stats.inFlight + stats.uploading);
+      frames++;
+      std::this_thread::sleep_for(FRAME_TIME);
+    }
+    finalStats = streamer.GetStats();
+    passed &= Check(SUITE, requested.empty() && finalStats.completed == requests, "every frame-loop request completed");
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Streaming suite error: " << e.what() << std::endl;
+    passed = false;
+  }
+  std::error_code error;
+  std::filesystem::remove_all(dir, error);
+
+  report.config.emplace_back("requests", std::to_string(requests));
+  report.config.emplace_back("files", std::to_string(FILE_COUNT));
+  report.config.emplace_back("frame_budget_bytes", std::to_string(FRAME_BUDGET));
+  report.config.emplace_back("frames", std::to_string(frames));
+  report.config.emplace_back("bytes_read", std::to_string(finalStats.bytesRead));
+  report.config.emplace_back("bytes_uploaded", std::to_string(finalStats.bytesUploaded));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(updateTime.name, Summarize(updateTime.samples));
+  report.metrics.emplace_back(latency.name, Summarize(latency.samples));
+  report.metrics.emplace_back(queueDepth.name, Summarize(queueDepth.samples));
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
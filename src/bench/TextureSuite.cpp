@@ -0,0 +1,465 @@
+// Texture suite: KTX2 parsing and the CPU fallback decoder for the
+// block-compressed formats. Checks a mip chain round trip through a KTX2 file,
+// the rejection of malformed files, every BCn format against hand-encoded
+// blocks, the BC7 partition and anchor tables, and the memory BC1 and BC7
+// save over RGBA8. Times the parse and the decode of a 1024x1024 level.
+
+#include "CpuSuites.h"
+
+#include "assets/TextureDecoder.h"
+#include "assets/TextureFile.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace VulkanApp::Bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace VulkanApp::Assets;
+using Bytes = std::vector<std::byte>;
+
+constexpr uint32_t DECODE_SIZE = 1024; // Texels per side of the timed level
+constexpr uint32_t MAX_SAMPLES = 50;
+constexpr uint32_t PARSE_SAMPLES = 1000;
+
+constexpr const char* SUITE = "Texture";
+
+template <typename T>
+void Put(Bytes& data, size_t offset, const T& value)
+{
+  if (data.size() < offset + sizeof(T))
+  {
+    data.resize(offset + sizeof(T));
+  }
+  std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+// Header fields a test may corrupt before writing
+struct Ktx2Fields
+{
+  uint32_t vkFormat;
+  uint32_t width;
+  uint32_t height;
+  uint32_t levelCount;
+  uint32_t faceCount = 1;
+  uint32_t supercompressionScheme = 0;
+};
+
+// A minimal KTX2 file: header, level index and the levels, smallest first.
+// There is no data format descriptor, since TextureFile does not read one.
+Bytes MakeKtx2(const Ktx2Fields& fields, const std::vector<Bytes>& levels)
+{
+  constexpr uint8_t identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+  Bytes file(80 + levels.size() * 24);
+  std::memcpy(file.data(), identifier, sizeof(identifier));
+  const uint32_t header[] = {fields.vkFormat, 1, fields.width, fields.height, 0, 0, fields.faceCount,
+                             fields.levelCount, fields.supercompressionScheme};
+  std::memcpy(file.data() + 12, header, sizeof(header));
+
+  std::vector<uint64_t> offsets(levels.size());
+  for (size_t level = levels.size(); level-- > 0;)
+  {
+    offsets[level] = (file.size() + 15) & ~uint64_t(15);
+    file.resize(offsets[level]);
+    file.insert(file.end(), levels[level].begin(), levels[level].end());
+  }
+  for (size_t level = 0; level < levels.size(); level++)
+  {
+    const uint64_t index[3] = {offsets[level], levels[level].size(), levels[level].size()};
+    std::memcpy(file.data() + 80 + level * 24, index, sizeof(index));
+  }
+  return file;
+}
+
+void WriteFile(const std::filesystem::path& path, const Bytes& data)
+{
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+Bytes RandomBytes(size_t size, std::mt19937& rng)
+{
+  Bytes data(size);
+  for (std::byte& b : data)
+  {
+    b = static_cast<std::byte>(rng());
+  }
+  return data;
+}
+
+// A full mip chain of random blocks
+std::vector<Bytes> RandomLevels(TextureFormat format, uint32_t width, uint32_t height, std::mt19937& rng)
+{
+  std::vector<Bytes> levels;
+  for (uint32_t level = 0; level < static_cast<uint32_t>(std::bit_width(std::max(width, height))); level++)
+  {
+    levels.push_back(RandomBytes(GetTextureLevelSize(format, std::max(width >> level, 1u),
+                                                     std::max(height >> level, 1u)), rng));
+  }
+  return levels;
+}
+
+bool RunFileChecks(const std::filesystem::path& dir)
+{
+  bool passed = true;
+  std::mt19937 rng(11);
+  const std::vector<Bytes> levels = RandomLevels(TextureFormat::Bc7Srgb, 64, 32, rng);
+  const Ktx2Fields fields{static_cast<uint32_t>(TextureFormat::Bc7Srgb), 64, 32,
+                          static_cast<uint32_t>(levels.size())};
+  const std::filesystem::path path = dir / "valid.ktx2";
+  WriteFile(path, MakeKtx2(fields, levels));
+  {
+    TextureFile file(path.string());
+    bool levelsMatch = file.GetLevelCount() == 7;
+    for (uint32_t level = 0; levelsMatch && level < file.GetLevelCount(); level++)
+    {
+      std::span<const std::byte> data = file.GetLevelData(level);
+      levelsMatch &= std::equal(data.begin(), data.end(), levels[level].begin(), levels[level].end());
+    }
+    passed &= Check(SUITE, file.GetFormat() == TextureFormat::Bc7Srgb && file.GetWidth() == 64 && file.GetHeight() == 32 &&
+                             file.GetLevelWidth(6) == 1 && file.GetLevelHeight(6) == 1 && levelsMatch,
+                    "KTX2 mip chain round trip");
+  }
+
+  // Each of these must be rejected with an exception, never read out of bounds
+  auto rejected = [&](const char* name, const Bytes& data) {
+    const std::filesystem::path badPath = dir / (std::string(name) + ".ktx2");
+    WriteFile(badPath, data);
+    try
+    {
+      TextureFile file(badPath.string());
+      std::cerr << "Texture check failed: accepted " << name << std::endl;
+      return false;
+    }
+    catch (const std::runtime_error&)
+    {
+      return true;
+    }
+  };
+  const Bytes valid = MakeKtx2(fields, levels);
+  Bytes badIdentifier = valid;
+  badIdentifier[5] = std::byte{'1'};
+  Bytes truncated = valid;
+  truncated.resize(truncated.size() - 1); // Level 0 is last in the file
+  Bytes badLevelSize = valid;
+  Put<uint64_t>(badLevelSize, 80 + 8, levels[0].size() - 16);
+  Bytes badLevelOffset = valid;
+  Put<uint64_t>(badLevelOffset, 80, UINT64_MAX - 8);
+  Ktx2Fields tooManyLevels = fields;
+  tooManyLevels.levelCount = 8;
+  std::vector<Bytes> extraLevels = levels;
+  extraLevels.push_back(levels.back());
+  Ktx2Fields cube = fields;
+  cube.faceCount = 6;
+  Ktx2Fields supercompressed = fields;
+  supercompressed.supercompressionScheme = 2; // Zstandard
+  Ktx2Fields bc6h = fields;
+  bc6h.vkFormat = 143; // VK_FORMAT_BC6H_UFLOAT_BLOCK
+  Ktx2Fields empty = fields;
+  empty.width = 0;
+
+  passed &= Check(SUITE, rejected("header", Bytes(valid.begin(), valid.begin() + 60)), "short header rejected");
+  passed &= Check(SUITE, rejected("identifier", badIdentifier), "bad identifier rejected");
+  passed &= Check(SUITE, rejected("truncated", truncated), "truncated level rejected");
+  passed &= Check(SUITE, rejected("level_size", badLevelSize), "wrong level size rejected");
+  passed &= Check(SUITE, rejected("level_offset", badLevelOffset), "overflowing level offset rejected");
+  passed &= Check(SUITE, rejected("levels", MakeKtx2(tooManyLevels, extraLevels)), "too many levels rejected");
+  passed &= Check(SUITE, rejected("cube", MakeKtx2(cube, levels)), "cube map rejected");
+  passed &= Check(SUITE, rejected("zstd", MakeKtx2(supercompressed, levels)), "supercompression rejected");
+  passed &= Check(SUITE, rejected("bc6h", MakeKtx2(bc6h, levels)), "unsupported format rejected");
+  passed &= Check(SUITE, rejected("empty", MakeKtx2(empty, levels)), "zero width rejected");
+  return passed;
+}
+
+using Texels = std::array<uint8_t, 64>;
+
+Texels Decode(TextureFormat format, const Bytes& block)
+{
+  Texels texels;
+  DecodeBlock(format, block.data(), texels.data());
+  return texels;
+}
+
+bool TexelIs(const Texels& texels, uint32_t texel, std::array<uint8_t, 4> rgba)
+{
+  return std::equal(rgba.begin(), rgba.end(), texels.begin() + texel * 4);
+}
+
+// LSB-first bit packing, as BC7 blocks are laid out
+class BitWriter
+{
+public:
+  void Write(uint32_t value, uint32_t count)
+  {
+    for (uint32_t i = 0; i < count; i++, _position++)
+    {
+      if ((value >> i) & 1)
+      {
+        _block[_position / 8] |= std::byte(1u << (_position % 8));
+      }
+    }
+  }
+
+  Bytes Take() const { return Bytes(_block.begin(), _block.end()); }
+
+private:
+  std::array<std::byte, 16> _block{};
+  uint32_t _position = 0;
+};
+
+bool RunBcChecks()
+{
+  bool passed = true;
+  Bytes block(8);
+
+  // BC1: red (0xF800) > blue (0x001F) picks four colors; texels use indices 0, 1, 2, 3, 0, ...
+  Put<uint16_t>(block, 0, 0xF800);
+  Put<uint16_t>(block, 2, 0x001F);
+  Put<uint32_t>(block, 4, 0xE4E4E4E4);
+  Texels texels = Decode(TextureFormat::Bc1RgbaUnorm, block);
+  passed &= Check(SUITE, TexelIs(texels, 0, {255, 0, 0, 255}) && TexelIs(texels, 1, {0, 0, 255, 255}) &&
+                           TexelIs(texels, 2, {170, 0, 85, 255}) && TexelIs(texels, 3, {85, 0, 170, 255}),
+                  "BC1 four-color block");
+  // Swapped endpoints: three colors and transparent black
+  Put<uint16_t>(block, 0, 0x001F);
+  Put<uint16_t>(block, 2, 0xF800);
+  texels = Decode(TextureFormat::Bc1RgbaUnorm, block);
+  passed &= Check(SUITE, TexelIs(texels, 2, {128, 0, 128, 255}) && TexelIs(texels, 3, {0, 0, 0, 0}) &&
+                           TexelIs(Decode(TextureFormat::Bc1RgbUnorm, block), 3, {0, 0, 0, 255}),
+                  "BC1 three-color block with transparent black");
+
+  // BC4: 200 > 100 gives six interpolated values; 100 < 200 four plus 0 and 255
+  Bytes alpha(8);
+  alpha[0] = std::byte{200};
+  alpha[1] = std::byte{100};
+  Put<uint16_t>(alpha, 2, 0b111'110'010'001'000u); // Texels 0-4: indices 0, 1, 2, 6, 7
+  texels = Decode(TextureFormat::Bc4Unorm, alpha);
+  passed &= Check(SUITE, TexelIs(texels, 0, {200, 0, 0, 255}) && TexelIs(texels, 1, {100, 0, 0, 255}) &&
+                           TexelIs(texels, 2, {186, 0, 0, 255}) && TexelIs(texels, 3, {129, 0, 0, 255}) &&
+                           TexelIs(texels, 4, {114, 0, 0, 255}),
+                  "BC4 eight-value block");
+  std::swap(alpha[0], alpha[1]);
+  texels = Decode(TextureFormat::Bc4Unorm, alpha);
+  passed &= Check(SUITE, TexelIs(texels, 2, {120, 0, 0, 255}) && TexelIs(texels, 3, {0, 0, 0, 255}) &&
+                           TexelIs(texels, 4, {255, 0, 0, 255}),
+                  "BC4 six-value block with 0 and 255");
+
+  // BC3 = BC4 alpha + BC1 colors; BC5 = BC4 red + BC4 green
+  Bytes bc3 = alpha;
+  Put<uint16_t>(block, 0, 0x07E0); // Green; BC3 never has transparent black
+  Put<uint16_t>(block, 2, 0xFFFF);
+  bc3.insert(bc3.end(), block.begin(), block.end());
+  texels = Decode(TextureFormat::Bc3Unorm, bc3);
+  passed &= Check(SUITE, TexelIs(texels, 0, {0, 255, 0, 100}) && TexelIs(texels, 3, {170, 255, 170, 0}),
+                  "BC3 block");
+  Bytes bc5 = alpha;
+  Bytes green(8);
+  green[0] = std::byte{50};
+  green[1] = std::byte{50};
+  bc5.insert(bc5.end(), green.begin(), green.end());
+  texels = Decode(TextureFormat::Bc5Unorm, bc5);
+  passed &= Check(SUITE, TexelIs(texels, 4, {255, 50, 0, 255}), "BC5 block");
+
+  // BC2: explicit 4-bit alpha, scaled by 17
+  Bytes bc2(8);
+  Put<uint64_t>(bc2, 0, 0xFEDCBA9876543210ull);
+  bc2.insert(bc2.end(), block.begin(), block.end());
+  texels = Decode(TextureFormat::Bc2Unorm, bc2);
+  passed &= Check(SUITE, texels[3] == 0 && texels[7] == 17 && texels[63] == 255, "BC2 alpha");
+
+  // Edge blocks are clipped: a 5x3 level is 2x1 blocks
+  Bytes level = bc3;
+  level.insert(level.end(), bc3.begin(), bc3.end());
+  Bytes decoded = DecodeTextureLevel(TextureFormat::Bc3Unorm, level, 5, 3);
+  passed &= Check(SUITE, decoded.size() == 5 * 3 * 4 && decoded[4 * 4 + 3] == std::byte{100} &&
+                           decoded[(2 * 5 + 4) * 4 + 3] == std::byte{100},
+                  "edge blocks clipped to the level");
+  return passed;
+}
+
+bool RunBc7Checks()
+{
+  bool passed = true;
+
+  // Every anchor lies in its own subset, and the first subset's is texel 0
+  bool anchorsConsistent = true;
+  for (uint32_t subsets = 2; subsets <= 3; subsets++)
+  {
+    for (uint32_t partition = 0; partition < 64; partition++)
+    {
+      anchorsConsistent &= GetBc7AnchorTexel(subsets, partition, 0) == 0;
+      for (uint32_t subset = 0; subset < subsets; subset++)
+      {
+        anchorsConsistent &= GetBc7Subset(subsets, partition, GetBc7AnchorTexel(subsets, partition, subset)) == subset;
+      }
+    }
+  }
+  passed &= Check(SUITE, anchorsConsistent, "BC7 anchors lie in their subsets");
+
+  // Mode 6 (one subset, 7-bit RGBA + p-bit, 4-bit indices): the endpoints are
+  // exact 8-bit values, so each texel must be the spec's interpolation. An
+  // endpoint's p-bit is shared by its channels, hence one parity per endpoint.
+  constexpr uint8_t endpoints[2][4] = {{10, 200, 64, 254}, {241, 31, 129, 1}};
+  constexpr uint8_t weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+  BitWriter mode6;
+  mode6.Write(1u << 6, 7);
+  for (int c = 0; c < 4; c++)
+  {
+    mode6.Write(endpoints[0][c] >> 1, 7);
+    mode6.Write(endpoints[1][c] >> 1, 7);
+  }
+  mode6.Write(endpoints[0][0] & 1, 1);
+  mode6.Write(endpoints[1][0] & 1, 1);
+  for (uint32_t texel = 0; texel < 16; texel++)
+  {
+    mode6.Write(texel, texel == 0 ? 3 : 4); // Texel i uses index i; the anchor drops its top bit
+  }
+  Texels texels = Decode(TextureFormat::Bc7Unorm, mode6.Take());
+  bool mode6Exact = true;
+  for (uint32_t texel = 0; texel < 16; texel++)
+  {
+    for (int c = 0; c < 4; c++)
+    {
+      const uint32_t expected = ((64 - weights[texel]) * endpoints[0][c] + weights[texel] * endpoints[1][c] + 32) >> 6;
+      mode6Exact &= texels[texel * 4 + c] == expected;
+    }
+  }
+  passed &= Check(SUITE, mode6Exact, "BC7 mode 6 interpolation");
+
+  // Mode 1 (two subsets, shared p-bits): subset 0 black, subset 1 white, index
+  // 0 everywhere, so the decoded texels draw the partition
+  bool partitionsMatch = true;
+  for (uint32_t partition = 0; partition < 64; partition++)
+  {
+    BitWriter mode1;
+    mode1.Write(1u << 1, 2);
+    mode1.Write(partition, 6);
+    for (int c = 0; c < 3; c++)
+    {
+      mode1.Write(0, 12);     // Subset 0: both endpoints 0
+      mode1.Write(0xFFF, 12); // Subset 1: both endpoints 63
+    }
+    mode1.Write(0b10, 2); // p-bits: subset 1 gets 1, making it 255
+    Texels decoded = Decode(TextureFormat::Bc7Unorm, mode1.Take());
+    for (uint32_t texel = 0; texel < 16; texel++)
+    {
+      const uint8_t expected = GetBc7Subset(2, partition, texel) ? 255 : 0;
+      partitionsMatch &= decoded[texel * 4] == expected && decoded[texel * 4 + 3] == 255;
+    }
+  }
+  passed &= Check(SUITE, partitionsMatch, "BC7 mode 1 partitions");
+
+  // Mode 5 with rotation 1: the alpha endpoints land in red
+  BitWriter mode5;
+  mode5.Write(1u << 5, 6);
+  mode5.Write(1, 2);       // Rotation: swap red and alpha
+  mode5.Write(0x3FFF, 14); // Red endpoints 255
+  mode5.Write(0, 28);      // Green and blue endpoints 0
+  mode5.Write(40, 8);      // Alpha endpoints 40
+  mode5.Write(40, 8);
+  texels = Decode(TextureFormat::Bc7Unorm, mode5.Take());
+  passed &= Check(SUITE, TexelIs(texels, 15, {40, 0, 0, 255}), "BC7 mode 5 rotation");
+
+  passed &= Check(SUITE, TexelIs(Decode(TextureFormat::Bc7Unorm, Bytes(16)), 0, {0, 0, 0, 0}),
+                  "BC7 reserved mode decodes to transparent black");
+  return passed;
+}
+
+// Bytes of a full mip chain over the same chain as RGBA8
+double CompressionRatio(TextureFormat format, uint32_t size)
+{
+  uint64_t compressed = 0;
+  uint64_t uncompressed = 0;
+  for (uint32_t level = size; level > 0; level >>= 1)
+  {
+    compressed += GetTextureLevelSize(format, level, level);
+    uncompressed += GetTextureLevelSize(TextureFormat::Rgba8Unorm, level, level);
+  }
+  return static_cast<double>(uncompressed) / compressed;
+}
+
+} // namespace
+
+bool RunTextureSuite(BenchReport& report, uint32_t iterations)
+{
+  bool passed = true;
+  MetricSeries parseTime{"ktx2_parse_us", {}};
+  MetricSeries bc1Time{"decode_bc1_ms", {}};
+  MetricSeries bc7Time{"decode_bc7_ms", {}};
+  const double bc1Ratio = CompressionRatio(TextureFormat::Bc1RgbUnorm, 2048);
+  const double bc7Ratio = CompressionRatio(TextureFormat::Bc7Unorm, 2048);
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "VulkanAppBench_textures";
+  std::filesystem::create_directories(dir);
+  try
+  {
+    passed &= RunFileChecks(dir);
+    passed &= RunBcChecks();
+    passed &= RunBc7Checks();
+    passed &= Check(SUITE, bc1Ratio > 7.9 && bc1Ratio <= 8.0 && bc7Ratio > 3.9 && bc7Ratio <= 4.0,
+                    "BC1 stores 8x and BC7 4x fewer bytes than RGBA8");
+
+    // Parse: map and validate a 2048x2048 BC7 mip chain
+    std::mt19937 rng(3);
+    const std::filesystem::path path = dir / "parse.ktx2";
+    const std::vector<Bytes> levels = RandomLevels(TextureFormat::Bc7Unorm, 2048, 2048, rng);
+    WriteFile(path, MakeKtx2({static_cast<uint32_t>(TextureFormat::Bc7Unorm), 2048, 2048,
+                              static_cast<uint32_t>(levels.size())},
+                             levels));
+    for (uint32_t sample = 0; sample < PARSE_SAMPLES; sample++)
+    {
+      Clock::time_point start = Clock::now();
+      TextureFile file(path.string());
+      parseTime.samples.push_back(ElapsedMs(start) * 1000.0);
+    }
+
+    // Decode: random blocks exercise every BC7 mode and partition
+    const Bytes bc1 = RandomBytes(GetTextureLevelSize(TextureFormat::Bc1RgbUnorm, DECODE_SIZE, DECODE_SIZE), rng);
+    const Bytes bc7 = RandomBytes(GetTextureLevelSize(TextureFormat::Bc7Unorm, DECODE_SIZE, DECODE_SIZE), rng);
+    const uint32_t samples = std::clamp(iterations, 1u, MAX_SAMPLES);
+    for (uint32_t sample = 0; sample < samples; sample++)
+    {
+      Clock::time_point start = Clock::now();
+      Bytes decoded = DecodeTextureLevel(TextureFormat::Bc1RgbUnorm, bc1, DECODE_SIZE, DECODE_SIZE);
+      bc1Time.samples.push_back(ElapsedMs(start));
+      start = Clock::now();
+      decoded = DecodeTextureLevel(TextureFormat::Bc7Unorm, bc7, DECODE_SIZE, DECODE_SIZE);
+      bc7Time.samples.push_back(ElapsedMs(start));
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "Texture suite error: " << e.what() << std::endl;
+    passed = false;
+  }
+  std::error_code error;
+  std::filesystem::remove_all(dir, error);
+
+  // Megatexels per second at the median
+  auto throughput = [](const MetricSeries& series) {
+    return series.samples.empty() ? 0.0 : DECODE_SIZE * DECODE_SIZE / 1000.0 / Summarize(series.samples).p50;
+  };
+  report.config.emplace_back("decode_size", std::to_string(DECODE_SIZE));
+  report.config.emplace_back("samples", std::to_string(bc7Time.samples.size()));
+  report.config.emplace_back("bc1_ratio", Format(bc1Ratio));
+  report.config.emplace_back("bc7_ratio", Format(bc7Ratio));
+  report.config.emplace_back("decode_bc1_mtexels_per_s", Format(throughput(bc1Time)));
+  report.config.emplace_back("decode_bc7_mtexels_per_s", Format(throughput(bc7Time)));
+  report.config.emplace_back("checks", passed ? "passed" : "FAILED");
+  report.metrics.emplace_back(parseTime.name, Summarize(parseTime.samples));
+  report.metrics.emplace_back(bc1Time.name, Summarize(bc1Time.samples));
+  report.metrics.emplace_back(bc7Time.name, Summarize(bc7Time.samples));
+  return passed;
+}
+
+} // namespace VulkanApp::Bench
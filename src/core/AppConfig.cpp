@@ -0,0 +1,188 @@
+#include "AppConfig.h"
+
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+uint32_t ParseUnsigned(std::string_view option, const char* value)
+{
+  if (value == nullptr)
+  {
+    throw std::runtime_error("Missing value for " + std::string(option));
+  }
+  // stoul accepts a sign (wrapping "-1" around) and stops at trailing garbage,
+  // so only digits are let through and the whole value must be consumed
+  const std::string_view digits = value;
+  if (digits.empty() || digits.find_first_not_of("0123456789") != std::string_view::npos)
+  {
+    throw std::runtime_error("Invalid value for " + std::string(option) + ": " + value);
+  }
+  unsigned long long parsed = 0;
+  try
+  {
+    size_t pos = 0;
+    parsed = std::stoull(value, &pos);
+    if (pos != digits.size())
+    {
+      throw std::invalid_argument(value);
+    }
+  }
+  catch (const std::exception&)
+  {
+    throw std::runtime_error("Invalid value for " + std::string(option) + ": " + value);
+  }
+  if (parsed > std::numeric_limits<uint32_t>::max())
+  {
+    throw std::runtime_error("Value out of range for " + std::string(option) + ": " + value);
+  }
+  return static_cast<uint32_t>(parsed);
+}
+
+namespace
+{
+VkPresentModeKHR ParsePresentMode(std::string_view option, const char* value)
+{
+  if (value == nullptr)
+  {
+    throw std::runtime_error("Missing value for " + std::string(option));
+  }
+  std::string_view mode = value;
+  if (mode == "fifo") return VK_PRESENT_MODE_FIFO_KHR;
+  if (mode == "mailbox") return VK_PRESENT_MODE_MAILBOX_KHR;
+  if (mode == "immediate") return VK_PRESENT_MODE_IMMEDIATE_KHR;
+  throw std::runtime_error("Invalid value for " + std::string(option) + ": " + value);
+}
+
+// True for GPU (compute) animation
+bool ParseStressAnimation(std::string_view option, const char* value)
+{
+  if (value == nullptr)
+  {
+    throw std::runtime_error("Missing value for " + std::string(option));
+  }
+  std::string_view animation = value;
+  if (animation == "cpu") return false;
+  if (animation == "gpu") return true;
+  throw std::runtime_error("Invalid value for " + std::string(option) + ": " + value);
+}
+} // namespace
+
+bool ParseAppOption(AppConfig& config, int& index, int argc, char** argv)
+{
+  std::string_view arg = argv[index];
+  const char* next = (index + 1 < argc) ? argv[index + 1] : nullptr;
+
+  if (arg == "--headless")
+  {
+    config.headless = true;
+    return true;
+  }
+  if (arg == "--low-latency")
+  {
+    config.lowLatency = true;
+    return true;
+  }
+  if (arg == "--no-dynamic-rendering")
+  {
+    config.dynamicRendering = false;
+    return true;
+  }
+  if (arg == "--no-gpu-culling")
+  {
+    config.gpuCulling = false;
+    return true;
+  }
+  if (arg == "--no-bindless")
+  {
+    config.bindless = false;
+    return true;
+  }
+
+  if (arg == "--width") config.width = ParseUnsigned(arg, next);
+  else if (arg == "--height") config.height = ParseUnsigned(arg, next);
+  else if (arg == "--frames") config.frameCount = ParseUnsigned(arg, next);
+  else if (arg == "--frames-in-flight") config.framesInFlight = ParseUnsigned(arg, next);
+  else if (arg == "--present-mode") config.presentMode = ParsePresentMode(arg, next);
+  else if (arg == "--swapchain-images") config.swapchainImages = ParseUnsigned(arg, next);
+  else if (arg == "--draws") config.drawCount = ParseUnsigned(arg, next);
+  else if (arg == "--stress-instances") config.stressInstances = ParseUnsigned(arg, next);
+  else if (arg == "--stress-animation") config.stressGpuAnimation = ParseStressAnimation(arg, next);
+  else if (arg == "--stream-budget") config.streamBudgetMiB = ParseUnsigned(arg, next);
+  else if (arg == "--compile-threads") config.pipelineCompileThreads = ParseUnsigned(arg, next);
+  else if (arg == "--job-threads") config.jobThreads = ParseUnsigned(arg, next);
+  else if (arg == "--pipeline-cache")
+  {
+    if (next == nullptr)
+    {
+      throw std::runtime_error("Missing value for " + std::string(arg));
+    }
+    config.pipelineCachePath = next; // "" disables the on-disk cache
+  }
+  else return false;
+
+  index++; // Skip the consumed value
+  return true;
+}
+
+void FinalizeAppConfig(AppConfig& config)
+{
+  if (config.width == 0 || config.height == 0)
+  {
+    throw std::runtime_error("Width and height must be non-zero");
+  }
+  if (config.framesInFlight == 0 || config.framesInFlight > AppConfig::MAX_FRAMES_IN_FLIGHT)
+  {
+    throw std::runtime_error("Frames in flight must be between 1 and " +
+                             std::to_string(AppConfig::MAX_FRAMES_IN_FLIGHT));
+  }
+  if (config.streamBudgetMiB == 0)
+  {
+    throw std::runtime_error("Stream budget must be at least 1 MiB");
+  }
+  if (!config.frameCount)
+  {
+    config.frameCount = config.headless ? AppConfig::DEFAULT_HEADLESS_FRAMES : 0;
+  }
+}
+
+AppConfig ParseCommandLine(int argc, char** argv)
+{
+  AppConfig config;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!ParseAppOption(config, i, argc, argv))
+    {
+      throw std::runtime_error("Unknown argument: " + std::string(argv[i]));
+    }
+  }
+
+  FinalizeAppConfig(config);
+  return config;
+}
+
+void PrintUsage(const std::string& programName)
+{
+  std::cerr << "Usage: " << programName << " [options]\n"
+            << "  --headless              Render offscreen without a window or surface\n"
+            << "  --width N               Render width (default 800)\n"
+            << "  --height N              Render height (default 600)\n"
+            << "  --frames N              Exit after N frames (headless default "
+            << AppConfig::DEFAULT_HEADLESS_FRAMES << ")\n"
+            << "  --frames-in-flight N    CPU/GPU frame overlap (default 2, at most 8)\n"
+            << "  --present-mode MODE     fifo, mailbox or immediate (default mailbox)\n"
+            << "  --swapchain-images N    Swap chain image count, clamped to the surface (default: minimum + 1)\n"
+            << "  --low-latency           Pace frame starts to minimize input-to-present latency\n"
+            << "  --no-dynamic-rendering  Use render pass and framebuffer objects even if dynamic rendering is supported\n"
+            << "  --no-gpu-culling        Record every draw on the CPU instead of culling and drawing indirectly on the GPU\n"
+            << "  --no-bindless           Bind per-pipeline descriptor sets instead of the global descriptor table\n"
+            << "  --draws N               Triangle draws per frame (default 1)\n"
+            << "  --stress-instances N    Draw N animated instanced triangles instead of the grid (default 0 = off)\n"
+            << "  --stress-animation MODE Animate the stress scene on the cpu or gpu (default cpu)\n"
+            << "  --stream-budget MIB     Streamed asset data handed to GPU uploads per frame (default 16)\n"
+            << "  --pipeline-cache PATH   Pipeline cache file, \"\" to disable (default pipeline_cache.bin)\n"
+            << "  --compile-threads N     Pipeline compiler workers (default: hardware threads - 1)\n"
+            << "  --job-threads N         Job system workers besides the main thread (default: hardware threads - 1)\n";
+}
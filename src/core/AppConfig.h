@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <vulkan/vulkan.h>
+
+// Startup options, filled from the command line in main()
+struct AppConfig
+{
+  uint32_t width = 800;
+  uint32_t height = 600;
+
+  // Render into an offscreen image ring instead of a GLFW window/swap chain
+  bool headless = false;
+
+  // Number of frames to render before exiting (0 = run until the window closes).
+  // Left empty until FinalizeAppConfig: headless runs have no window to close,
+  // so they default to a finite count.
+  std::optional<uint32_t> frameCount;
+
+  // Frame loop tuning
+  uint32_t framesInFlight = 2;
+  // Per-frame resources (command buffers, uniform rings, query pools) scale with it
+  static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 8;
+  VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR; // Falls back to FIFO
+  uint32_t swapchainImages = 0; // 0 = surface minimum + 1
+  // Delay each frame's start (and input sampling) until just before the GPU
+  // or display can take it, trading throughput for input-to-present latency
+  bool lowLatency = false;
+  // Begin rendering on image views (VK_KHR_dynamic_rendering) when the device
+  // supports it; false keeps render pass and framebuffer objects
+  bool dynamicRendering = true;
+  // Cull the scene in a compute pass and draw it with indirect draws when the
+  // device supports it; false records one draw per object on the CPU
+  bool gpuCulling = true;
+  // Reach shader resources through one global descriptor table (descriptor
+  // indexing) when the device supports it; false keeps per-pipeline sets
+  bool bindless = true;
+  uint32_t drawCount = 1; // Scene size: triangle draws recorded per frame
+  // Replace the grid with N animated triangles drawn by one instanced draw
+  // (0 = off), animated on the CPU or, with stressGpuAnimation, in a compute pass
+  uint32_t stressInstances = 0;
+  bool stressGpuAnimation = false;
+  // Streamed asset data handed to GPU uploads per frame
+  uint32_t streamBudgetMiB = 16;
+
+  // Pipeline cache blob reused across launches (empty = in-memory only)
+  std::string pipelineCachePath = "pipeline_cache.bin";
+  uint32_t pipelineCompileThreads = 0; // 0 = hardware threads minus one
+  uint32_t jobThreads = 0; // Job system workers (command recording etc.); 0 = hardware threads minus one
+
+  static constexpr uint32_t DEFAULT_HEADLESS_FRAMES = 1000;
+};
+
+// Parses --headless, --width N, --height N, --frames N, --frames-in-flight N,
+// --present-mode fifo|mailbox|immediate, --swapchain-images N, --low-latency,
+// --no-dynamic-rendering, --no-gpu-culling, --no-bindless, --draws N, --stress-instances N,
+// --stress-animation cpu|gpu, --stream-budget MIB, --pipeline-cache PATH,
+// --compile-threads N and --job-threads N.
+// Throws std::runtime_error on unknown or malformed arguments.
+AppConfig ParseCommandLine(int argc, char** argv);
+
+// Consumes the option at argv[index] (and its value, advancing index) if it is
+// one of the options above. Lets other executables extend the command line.
+bool ParseAppOption(AppConfig& config, int& index, int argc, char** argv);
+
+// Parses the value of a numeric option: decimal digits only, at most UINT32_MAX.
+// Throws std::runtime_error naming the option if the value is missing or malformed.
+uint32_t ParseUnsigned(std::string_view option, const char* value);
+
+// Validates the parsed options and applies mode-dependent defaults
+void FinalizeAppConfig(AppConfig& config);
+
+// Prints the supported options
+void PrintUsage(const std::string& programName);
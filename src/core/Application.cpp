@@ -4,17 +4,18 @@
 #include "../platform/Window.h"
 #include "../vulkan/VulkanInstance.h"
 #include "../vulkan/VulkanDevice.h"
+#include "../vulkan/VulkanPipelineCache.h"
+#include "../vulkan/VulkanMemoryAllocator.h"
 #include "../vulkan/VulkanSwapChain.h"
+#include "../vulkan/VulkanOffscreenTarget.h"
 #include "../rendering/Renderer.h"
+#include "JobSystem.h"
 
 #include <stdexcept> // For exception handling
 #include <iostream>  // For logging
+#include <chrono>
 
-// Constants can be moved to a config header later
-const uint32_t INITIAL_WIDTH = 800;
-const uint32_t INITIAL_HEIGHT = 600;
-
-Application::Application()
+Application::Application(const AppConfig& config) : _config(config)
 {
   // Constructor can be empty if init() does all the work
 }
@@ -23,7 +24,7 @@ Application::~Application()
 {
   // Destructor is automatically correct thanks to std::unique_ptr
   // Order of destruction is reverse order of declaration in the header
-  // _renderer -> _vulkanSwapChain -> _vulkanDevice -> _vulkanInstance -> _window
+  // _renderer -> _presentTarget -> _pipelineCache (saves) -> _vulkanDevice -> _vulkanInstance -> _jobSystem -> _window
   std::cout << "Application shutting down." << std::endl;
 }
 
@@ -42,23 +43,54 @@ void Application::Run()
 
 void Application::InitWindow()
 {
-  _window = std::make_unique<Window>(INITIAL_WIDTH, INITIAL_HEIGHT, "Vulkan App");
+  if (_config.headless)
+  {
+    std::cout << "Headless mode: skipping window creation." << std::endl;
+    return;
+  }
+  _window = std::make_unique<Window>(_config.width, _config.height, "Vulkan App");
   std::cout << "Window initialized." << std::endl;
 }
 
 void Application::InitVulkan()
 {
+  // Engine-wide workers; the renderer fans command recording out to them
+  _jobSystem = std::make_unique<JobSystem>(_config.jobThreads);
+
   // Initialize core Vulkan components
-  _vulkanInstance = std::make_unique<VulkanInstance>(*_window); 
+  _vulkanInstance = std::make_unique<VulkanInstance>(_window.get()); // Null window = headless
   _vulkanDevice = std::make_unique<VulkanDevice>(*_vulkanInstance);
-  _vulkanSwapChain = std::make_unique<VulkanSwapChain>(*_vulkanDevice, *_window, _vulkanInstance->getSurface());
+  _pipelineCache = std::make_unique<VulkanPipelineCache>(*_vulkanDevice, _config.pipelineCachePath);
+
+  if (_config.headless)
+  {
+    // Offscreen ring size matches the Renderer's frames in flight
+    _presentTarget = std::make_unique<VulkanOffscreenTarget>(
+        *_vulkanDevice, VkExtent2D{_config.width, _config.height}, _config.framesInFlight);
+  }
+  else
+  {
+    _presentTarget = std::make_unique<VulkanSwapChain>(*_vulkanDevice, *_window, _vulkanInstance->getSurface(),
+                                                       _config.presentMode, _config.swapchainImages);
+  }
   
   // Explicitly get lvalue references
   VulkanDevice& deviceRef = *_vulkanDevice;
-  VulkanSwapChain& swapChainRef = *_vulkanSwapChain;
+  PresentTarget& presentTargetRef = *_presentTarget;
 
   // Create and initialize the Renderer using the explicit references
-  _renderer.reset(new VulkanApp::Rendering::Renderer(deviceRef, swapChainRef));
+  VulkanApp::Rendering::RendererSettings settings;
+  settings.maxFramesInFlight = _config.framesInFlight;
+  settings.drawCount = _config.drawCount;
+  settings.pipelineCompileThreads = _config.pipelineCompileThreads;
+  settings.lowLatency = _config.lowLatency;
+  settings.dynamicRendering = _config.dynamicRendering;
+  settings.gpuCulling = _config.gpuCulling;
+  settings.bindless = _config.bindless;
+  settings.stressInstances = _config.stressInstances;
+  settings.stressGpuAnimation = _config.stressGpuAnimation;
+  settings.streamBudget = static_cast<uint64_t>(_config.streamBudgetMiB) * 1024 * 1024;
+  _renderer.reset(new VulkanApp::Rendering::Renderer(deviceRef, presentTargetRef, *_pipelineCache, *_jobSystem, settings));
   _renderer->Init(); // Call the renderer's initialization
 
   std::cout << "--- Vulkan Initialized Successfully ---" << std::endl;
@@ -68,12 +100,38 @@ void Application::InitVulkan()
 void Application::MainLoop()
 {
   std::cout << "Starting main loop..." << std::endl;
-  while (!_window->shouldClose())
+  const uint32_t frameCount = *_config.frameCount; // Set by FinalizeAppConfig
+  uint32_t framesRendered = 0;
+  while (!_window || !_window->shouldClose())
   {
-    glfwPollEvents();
+    if (frameCount != 0 && framesRendered >= frameCount)
+    {
+      break;
+    }
+    // In low-latency mode this sleeps so that input is read as late as possible
+    _renderer->PaceFrameStart();
+    if (_window)
+    {
+      glfwPollEvents();
+      if (_window->consumeResized())
+      {
+        _renderer->NotifyResized();
+      }
+      if (_window->isMinimized())
+      {
+        glfwWaitEvents(); // Nothing to present; sleep until the window is restored
+        continue;
+      }
+    }
+    _renderer->MarkInputSampled();
     _renderer->DrawFrame(); // Delegate drawing to the renderer
+    framesRendered++;
+
+    // Persist newly compiled pipelines now and then, not only on a clean exit
+    _pipelineCache->saveIfDue(std::chrono::seconds(30));
   }
-  std::cout << "Main loop finished." << std::endl;
+  std::cout << "Main loop finished (" << framesRendered << " frames)." << std::endl;
+  _vulkanDevice->getAllocator().printStats();
 
   // Wait for the device to be idle before cleanup, especially before Application destructor runs
   // This prevents destroying resources while they might still be in use by the GPU.
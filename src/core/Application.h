@@ -3,11 +3,15 @@
 #include <memory> // For std::unique_ptr
 // Removed <vector> and vulkan includes if not directly needed by Application
 
+#include "AppConfig.h"
+
 // Forward declarations
 class Window;
 class VulkanInstance;
 class VulkanDevice;
-class VulkanSwapChain;
+class VulkanPipelineCache;
+class PresentTarget;
+class JobSystem;
 
 // Forward declare Renderer instead of including the full header
 namespace VulkanApp::Rendering { class Renderer; }
@@ -15,7 +19,7 @@ namespace VulkanApp::Rendering { class Renderer; }
 class Application
 {
 public:
-    Application();
+    explicit Application(const AppConfig& config);
     ~Application();
 
     void Run(); // Renamed for consistency maybe?
@@ -26,11 +30,15 @@ private:
     void MainLoop();
     void Cleanup();
 
+    AppConfig _config;
+
     // Order matters for initialization and destruction!
-    std::unique_ptr<Window> _window;
+    std::unique_ptr<Window> _window; // Null in headless mode
+    std::unique_ptr<JobSystem> _jobSystem; // Outlives every system that queues jobs
     std::unique_ptr<VulkanInstance> _vulkanInstance;
     std::unique_ptr<VulkanDevice> _vulkanDevice;
-    std::unique_ptr<VulkanSwapChain> _vulkanSwapChain;
+    std::unique_ptr<VulkanPipelineCache> _pipelineCache; // Outlives the Renderer's pipelines
+    std::unique_ptr<PresentTarget> _presentTarget; // Swap chain or offscreen image ring
     std::unique_ptr<VulkanApp::Rendering::Renderer> _renderer; // Added Renderer
 
     // No longer owns render pass, pipeline, etc.
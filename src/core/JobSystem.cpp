@@ -0,0 +1,261 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+thread_local int32_t t_workerIndex = -1;
+thread_local uint32_t t_stealSeed = 0;
+
+// Spins before a worker with nothing to do goes to sleep
+constexpr uint32_t IDLE_SPINS = 64;
+
+uint32_t NextRandom()
+{
+  // xorshift32; seeded per thread so thieves spread over victims
+  uint32_t x = t_stealSeed ? t_stealSeed : 0x9e3779b9u ^ static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  t_stealSeed = x;
+  return x;
+}
+} // namespace
+
+JobSystem::JobSystem(uint32_t workerCount)
+{
+  if (workerCount == 0)
+  {
+    uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    workerCount = std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+  }
+
+  for (uint32_t i = 0; i <= workerCount; i++)
+  {
+    _queues.push_back(std::make_unique<WorkQueue>());
+  }
+  _workers.reserve(workerCount);
+  for (uint32_t i = 0; i < workerCount; i++)
+  {
+    _workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+  }
+}
+
+JobSystem::~JobSystem()
+{
+  {
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+    _stopping = true;
+  }
+  _wake.notify_all();
+  for (std::thread& worker : _workers)
+  {
+    worker.join();
+  }
+}
+
+int32_t JobSystem::CurrentWorkerIndex()
+{
+  return t_workerIndex;
+}
+
+uint32_t JobSystem::CallerQueue() const
+{
+  return t_workerIndex >= 0 ? static_cast<uint32_t>(t_workerIndex) : static_cast<uint32_t>(_workers.size());
+}
+
+void JobSystem::Run(std::function<void()> function, JobCounter* counter)
+{
+  if (counter)
+  {
+    counter->_pending.fetch_add(1, std::memory_order_relaxed);
+  }
+  Push(Job{std::move(function), counter, 0});
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter)
+{
+  if (counter)
+  {
+    counter->_pending.fetch_add(1, std::memory_order_relaxed);
+  }
+  {
+    // Checked under the lock: Finish drains the continuations under it too
+    std::lock_guard<std::mutex> lock(dependency._mutex);
+    if (!dependency.IsDone())
+    {
+      dependency._continuations.push_back({std::move(function), counter});
+      return;
+    }
+  }
+  Push(Job{std::move(function), counter, 0});
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+  uint32_t ownQueue = CallerQueue();
+  while (!counter.IsDone())
+  {
+    Job job;
+    if (TryPop(ownQueue, job) || TrySteal(ownQueue, job))
+    {
+      Execute(job, ownQueue);
+    }
+    else
+    {
+      std::this_thread::yield(); // The remaining jobs are running on other threads
+    }
+  }
+  // The last Finish may still hold the counter's lock; once we get it the
+  // counter is untouched by the job system and the caller may destroy it
+  std::lock_guard<std::mutex> lock(counter._mutex);
+}
+
+JobSystem::Stats JobSystem::GetStats() const
+{
+  Stats stats;
+  stats.jobsExecuted = _jobsExecuted.load(std::memory_order_relaxed);
+  stats.jobsStolen = _jobsStolen.load(std::memory_order_relaxed);
+  stats.workerSleeps = _workerSleeps.load(std::memory_order_relaxed);
+  return stats;
+}
+
+// --- Private ---
+
+void JobSystem::Push(Job job)
+{
+  uint32_t queueIndex = CallerQueue();
+  job.queue = queueIndex;
+  _queuedJobs.fetch_add(1); // Before the push, so a pop never sees the count go negative
+  {
+    std::lock_guard<std::mutex> lock(_queues[queueIndex]->mutex);
+    _queues[queueIndex]->jobs.push_back(std::move(job));
+  }
+
+  // Pairs with the sleeper registering itself before re-checking _queuedJobs,
+  // so either it sees this job or we see it sleeping
+  if (_sleepingWorkers.load() > 0)
+  {
+    {
+      std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wake.notify_one();
+  }
+}
+
+bool JobSystem::TryPop(uint32_t ownQueue, Job& job)
+{
+  WorkQueue& queue = *_queues[ownQueue];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.jobs.empty())
+  {
+    return false;
+  }
+  // The injection queue is shared by outside threads, so it stays FIFO
+  if (ownQueue == _workers.size())
+  {
+    job = std::move(queue.jobs.front());
+    queue.jobs.pop_front();
+  }
+  else
+  {
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+  }
+  _queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool JobSystem::TrySteal(uint32_t ownQueue, Job& job)
+{
+  uint32_t queueCount = static_cast<uint32_t>(_queues.size());
+  uint32_t start = NextRandom() % queueCount;
+  for (uint32_t i = 0; i < queueCount; i++)
+  {
+    uint32_t victim = (start + i) % queueCount;
+    if (victim == ownQueue)
+    {
+      continue;
+    }
+    WorkQueue& queue = *_queues[victim];
+    std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+    if (!lock.owns_lock() || queue.jobs.empty())
+    {
+      continue; // Busy or empty; another victim is as good
+    }
+    job = std::move(queue.jobs.front());
+    queue.jobs.pop_front();
+    _queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void JobSystem::Execute(Job& job, uint32_t ownQueue)
+{
+  job.function();
+  _jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+  if (job.queue != ownQueue)
+  {
+    _jobsStolen.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (job.counter)
+  {
+    Finish(*job.counter);
+  }
+}
+
+void JobSystem::Finish(JobCounter& counter)
+{
+  std::vector<JobCounter::Continuation> continuations;
+  {
+    // Decrement under the lock so RunAfter can't register against a counter
+    // that has just reached zero but not yet been drained
+    std::lock_guard<std::mutex> lock(counter._mutex);
+    if (counter._pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+      return;
+    }
+    continuations.swap(counter._continuations);
+  }
+  for (JobCounter::Continuation& continuation : continuations)
+  {
+    Push(Job{std::move(continuation.function), continuation.counter, 0});
+  }
+}
+
+void JobSystem::WorkerLoop(uint32_t workerIndex)
+{
+  t_workerIndex = static_cast<int32_t>(workerIndex);
+  t_stealSeed = 0x9e3779b9u * (workerIndex + 1);
+  uint32_t idleSpins = 0;
+  while (true)
+  {
+    Job job;
+    if (TryPop(workerIndex, job) || TrySteal(workerIndex, job))
+    {
+      Execute(job, workerIndex);
+      idleSpins = 0;
+      continue;
+    }
+    if (++idleSpins < IDLE_SPINS)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    _sleepingWorkers.fetch_add(1);
+    if (_queuedJobs.load() == 0 && !_stopping)
+    {
+      _workerSleeps.fetch_add(1, std::memory_order_relaxed);
+      _wake.wait(lock, [this]() { return _queuedJobs.load() > 0 || _stopping; });
+    }
+    _sleepingWorkers.fetch_sub(1);
+    idleSpins = 0;
+    if (_stopping && _queuedJobs.load() == 0)
+    {
+      return; // Stopping and drained
+    }
+  }
+}
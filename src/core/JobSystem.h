@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Tracks a group of jobs: incremented when a job is queued against it and
+// decremented when the job finishes. Jobs queued with RunAfter start once
+// the counter drops to zero. Must outlive every job that references it; only
+// destroy it after JobSystem::Wait returned for it.
+class JobCounter
+{
+public:
+  JobCounter() = default;
+  JobCounter(const JobCounter&) = delete;
+  JobCounter& operator=(const JobCounter&) = delete;
+
+  bool IsDone() const { return _pending.load(std::memory_order_acquire) == 0; }
+  uint32_t GetPending() const { return _pending.load(std::memory_order_acquire); }
+
+private:
+  friend class JobSystem;
+
+  struct Continuation
+  {
+    std::function<void()> function;
+    JobCounter* counter;
+  };
+
+  std::atomic<uint32_t> _pending{0};
+  std::mutex _mutex; // Guards _continuations
+  std::vector<Continuation> _continuations;
+};
+
+// Work-stealing job system for short, fine-grained engine tasks (command
+// recording, culling, asset processing). Every worker owns a deque: it pushes
+// and pops its own jobs at the back (LIFO, cache-warm) while idle workers steal
+// from the front of others. Jobs queued from outside the pool (e.g. the main
+// thread) go to a shared injection deque that workers steal from as well.
+// Wait() lets the waiting thread execute jobs instead of blocking.
+// Jobs must not throw; an exception escaping a job terminates the program.
+// For long-running work that must never delay a frame, use ThreadPool.
+class JobSystem
+{
+public:
+  struct Stats
+  {
+    uint64_t jobsExecuted = 0;
+    uint64_t jobsStolen = 0;   // Executed by a thread other than the one that queued them
+    uint64_t workerSleeps = 0; // Times a worker found nothing to do and blocked
+  };
+
+  // workerCount 0 = one worker per hardware thread, minus one for the main thread
+  explicit JobSystem(uint32_t workerCount = 0);
+  ~JobSystem(); // Runs every queued job, then joins
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  uint32_t GetWorkerCount() const { return static_cast<uint32_t>(_workers.size()); }
+
+  // Index of the calling worker in [0, GetWorkerCount()), or -1 off the pool
+  static int32_t CurrentWorkerIndex();
+
+  // Queues a job; counter (optional) is incremented now and decremented when it finishes
+  void Run(std::function<void()> function, JobCounter* counter = nullptr);
+
+  // Queues a job that starts once dependency reaches zero (immediately if it already has)
+  void RunAfter(JobCounter& dependency, std::function<void()> function, JobCounter* counter = nullptr);
+
+  // Splits [0, count) into ranges of at most grainSize and runs
+  // function(begin, end) on each as separate jobs tracked by counter
+  template <typename Fn>
+  void ParallelFor(uint32_t count, uint32_t grainSize, Fn function, JobCounter& counter)
+  {
+    grainSize = grainSize == 0 ? 1 : grainSize;
+    for (uint32_t begin = 0; begin < count; begin += grainSize)
+    {
+      uint32_t end = count - begin > grainSize ? begin + grainSize : count;
+      Run([function, begin, end]() { function(begin, end); }, &counter);
+    }
+  }
+
+  // Executes queued jobs on the calling thread until counter reaches zero
+  void Wait(JobCounter& counter);
+
+  Stats GetStats() const;
+
+private:
+  struct Job
+  {
+    std::function<void()> function;
+    JobCounter* counter = nullptr;
+    uint32_t queue = 0; // Queue it was pushed to, for steal accounting
+  };
+
+  // A mutex-guarded deque per thread keeps stealing simple; contention is low
+  // because owners and thieves work at opposite ends and jobs are coarse enough
+  // (tens of microseconds) for the lock to be noise
+  struct WorkQueue
+  {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  void Push(Job job);
+  bool TryPop(uint32_t ownQueue, Job& job);
+  bool TrySteal(uint32_t ownQueue, Job& job);
+  void Execute(Job& job, uint32_t ownQueue);
+  void Finish(JobCounter& counter);
+  uint32_t CallerQueue() const;
+  void WorkerLoop(uint32_t workerIndex);
+
+  std::vector<std::unique_ptr<WorkQueue>> _queues; // One per worker, plus the injection queue last
+  std::vector<std::thread> _workers;
+
+  std::atomic<uint32_t> _queuedJobs{0};
+  std::atomic<uint32_t> _sleepingWorkers{0};
+  std::mutex _sleepMutex;
+  std::condition_variable _wake;
+  std::atomic<bool> _stopping{false};
+
+  std::atomic<uint64_t> _jobsExecuted{0};
+  std::atomic<uint64_t> _jobsStolen{0};
+  std::atomic<uint64_t> _workerSleeps{0};
+};
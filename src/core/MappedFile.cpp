@@ -0,0 +1,150 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path)
+    : _path(path)
+{
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    throw std::runtime_error("Failed to open file: " + path);
+  }
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(file, &size))
+  {
+    CloseHandle(file);
+    throw std::runtime_error("Failed to get the size of file: " + path);
+  }
+  _file = file;
+  _size = static_cast<size_t>(size.QuadPart);
+  if (_size == 0)
+  {
+    return; // Nothing to map
+  }
+  _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (_mapping != nullptr)
+  {
+    _data = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+  }
+  if (_data == nullptr)
+  {
+    Close();
+    throw std::runtime_error("Failed to map file: " + path + "! Error code: " + std::to_string(GetLastError()));
+  }
+}
+
+void MappedFile::Close()
+{
+  if (_data != nullptr) UnmapViewOfFile(_data);
+  if (_mapping != nullptr) CloseHandle(_mapping);
+  if (_file != nullptr) CloseHandle(_file);
+  _data = nullptr;
+  _mapping = nullptr;
+  _file = nullptr;
+  _size = 0;
+}
+
+void MappedFile::Prefetch(size_t offset, size_t size) const
+{
+  if (_data == nullptr || offset >= _size) return;
+  WIN32_MEMORY_RANGE_ENTRY range{const_cast<char*>(static_cast<const char*>(_data)) + offset,
+                                 std::min(size, _size - offset)};
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+    : _path(path)
+{
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    throw std::runtime_error("Failed to open file: " + path);
+  }
+  struct stat status{};
+  if (fstat(fd, &status) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("Failed to get the size of file: " + path);
+  }
+  _size = static_cast<size_t>(status.st_size);
+  if (_size > 0)
+  {
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+      close(fd);
+      throw std::runtime_error("Failed to map file: " + path);
+    }
+    _data = data;
+  }
+  close(fd); // The mapping keeps the file referenced
+}
+
+void MappedFile::Close()
+{
+  if (_data != nullptr)
+  {
+    munmap(const_cast<void*>(_data), _size);
+  }
+  _data = nullptr;
+  _size = 0;
+}
+
+void MappedFile::Prefetch(size_t offset, size_t size) const
+{
+  if (_data == nullptr || offset >= _size) return;
+  // madvise wants a page-aligned start
+  size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t start = offset / pageSize * pageSize;
+  size_t end = std::min(_size, offset + size);
+  madvise(const_cast<char*>(static_cast<const char*>(_data)) + start, end - start, MADV_WILLNEED);
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if (this != &other)
+  {
+    Close();
+    _path = std::move(other._path);
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+#ifdef _WIN32
+    _file = std::exchange(other._file, nullptr);
+    _mapping = std::exchange(other._mapping, nullptr);
+#endif
+    other._path.clear();
+  }
+  return *this;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+// Read-only memory mapping of a whole file. Asset loaders hand the mapped
+// bytes straight to the upload staging ring instead of reading them into a
+// heap buffer first; pages are faulted in from the OS page cache on first
+// touch. Moveable, not copyable.
+class MappedFile
+{
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& path); // Throws std::runtime_error if it can't be opened or mapped
+  ~MappedFile();
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool IsOpen() const { return !_path.empty(); }
+  const std::string& GetPath() const { return _path; }
+
+  // Empty for an empty file
+  std::span<const std::byte> GetBytes() const { return {static_cast<const std::byte*>(_data), _size}; }
+  size_t GetSize() const { return _size; }
+
+  // Hints that the range will be read soon (madvise WILLNEED / PrefetchVirtualMemory)
+  void Prefetch(size_t offset, size_t size) const;
+
+private:
+  void Close();
+
+  std::string _path;
+  const void* _data = nullptr;
+  size_t _size = 0;
+#ifdef _WIN32
+  void* _file = nullptr;    // HANDLE
+  void* _mapping = nullptr; // HANDLE
+#endif
+};
@@ -0,0 +1,87 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+thread_local int32_t t_workerIndex = -1;
+}
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+  if (threadCount == 0)
+  {
+    uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    threadCount = std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+  }
+
+  _workers.reserve(threadCount);
+  for (uint32_t i = 0; i < threadCount; i++)
+  {
+    _workers.emplace_back(&ThreadPool::WorkerLoop, this, static_cast<int32_t>(i));
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopping = true;
+  }
+  _taskAvailable.notify_all();
+  for (std::thread& worker : _workers)
+  {
+    worker.join();
+  }
+}
+
+int32_t ThreadPool::CurrentWorkerIndex()
+{
+  return t_workerIndex;
+}
+
+void ThreadPool::WaitIdle()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _idle.wait(lock, [this]() { return _tasks.empty() && _activeTasks == 0; });
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tasks.push_back(std::move(task));
+  }
+  _taskAvailable.notify_one();
+}
+
+void ThreadPool::WorkerLoop(int32_t workerIndex)
+{
+  t_workerIndex = workerIndex;
+  while (true)
+  {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _taskAvailable.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+      if (_tasks.empty())
+      {
+        return; // Stopping and drained
+      }
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+      _activeTasks++;
+    }
+
+    task(); // packaged_task captures exceptions in the future
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _activeTasks--;
+      if (_tasks.empty() && _activeTasks == 0)
+      {
+        _idle.notify_all();
+      }
+    }
+  }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size pool of worker threads consuming a FIFO of tasks. Used for work
+// that must not block the frame loop (e.g. pipeline compilation).
+class ThreadPool
+{
+public:
+  // threadCount 0 = one worker per hardware thread, minus one for the main thread
+  explicit ThreadPool(uint32_t threadCount = 0);
+  ~ThreadPool(); // Finishes queued tasks, then joins
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  uint32_t GetThreadCount() const { return static_cast<uint32_t>(_workers.size()); }
+
+  // Index of the calling worker in [0, GetThreadCount()), or -1 off the pool
+  static int32_t CurrentWorkerIndex();
+
+  // Queues fn and returns a future for its result (exceptions are forwarded)
+  template <typename Fn>
+  auto Submit(Fn&& fn) -> std::future<std::invoke_result_t<Fn>>
+  {
+    using Result = std::invoke_result_t<Fn>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+    std::future<Result> future = task->get_future();
+    Enqueue([task]() { (*task)(); });
+    return future;
+  }
+
+  // Blocks until the queue is empty and no task is running
+  void WaitIdle();
+
+private:
+  void Enqueue(std::function<void()> task);
+  void WorkerLoop(int32_t workerIndex);
+
+  std::vector<std::thread> _workers;
+  std::deque<std::function<void()>> _tasks;
+  std::mutex _mutex;
+  std::condition_variable _taskAvailable;
+  std::condition_variable _idle;
+  uint32_t _activeTasks = 0;
+  bool _stopping = false;
+};
@@ -1,13 +1,26 @@
 #include "core/Application.h"
+#include "core/AppConfig.h"
 
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
 
-int main()
+int main(int argc, char** argv)
 {
+  AppConfig config;
+  try
+  {
+    config = ParseCommandLine(argc, argv);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
   // Create the main application object
-  Application app;
+  Application app(config);
 
   try
   {
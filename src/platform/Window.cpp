@@ -26,7 +26,7 @@ void Window::initGLFW()
 void Window::createWindow()
 {
   glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-  glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE); // Keep non-resizable for now
+  glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE); // Renderer recreates the swap chain on resize
 
   _glfwWindow = glfwCreateWindow(static_cast<int>(_width),
                                  static_cast<int>(_height),
@@ -38,6 +38,9 @@ void Window::createWindow()
     glfwTerminate();
     throw std::runtime_error("Failed to create GLFW window");
   }
+
+  glfwSetWindowUserPointer(_glfwWindow, this);
+  glfwSetFramebufferSizeCallback(_glfwWindow, framebufferResizeCallback);
   std::cout << "GLFW window created successfully." << std::endl;
 }
 
@@ -61,6 +64,25 @@ VkExtent2D Window::getFramebufferExtent() const
     return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
 }
 
+bool Window::isMinimized() const
+{
+  VkExtent2D extent = getFramebufferExtent();
+  return extent.width == 0 || extent.height == 0;
+}
+
+bool Window::consumeResized()
+{
+  bool resized = _framebufferResized;
+  _framebufferResized = false;
+  return resized;
+}
+
+void Window::framebufferResizeCallback(GLFWwindow* glfwWindow, int /*width*/, int /*height*/)
+{
+  auto* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+  window->_framebufferResized = true;
+}
+
 bool Window::shouldClose() const
 {
   return glfwWindowShouldClose(_glfwWindow);
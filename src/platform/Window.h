@@ -22,14 +22,21 @@ public:
   // Accessors
   GLFWwindow* getGLFWwindow() const { return _glfwWindow; }
   VkExtent2D getFramebufferExtent() const;
+  bool isMinimized() const; // Zero-sized framebuffer: nothing can be presented
+
+  // True once after the framebuffer has been resized
+  bool consumeResized();
 
 private:
   GLFWwindow* _glfwWindow = nullptr;
   uint32_t _width;
   uint32_t _height;
   std::string _title;
+  bool _framebufferResized = false;
 
   void initGLFW();
   void createWindow();
   void cleanupGLFW();
+
+  static void framebufferResizeCallback(GLFWwindow* glfwWindow, int width, int height);
 }; 
\ No newline at end of file
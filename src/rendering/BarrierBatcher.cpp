@@ -0,0 +1,281 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+
+#include "BarrierBatcher.h" // Include own header after dependencies
+
+#include <algorithm>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+constexpr VkAccessFlags2KHR WRITE_ACCESS_MASK =
+    VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR |
+    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR |
+    VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_HOST_WRITE_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+
+// Legacy flags share the low 32 bits; stages only expressible in 64 bits
+// (e.g. COPY, BLIT) fall back to ALL_COMMANDS
+VkPipelineStageFlags LegacyStages(VkPipelineStageFlags2KHR stages, VkPipelineStageFlags none)
+{
+    if (stages == 0) {
+        return none;
+    }
+    if ((stages >> 32) != 0) {
+        return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    return static_cast<VkPipelineStageFlags>(stages);
+}
+
+VkAccessFlags LegacyAccess(VkAccessFlags2KHR access)
+{
+    if ((access >> 32) != 0) {
+        return (access & WRITE_ACCESS_MASK) ? (VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT)
+                                            : VK_ACCESS_MEMORY_READ_BIT;
+    }
+    return static_cast<VkAccessFlags>(access);
+}
+} // namespace
+
+void BarrierBatcher::TrackImage(VkImage image, VkImageAspectFlags aspect, const ResourceState& state)
+{
+    Tracked& tracked = _images[image];
+    tracked.state = state;
+    tracked.aspect = aspect;
+}
+
+void BarrierBatcher::TrackBuffer(VkBuffer buffer, const ResourceState& state)
+{
+    _buffers[buffer].state = state;
+}
+
+void BarrierBatcher::Forget(VkImage image)
+{
+    _images.erase(image);
+}
+
+void BarrierBatcher::Forget(VkBuffer buffer)
+{
+    _buffers.erase(buffer);
+}
+
+bool BarrierBatcher::Transition(ResourceState& state, bool layoutChange, VkImageLayout layout,
+                                VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access,
+                                VkPipelineStageFlags2KHR& srcStages, VkAccessFlags2KHR& srcAccess)
+{
+    const bool write = (access & WRITE_ACCESS_MASK) != 0;
+
+    if (!layoutChange && !write) {
+        // Reads need ordering only after a write, once per stage and access
+        bool covered = (stages & ~state.readStages) == 0 && (access & ~state.readAccess) == 0;
+        bool needed = state.writeStages != 0 && !covered;
+        srcStages = state.writeStages;
+        srcAccess = state.writeAccess;
+        state.readStages |= stages;
+        state.readAccess |= access;
+        return needed;
+    }
+
+    // Layout transitions and writes wait for the last write and every read since
+    bool needed = layoutChange || state.writeStages != 0 || state.readStages != 0;
+    srcStages = state.writeStages | state.readStages;
+    srcAccess = state.writeAccess;
+    state.layout = layout;
+    if (write) {
+        state.writeStages = stages;
+        state.writeAccess = access & WRITE_ACCESS_MASK;
+        state.readStages = 0;
+        state.readAccess = 0;
+    } else {
+        // The transition itself is the write; it is ordered before these stages
+        state.writeStages = stages;
+        state.writeAccess = 0;
+        state.readStages = stages;
+        state.readAccess = access;
+    }
+    return needed;
+}
+
+void BarrierBatcher::Collapse(ResourceState& state, VkImageLayout layout, VkPipelineStageFlags2KHR stages,
+                              VkAccessFlags2KHR access)
+{
+    // Everything in the batch's destination scope is ordered after the state
+    // before the batch, so the uses merge like concurrent accesses
+    state.layout = layout;
+    if ((access & WRITE_ACCESS_MASK) != 0) {
+        state.writeStages |= stages;
+        state.writeAccess |= access & WRITE_ACCESS_MASK;
+    }
+    state.readStages |= stages;
+    state.readAccess |= access;
+    _stats.collapsed++;
+}
+
+void BarrierBatcher::UseImage(VkImage image, VkImageLayout layout, VkPipelineStageFlags2KHR stages,
+                              VkAccessFlags2KHR access, bool discardContents)
+{
+    _stats.uses++;
+    auto [it, inserted] = _images.try_emplace(image);
+    Tracked& tracked = it->second;
+    if (inserted) {
+        tracked.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+
+    if (tracked.pendingIndex >= 0) {
+        VkImageMemoryBarrier2KHR& barrier = _imageBarriers[tracked.pendingIndex];
+        barrier.dstStageMask |= stages;
+        barrier.dstAccessMask |= access;
+        barrier.newLayout = layout;
+        Collapse(tracked.state, layout, stages, access);
+        return;
+    }
+
+    VkImageLayout oldLayout = discardContents ? VK_IMAGE_LAYOUT_UNDEFINED : tracked.state.layout;
+    VkPipelineStageFlags2KHR srcStages = 0;
+    VkAccessFlags2KHR srcAccess = 0;
+    if (!Transition(tracked.state, oldLayout != layout, layout, stages, access, srcStages, srcAccess)) {
+        _stats.dropped++;
+        return;
+    }
+
+    VkImageMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+    barrier.srcStageMask = srcStages;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = stages;
+    barrier.dstAccessMask = access;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {tracked.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS};
+    tracked.pendingIndex = static_cast<int64_t>(_imageBarriers.size());
+    _imageBarriers.push_back(barrier);
+}
+
+void BarrierBatcher::UseBuffer(VkBuffer buffer, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access)
+{
+    _stats.uses++;
+    Tracked& tracked = _buffers[buffer];
+
+    if (tracked.pendingIndex >= 0) {
+        VkBufferMemoryBarrier2KHR& barrier = _bufferBarriers[tracked.pendingIndex];
+        barrier.dstStageMask |= stages;
+        barrier.dstAccessMask |= access;
+        Collapse(tracked.state, VK_IMAGE_LAYOUT_UNDEFINED, stages, access);
+        return;
+    }
+
+    VkPipelineStageFlags2KHR srcStages = 0;
+    VkAccessFlags2KHR srcAccess = 0;
+    if (!Transition(tracked.state, false, VK_IMAGE_LAYOUT_UNDEFINED, stages, access, srcStages, srcAccess)) {
+        _stats.dropped++;
+        return;
+    }
+
+    VkBufferMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+    barrier.srcStageMask = srcStages;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = stages;
+    barrier.dstAccessMask = access;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    tracked.pendingIndex = static_cast<int64_t>(_bufferBarriers.size());
+    _bufferBarriers.push_back(barrier);
+}
+
+void BarrierBatcher::Flush(VkCommandBuffer commandBuffer, const VulkanDevice& device)
+{
+    if (!HasPending()) {
+        return;
+    }
+
+    if (device.supportsSynchronization2()) {
+        VkDependencyInfoKHR dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(_bufferBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = _bufferBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(_imageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = _imageBarriers.data();
+        device.cmdPipelineBarrier2(commandBuffer, dependencyInfo);
+    } else {
+        // One legacy call with the union of the stage masks
+        VkPipelineStageFlags2KHR srcStages = 0;
+        VkPipelineStageFlags2KHR dstStages = 0;
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        for (const VkImageMemoryBarrier2KHR& barrier2 : _imageBarriers) {
+            srcStages |= barrier2.srcStageMask;
+            dstStages |= barrier2.dstStageMask;
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = LegacyAccess(barrier2.srcAccessMask);
+            barrier.dstAccessMask = LegacyAccess(barrier2.dstAccessMask);
+            barrier.oldLayout = barrier2.oldLayout;
+            barrier.newLayout = barrier2.newLayout;
+            barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+            barrier.image = barrier2.image;
+            barrier.subresourceRange = barrier2.subresourceRange;
+            imageBarriers.push_back(barrier);
+        }
+        for (const VkBufferMemoryBarrier2KHR& barrier2 : _bufferBarriers) {
+            srcStages |= barrier2.srcStageMask;
+            dstStages |= barrier2.dstStageMask;
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = LegacyAccess(barrier2.srcAccessMask);
+            barrier.dstAccessMask = LegacyAccess(barrier2.dstAccessMask);
+            barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+            barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+            barrier.buffer = barrier2.buffer;
+            barrier.offset = barrier2.offset;
+            barrier.size = barrier2.size;
+            bufferBarriers.push_back(barrier);
+        }
+        vkCmdPipelineBarrier(commandBuffer, LegacyStages(srcStages, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
+                             LegacyStages(dstStages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT), 0, 0, nullptr,
+                             static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                             static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+    }
+
+    _stats.barriers += _imageBarriers.size() + _bufferBarriers.size();
+    _stats.flushes++;
+    ClearPending();
+}
+
+void BarrierBatcher::ClearPending()
+{
+    for (const VkImageMemoryBarrier2KHR& barrier : _imageBarriers) {
+        auto it = _images.find(barrier.image);
+        if (it != _images.end()) {
+            it->second.pendingIndex = -1;
+        }
+    }
+    for (const VkBufferMemoryBarrier2KHR& barrier : _bufferBarriers) {
+        auto it = _buffers.find(barrier.buffer);
+        if (it != _buffers.end()) {
+            it->second.pendingIndex = -1;
+        }
+    }
+    _imageBarriers.clear();
+    _bufferBarriers.clear();
+}
+
+const BarrierBatcher::ResourceState* BarrierBatcher::GetImageState(VkImage image) const
+{
+    auto it = _images.find(image);
+    return it != _images.end() ? &it->second.state : nullptr;
+}
+
+const BarrierBatcher::ResourceState* BarrierBatcher::GetBufferState(VkBuffer buffer) const
+{
+    auto it = _buffers.find(buffer);
+    return it != _buffers.end() ? &it->second.state : nullptr;
+}
+
+} // namespace VulkanApp::Rendering
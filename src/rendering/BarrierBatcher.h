@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+
+namespace VulkanApp::Rendering {
+
+// Collects the image and buffer barriers for one sync point and records them
+// with a single vkCmdPipelineBarrier2 (VK_KHR_synchronization2). Each tracked
+// resource remembers its layout, its last write and the reads already ordered
+// after that write, so a use declared with Use* only queues a barrier when it
+// is actually needed:
+//   - layout transitions, and any use after a write (RAW/WAW),
+//   - writes after reads (WAR; execution dependency only),
+//   - reads in stages not yet ordered after the last write.
+// Reads already covered are dropped. Uses of the same resource before the next
+// Flush describe the commands after that sync point, so they collapse into one
+// barrier from the state before the batch to the union of the uses (the last
+// layout wins).
+//
+// State tracking is CPU-only and can be exercised without a device; only
+// Flush records commands. Not thread-safe: one batcher per command buffer.
+class BarrierBatcher {
+public:
+    struct Stats {
+        uint64_t uses = 0;
+        uint64_t barriers = 0;  // Recorded by Flush
+        uint64_t dropped = 0;   // Uses that needed no barrier
+        uint64_t collapsed = 0; // Uses merged into a barrier already pending
+        uint64_t flushes = 0;   // vkCmdPipelineBarrier2 calls
+    };
+
+    // What the batcher knows about a resource
+    struct ResourceState {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; // Images only
+        VkPipelineStageFlags2KHR writeStages = 0;
+        VkAccessFlags2KHR writeAccess = 0;
+        VkPipelineStageFlags2KHR readStages = 0; // Reads ordered after the last write
+        VkAccessFlags2KHR readAccess = 0;
+    };
+
+    // Registers a resource's current state, e.g. an imported image that
+    // arrives in a known layout. Untracked resources start UNDEFINED with no
+    // prior access.
+    void TrackImage(VkImage image, VkImageAspectFlags aspect, const ResourceState& state = {});
+    void TrackBuffer(VkBuffer buffer, const ResourceState& state = {});
+    void Forget(VkImage image);
+    void Forget(VkBuffer buffer);
+
+    // Declares the next use of a resource. discardContents lets an image
+    // transition from UNDEFINED, for uses that overwrite all of it.
+    void UseImage(VkImage image, VkImageLayout layout, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access,
+                  bool discardContents = false);
+    void UseBuffer(VkBuffer buffer, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access);
+
+    bool HasPending() const { return !_imageBarriers.empty() || !_bufferBarriers.empty(); }
+    const std::vector<VkImageMemoryBarrier2KHR>& GetPendingImageBarriers() const { return _imageBarriers; }
+    const std::vector<VkBufferMemoryBarrier2KHR>& GetPendingBufferBarriers() const { return _bufferBarriers; }
+
+    // Records every pending barrier in one call and clears them. Falls back to
+    // a single vkCmdPipelineBarrier when synchronization2 is not enabled.
+    void Flush(VkCommandBuffer commandBuffer, const VulkanDevice& device);
+    // Drops the pending barriers without recording them (the tracked state
+    // already reflects the uses)
+    void ClearPending();
+
+    const ResourceState* GetImageState(VkImage image) const;
+    const ResourceState* GetBufferState(VkBuffer buffer) const;
+    const Stats& GetStats() const { return _stats; }
+
+private:
+    struct Tracked {
+        ResourceState state;
+        VkImageAspectFlags aspect = 0;
+        int64_t pendingIndex = -1; // Into the barrier vector of its kind, -1 = none this batch
+    };
+
+    // Shared by images and buffers: updates the state for a use outside any
+    // pending barrier and returns whether one is needed, with its source scope
+    bool Transition(ResourceState& state, bool layoutChange, VkImageLayout layout, VkPipelineStageFlags2KHR stages,
+                    VkAccessFlags2KHR access, VkPipelineStageFlags2KHR& srcStages, VkAccessFlags2KHR& srcAccess);
+    // A later use of a resource that already has a barrier in this batch
+    void Collapse(ResourceState& state, VkImageLayout layout, VkPipelineStageFlags2KHR stages, VkAccessFlags2KHR access);
+
+    std::unordered_map<VkImage, Tracked> _images;
+    std::unordered_map<VkBuffer, Tracked> _buffers;
+    std::vector<VkImageMemoryBarrier2KHR> _imageBarriers;
+    std::vector<VkBufferMemoryBarrier2KHR> _bufferBarriers;
+    Stats _stats;
+};
+
+} // namespace VulkanApp::Rendering
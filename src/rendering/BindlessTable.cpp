@@ -0,0 +1,238 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+
+#include "BindlessTable.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+constexpr std::array<VkDescriptorType, 3> DESCRIPTOR_TYPES = {
+    VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,  // SAMPLED_IMAGE_BINDING
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // STORAGE_BUFFER_BINDING
+    VK_DESCRIPTOR_TYPE_SAMPLER         // SAMPLER_BINDING
+};
+} // namespace
+
+bool BindlessTable::IsSupported(const VulkanDevice& device)
+{
+    return device.supportsDescriptorIndexing();
+}
+
+BindlessTable::BindlessTable(VulkanDevice& device)
+    : _device(device)
+{
+    if (!IsSupported(device)) {
+        throw std::runtime_error("Error: the bindless descriptor table requires descriptor indexing!");
+    }
+
+    // Array sizes within the update-after-bind limits, per stage and per set,
+    // and together within the per-stage resource budget
+    VkPhysicalDeviceVulkan12Properties limits{};
+    limits.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &limits;
+    vkGetPhysicalDeviceProperties2(device.getPhysicalDevice(), &properties2);
+
+    uint32_t budget = limits.maxPerStageUpdateAfterBindResources;
+    uint32_t samplers = std::min({MAX_SAMPLERS, limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                  limits.maxDescriptorSetUpdateAfterBindSamplers, budget / 4});
+    uint32_t images = std::min({MAX_SAMPLED_IMAGES, limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                limits.maxDescriptorSetUpdateAfterBindSampledImages, (budget - samplers) / 2});
+    uint32_t buffers = std::min({MAX_STORAGE_BUFFERS, limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                 limits.maxDescriptorSetUpdateAfterBindStorageBuffers, budget - samplers - images});
+    _arrays[SAMPLED_IMAGE_BINDING] = BindlessSlotArray(images);
+    _arrays[STORAGE_BUFFER_BINDING] = BindlessSlotArray(buffers);
+    _arrays[SAMPLER_BINDING] = BindlessSlotArray(samplers);
+
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    std::array<VkDescriptorBindingFlags, 3> bindingFlags{};
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = DESCRIPTOR_TYPES[i];
+        bindings[i].descriptorCount = _arrays[i].GetCapacity();
+        bindings[i].stageFlags = VK_SHADER_STAGE_ALL;
+        bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                          VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        poolSizes[i] = {DESCRIPTOR_TYPES[i], _arrays[i].GetCapacity()};
+        _stats.capacity[i] = _arrays[i].GetCapacity();
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+    flagsInfo.pBindingFlags = bindingFlags.data();
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    VkResult result = vkCreateDescriptorSetLayout(device.getDevice(), &layoutInfo, nullptr, &_setLayout);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create bindless descriptor set layout! Error: " + std::to_string(result));
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    result = vkCreateDescriptorPool(device.getDevice(), &poolInfo, nullptr, &_descriptorPool);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create bindless descriptor pool! Error: " + std::to_string(result));
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_setLayout;
+    result = vkAllocateDescriptorSets(device.getDevice(), &allocInfo, &_set);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate bindless descriptor set! Error: " + std::to_string(result));
+    }
+
+    VkPushConstantRange pushRange{VK_SHADER_STAGE_ALL, 0, PUSH_CONSTANT_SIZE};
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &_setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+    result = vkCreatePipelineLayout(device.getDevice(), &pipelineLayoutInfo, nullptr, &_pipelineLayout);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create bindless pipeline layout! Error: " + std::to_string(result));
+    }
+
+    std::cout << "Bindless descriptor table created (" << images << " sampled images, " << buffers
+              << " storage buffers, " << samplers << " samplers)." << std::endl;
+}
+
+BindlessTable::~BindlessTable()
+{
+    VkDevice device = _device.getDevice();
+    vkDestroyPipelineLayout(device, _pipelineLayout, nullptr);
+    vkDestroyDescriptorPool(device, _descriptorPool, nullptr); // Frees the set
+    vkDestroyDescriptorSetLayout(device, _setLayout, nullptr);
+}
+
+BindlessHandle BindlessTable::RegisterSampledImage(VkImageView view, VkImageLayout layout)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    BindlessHandle handle = _arrays[SAMPLED_IMAGE_BINDING].Allocate("sampled image");
+    VkDescriptorImageInfo imageInfo{VK_NULL_HANDLE, view, layout};
+    Write(SAMPLED_IMAGE_BINDING, handle, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &imageInfo, nullptr);
+    return handle;
+}
+
+BindlessHandle BindlessTable::RegisterStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    BindlessHandle handle = _arrays[STORAGE_BUFFER_BINDING].Allocate("storage buffer");
+    VkDescriptorBufferInfo bufferInfo{buffer, offset, range};
+    Write(STORAGE_BUFFER_BINDING, handle, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &bufferInfo);
+    return handle;
+}
+
+BindlessHandle BindlessTable::RegisterSampler(VkSampler sampler)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    BindlessHandle handle = _arrays[SAMPLER_BINDING].Allocate("sampler");
+    VkDescriptorImageInfo imageInfo{sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED};
+    Write(SAMPLER_BINDING, handle, VK_DESCRIPTOR_TYPE_SAMPLER, &imageInfo, nullptr);
+    return handle;
+}
+
+void BindlessTable::ReleaseSampledImage(BindlessHandle handle)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _arrays[SAMPLED_IMAGE_BINDING].Free(handle);
+}
+
+void BindlessTable::ReleaseStorageBuffer(BindlessHandle handle)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _arrays[STORAGE_BUFFER_BINDING].Free(handle);
+}
+
+void BindlessTable::ReleaseSampler(BindlessHandle handle)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _arrays[SAMPLER_BINDING].Free(handle);
+}
+
+void BindlessTable::Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint) const
+{
+    vkCmdBindDescriptorSets(commandBuffer, bindPoint, _pipelineLayout, 0, 1, &_set, 0, nullptr);
+}
+
+BindlessTable::Stats BindlessTable::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats stats = _stats;
+    for (uint32_t i = 0; i < _arrays.size(); i++) {
+        stats.live[i] = _arrays[i].GetLiveCount();
+    }
+    return stats;
+}
+
+BindlessHandle BindlessSlotArray::Allocate(const char* what)
+{
+    BindlessHandle handle;
+    if (!_freeSlots.empty()) {
+        handle = _freeSlots.back();
+        _freeSlots.pop_back();
+    } else if (_highWater < _capacity) {
+        handle = _highWater++;
+        _live.push_back(false);
+    } else {
+        throw std::runtime_error("Error: bindless table is out of " + std::string(what) + " slots (" +
+                                 std::to_string(_capacity) + ")!");
+    }
+    _live[handle] = true;
+    _liveCount++;
+    return handle;
+}
+
+// The stale descriptor stays in the slot; partially bound bindings allow that
+// as long as no shader reads it
+void BindlessSlotArray::Free(BindlessHandle handle)
+{
+    if (handle >= _highWater) {
+        throw std::runtime_error("Error: releasing bindless handle " + std::to_string(handle) +
+                                 " that was never registered!");
+    }
+    if (!_live[handle]) {
+        throw std::runtime_error("Error: releasing bindless handle " + std::to_string(handle) + " twice!");
+    }
+    _live[handle] = false;
+    _liveCount--;
+    _freeSlots.push_back(handle);
+}
+
+// Caller holds _mutex: writes to one set must be externally synchronized
+void BindlessTable::Write(uint32_t binding, BindlessHandle handle, VkDescriptorType type,
+                          const VkDescriptorImageInfo* imageInfo, const VkDescriptorBufferInfo* bufferInfo)
+{
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = _set;
+    write.dstBinding = binding;
+    write.dstArrayElement = handle;
+    write.descriptorCount = 1;
+    write.descriptorType = type;
+    write.pImageInfo = imageInfo;
+    write.pBufferInfo = bufferInfo;
+    vkUpdateDescriptorSets(_device.getDevice(), 1, &write, 0, nullptr);
+    _stats.descriptorWrites++;
+}
+
+} // namespace VulkanApp::Rendering
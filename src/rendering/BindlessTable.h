@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+
+namespace VulkanApp::Rendering {
+
+// Index of a descriptor in one of the BindlessTable's arrays. Shaders receive
+// it (push constants, object data) and index the array with it.
+using BindlessHandle = uint32_t;
+constexpr BindlessHandle INVALID_BINDLESS_HANDLE = UINT32_MAX;
+
+// The slots of one of the table's arrays: a free list over [0, capacity) that
+// reuses the most recently released slot, which keeps the used part dense.
+// Not thread-safe; BindlessTable guards it. Free throws on a handle that is not
+// live, since releasing one twice would hand the same slot to two owners.
+class BindlessSlotArray {
+public:
+    explicit BindlessSlotArray(uint32_t capacity = 0) : _capacity(capacity) {}
+
+    // Throws std::runtime_error when every slot is live; what names the array
+    BindlessHandle Allocate(const char* what);
+    void Free(BindlessHandle handle);
+
+    bool IsLive(BindlessHandle handle) const { return handle < _highWater && _live[handle]; }
+    uint32_t GetCapacity() const { return _capacity; }
+    uint32_t GetLiveCount() const { return _liveCount; }
+
+private:
+    uint32_t _capacity = 0;
+    uint32_t _highWater = 0;          // Slots [0, highWater) have been handed out at least once
+    uint32_t _liveCount = 0;
+    std::vector<uint32_t> _freeSlots; // Released slots below highWater, reused LIFO
+    std::vector<bool> _live;          // Per slot below highWater
+};
+
+// One global descriptor set holding every sampled image, storage buffer and
+// sampler a shader may reach, as runtime-sized arrays (shaders/bindless.glsl).
+// The bindings are update-after-bind and partially bound: slots are written
+// while command buffers using the set are recorded or in flight, and unwritten
+// or stale slots are fine as long as no shader reads them. Slots come from a
+// free list per array. Every bindless pipeline uses GetPipelineLayout(), so
+// the set is bound once per command buffer and bind point, and a draw only
+// pushes the handles it needs.
+class BindlessTable {
+public:
+    static constexpr uint32_t SAMPLED_IMAGE_BINDING = 0;
+    static constexpr uint32_t STORAGE_BUFFER_BINDING = 1;
+    static constexpr uint32_t SAMPLER_BINDING = 2;
+    // Requested array sizes, clamped to the device's update-after-bind limits
+    static constexpr uint32_t MAX_SAMPLED_IMAGES = 65536;
+    static constexpr uint32_t MAX_STORAGE_BUFFERS = 65536;
+    static constexpr uint32_t MAX_SAMPLERS = 1024;
+    // Push constant bytes of the shared layout, visible to every stage; the
+    // minimum maxPushConstantsSize every device guarantees
+    static constexpr uint32_t PUSH_CONSTANT_SIZE = 128;
+
+    struct Stats {
+        std::array<uint32_t, 3> capacity{}; // Per binding
+        std::array<uint32_t, 3> live{};     // Registered and not yet released, per binding
+        uint64_t descriptorWrites = 0;
+    };
+
+    // Needs VulkanDevice::supportsDescriptorIndexing()
+    static bool IsSupported(const VulkanDevice& device);
+
+    explicit BindlessTable(VulkanDevice& device);
+    ~BindlessTable(); // Device must be idle
+
+    BindlessTable(const BindlessTable&) = delete;
+    BindlessTable& operator=(const BindlessTable&) = delete;
+
+    // Thread-safe. Writes the descriptor into a free slot; command buffers
+    // submitted afterwards may use the handle. Throws when the array is full.
+    BindlessHandle RegisterSampledImage(VkImageView view,
+                                        VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    BindlessHandle RegisterStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+    BindlessHandle RegisterSampler(VkSampler sampler);
+
+    // Thread-safe. Returns the slot to its free list, to be overwritten by a
+    // later Register*: no submitted work may still read it, so defer the call
+    // through the DeletionQueue past the last frame that used the handle.
+    void ReleaseSampledImage(BindlessHandle handle);
+    void ReleaseStorageBuffer(BindlessHandle handle);
+    void ReleaseSampler(BindlessHandle handle);
+
+    // Binds the table as set 0 of GetPipelineLayout(); stays bound across
+    // every pipeline built against that layout
+    void Bind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint) const;
+
+    VkDescriptorSetLayout GetSetLayout() const { return _setLayout; }
+    // Set 0: the table; push constants: PUSH_CONSTANT_SIZE bytes, VK_SHADER_STAGE_ALL
+    VkPipelineLayout GetPipelineLayout() const { return _pipelineLayout; }
+
+    Stats GetStats() const;
+
+private:
+    void Write(uint32_t binding, BindlessHandle handle, VkDescriptorType type, const VkDescriptorImageInfo* imageInfo,
+               const VkDescriptorBufferInfo* bufferInfo);
+
+    VulkanDevice& _device;
+    VkDescriptorSetLayout _setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet _set = VK_NULL_HANDLE;
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
+
+    mutable std::mutex _mutex; // Guards the free lists, the stats and descriptor writes to _set
+    std::array<BindlessSlotArray, 3> _arrays; // Indexed by binding
+    Stats _stats;
+};
+
+} // namespace VulkanApp::Rendering
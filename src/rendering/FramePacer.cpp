@@ -0,0 +1,173 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/PresentTarget.h"
+#include "../vulkan/VulkanTimeline.h"
+
+#include "FramePacer.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+constexpr double PREDICTOR_WEIGHT = 0.1;  // Share of a new sample in the moving averages
+constexpr double MAX_SLEEP_MS = 50.0;     // Never hold a frame back longer than this
+constexpr uint64_t MAX_PRESENT_WAIT_NS = 100'000'000;
+constexpr double BLOCKED_TARGET_MS = 0.25; // Blocking after input sampling the correction leaves in place
+constexpr double BLOCKED_GAIN = 0.5;
+constexpr double REFRESH_RELAX = 0.01;     // How fast the refresh estimate follows longer intervals
+constexpr size_t MAX_PENDING_FRAMES = 64;
+
+double MillisecondsBetween(FramePacer::Clock::time_point start, FramePacer::Clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+FramePacer::Clock::duration FromMilliseconds(double ms)
+{
+    return std::chrono::duration_cast<FramePacer::Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+}
+} // namespace
+
+void DurationPredictor::Add(double ms)
+{
+    if (!_valid) {
+        _mean = ms;
+        _deviation = 0.0;
+        _valid = true;
+        return;
+    }
+    _deviation += PREDICTOR_WEIGHT * (std::abs(ms - _mean) - _deviation);
+    _mean += PREDICTOR_WEIGHT * (ms - _mean);
+}
+
+FramePacer::FramePacer(PresentTarget& presentTarget, const VulkanTimeline& frameTimeline, bool lowLatency)
+    : _presentTarget(presentTarget),
+      _frameTimeline(frameTimeline),
+      _lowLatency(lowLatency),
+      _usePresentWait(presentTarget.supportsPresentWait())
+{
+}
+
+double FramePacer::WaitForFrameStart()
+{
+    Clock::time_point waitStart = Clock::now();
+    CollectFinishedFrames();
+
+    if (_lowLatency) {
+        Clock::time_point deadline = waitStart;
+        if (_usePresentWait) {
+            // Keep at most one frame queued for the display: wait for the
+            // previous present, then aim to finish just before the next refresh
+            bool previousPending = !_pending.empty() && _pending.back().presentId != 0;
+            if (previousPending &&
+                _presentTarget.waitForPresent(_pending.back().presentId, MAX_PRESENT_WAIT_NS) == VK_SUCCESS) {
+                Clock::time_point displayed = Clock::now();
+                if (_hasDisplayed) {
+                    double interval = MillisecondsBetween(_lastDisplayed, displayed);
+                    if (!_refreshValid || interval < _refreshMs) {
+                        _refreshMs = interval;
+                        _refreshValid = true;
+                    } else {
+                        _refreshMs += REFRESH_RELAX * (interval - _refreshMs);
+                    }
+                }
+                _lastDisplayed = displayed;
+                _hasDisplayed = true;
+                CollectFinishedFrames(); // The wait timed the previous frame exactly
+                if (_refreshValid) {
+                    deadline = displayed + FromMilliseconds(_refreshMs - _cpuTime.Predict() - _gpuTime.Predict());
+                }
+            } else {
+                // Already on screen (this frame is late) or unknown: start now
+                // and do not time the refresh against a stale display time
+                _hasDisplayed = false;
+            }
+        } else if (_hasSubmitted) {
+            // Submit this frame as the GPU finishes the previous one
+            deadline = _lastSubmit + FromMilliseconds(_gpuTime.Predict() - _cpuTime.Predict());
+        }
+
+        deadline += FromMilliseconds(_blockedCorrectionMs);
+        deadline = std::min(deadline, waitStart + FromMilliseconds(MAX_SLEEP_MS));
+        if (deadline > Clock::now()) {
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+
+    _frameStart = Clock::now();
+    _inputTime = _frameStart;
+    _frameStarted = true;
+    return MillisecondsBetween(waitStart, _frameStart);
+}
+
+void FramePacer::MarkInputSampled()
+{
+    _inputTime = Clock::now();
+}
+
+void FramePacer::FramePresented(uint64_t frameNumber, Clock::time_point submitTime, double blockedMs, double gpuMs)
+{
+    if (gpuMs >= 0.0) {
+        _gpuTime.Add(gpuMs);
+    }
+    if (_frameStarted) {
+        _cpuTime.Add(std::max(0.0, MillisecondsBetween(_frameStart, submitTime) - blockedMs));
+        if (_lowLatency) {
+            // Integral controller: blocking after input sampling adds latency
+            // without adding throughput, so move it in front of the sampling
+            _blockedCorrectionMs = std::clamp(_blockedCorrectionMs + BLOCKED_GAIN * (blockedMs - BLOCKED_TARGET_MS),
+                                              0.0, MAX_SLEEP_MS);
+        }
+    }
+
+    uint64_t presentId = _usePresentWait ? _presentTarget.getLastPresentId() : 0;
+    _pending.push_back({frameNumber, presentId, _frameStarted ? _inputTime : submitTime});
+    if (_pending.size() > MAX_PENDING_FRAMES) {
+        _pending.pop_front();
+    }
+
+    _lastSubmit = submitTime;
+    _hasSubmitted = true;
+    _frameStarted = false;
+}
+
+bool FramePacer::TakeLatency(double& latencyMs)
+{
+    if (!_latencyFresh) {
+        return false;
+    }
+    latencyMs = _latencyMs;
+    _latencyFresh = false;
+    return true;
+}
+
+void FramePacer::CollectFinishedFrames()
+{
+    while (!_pending.empty()) {
+        const PendingFrame& frame = _pending.front();
+        bool finished = false;
+        if (frame.presentId != 0) {
+            VkResult result = _presentTarget.waitForPresent(frame.presentId, 0);
+            // On errors (e.g. out of date) fall back to GPU completion
+            finished = result == VK_SUCCESS ||
+                       (result != VK_TIMEOUT && _frameTimeline.isComplete(frame.frameNumber + 1));
+        } else {
+            finished = _frameTimeline.isComplete(frame.frameNumber + 1);
+        }
+        if (!finished) {
+            break;
+        }
+        FinishFrame(frame, Clock::now());
+        _pending.pop_front();
+    }
+}
+
+void FramePacer::FinishFrame(const PendingFrame& frame, Clock::time_point finishTime)
+{
+    _latencyMs = MillisecondsBetween(frame.inputTime, finishTime);
+    _latencyFresh = true;
+}
+
+} // namespace VulkanApp::Rendering
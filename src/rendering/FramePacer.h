@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+// Forward declarations (global namespace)
+class PresentTarget;
+class VulkanTimeline;
+
+namespace VulkanApp::Rendering {
+
+// Exponential moving average of a duration plus its mean absolute deviation;
+// predictions are padded by the deviation so a noisy frame rarely overshoots
+class DurationPredictor {
+public:
+    void Add(double ms);
+    double Predict() const { return _valid ? _mean + 2.0 * _deviation : 0.0; }
+    bool IsValid() const { return _valid; }
+
+private:
+    double _mean = 0.0;
+    double _deviation = 0.0;
+    bool _valid = false;
+};
+
+// Measures input-to-present latency and, in low-latency mode, delays the start
+// of each frame (and with it input sampling) so the frame reaches the GPU or
+// display just as it becomes free instead of queueing behind earlier frames.
+//
+// Per frame: WaitForFrameStart, MarkInputSampled, record/submit/present, then
+// FramePresented. With VK_KHR_present_wait the previous present is waited on
+// and the sleep targets the next refresh; otherwise the previous frame's GPU
+// completion is predicted from its submit time and the GPU time estimate. Any
+// blocking left after input sampling (frame slot wait, acquire) is fed back so
+// the next frame sleeps that much longer before sampling instead.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer(PresentTarget& presentTarget, const VulkanTimeline& frameTimeline, bool lowLatency);
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Collects finished frames' latency and, in low-latency mode, sleeps until
+    // the next frame should start. Returns the milliseconds spent waiting.
+    double WaitForFrameStart();
+    // Input for the upcoming frame has been read; latency is measured from here
+    void MarkInputSampled();
+
+    // Frame frameNumber was submitted at submitTime (and presented, if the
+    // target presents). blockedMs is time spent blocked after input sampling;
+    // gpuMs is a fresh GPU frame time from the profiler, or negative if none.
+    void FramePresented(uint64_t frameNumber, Clock::time_point submitTime, double blockedMs, double gpuMs);
+
+    // Latency of the most recently finished frame: from MarkInputSampled to
+    // the present reaching the screen with present wait, else to the GPU
+    // finishing the frame. Polled at frame start, so without a blocking wait
+    // it can read up to one frame interval high. Returns false if no frame
+    // finished since the last call.
+    bool TakeLatency(double& latencyMs);
+
+    bool IsLowLatency() const { return _lowLatency; }
+    bool UsesPresentWait() const { return _usePresentWait; }
+    double GetPredictedCpuMs() const { return _cpuTime.Predict(); }
+    double GetPredictedGpuMs() const { return _gpuTime.Predict(); }
+
+private:
+    struct PendingFrame {
+        uint64_t frameNumber;
+        uint64_t presentId; // 0 = not presented to a display
+        Clock::time_point inputTime;
+    };
+
+    void CollectFinishedFrames();
+    void FinishFrame(const PendingFrame& frame, Clock::time_point finishTime);
+
+    PresentTarget& _presentTarget;
+    const VulkanTimeline& _frameTimeline;
+    const bool _lowLatency;
+    const bool _usePresentWait;
+
+    DurationPredictor _cpuTime; // Frame start to submit, excluding blocking
+    DurationPredictor _gpuTime; // GPU frame time from the profiler
+    // Shortest recent interval between presents reaching the screen: the
+    // refresh period when the display paces frames (FIFO), otherwise no
+    // longer than a frame's CPU + GPU time, which makes the target a no-op
+    double _refreshMs = 0.0;
+    bool _refreshValid = false;
+    double _blockedCorrectionMs = 0.0; // Extra sleep learned from blocking after input sampling
+
+    bool _frameStarted = false;
+    Clock::time_point _frameStart;
+    Clock::time_point _inputTime;
+    Clock::time_point _lastSubmit;
+    bool _hasSubmitted = false;
+    Clock::time_point _lastDisplayed;
+    bool _hasDisplayed = false;
+
+    std::deque<PendingFrame> _pending; // Oldest first
+    double _latencyMs = 0.0;
+    bool _latencyFresh = false;
+};
+
+} // namespace VulkanApp::Rendering
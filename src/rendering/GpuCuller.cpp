@@ -0,0 +1,380 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+#include "../vulkan/VulkanPipelineCache.h"
+#include "ShaderLibrary.h"
+
+#include "GpuCuller.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+constexpr uint32_t INDEX_COUNT = 3; // One triangle, indices into indirect.vert's positions
+
+// Matches the Cull push constant block in cull.comp
+struct CullConstants {
+    float planes[6][4];
+    uint32_t objectCount;
+    uint32_t compact;
+    uint32_t indexCount;
+};
+
+// Matches the View push constant block of indirect.vert built with -DBINDLESS
+struct BindlessDrawConstants {
+    glm::mat4 viewProjection;
+    uint32_t objectBuffer;
+};
+
+// Frustum planes of a Vulkan clip space (0 <= z <= w), normalized and facing
+// inwards, so a sphere is outside when its distance to a plane is below -radius
+void ExtractFrustumPlanes(const glm::mat4& viewProjection, float planes[6][4])
+{
+    auto row = [&](int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+    const std::array<glm::vec4, 6> unnormalized = {
+        row(3) + row(0), row(3) - row(0), // Left, right
+        row(3) + row(1), row(3) - row(1), // Top, bottom
+        row(2), row(3) - row(2)           // Near, far
+    };
+    for (size_t i = 0; i < unnormalized.size(); i++) {
+        float length = glm::length(glm::vec3(unnormalized[i]));
+        glm::vec4 plane = length > 0.0f ? unnormalized[i] / length : unnormalized[i];
+        for (int c = 0; c < 4; c++) {
+            planes[i][c] = plane[c];
+        }
+    }
+}
+} // namespace
+
+bool GpuCuller::IsSupported(const VulkanDevice& device)
+{
+    const VkPhysicalDeviceFeatures& features = device.getEnabledFeatures();
+    return features.multiDrawIndirect == VK_TRUE && features.drawIndirectFirstInstance == VK_TRUE;
+}
+
+GpuCuller::GpuCuller(VulkanDevice& device, VulkanPipelineCache& pipelineCache, ShaderLibrary& shaderLibrary,
+                     UploadManager& uploadManager, BindlessTable* bindlessTable, uint32_t framesInFlight,
+                     std::vector<GpuObject> objects)
+    : _device(device),
+      _pipelineCache(pipelineCache),
+      _shaderLibrary(shaderLibrary),
+      _uploadManager(uploadManager),
+      _bindlessTable(bindlessTable),
+      _compact(device.supportsDrawIndirectCount()),
+      _objects(std::move(objects)),
+      _objectCount(static_cast<uint32_t>(_objects.size())),
+      _frames(framesInFlight)
+{
+    if (!IsSupported(device)) {
+        throw std::runtime_error("Error: GPU culling requires multiDrawIndirect and drawIndirectFirstInstance!");
+    }
+    VkDeviceSize objectBytes = std::max<VkDeviceSize>(_objectCount, 1) * sizeof(GpuObject);
+    if (objectBytes > device.getProperties().limits.maxStorageBufferRange) {
+        throw std::runtime_error("Error: GPU culling object buffer exceeds maxStorageBufferRange (" +
+                                 std::to_string(_objectCount) + " objects)!");
+    }
+    _stats.objects = _objectCount;
+    _stats.drawIndirectCount = _compact;
+
+    _objectBuffer = CreateBuffer(objectBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 MemoryUsage::GpuOnly, _objectMemory);
+    _indexBuffer = CreateBuffer(INDEX_COUNT * sizeof(uint32_t),
+                                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                MemoryUsage::GpuOnly, _indexMemory);
+    VkDeviceSize drawBytes = std::max<VkDeviceSize>(_objectCount, 1) * sizeof(VkDrawIndexedIndirectCommand);
+    for (FrameResources& frame : _frames) {
+        frame.drawBuffer = CreateBuffer(drawBytes,
+                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                        MemoryUsage::GpuOnly, frame.drawMemory);
+        frame.countBuffer = CreateBuffer(sizeof(uint32_t),
+                                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                             VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                         MemoryUsage::GpuOnly, frame.countMemory);
+        frame.readbackBuffer = CreateBuffer(sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                            MemoryUsage::GpuToCpu, frame.readbackMemory);
+    }
+
+    if (_bindlessTable) {
+        _objectHandle = _bindlessTable->RegisterStorageBuffer(_objectBuffer);
+    }
+    CreateLayouts();
+    CreateDescriptors();
+    CreatePipelines();
+    std::cout << "GPU culling ready (" << _objectCount << " objects, "
+              << (_compact ? "vkCmdDrawIndexedIndirectCount" : "vkCmdDrawIndexedIndirect")
+              << (_bindlessTable ? ", bindless" : "") << ")." << std::endl;
+}
+
+GpuCuller::~GpuCuller()
+{
+    VkDevice device = _device.getDevice();
+    vkDestroyPipeline(device, _cullPipeline, nullptr);
+    // The descriptor sets are freed with their pool; the layouts belong to the shader library
+    vkDestroyDescriptorPool(device, _descriptorPool, nullptr);
+
+    if (_objectHandle != INVALID_BINDLESS_HANDLE) {
+        _bindlessTable->ReleaseStorageBuffer(_objectHandle);
+    }
+
+    VulkanMemoryAllocator& allocator = _device.getAllocator();
+    for (FrameResources& frame : _frames) {
+        allocator.destroyBuffer(frame.drawBuffer, frame.drawMemory);
+        allocator.destroyBuffer(frame.countBuffer, frame.countMemory);
+        allocator.destroyBuffer(frame.readbackBuffer, frame.readbackMemory);
+    }
+    allocator.destroyBuffer(_indexBuffer, _indexMemory);
+    allocator.destroyBuffer(_objectBuffer, _objectMemory);
+}
+
+VkBuffer GpuCuller::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, MemoryUsage memoryUsage,
+                                 VulkanAllocation& allocation)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    return _device.getAllocator().createBuffer(bufferInfo, memoryUsage, allocation);
+}
+
+// Derived from the shaders' reflection, checked against the C++ side: the
+// constants structs and the workgroup size the dispatch is sized with
+void GpuCuller::CreateLayouts()
+{
+    if (_shaderLibrary.GetReflection("cull.comp").localSize[0] != WORKGROUP_SIZE) {
+        throw std::runtime_error("Error: cull.comp's local_size_x does not match GpuCuller::WORKGROUP_SIZE!");
+    }
+    ReflectedPipelineLayout cull = _shaderLibrary.CreatePipelineLayout({"cull.comp"}, sizeof(CullConstants));
+    _cullPipelineLayout = cull.layout;
+    _cullSetLayout = cull.setLayouts[0];
+
+    if (_bindlessTable) {
+        // The draws use the table's shared layout, whose push range covers any block that fits
+        if (_shaderLibrary.GetReflection("indirect_bindless.vert").pushConstantSize != sizeof(BindlessDrawConstants)) {
+            throw std::runtime_error("Error: the push constants of indirect_bindless.vert do not match "
+                                     "BindlessDrawConstants!");
+        }
+        return;
+    }
+    ReflectedPipelineLayout draw =
+        _shaderLibrary.CreatePipelineLayout({"indirect.vert", "shader.frag"}, sizeof(glm::mat4));
+    _drawPipelineLayout = draw.layout;
+    _drawSetLayout = draw.setLayouts[0];
+}
+
+// Written once: per frame slot a culling set (objects, draws, count), plus,
+// without a bindless table, one set with the objects for the vertex shader
+void GpuCuller::CreateDescriptors()
+{
+    const uint32_t drawSets = _bindlessTable ? 0 : 1;
+    const uint32_t frameCount = static_cast<uint32_t>(_frames.size());
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, frameCount * 3 + drawSets};
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = frameCount + drawSets;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    VkResult result = vkCreateDescriptorPool(_device.getDevice(), &poolInfo, nullptr, &_descriptorPool);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create culling descriptor pool! Error: " + std::to_string(result));
+    }
+
+    std::vector<VkDescriptorSetLayout> setLayouts(frameCount, _cullSetLayout);
+    if (drawSets > 0) {
+        setLayouts.push_back(_drawSetLayout);
+    }
+    std::vector<VkDescriptorSet> sets(setLayouts.size());
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(setLayouts.size());
+    allocInfo.pSetLayouts = setLayouts.data();
+    result = vkAllocateDescriptorSets(_device.getDevice(), &allocInfo, sets.data());
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate culling descriptor sets! Error: " + std::to_string(result));
+    }
+    if (drawSets > 0) {
+        _drawSet = sets.back();
+    }
+
+    VkDescriptorBufferInfo objectInfo{_objectBuffer, 0, VK_WHOLE_SIZE};
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    bufferInfos.reserve(frameCount * 2);
+    std::vector<VkWriteDescriptorSet> writes;
+    auto addWrite = [&](VkDescriptorSet set, uint32_t binding, const VkDescriptorBufferInfo* info) {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = info;
+        writes.push_back(write);
+    };
+    for (uint32_t i = 0; i < frameCount; i++) {
+        _frames[i].cullSet = sets[i];
+        bufferInfos.push_back({_frames[i].drawBuffer, 0, VK_WHOLE_SIZE});
+        bufferInfos.push_back({_frames[i].countBuffer, 0, VK_WHOLE_SIZE});
+        addWrite(sets[i], 0, &objectInfo);
+        addWrite(sets[i], 1, &bufferInfos[i * 2]);
+        addWrite(sets[i], 2, &bufferInfos[i * 2 + 1]);
+    }
+    if (drawSets > 0) {
+        addWrite(_drawSet, 0, &objectInfo);
+    }
+    vkUpdateDescriptorSets(_device.getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+void GpuCuller::CreatePipelines()
+{
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = _shaderLibrary.GetStageInfo("cull.comp");
+    pipelineInfo.layout = _cullPipelineLayout;
+    VkResult result = vkCreateComputePipelines(_device.getDevice(), _pipelineCache.getCache(), 1, &pipelineInfo,
+                                               nullptr, &_cullPipeline);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create culling pipeline! Error: " + std::to_string(result));
+    }
+    _pipelineCache.markDirty();
+}
+
+VkPipelineLayout GpuCuller::GetDrawPipelineLayout() const
+{
+    return _bindlessTable ? _bindlessTable->GetPipelineLayout() : _drawPipelineLayout;
+}
+
+void GpuCuller::StreamObjects()
+{
+    if (_indexTicket == 0) {
+        const std::array<uint32_t, INDEX_COUNT> indices = {0, 1, 2};
+        _indexTicket = _uploadManager.UploadBuffer(_indexBuffer, 0, indices.data(), sizeof(indices),
+                                                   VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
+    }
+    while (_queuedObjects < _objectCount) {
+        uint32_t count = std::min(OBJECTS_PER_UPLOAD, _objectCount - _queuedObjects);
+        UploadTicket ticket = _uploadManager.UploadBuffer(
+            _objectBuffer, static_cast<VkDeviceSize>(_queuedObjects) * sizeof(GpuObject), &_objects[_queuedObjects],
+            static_cast<VkDeviceSize>(count) * sizeof(GpuObject),
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        if (ticket == 0) {
+            break; // Staging ring full; the rest follows on later frames
+        }
+        _queuedObjects += count;
+        _pendingChunks.push_back({_queuedObjects, ticket});
+    }
+    if (_queuedObjects == _objectCount && !_objects.empty()) {
+        _objects = {}; // Everything is in the staging ring
+    }
+}
+
+// Objects become drawable in upload order, a chunk at a time
+void GpuCuller::UpdateResidency()
+{
+    if (_indexTicket == 0 || !_uploadManager.IsReady(_indexTicket)) {
+        return;
+    }
+    size_t ready = 0;
+    while (ready < _pendingChunks.size() && _uploadManager.IsReady(_pendingChunks[ready].ticket)) {
+        _stats.residentObjects = _pendingChunks[ready].endObject;
+        ready++;
+    }
+    _pendingChunks.erase(_pendingChunks.begin(), _pendingChunks.begin() + ready);
+}
+
+void GpuCuller::RecordCull(VkCommandBuffer commandBuffer, uint32_t frameSlot, const glm::mat4& viewProjection)
+{
+    UpdateResidency();
+    FrameResources& frame = _frames[frameSlot];
+    if (frame.culled) {
+        _device.getAllocator().invalidate(frame.readbackMemory);
+        _stats.visibleObjects = *static_cast<const uint32_t*>(frame.readbackMemory.mappedData);
+    }
+
+    // The slot's previous frame has completed: its buffers carry no pending accesses
+    _barriers.TrackBuffer(frame.drawBuffer);
+    _barriers.TrackBuffer(frame.countBuffer);
+    _barriers.TrackBuffer(frame.readbackBuffer);
+
+    _barriers.UseBuffer(frame.countBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    _barriers.Flush(commandBuffer, _device);
+    vkCmdFillBuffer(commandBuffer, frame.countBuffer, 0, sizeof(uint32_t), 0);
+
+    _barriers.UseBuffer(frame.countBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                        VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+    _barriers.UseBuffer(frame.drawBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+    _barriers.Flush(commandBuffer, _device);
+
+    if (_stats.residentObjects > 0) {
+        CullConstants constants{};
+        ExtractFrustumPlanes(viewProjection, constants.planes);
+        constants.objectCount = _stats.residentObjects;
+        constants.compact = _compact ? 1 : 0;
+        constants.indexCount = INDEX_COUNT;
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _cullPipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _cullPipelineLayout, 0, 1,
+                                &frame.cullSet, 0, nullptr);
+        vkCmdPushConstants(commandBuffer, _cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants),
+                           &constants);
+        vkCmdDispatch(commandBuffer, (_stats.residentObjects + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    // One barrier hands the draws and the count to the indirect stage and the
+    // count to the readback copy
+    _barriers.UseBuffer(frame.drawBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR,
+                        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR);
+    _barriers.UseBuffer(frame.countBuffer,
+                        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+                        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+    _barriers.UseBuffer(frame.readbackBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    _barriers.Flush(commandBuffer, _device);
+
+    VkBufferCopy copy{0, 0, sizeof(uint32_t)};
+    vkCmdCopyBuffer(commandBuffer, frame.countBuffer, frame.readbackBuffer, 1, &copy);
+    _barriers.UseBuffer(frame.readbackBuffer, VK_PIPELINE_STAGE_2_HOST_BIT_KHR, VK_ACCESS_2_HOST_READ_BIT_KHR);
+    _barriers.Flush(commandBuffer, _device);
+    frame.culled = true;
+}
+
+void GpuCuller::RecordDraws(VkCommandBuffer commandBuffer, uint32_t frameSlot, const glm::mat4& viewProjection)
+{
+    if (_stats.residentObjects == 0) {
+        return;
+    }
+    const FrameResources& frame = _frames[frameSlot];
+    if (_bindlessTable) {
+        // The table is already bound; only the handle changes hands
+        BindlessDrawConstants constants{viewProjection, _objectHandle};
+        vkCmdPushConstants(commandBuffer, _bindlessTable->GetPipelineLayout(), VK_SHADER_STAGE_ALL, 0,
+                           sizeof(constants), &constants);
+    } else {
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _drawPipelineLayout, 0, 1, &_drawSet,
+                                0, nullptr);
+        vkCmdPushConstants(commandBuffer, _drawPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4),
+                           &viewProjection);
+    }
+    vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    if (_compact) {
+        vkCmdDrawIndexedIndirectCount(commandBuffer, frame.drawBuffer, 0, frame.countBuffer, 0,
+                                      _stats.residentObjects, stride);
+    } else {
+        // Every resident object's slot, split only if the device caps the draw count
+        uint32_t maxDraws = std::max(_device.getProperties().limits.maxDrawIndirectCount, 1u);
+        for (uint32_t first = 0; first < _stats.residentObjects; first += maxDraws) {
+            uint32_t count = std::min(maxDraws, _stats.residentObjects - first);
+            vkCmdDrawIndexedIndirect(commandBuffer, frame.drawBuffer, static_cast<VkDeviceSize>(first) * stride,
+                                     count, stride);
+        }
+    }
+}
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include "BarrierBatcher.h"
+#include "BindlessTable.h"
+#include "UploadManager.h"
+#include "../vulkan/VulkanMemoryAllocator.h"
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+class VulkanPipelineCache;
+
+namespace VulkanApp::Rendering {
+
+class ShaderLibrary;
+
+// One object of the scene as the culling and vertex shaders see it; matches
+// Object in cull.comp and indirect.vert (std430)
+struct GpuObject {
+    float boundingSphere[4]; // xyz: center, w: radius
+    float offsetScale[4];    // xy: position, z: scale
+    float color[4];
+};
+
+// GPU-driven drawing: the objects live in a storage buffer, a compute pass
+// tests each one's bounding sphere against the frustum and writes a
+// VkDrawIndexedIndirectCommand for it, and the frame draws everything with one
+// vkCmdDrawIndexedIndirectCount (or, without drawIndirectCount, one
+// vkCmdDrawIndexedIndirect over every object's slot, culled ones drawing zero
+// instances). Recording cost no longer depends on the object count.
+//
+// Objects are streamed through the UploadManager in chunks and drawn once
+// resident. The draw and count buffers are per frame in flight, so a frame's
+// culling never waits for the previous frame's draws. The compute pipeline is
+// small and built synchronously against the persistent pipeline cache.
+//
+// Given a BindlessTable, the object buffer is registered in it and the draws
+// use the table's shared pipeline layout (indirect.vert built with -DBINDLESS),
+// so they bind nothing of their own.
+class GpuCuller {
+public:
+    static constexpr uint32_t WORKGROUP_SIZE = 64; // local_size_x in cull.comp
+    static constexpr uint32_t OBJECTS_PER_UPLOAD = 65536; // 3 MiB chunks through the staging ring
+
+    struct Stats {
+        uint32_t objects = 0;
+        uint32_t residentObjects = 0; // Uploaded and visible to graphics work
+        uint32_t visibleObjects = 0;  // Survived culling in the last frame read back
+        bool drawIndirectCount = false;
+    };
+
+    // Needs multiDrawIndirect and drawIndirectFirstInstance; drawIndirectCount is optional
+    static bool IsSupported(const VulkanDevice& device);
+
+    // bindlessTable is optional; it and shaderLibrary must outlive the culler
+    GpuCuller(VulkanDevice& device, VulkanPipelineCache& pipelineCache, ShaderLibrary& shaderLibrary,
+              UploadManager& uploadManager, BindlessTable* bindlessTable, uint32_t framesInFlight,
+              std::vector<GpuObject> objects);
+    ~GpuCuller(); // Device must be idle
+
+    GpuCuller(const GpuCuller&) = delete;
+    GpuCuller& operator=(const GpuCuller&) = delete;
+
+    // Render thread, before UploadManager::Flush: queues the object chunks the
+    // staging ring did not accept yet
+    void StreamObjects();
+
+    // Records the culling dispatch for frameSlot, whose previous frame must
+    // have completed; outside a render pass. Leaves the draws ready for
+    // DRAW_INDIRECT.
+    void RecordCull(VkCommandBuffer commandBuffer, uint32_t frameSlot, const glm::mat4& viewProjection);
+
+    // Inside the render pass, with a pipeline built against GetDrawPipelineLayout()
+    // bound, and the bindless table too when there is one
+    void RecordDraws(VkCommandBuffer commandBuffer, uint32_t frameSlot, const glm::mat4& viewProjection);
+
+    // Set 0: the object buffer (vertex stage), or the bindless table; push
+    // constants: the view-projection matrix, plus the object buffer's handle
+    // when bindless
+    VkPipelineLayout GetDrawPipelineLayout() const;
+    bool UsesBindless() const { return _bindlessTable != nullptr; }
+
+    const Stats& GetStats() const { return _stats; }
+
+private:
+    struct FrameResources {
+        VkBuffer drawBuffer = VK_NULL_HANDLE;
+        VulkanAllocation drawMemory;
+        VkBuffer countBuffer = VK_NULL_HANDLE;
+        VulkanAllocation countMemory;
+        VkBuffer readbackBuffer = VK_NULL_HANDLE; // Visible count, read once the slot retires
+        VulkanAllocation readbackMemory;
+        VkDescriptorSet cullSet = VK_NULL_HANDLE;
+        bool culled = false; // Readback holds a result
+    };
+
+    struct PendingChunk {
+        uint32_t endObject;
+        UploadTicket ticket;
+    };
+
+    VkBuffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, MemoryUsage memoryUsage,
+                          VulkanAllocation& allocation);
+    void CreateLayouts();
+    void CreateDescriptors();
+    void CreatePipelines();
+    void UpdateResidency();
+
+    VulkanDevice& _device;
+    VulkanPipelineCache& _pipelineCache;
+    ShaderLibrary& _shaderLibrary;
+    UploadManager& _uploadManager;
+    BindlessTable* _bindlessTable; // Null: the draws use _drawSet
+    const bool _compact; // drawIndirectCount: visible draws packed at the front
+
+    std::vector<GpuObject> _objects; // Kept until every chunk has been accepted
+    uint32_t _objectCount = 0;
+    uint32_t _queuedObjects = 0;           // Accepted by the upload manager
+    std::vector<PendingChunk> _pendingChunks; // Accepted but not yet resident, oldest first
+    UploadTicket _indexTicket = 0;
+
+    VkBuffer _objectBuffer = VK_NULL_HANDLE;
+    VulkanAllocation _objectMemory;
+    BindlessHandle _objectHandle = INVALID_BINDLESS_HANDLE;
+    VkBuffer _indexBuffer = VK_NULL_HANDLE;
+    VulkanAllocation _indexMemory;
+    std::vector<FrameResources> _frames;
+
+    // Layouts are reflected from the shaders and owned by the ShaderLibrary
+    VkDescriptorSetLayout _cullSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout _drawSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet _drawSet = VK_NULL_HANDLE;
+    VkPipelineLayout _cullPipelineLayout = VK_NULL_HANDLE;
+    VkPipelineLayout _drawPipelineLayout = VK_NULL_HANDLE;
+    VkPipeline _cullPipeline = VK_NULL_HANDLE;
+
+    BarrierBatcher _barriers; // Tracks the per-frame draw and count buffers
+    Stats _stats;
+};
+
+} // namespace VulkanApp::Rendering
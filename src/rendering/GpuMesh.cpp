@@ -0,0 +1,197 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+
+#include "GpuMesh.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace VulkanApp::Rendering {
+
+GpuMesh::GpuMesh(VulkanDevice& device, UploadManager& uploadManager, Assets::MeshFile file)
+    : _device(device),
+      _uploadManager(uploadManager),
+      _file(std::make_unique<Assets::MeshFile>(std::move(file)))
+{
+    _vertexCount = _file->GetVertexCount();
+    _indexCount = _file->GetIndexCount();
+    _indexType = _file->GetIndexType() == Assets::IndexType::Uint16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    _submeshes.assign(_file->GetSubmeshes().begin(), _file->GetSubmeshes().end());
+
+    // Queued in chunks so any mesh size fits through the staging ring
+    auto queueUpload = [&](VkBuffer buffer, std::span<const std::byte> data, VkAccessFlags dstAccess) {
+        for (VkDeviceSize offset = 0; offset < data.size(); offset += BYTES_PER_UPLOAD) {
+            _pendingUploads.push_back({buffer, offset, data.data() + offset,
+                                       std::min<VkDeviceSize>(BYTES_PER_UPLOAD, data.size() - offset), dstAccess});
+        }
+        _totalBytes += data.size();
+    };
+
+    std::span<const std::byte> indexData = _file->GetIndexData();
+    if (!indexData.empty()) {
+        _indexBuffer = CreateBuffer(indexData.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                    _indexMemory);
+        queueUpload(_indexBuffer, indexData, VK_ACCESS_INDEX_READ_BIT);
+    }
+    for (const Assets::MeshStreamDesc& desc : _file->GetStreams()) {
+        StreamBuffer& stream = _streams.emplace_back();
+        stream.semantic = static_cast<Assets::VertexSemantic>(desc.semantic);
+        stream.format = ToVkFormat(static_cast<Assets::VertexFormat>(desc.format));
+        stream.stride = desc.stride;
+        std::span<const std::byte> data = _file->GetStreamData(desc);
+        if (data.empty()) {
+            continue; // No vertices; the stream still gets a binding number
+        }
+        stream.buffer = CreateBuffer(data.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                     stream.memory);
+        queueUpload(stream.buffer, data, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    }
+
+    // Fault the pages in ahead of the copies into the staging ring
+    _file->GetMappedFile().Prefetch(0, _file->GetFileSize());
+}
+
+GpuMesh::~GpuMesh()
+{
+    VulkanMemoryAllocator& allocator = _device.getAllocator();
+    for (StreamBuffer& stream : _streams) {
+        if (stream.buffer != VK_NULL_HANDLE) {
+            allocator.destroyBuffer(stream.buffer, stream.memory);
+        }
+    }
+    if (_indexBuffer != VK_NULL_HANDLE) {
+        allocator.destroyBuffer(_indexBuffer, _indexMemory);
+    }
+}
+
+VkBuffer GpuMesh::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VulkanAllocation& allocation)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    return _device.getAllocator().createBuffer(bufferInfo, MemoryUsage::GpuOnly, allocation);
+}
+
+VkDeviceSize GpuMesh::Stream(VkDeviceSize maxBytes)
+{
+    VkDeviceSize handedOff = 0;
+    while (_queuedUploads < _pendingUploads.size() && handedOff < maxBytes) {
+        PendingUpload& upload = _pendingUploads[_queuedUploads];
+        VkDeviceSize size = std::min(upload.size, maxBytes - handedOff);
+        UploadTicket ticket = _uploadManager.UploadBuffer(upload.buffer, upload.offset, upload.data, size,
+                                                          VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, upload.dstAccess);
+        if (ticket == 0) {
+            return handedOff; // Staging ring full; the rest follows on later frames
+        }
+        _lastTicket = ticket;
+        handedOff += size;
+        if (size < upload.size) {
+            // Budget ran out mid-chunk; the rest of it goes first next time
+            upload.offset += size;
+            upload.data += size;
+            upload.size -= size;
+            return handedOff;
+        }
+        _queuedUploads++;
+    }
+    if (_file && _queuedUploads == _pendingUploads.size()) {
+        // Everything is in the staging ring; unmap the file
+        _pendingUploads = {};
+        _queuedUploads = 0;
+        _file.reset();
+    }
+    return handedOff;
+}
+
+bool GpuMesh::IsResident() const
+{
+    // A mesh without data has nothing to wait for
+    return !_file && (_lastTicket == 0 || _uploadManager.IsReady(_lastTicket));
+}
+
+void GpuMesh::GetVertexInput(const std::vector<Assets::VertexSemantic>& semantics,
+                             std::vector<VkVertexInputBindingDescription>& bindings,
+                             std::vector<VkVertexInputAttributeDescription>& attributes) const
+{
+    bindings.clear();
+    attributes.clear();
+    for (Assets::VertexSemantic semantic : semantics) {
+        for (uint32_t i = 0; i < _streams.size(); i++) {
+            if (_streams[i].semantic != semantic) {
+                continue;
+            }
+            bindings.push_back({i, _streams[i].stride, VK_VERTEX_INPUT_RATE_VERTEX});
+            attributes.push_back({static_cast<uint32_t>(semantic), i, _streams[i].format, 0});
+            break;
+        }
+    }
+}
+
+void GpuMesh::Bind(VkCommandBuffer commandBuffer) const
+{
+    std::vector<VkBuffer> buffers;
+    std::vector<VkDeviceSize> offsets(_streams.size(), 0);
+    buffers.reserve(_streams.size());
+    for (const StreamBuffer& stream : _streams) {
+        buffers.push_back(stream.buffer);
+    }
+    if (!buffers.empty() && _vertexCount > 0) {
+        vkCmdBindVertexBuffers(commandBuffer, 0, static_cast<uint32_t>(buffers.size()), buffers.data(),
+                               offsets.data());
+    }
+    if (_indexBuffer != VK_NULL_HANDLE) {
+        vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, _indexType);
+    }
+}
+
+void GpuMesh::DrawSubmesh(VkCommandBuffer commandBuffer, uint32_t submesh, uint32_t instanceCount) const
+{
+    const Assets::MeshSubmesh& range = _submeshes.at(submesh);
+    vkCmdDrawIndexed(commandBuffer, range.indexCount, instanceCount, range.firstIndex, range.vertexOffset, 0);
+}
+
+StreamedMesh::StreamedMesh(VulkanDevice& device, UploadManager& uploadManager, Assets::MeshFile file)
+    : _device(device),
+      _uploadManager(uploadManager),
+      _file(std::make_unique<Assets::MeshFile>(std::move(file)))
+{
+}
+
+Assets::AssetDecoder StreamedMesh::MakeDecoder(VulkanDevice& device, UploadManager& uploadManager)
+{
+    return [&device, &uploadManager](MappedFile file) -> std::unique_ptr<Assets::StreamedAsset> {
+        // Validation is the whole decode: the sections are uploaded as stored
+        return std::make_unique<StreamedMesh>(device, uploadManager, Assets::MeshFile(std::move(file)));
+    };
+}
+
+uint64_t StreamedMesh::Upload(uint64_t maxBytes)
+{
+    if (!_mesh) {
+        _mesh = std::make_unique<GpuMesh>(_device, _uploadManager, std::move(*_file));
+        _file.reset();
+    }
+    return _mesh->Stream(maxBytes);
+}
+
+VkFormat GpuMesh::ToVkFormat(Assets::VertexFormat format)
+{
+    switch (format) {
+        case Assets::VertexFormat::Float32x2: return VK_FORMAT_R32G32_SFLOAT;
+        case Assets::VertexFormat::Float32x3: return VK_FORMAT_R32G32B32_SFLOAT;
+        case Assets::VertexFormat::Float32x4: return VK_FORMAT_R32G32B32A32_SFLOAT;
+        case Assets::VertexFormat::Float16x2: return VK_FORMAT_R16G16_SFLOAT;
+        case Assets::VertexFormat::Float16x4: return VK_FORMAT_R16G16B16A16_SFLOAT;
+        // Read as float in [-1, 1] / [0, 1]; shaders/mesh_decode.glsl unpacks them
+        case Assets::VertexFormat::Octahedral16x2: return VK_FORMAT_R16G16_SNORM;
+        case Assets::VertexFormat::Unorm10x3_2: return VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+        case Assets::VertexFormat::Unorm8x4: return VK_FORMAT_R8G8B8A8_UNORM;
+    }
+    throw std::runtime_error("Error: unknown vertex format " + std::to_string(static_cast<uint32_t>(format)) + "!");
+}
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "UploadManager.h"
+#include "../assets/AssetStreamer.h"
+#include "../assets/MeshFile.h"
+#include "../vulkan/VulkanMemoryAllocator.h"
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+
+namespace VulkanApp::Rendering {
+
+// A .vkmesh in device-local vertex and index buffers. The data goes from the
+// file's memory mapping straight into the UploadManager's staging ring: no
+// parse, no intermediate heap copy. Each vertex stream gets its own buffer and
+// vertex binding (binding = stream index, location = VertexSemantic), so the
+// same mesh feeds pipelines that read any subset of the streams. The mapping
+// is kept until every chunk has been accepted by the staging ring.
+class GpuMesh {
+public:
+    static constexpr VkDeviceSize BYTES_PER_UPLOAD = 4ull * 1024 * 1024; // Chunks through the staging ring
+
+    // Creates the buffers and queues the uploads; nothing is copied until Stream()
+    GpuMesh(VulkanDevice& device, UploadManager& uploadManager, Assets::MeshFile file);
+    ~GpuMesh(); // No submitted frame may still use it (device idle or retired through the DeletionQueue)
+
+    GpuMesh(const GpuMesh&) = delete;
+    GpuMesh& operator=(const GpuMesh&) = delete;
+
+    // Render thread, before UploadManager::Flush: hands the staging ring up to
+    // maxBytes, as much as it accepts. Returns the bytes handed off.
+    VkDeviceSize Stream(VkDeviceSize maxBytes = VK_WHOLE_SIZE);
+
+    // Every byte handed to the staging ring; the file is unmapped
+    bool IsStreamed() const { return !_file; }
+    // Streamed and visible to graphics work
+    bool IsResident() const;
+
+    // Vertex input for a pipeline reading the given streams; a semantic the
+    // mesh lacks is skipped. Bindings refer to Bind()'s binding numbers.
+    void GetVertexInput(const std::vector<Assets::VertexSemantic>& semantics,
+                        std::vector<VkVertexInputBindingDescription>& bindings,
+                        std::vector<VkVertexInputAttributeDescription>& attributes) const;
+
+    // Binds every stream and the index buffer
+    void Bind(VkCommandBuffer commandBuffer) const;
+    void DrawSubmesh(VkCommandBuffer commandBuffer, uint32_t submesh, uint32_t instanceCount = 1) const;
+
+    uint32_t GetVertexCount() const { return _vertexCount; }
+    uint32_t GetIndexCount() const { return _indexCount; }
+    VkIndexType GetIndexType() const { return _indexType; }
+    const std::vector<Assets::MeshSubmesh>& GetSubmeshes() const { return _submeshes; }
+    VkDeviceSize GetResidentBytes() const { return _totalBytes; } // Device memory the mesh occupies once loaded
+
+    static VkFormat ToVkFormat(Assets::VertexFormat format);
+
+private:
+    struct StreamBuffer {
+        Assets::VertexSemantic semantic;
+        VkFormat format;
+        uint32_t stride;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VulkanAllocation memory;
+    };
+
+    // A piece of the mapping still to be handed to the UploadManager
+    struct PendingUpload {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        const std::byte* data;
+        VkDeviceSize size;
+        VkAccessFlags dstAccess;
+    };
+
+    VkBuffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VulkanAllocation& allocation);
+
+    VulkanDevice& _device;
+    UploadManager& _uploadManager;
+    std::unique_ptr<Assets::MeshFile> _file; // Released once every chunk is in the staging ring
+
+    uint32_t _vertexCount = 0;
+    uint32_t _indexCount = 0;
+    VkIndexType _indexType = VK_INDEX_TYPE_UINT32;
+    std::vector<Assets::MeshSubmesh> _submeshes;
+    VkDeviceSize _totalBytes = 0;
+
+    std::vector<StreamBuffer> _streams;
+    VkBuffer _indexBuffer = VK_NULL_HANDLE;
+    VulkanAllocation _indexMemory;
+
+    std::vector<PendingUpload> _pendingUploads; // Not yet accepted, in order
+    size_t _queuedUploads = 0;
+    UploadTicket _lastTicket = 0; // Resident once ready; tickets complete in order
+};
+
+// AssetStreamer payload for a .vkmesh. The decode worker validates the file
+// the I/O thread mapped; the first Upload, on the render thread, creates the
+// GpuMesh and its buffers, and every Upload streams sections within the
+// frame's byte budget.
+class StreamedMesh : public Assets::StreamedAsset {
+public:
+    StreamedMesh(VulkanDevice& device, UploadManager& uploadManager, Assets::MeshFile file);
+
+    // Decoder for AssetStreamer::Request
+    static Assets::AssetDecoder MakeDecoder(VulkanDevice& device, UploadManager& uploadManager);
+
+    uint64_t Upload(uint64_t maxBytes) override;
+    bool IsUploaded() const override { return _mesh && _mesh->IsStreamed(); }
+
+    // The mesh, once Upload created it; wait for IsResident() before drawing
+    GpuMesh* GetMesh() const { return _mesh.get(); }
+    std::unique_ptr<GpuMesh> TakeMesh() { return std::move(_mesh); }
+
+private:
+    VulkanDevice& _device;
+    UploadManager& _uploadManager;
+    std::unique_ptr<Assets::MeshFile> _file; // Until the GpuMesh takes it
+    std::unique_ptr<GpuMesh> _mesh;
+};
+
+} // namespace VulkanApp::Rendering
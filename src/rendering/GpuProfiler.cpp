@@ -0,0 +1,265 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+
+#include "GpuProfiler.h" // Include own header after dependencies
+
+#include <stdexcept>
+#include <iostream>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+// Order matches the bit order Vulkan uses to lay out the results
+constexpr VkQueryPipelineStatisticFlags STATISTICS_FLAGS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+constexpr uint32_t STATISTICS_VALUE_COUNT = 7;
+
+// Marks a scope that was dropped because the slot ran out of queries
+constexpr uint32_t DROPPED_SCOPE = UINT32_MAX;
+} // namespace
+
+VkQueryPipelineStatisticFlags GpuProfiler::GetStatisticsFlags() const
+{
+    return SupportsPipelineStatistics() ? STATISTICS_FLAGS : 0;
+}
+
+GpuProfiler::GpuProfiler(VulkanDevice& device, uint32_t framesInFlight, uint32_t maxScopesPerFrame, size_t historySize)
+    : _device(device), _framesInFlight(framesInFlight), _maxScopes(maxScopesPerFrame), _historySize(historySize),
+      _slots(framesInFlight)
+{
+    uint32_t graphicsFamily = _device.getQueueFamilyIndices().graphicsFamily.value();
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(_device.getPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(_device.getPhysicalDevice(), &familyCount, families.data());
+
+    uint32_t validBits = families[graphicsFamily].timestampValidBits;
+    if (validBits == 0) {
+        std::cout << "Graphics queue does not support timestamps; GPU profiler disabled." << std::endl;
+        return;
+    }
+    _timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+    _timestampPeriodNs = _device.getProperties().limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo timestampPoolInfo{};
+    timestampPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    timestampPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    timestampPoolInfo.queryCount = 2 * _maxScopes * _framesInFlight;
+
+    VkResult result = vkCreateQueryPool(_device.getDevice(), &timestampPoolInfo, nullptr, &_timestampPool);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool! Error: " + std::to_string(result));
+    }
+
+    if (_device.getEnabledFeatures().pipelineStatisticsQuery) {
+        VkQueryPoolCreateInfo statisticsPoolInfo{};
+        statisticsPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        statisticsPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statisticsPoolInfo.queryCount = _maxScopes * _framesInFlight;
+        statisticsPoolInfo.pipelineStatistics = STATISTICS_FLAGS;
+
+        result = vkCreateQueryPool(_device.getDevice(), &statisticsPoolInfo, nullptr, &_statisticsPool);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create pipeline statistics query pool! Error: " + std::to_string(result));
+        }
+    }
+    std::cout << "GPU profiler created (" << _maxScopes << " scopes/frame, statistics "
+              << (SupportsPipelineStatistics() ? "on" : "off") << ")." << std::endl;
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    if (_statisticsPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(_device.getDevice(), _statisticsPool, nullptr);
+    }
+    if (_timestampPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(_device.getDevice(), _timestampPool, nullptr);
+    }
+}
+
+bool GpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint64_t frameNumber)
+{
+    if (!IsEnabled()) {
+        return false;
+    }
+
+    if (!_openScopes.empty()) {
+        std::cerr << "GpuProfiler: " << _openScopes.size() << " scope(s) left open last frame." << std::endl;
+        _openScopes.clear();
+        _activeStatisticsScope = -1;
+    }
+
+    _currentSlot = frameIndex;
+    FrameSlot& slot = _slots[frameIndex];
+    bool collected = slot.pending && CollectResults(slot, frameIndex);
+
+    slot.scopes.clear();
+    slot.timestampCount = 0;
+    slot.statisticsCount = 0;
+    slot.frameNumber = frameNumber;
+    slot.pending = false;
+
+    // Queries must be reset before reuse; this has to happen outside a render pass
+    vkCmdResetQueryPool(commandBuffer, _timestampPool, 2 * _maxScopes * frameIndex, 2 * _maxScopes);
+    if (_statisticsPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, _statisticsPool, _maxScopes * frameIndex, _maxScopes);
+    }
+    return collected;
+}
+
+void GpuProfiler::BeginScope(VkCommandBuffer commandBuffer, const char* name, bool collectStatistics)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+
+    FrameSlot& slot = _slots[_currentSlot];
+    if (slot.scopes.size() >= _maxScopes) {
+        _openScopes.push_back(DROPPED_SCOPE);
+        return;
+    }
+
+    ScopeRecord record;
+    record.name = name;
+    record.depth = static_cast<uint32_t>(_openScopes.size());
+    for (auto it = _openScopes.rbegin(); it != _openScopes.rend(); ++it) {
+        if (*it != DROPPED_SCOPE) {
+            record.parent = static_cast<int32_t>(*it);
+            break;
+        }
+    }
+    record.beginQuery = slot.timestampCount;
+    slot.timestampCount += 2;
+
+    uint32_t scopeIndex = static_cast<uint32_t>(slot.scopes.size());
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _timestampPool,
+                        2 * _maxScopes * _currentSlot + record.beginQuery);
+
+    if (collectStatistics && _statisticsPool != VK_NULL_HANDLE && _activeStatisticsScope < 0) {
+        record.statisticsQuery = static_cast<int32_t>(slot.statisticsCount++);
+        vkCmdBeginQuery(commandBuffer, _statisticsPool, _maxScopes * _currentSlot + record.statisticsQuery, 0);
+        _activeStatisticsScope = static_cast<int32_t>(scopeIndex);
+    }
+
+    slot.scopes.push_back(std::move(record));
+    _openScopes.push_back(scopeIndex);
+}
+
+void GpuProfiler::EndScope(VkCommandBuffer commandBuffer)
+{
+    if (!IsEnabled()) {
+        return;
+    }
+    if (_openScopes.empty()) {
+        throw std::runtime_error("GpuProfiler::EndScope called without a matching BeginScope!");
+    }
+
+    uint32_t scopeIndex = _openScopes.back();
+    _openScopes.pop_back();
+    if (scopeIndex == DROPPED_SCOPE) {
+        return;
+    }
+
+    FrameSlot& slot = _slots[_currentSlot];
+    const ScopeRecord& record = slot.scopes[scopeIndex];
+    if (record.statisticsQuery >= 0) {
+        vkCmdEndQuery(commandBuffer, _statisticsPool, _maxScopes * _currentSlot + record.statisticsQuery);
+        _activeStatisticsScope = -1;
+    }
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _timestampPool,
+                        2 * _maxScopes * _currentSlot + record.beginQuery + 1);
+
+    // The slot has something to read back once every scope is closed
+    slot.pending = _openScopes.empty();
+}
+
+bool GpuProfiler::CollectResults(FrameSlot& slot, uint32_t frameIndex)
+{
+    slot.pending = false;
+    if (slot.scopes.empty()) {
+        return false;
+    }
+
+    // No WAIT flag: the slot's frame has completed, anything else is a bug we'd rather skip than stall on
+    std::vector<uint64_t> timestamps(slot.timestampCount);
+    VkResult result = vkGetQueryPoolResults(_device.getDevice(), _timestampPool, 2 * _maxScopes * frameIndex,
+                                            slot.timestampCount, timestamps.size() * sizeof(uint64_t),
+                                            timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return false;
+    }
+
+    std::vector<uint64_t> statistics(slot.statisticsCount * STATISTICS_VALUE_COUNT);
+    bool statisticsValid = false;
+    if (slot.statisticsCount > 0) {
+        result = vkGetQueryPoolResults(_device.getDevice(), _statisticsPool, _maxScopes * frameIndex,
+                                       slot.statisticsCount, statistics.size() * sizeof(uint64_t), statistics.data(),
+                                       STATISTICS_VALUE_COUNT * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        statisticsValid = result == VK_SUCCESS;
+    }
+
+    GpuFrameResult frame;
+    frame.frameNumber = slot.frameNumber;
+    frame.scopes.reserve(slot.scopes.size());
+    for (const ScopeRecord& record : slot.scopes) {
+        GpuScopeResult scope;
+        scope.name = record.name;
+        scope.depth = record.depth;
+        scope.parent = record.parent;
+
+        // Modular difference: a counter that wrapped inside the scope still gives its duration
+        uint64_t ticks = (timestamps[record.beginQuery + 1] - timestamps[record.beginQuery]) & _timestampMask;
+        scope.gpuMs = static_cast<double>(ticks) * _timestampPeriodNs / 1.0e6;
+
+        if (statisticsValid && record.statisticsQuery >= 0) {
+            const uint64_t* values = &statistics[record.statisticsQuery * STATISTICS_VALUE_COUNT];
+            scope.hasStatistics = true;
+            scope.statistics.inputAssemblyVertices = values[0];
+            scope.statistics.inputAssemblyPrimitives = values[1];
+            scope.statistics.vertexShaderInvocations = values[2];
+            scope.statistics.clippingInvocations = values[3];
+            scope.statistics.clippingPrimitives = values[4];
+            scope.statistics.fragmentShaderInvocations = values[5];
+            scope.statistics.computeShaderInvocations = values[6];
+        }
+
+        if (scope.depth == 0) {
+            frame.totalMs += scope.gpuMs;
+        }
+        frame.scopes.push_back(std::move(scope));
+    }
+
+    _history.push_back(std::move(frame));
+    while (_history.size() > _historySize) {
+        _history.pop_front();
+    }
+    return true;
+}
+
+const GpuFrameResult* GpuProfiler::GetLatestFrame() const
+{
+    return _history.empty() ? nullptr : &_history.back();
+}
+
+double GpuProfiler::GetAverageScopeMs(const std::string& name) const
+{
+    double total = 0.0;
+    size_t count = 0;
+    for (const GpuFrameResult& frame : _history) {
+        for (const GpuScopeResult& scope : frame.scopes) {
+            if (scope.name == name) {
+                total += scope.gpuMs;
+                count++;
+            }
+        }
+    }
+    return count > 0 ? total / static_cast<double>(count) : 0.0;
+}
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+
+namespace VulkanApp::Rendering {
+
+// Counters gathered by a pipeline-statistics query (requires the
+// pipelineStatisticsQuery device feature)
+struct PipelineStatistics {
+    uint64_t inputAssemblyVertices = 0;
+    uint64_t inputAssemblyPrimitives = 0;
+    uint64_t vertexShaderInvocations = 0;
+    uint64_t clippingInvocations = 0;
+    uint64_t clippingPrimitives = 0;
+    uint64_t fragmentShaderInvocations = 0;
+    uint64_t computeShaderInvocations = 0;
+};
+
+struct GpuScopeResult {
+    std::string name;
+    uint32_t depth = 0;            // Nesting level, 0 = outermost
+    int32_t parent = -1;           // Index into GpuFrameResult::scopes, -1 for roots
+    double gpuMs = 0.0;
+    bool hasStatistics = false;
+    PipelineStatistics statistics;
+};
+
+struct GpuFrameResult {
+    uint64_t frameNumber = 0;
+    double totalMs = 0.0;          // Sum of the root scopes
+    std::vector<GpuScopeResult> scopes; // In begin order
+};
+
+// Per-frame-in-flight query-pool profiler. Scopes are recorded into the
+// frame's command buffer; their results are read back when the same frame
+// slot comes around again (its frame has completed), so reading never stalls
+// and results arrive maxFramesInFlight frames late.
+class GpuProfiler {
+public:
+    GpuProfiler(VulkanDevice& device, uint32_t framesInFlight,
+                uint32_t maxScopesPerFrame = 64, size_t historySize = 240);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // False when the graphics queue has no timestamp support; all calls become no-ops
+    bool IsEnabled() const { return _timestampPool != VK_NULL_HANDLE; }
+    bool SupportsPipelineStatistics() const { return _statisticsPool != VK_NULL_HANDLE; }
+    // Counters a statistics scope collects (0 if unsupported); secondary command
+    // buffers executed inside such a scope must inherit them
+    VkQueryPipelineStatisticFlags GetStatisticsFlags() const;
+
+    // Call right after vkBeginCommandBuffer, once the slot's previous frame has completed.
+    // Collects the slot's previous results and resets its queries.
+    // Returns true if a new frame result was added to the history.
+    bool BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint64_t frameNumber);
+
+    // Scopes nest. Statistics are collected for the outermost scope that asks
+    // for them (Vulkan allows one active query of a type at a time); scopes
+    // started inside a render pass must also end inside it.
+    void BeginScope(VkCommandBuffer commandBuffer, const char* name, bool collectStatistics = false);
+    void EndScope(VkCommandBuffer commandBuffer);
+
+    // RAII helper: GpuProfiler::Scope scope(profiler, cmd, "Shadows");
+    class Scope {
+    public:
+        Scope(GpuProfiler& profiler, VkCommandBuffer commandBuffer, const char* name, bool collectStatistics = false)
+            : _profiler(profiler), _commandBuffer(commandBuffer)
+        {
+            _profiler.BeginScope(_commandBuffer, name, collectStatistics);
+        }
+        ~Scope() { _profiler.EndScope(_commandBuffer); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler& _profiler;
+        VkCommandBuffer _commandBuffer;
+    };
+
+    // Most recent completed frame, or nullptr before the first readback
+    const GpuFrameResult* GetLatestFrame() const;
+    // Rolling window of completed frames, oldest first
+    const std::deque<GpuFrameResult>& GetHistory() const { return _history; }
+    // Mean duration of a named scope over the history (0 if never seen)
+    double GetAverageScopeMs(const std::string& name) const;
+
+private:
+    struct ScopeRecord {
+        std::string name;
+        uint32_t depth = 0;
+        int32_t parent = -1;
+        uint32_t beginQuery = 0;   // Timestamp index relative to the slot's first query
+        int32_t statisticsQuery = -1; // Statistics index relative to the slot, -1 if none
+    };
+
+    struct FrameSlot {
+        std::vector<ScopeRecord> scopes;
+        uint32_t timestampCount = 0;
+        uint32_t statisticsCount = 0;
+        uint64_t frameNumber = 0;
+        bool pending = false;      // Recorded but not yet read back
+    };
+
+    bool CollectResults(FrameSlot& slot, uint32_t frameIndex);
+
+    VulkanDevice& _device;
+    const uint32_t _framesInFlight;
+    const uint32_t _maxScopes;
+    const size_t _historySize;
+
+    VkQueryPool _timestampPool = VK_NULL_HANDLE;  // 2 queries per scope per slot
+    VkQueryPool _statisticsPool = VK_NULL_HANDLE; // 1 query per scope per slot
+    double _timestampPeriodNs = 1.0;
+    uint64_t _timestampMask = ~0ull;
+
+    std::vector<FrameSlot> _slots;
+    uint32_t _currentSlot = 0;
+    std::vector<uint32_t> _openScopes;   // Stack of indices into the current slot's scopes
+    int32_t _activeStatisticsScope = -1;
+    std::deque<GpuFrameResult> _history;
+};
+
+} // namespace VulkanApp::Rendering
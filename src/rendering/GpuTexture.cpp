@@ -0,0 +1,205 @@
+// Include dependent class definitions *before* the namespace
+#include "../assets/TextureDecoder.h"
+#include "../vulkan/DeletionQueue.h"
+#include "../vulkan/VulkanDevice.h"
+
+#include "GpuTexture.h" // Include own header after dependencies
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace VulkanApp::Rendering {
+
+bool GpuTexture::IsFormatSupported(const VulkanDevice& device, Assets::TextureFormat format)
+{
+    if (Assets::GetTextureFormatInfo(format).compressed && !device.getEnabledFeatures().textureCompressionBC) {
+        return false;
+    }
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(device.getPhysicalDevice(), ToVkFormat(format), &properties);
+    const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+                                          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT |
+                                          VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    return (properties.optimalTilingFeatures & required) == required;
+}
+
+GpuTexture::Source GpuTexture::PrepareSource(const VulkanDevice& device, const UploadManager& uploadManager,
+                                             Assets::TextureFile file)
+{
+    Source source{std::move(file)};
+    const Assets::TextureFormat format = source.file.GetFormat();
+    const bool decode = !IsFormatSupported(device, format);
+    if (decode && !Assets::GetTextureFormatInfo(format).compressed) {
+        throw std::runtime_error("Error: " + source.file.GetMappedFile().GetPath() + ": the device cannot sample " +
+                                 Assets::GetTextureFormatName(format) + "!");
+    }
+    source.format = ToVkFormat(decode ? Assets::GetDecodedFormat(format) : format);
+    for (uint32_t level = 0; level < source.file.GetLevelCount(); level++) {
+        std::span<const std::byte> data = source.file.GetLevelData(level);
+        if (decode) {
+            data = source.decodedLevels.emplace_back(Assets::DecodeTextureLevel(
+                format, data, source.file.GetLevelWidth(level), source.file.GetLevelHeight(level)));
+        }
+        // A level is one copy, so it has to fit the ring in one piece
+        if (data.size() > uploadManager.GetStagingSize()) {
+            throw std::runtime_error("Error: " + source.file.GetMappedFile().GetPath() + " level " +
+                                     std::to_string(level) + " is larger than the staging ring!");
+        }
+    }
+    return source;
+}
+
+GpuTexture::GpuTexture(VulkanDevice& device, UploadManager& uploadManager, Source source)
+    : _device(device),
+      _uploadManager(uploadManager),
+      _source(std::make_unique<Source>(std::move(source))),
+      _format(_source->format)
+{
+    const Assets::TextureFile& file = _source->file;
+    _width = file.GetWidth();
+    _height = file.GetHeight();
+    for (uint32_t level = 0; level < file.GetLevelCount(); level++) {
+        std::span<const std::byte> data = file.GetLevelData(level);
+        if (!_source->decodedLevels.empty()) {
+            data = _source->decodedLevels[level];
+        }
+        _levels.push_back({file.GetLevelWidth(level), file.GetLevelHeight(level), data.data(), data.size()});
+        _totalBytes += data.size();
+    }
+    _residentLevel = GetLevelCount();
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = _format;
+    imageInfo.extent = {_width, _height, 1};
+    imageInfo.mipLevels = GetLevelCount();
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    _image = _device.getAllocator().createImage(imageInfo, MemoryUsage::GpuOnly, _memory);
+
+    if (_source->decodedLevels.empty()) {
+        // Fault the pages in ahead of the copies into the staging ring
+        file.GetMappedFile().Prefetch(0, file.GetFileSize());
+    }
+}
+
+GpuTexture::~GpuTexture()
+{
+    if (_view != VK_NULL_HANDLE) {
+        vkDestroyImageView(_device.getDevice(), _view, nullptr);
+    }
+    _device.getAllocator().destroyImage(_image, _memory);
+}
+
+VkDeviceSize GpuTexture::Stream(VkDeviceSize maxBytes)
+{
+    VkDeviceSize handedOff = 0;
+    while (_queuedLevels < _levels.size()) {
+        Level& level = _levels[_levels.size() - 1 - _queuedLevels];
+        // Levels are never split: each upload moves its whole subresource to the final layout
+        if (handedOff > 0 && handedOff + level.size > maxBytes) {
+            return handedOff;
+        }
+        level.ticket = _uploadManager.UploadImage(
+            _image, VK_IMAGE_ASPECT_COLOR_BIT, static_cast<uint32_t>(_levels.size() - 1 - _queuedLevels), 0,
+            {level.width, level.height, 1}, level.data, level.size, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        if (level.ticket == 0) {
+            return handedOff; // Staging ring full; the rest follows on later frames
+        }
+        handedOff += level.size;
+        _queuedLevels++;
+    }
+    if (_source) {
+        // Every level is in the staging ring; unmap the file and drop decoded copies
+        _source.reset();
+        for (Level& level : _levels) {
+            level.data = nullptr;
+        }
+    }
+    return handedOff;
+}
+
+bool GpuTexture::UpdateResidency(DeletionQueue& deletionQueue, uint64_t lastUsingFrame)
+{
+    uint32_t residentLevel = _residentLevel;
+    while (residentLevel > 0 && _levels[residentLevel - 1].ticket != 0 &&
+           _uploadManager.IsReady(_levels[residentLevel - 1].ticket)) {
+        residentLevel--;
+    }
+    if (residentLevel == _residentLevel) {
+        return false;
+    }
+    if (_view != VK_NULL_HANDLE) {
+        VkDevice device = _device.getDevice();
+        VkImageView retired = _view;
+        deletionQueue.push(lastUsingFrame, [device, retired]() { vkDestroyImageView(device, retired, nullptr); });
+    }
+    _view = CreateView(residentLevel);
+    _residentLevel = residentLevel;
+    return true;
+}
+
+VkImageView GpuTexture::CreateView(uint32_t baseLevel) const
+{
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = _image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = _format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, baseLevel, GetLevelCount() - baseLevel, 0, 1};
+    VkImageView view = VK_NULL_HANDLE;
+    VkResult result = vkCreateImageView(_device.getDevice(), &viewInfo, nullptr, &view);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create texture image view! Error: " + std::to_string(result));
+    }
+    return view;
+}
+
+VkDeviceSize GpuTexture::GetUncompressedBytes() const
+{
+    VkDeviceSize bytes = 0;
+    for (const Level& level : _levels) {
+        bytes += VkDeviceSize(level.width) * level.height * 4;
+    }
+    return bytes;
+}
+
+StreamedTexture::StreamedTexture(VulkanDevice& device, UploadManager& uploadManager, GpuTexture::Source source,
+                                 TextureCreatedCallback onCreated)
+    : _device(device),
+      _uploadManager(uploadManager),
+      _source(std::make_unique<GpuTexture::Source>(std::move(source))),
+      _onCreated(std::move(onCreated))
+{
+}
+
+Assets::AssetDecoder StreamedTexture::MakeDecoder(VulkanDevice& device, UploadManager& uploadManager,
+                                                  TextureCreatedCallback onCreated)
+{
+    return [&device, &uploadManager, onCreated](MappedFile file) -> std::unique_ptr<Assets::StreamedAsset> {
+        GpuTexture::Source source =
+            GpuTexture::PrepareSource(device, uploadManager, Assets::TextureFile(std::move(file)));
+        return std::make_unique<StreamedTexture>(device, uploadManager, std::move(source), onCreated);
+    };
+}
+
+uint64_t StreamedTexture::Upload(uint64_t maxBytes)
+{
+    if (!_texture) {
+        _texture = std::make_unique<GpuTexture>(_device, _uploadManager, std::move(*_source));
+        _source.reset();
+        if (_onCreated) {
+            _onCreated(*_texture);
+        }
+    }
+    return _texture->Stream(maxBytes);
+}
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "UploadManager.h"
+#include "../assets/AssetStreamer.h"
+#include "../assets/TextureFile.h"
+#include "../vulkan/VulkanMemoryAllocator.h"
+
+// Forward declarations (global namespace)
+class DeletionQueue;
+class VulkanDevice;
+
+namespace VulkanApp::Rendering {
+
+// A KTX2 texture in a device-local, fully mipmapped image. Block-compressed
+// levels are copied from the file's mapping into the staging ring as stored,
+// so the image takes 4-8x less memory and bandwidth than RGBA8; a device that
+// cannot sample the format gets levels decoded to RGBA8 on the CPU instead
+// (assets/TextureDecoder.h). Levels stream smallest first, and the view only
+// covers the levels already resident, so the texture is usable at low
+// resolution after the first few kilobytes and sharpens as the rest arrive.
+class GpuTexture {
+public:
+    // What the image is filled from; PrepareSource builds it on a worker thread
+    struct Source {
+        Assets::TextureFile file;
+        VkFormat format = VK_FORMAT_UNDEFINED; // The image's format
+        // RGBA8 copies of every level when the device cannot sample the file's format
+        std::vector<std::vector<std::byte>> decodedLevels;
+    };
+
+    // True when the device can sample, filter and copy to format in an optimal-tiling image
+    static bool IsFormatSupported(const VulkanDevice& device, Assets::TextureFormat format);
+    // Any thread. Picks the image format, decoding every level if the device
+    // lacks it. Throws std::runtime_error if a level cannot fit the staging ring.
+    static Source PrepareSource(const VulkanDevice& device, const UploadManager& uploadManager,
+                                Assets::TextureFile file);
+
+    // Creates the image; nothing is copied until Stream()
+    GpuTexture(VulkanDevice& device, UploadManager& uploadManager, Source source);
+    ~GpuTexture(); // No submitted frame may still use it (device idle or retired through the DeletionQueue)
+
+    GpuTexture(const GpuTexture&) = delete;
+    GpuTexture& operator=(const GpuTexture&) = delete;
+
+    // Render thread, before UploadManager::Flush: hands whole levels to the
+    // staging ring, smallest first, up to maxBytes. A level larger than
+    // maxBytes still goes alone when it is the first this call, so every
+    // level makes progress. Returns the bytes handed off.
+    VkDeviceSize Stream(VkDeviceSize maxBytes = VK_WHOLE_SIZE);
+
+    // Render thread, before recording: widens the view to every level whose
+    // upload is visible to graphics work, retiring the old view after
+    // lastUsingFrame. Returns true when the view changed (re-register it with
+    // the BindlessTable, or rewrite descriptors that hold it).
+    bool UpdateResidency(DeletionQueue& deletionQueue, uint64_t lastUsingFrame);
+
+    // Every level handed to the staging ring; the file is unmapped
+    bool IsStreamed() const { return !_source; }
+    // Every level visible to graphics work and in the view
+    bool IsResident() const { return _residentLevel == 0; }
+
+    // Null until the smallest level is resident. Layout: SHADER_READ_ONLY_OPTIMAL.
+    VkImageView GetView() const { return _view; }
+    VkImage GetImage() const { return _image; }
+    VkFormat GetFormat() const { return _format; }
+    uint32_t GetWidth() const { return _width; }
+    uint32_t GetHeight() const { return _height; }
+    uint32_t GetLevelCount() const { return static_cast<uint32_t>(_levels.size()); }
+    // Most detailed level in the view; GetLevelCount() while none is
+    uint32_t GetResidentLevel() const { return _residentLevel; }
+
+    VkDeviceSize GetResidentBytes() const { return _totalBytes; } // Device memory the levels occupy once loaded
+    VkDeviceSize GetUncompressedBytes() const; // The same mip chain as RGBA8
+
+    static VkFormat ToVkFormat(Assets::TextureFormat format) { return static_cast<VkFormat>(format); }
+
+private:
+    struct Level {
+        uint32_t width;
+        uint32_t height;
+        const std::byte* data; // Into the mapping or Source::decodedLevels
+        VkDeviceSize size;
+        UploadTicket ticket = 0; // 0 until accepted by the staging ring
+    };
+
+    VkImageView CreateView(uint32_t baseLevel) const;
+
+    VulkanDevice& _device;
+    UploadManager& _uploadManager;
+    std::unique_ptr<Source> _source; // Released once every level is in the staging ring
+
+    VkFormat _format;
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+    VkDeviceSize _totalBytes = 0;
+    std::vector<Level> _levels;
+    uint32_t _queuedLevels = 0;  // Handed to the staging ring, smallest first
+    uint32_t _residentLevel = 0; // Set to the level count by the constructor
+
+    VkImage _image = VK_NULL_HANDLE;
+    VulkanAllocation _memory;
+    VkImageView _view = VK_NULL_HANDLE;
+};
+
+// Render thread: called with the texture the first Upload creates, before any
+// level is resident, so its owner can draw with it while it streams
+using TextureCreatedCallback = std::function<void(GpuTexture& texture)>;
+
+// AssetStreamer payload for a .ktx2. The decode worker validates the file the
+// I/O thread mapped and, on devices without the format, decodes it to RGBA8;
+// the first Upload, on the render thread, creates the GpuTexture and every
+// Upload streams levels within the frame's byte budget.
+class StreamedTexture : public Assets::StreamedAsset {
+public:
+    StreamedTexture(VulkanDevice& device, UploadManager& uploadManager, GpuTexture::Source source,
+                    TextureCreatedCallback onCreated = {});
+
+    // Decoder for AssetStreamer::Request
+    static Assets::AssetDecoder MakeDecoder(VulkanDevice& device, UploadManager& uploadManager,
+                                            TextureCreatedCallback onCreated = {});
+
+    uint64_t Upload(uint64_t maxBytes) override;
+    bool IsUploaded() const override { return _texture && _texture->IsStreamed(); }
+
+    // The texture, once Upload created it; call UpdateResidency every frame until IsResident()
+    GpuTexture* GetTexture() const { return _texture.get(); }
+    std::unique_ptr<GpuTexture> TakeTexture() { return std::move(_texture); }
+
+private:
+    VulkanDevice& _device;
+    UploadManager& _uploadManager;
+    std::unique_ptr<GpuTexture::Source> _source; // Until the GpuTexture takes it
+    TextureCreatedCallback _onCreated;
+    std::unique_ptr<GpuTexture> _texture;
+};
+
+} // namespace VulkanApp::Rendering
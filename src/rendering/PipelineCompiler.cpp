@@ -0,0 +1,279 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+#include "../vulkan/VulkanPipelineCache.h"
+#include "../vulkan/DeletionQueue.h"
+#include "../core/ThreadPool.h"
+#include "ShaderLibrary.h"
+
+#include "PipelineCompiler.h" // Include own header after dependencies
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+void HashCombine(size_t& seed, size_t value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+bool HasStencil(VkFormat format)
+{
+    return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT ||
+           format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_S8_UINT;
+}
+} // namespace
+
+size_t GraphicsPipelineDescHash::operator()(const GraphicsPipelineDesc& desc) const
+{
+    size_t seed = 0;
+    HashCombine(seed, std::hash<std::string>{}(desc.vertexShader));
+    HashCombine(seed, std::hash<std::string>{}(desc.fragmentShader));
+    HashCombine(seed, static_cast<size_t>(desc.topology));
+    HashCombine(seed, static_cast<size_t>(desc.polygonMode));
+    HashCombine(seed, static_cast<size_t>(desc.cullMode));
+    HashCombine(seed, static_cast<size_t>(desc.frontFace));
+    HashCombine(seed, static_cast<size_t>(desc.blendEnable));
+    HashCombine(seed, std::hash<const void*>{}(reinterpret_cast<const void*>(desc.layout)));
+    HashCombine(seed, std::hash<const void*>{}(reinterpret_cast<const void*>(desc.renderPass)));
+    HashCombine(seed, static_cast<size_t>(desc.subpass));
+    for (VkFormat format : desc.colorFormats) {
+        HashCombine(seed, static_cast<size_t>(format));
+    }
+    HashCombine(seed, static_cast<size_t>(desc.depthFormat));
+    return seed;
+}
+
+PipelineCompiler::PipelineCompiler(VulkanDevice& device, VulkanPipelineCache& pipelineCache,
+                                   const ShaderLibrary& shaderLibrary, uint32_t threadCount)
+    : _device(device), _pipelineCache(pipelineCache), _shaderLibrary(shaderLibrary)
+{
+    _threadPool = std::make_unique<ThreadPool>(threadCount);
+    _workerCaches.reserve(_threadPool->GetThreadCount());
+    for (uint32_t i = 0; i < _threadPool->GetThreadCount(); i++) {
+        _workerCaches.push_back(_pipelineCache.createWorkerCache());
+    }
+    std::cout << "Pipeline compiler started with " << _threadPool->GetThreadCount() << " worker threads." << std::endl;
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+    _threadPool->WaitIdle();
+
+    for (auto& [desc, future] : _pipelines) {
+        VkPipeline pipeline = TryGet(future);
+        if (pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(_device.getDevice(), pipeline, nullptr);
+        }
+    }
+    _pipelines.clear();
+
+    _pipelineCache.mergeWorkerCaches(_workerCaches, true);
+    _workerCaches.clear();
+    std::cout << "Pipeline compiler destroyed." << std::endl;
+}
+
+PipelineFuture PipelineCompiler::Request(const GraphicsPipelineDesc& desc)
+{
+    auto it = _pipelines.find(desc);
+    if (it != _pipelines.end()) {
+        _deduplicatedRequests++;
+        return it->second;
+    }
+
+    _pendingCompiles++;
+    PipelineFuture future = _threadPool->Submit([this, desc]() {
+        struct PendingGuard {
+            std::atomic<uint32_t>& pending;
+            ~PendingGuard() { pending--; }
+        } guard{_pendingCompiles};
+        return Compile(desc);
+    }).share();
+    _pipelines.emplace(desc, future);
+    return future;
+}
+
+VkPipeline PipelineCompiler::TryGet(const PipelineFuture& future)
+{
+    if (!future.valid() || future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return VK_NULL_HANDLE;
+    }
+    try {
+        return future.get();
+    } catch (const std::exception&) {
+        return VK_NULL_HANDLE; // The compile failed; the error was logged on the worker
+    }
+}
+
+void PipelineCompiler::Retire(const GraphicsPipelineDesc& desc, DeletionQueue& deletionQueue, uint64_t lastUsingFrame)
+{
+    auto it = _pipelines.find(desc);
+    if (it == _pipelines.end()) {
+        return;
+    }
+    PipelineFuture future = it->second;
+    _pipelines.erase(it);
+
+    // A compile still in flight has to finish before its result can be destroyed
+    future.wait();
+    VkPipeline pipeline = TryGet(future);
+    if (pipeline == VK_NULL_HANDLE) {
+        return;
+    }
+    VkDevice device = _device.getDevice();
+    deletionQueue.push(lastUsingFrame, [device, pipeline]() {
+        vkDestroyPipeline(device, pipeline, nullptr);
+    });
+}
+
+void PipelineCompiler::Update()
+{
+    // Worker caches are only written by compiles, so merge once none are running
+    if (_pendingCompiles.load() == 0 && _workerCachesDirty.exchange(false)) {
+        _pipelineCache.mergeWorkerCaches(_workerCaches, false);
+    }
+}
+
+void PipelineCompiler::WaitIdle()
+{
+    _threadPool->WaitIdle();
+}
+
+uint32_t PipelineCompiler::GetThreadCount() const
+{
+    return _threadPool->GetThreadCount();
+}
+
+double PipelineCompiler::GetTotalCompileMs() const
+{
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    return _totalCompileMs;
+}
+
+// --- Worker side ---
+
+VkPipeline PipelineCompiler::Compile(const GraphicsPipelineDesc& desc)
+{
+    auto compileStart = std::chrono::steady_clock::now();
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    try {
+        VkPipelineShaderStageCreateInfo shaderStages[2] = {_shaderLibrary.GetStageInfo(desc.vertexShader),
+                                                           _shaderLibrary.GetStageInfo(desc.fragmentShader)};
+        if (shaderStages[0].stage != VK_SHADER_STAGE_VERTEX_BIT ||
+            shaderStages[1].stage != VK_SHADER_STAGE_FRAGMENT_BIT) {
+            throw std::runtime_error("Error: expected a vertex and a fragment shader!");
+        }
+
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = desc.topology;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        // Viewport and scissor are dynamic; only the counts are baked in
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.scissorCount = 1;
+
+        std::array<VkDynamicState, 2> dynamicStates = {
+            VK_DYNAMIC_STATE_VIEWPORT,
+            VK_DYNAMIC_STATE_SCISSOR
+        };
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates = dynamicStates.data();
+
+        VkPipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.depthClampEnable = VK_FALSE;
+        rasterizer.rasterizerDiscardEnable = VK_FALSE;
+        rasterizer.polygonMode = desc.polygonMode;
+        rasterizer.lineWidth = 1.0f;
+        rasterizer.cullMode = desc.cullMode;
+        rasterizer.frontFace = desc.frontFace;
+        rasterizer.depthBiasEnable = VK_FALSE;
+
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.sampleShadingEnable = VK_FALSE;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = desc.blendEnable ? VK_TRUE : VK_FALSE;
+        if (desc.blendEnable) {
+            colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+            colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+            colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+            colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        }
+
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.logicOpEnable = VK_FALSE;
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments = &colorBlendAttachment;
+
+        // Without a render pass the attachment formats are declared directly
+        VkPipelineRenderingCreateInfoKHR renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(desc.colorFormats.size());
+        renderingInfo.pColorAttachmentFormats = desc.colorFormats.data();
+        renderingInfo.depthAttachmentFormat = desc.depthFormat;
+        renderingInfo.stencilAttachmentFormat = HasStencil(desc.depthFormat) ? desc.depthFormat : VK_FORMAT_UNDEFINED;
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.pNext = desc.renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
+        pipelineInfo.stageCount = 2;
+        pipelineInfo.pStages = shaderStages;
+        pipelineInfo.pVertexInputState = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState = &multisampling;
+        pipelineInfo.pColorBlendState = &colorBlending;
+        pipelineInfo.pDynamicState = &dynamicState;
+        pipelineInfo.layout = desc.layout;
+        pipelineInfo.renderPass = desc.renderPass;
+        pipelineInfo.subpass = desc.subpass;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineInfo.basePipelineIndex = -1;
+
+        // Each worker owns its cache, so compiles never contend on a cache lock
+        int32_t workerIndex = ThreadPool::CurrentWorkerIndex();
+        VkPipelineCache cache = workerIndex >= 0 ? _workerCaches[workerIndex] : _pipelineCache.getCache();
+
+        VkResult result = vkCreateGraphicsPipelines(_device.getDevice(), cache, 1, &pipelineInfo, nullptr, &pipeline);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create graphics pipeline! Error: " + std::to_string(result));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: pipeline compile failed (" << desc.vertexShader << ", " << desc.fragmentShader
+                  << "): " << e.what() << std::endl;
+        throw;
+    }
+    _workerCachesDirty = true;
+
+    double compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compileStart).count();
+    {
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _totalCompileMs += compileMs;
+    }
+    std::cout << "Graphics pipeline compiled in " << compileMs << " ms ("
+              << (_pipelineCache.isWarm() ? "warm" : "cold") << " cache)." << std::endl;
+    return pipeline;
+}
+
+} // namespace VulkanApp::Rendering
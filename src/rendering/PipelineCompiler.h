@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+class VulkanPipelineCache;
+class DeletionQueue;
+class ThreadPool;
+
+namespace VulkanApp::Rendering {
+
+class ShaderLibrary;
+
+// Everything that determines a graphics pipeline. Viewport and scissor are
+// always dynamic state, so the extent is not part of the description.
+struct GraphicsPipelineDesc {
+    std::string vertexShader;   // Name in the ShaderLibrary, e.g. "shader.vert"
+    std::string fragmentShader;
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+    bool blendEnable = false;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    uint32_t subpass = 0;
+    // Attachment formats for dynamic rendering, used when renderPass is VK_NULL_HANDLE
+    std::vector<VkFormat> colorFormats;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+    bool operator==(const GraphicsPipelineDesc& other) const = default;
+};
+
+struct GraphicsPipelineDescHash {
+    size_t operator()(const GraphicsPipelineDesc& desc) const;
+};
+
+// Resolves to the pipeline once compiled; get() rethrows compile errors
+using PipelineFuture = std::shared_future<VkPipeline>;
+
+// Compiles graphics pipelines on a pool of worker threads. Identical
+// descriptions share one compile and one VkPipeline. Each worker compiles into
+// its own VkPipelineCache (seeded from the persistent cache), and the worker
+// caches are merged back whenever the compiler goes idle. Shader modules come
+// from the ShaderLibrary, created once at startup, so a compile does no I/O.
+class PipelineCompiler {
+public:
+    // threadCount 0 = one worker per hardware thread minus one; shaderLibrary must outlive the compiler
+    PipelineCompiler(VulkanDevice& device, VulkanPipelineCache& pipelineCache, const ShaderLibrary& shaderLibrary,
+                     uint32_t threadCount = 0);
+    ~PipelineCompiler(); // Waits for running compiles and destroys every pipeline
+
+    PipelineCompiler(const PipelineCompiler&) = delete;
+    PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+    // Never blocks. Returns the existing future for an identical description.
+    PipelineFuture Request(const GraphicsPipelineDesc& desc);
+
+    // The pipeline if it is ready, VK_NULL_HANDLE while it is still compiling
+    static VkPipeline TryGet(const PipelineFuture& future);
+
+    // Forgets desc's pipeline; it is destroyed once lastUsingFrame has retired
+    void Retire(const GraphicsPipelineDesc& desc, DeletionQueue& deletionQueue, uint64_t lastUsingFrame);
+
+    // Call once per frame from the render thread: merges worker caches when idle
+    void Update();
+
+    // Blocks until every queued compile has finished
+    void WaitIdle();
+
+    uint32_t GetThreadCount() const;
+    uint32_t GetPendingCount() const { return _pendingCompiles.load(); }
+    uint64_t GetDeduplicatedCount() const { return _deduplicatedRequests; }
+    // Summed worker time spent in vkCreateGraphicsPipelines
+    double GetTotalCompileMs() const;
+
+private:
+    VkPipeline Compile(const GraphicsPipelineDesc& desc);
+
+    VulkanDevice& _device;
+    VulkanPipelineCache& _pipelineCache;
+    const ShaderLibrary& _shaderLibrary;
+    std::vector<VkPipelineCache> _workerCaches; // Indexed by ThreadPool::CurrentWorkerIndex()
+
+    std::unordered_map<GraphicsPipelineDesc, PipelineFuture, GraphicsPipelineDescHash> _pipelines;
+    uint64_t _deduplicatedRequests = 0;
+
+    std::atomic<uint32_t> _pendingCompiles{0};
+    std::atomic<bool> _workerCachesDirty{false};
+    mutable std::mutex _statsMutex;
+    double _totalCompileMs = 0.0;
+
+    // Declared last so the workers are joined before anything above is destroyed
+    std::unique_ptr<ThreadPool> _threadPool;
+};
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,1051 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+#include "GpuProfiler.h"
+
+#include "RenderGraph.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+// Layout, stages and access mask an RGAccess stands for
+struct AccessInfo {
+    VkImageLayout layout;
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+    bool write;
+};
+
+constexpr VkAccessFlags WRITE_ACCESS_MASK = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+VkPipelineStageFlags ShaderStages(RGPassType type)
+{
+    return type == RGPassType::Compute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                       : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+}
+
+AccessInfo GetAccessInfo(RGAccess access, RGPassType type, VkAttachmentLoadOp loadOp)
+{
+    constexpr VkPipelineStageFlags depthStages =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    switch (access) {
+    case RGAccess::ColorAttachment:
+        return {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                    (loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT : 0u),
+                true};
+    case RGAccess::DepthAttachment:
+        return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depthStages,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, true};
+    case RGAccess::DepthRead:
+        return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, depthStages,
+                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, false};
+    case RGAccess::Sampled:
+        return {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, ShaderStages(type), VK_ACCESS_SHADER_READ_BIT, false};
+    case RGAccess::StorageRead:
+        return {VK_IMAGE_LAYOUT_GENERAL, ShaderStages(type), VK_ACCESS_SHADER_READ_BIT, false};
+    case RGAccess::StorageWrite:
+        return {VK_IMAGE_LAYOUT_GENERAL, ShaderStages(type), VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, true};
+    case RGAccess::TransferSrc:
+        return {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, false};
+    case RGAccess::TransferDst:
+        return {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, true};
+    }
+    throw std::runtime_error("Error: Unknown render graph access!");
+}
+
+VkImageUsageFlags GetImageUsage(RGAccess access)
+{
+    switch (access) {
+    case RGAccess::ColorAttachment: return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    case RGAccess::DepthAttachment:
+    case RGAccess::DepthRead: return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    case RGAccess::Sampled: return VK_IMAGE_USAGE_SAMPLED_BIT;
+    case RGAccess::StorageRead:
+    case RGAccess::StorageWrite: return VK_IMAGE_USAGE_STORAGE_BIT;
+    case RGAccess::TransferSrc: return VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    case RGAccess::TransferDst: return VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
+    return 0;
+}
+
+bool IsAttachment(RGAccess access)
+{
+    return access == RGAccess::ColorAttachment || access == RGAccess::DepthAttachment || access == RGAccess::DepthRead;
+}
+
+// A write that leaves nothing of the previous contents, so earlier writers aren't needed
+bool OverwritesAll(RGAccess access, VkAttachmentLoadOp loadOp)
+{
+    return (access == RGAccess::ColorAttachment || access == RGAccess::DepthAttachment) &&
+           loadOp != VK_ATTACHMENT_LOAD_OP_LOAD;
+}
+
+bool HasStencil(VkFormat format)
+{
+    return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT ||
+           format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_S8_UINT;
+}
+
+VkImageAspectFlags GetAspect(VkFormat format)
+{
+    switch (format) {
+    case VK_FORMAT_D16_UNORM:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+    case VK_FORMAT_D32_SFLOAT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    case VK_FORMAT_S8_UINT:
+        return VK_IMAGE_ASPECT_STENCIL_BIT;
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    default:
+        return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
+// Non-dispatchable handles are pointers or uint64_t depending on the platform
+template <typename Handle>
+uint64_t HandleBits(Handle handle)
+{
+    return (uint64_t)handle;
+}
+
+// FNV-1a over the fields that shape the compiled graph
+class TopologyHasher {
+public:
+    void Add(uint64_t value)
+    {
+        for (int i = 0; i < 8; i++) {
+            _hash ^= (value >> (i * 8)) & 0xff;
+            _hash *= 0x100000001b3ull;
+        }
+    }
+    void Add(const std::string& text)
+    {
+        for (char c : text) {
+            _hash ^= static_cast<unsigned char>(c);
+            _hash *= 0x100000001b3ull;
+        }
+        Add(text.size());
+    }
+    uint64_t Get() const { return _hash; }
+
+private:
+    uint64_t _hash = 0xcbf29ce484222325ull;
+};
+} // namespace
+
+// --- PassBuilder ---
+
+RGResource RenderGraph::PassBuilder::CreateImage(const std::string& name, const RGImageDesc& desc)
+{
+    if (desc.format == VK_FORMAT_UNDEFINED || desc.extent.width == 0 || desc.extent.height == 0) {
+        throw std::runtime_error("Error: Render graph image '" + name + "' needs a format and a non-zero extent!");
+    }
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    _graph._resources.push_back(std::move(resource));
+    return static_cast<RGResource>(_graph._resources.size() - 1);
+}
+
+void RenderGraph::PassBuilder::WriteColor(RGResource resource, VkAttachmentLoadOp loadOp, VkClearColorValue clear)
+{
+    VkClearValue value{};
+    value.color = clear;
+    AddAccess(resource, RGAccess::ColorAttachment, loadOp, value);
+}
+
+void RenderGraph::PassBuilder::WriteDepth(RGResource resource, VkAttachmentLoadOp loadOp, VkClearDepthStencilValue clear)
+{
+    VkClearValue value{};
+    value.depthStencil = clear;
+    AddAccess(resource, RGAccess::DepthAttachment, loadOp, value);
+}
+
+void RenderGraph::PassBuilder::ReadDepth(RGResource resource)
+{
+    AddAccess(resource, RGAccess::DepthRead, VK_ATTACHMENT_LOAD_OP_LOAD, {});
+}
+
+void RenderGraph::PassBuilder::ReadTexture(RGResource resource)
+{
+    AddAccess(resource, RGAccess::Sampled, VK_ATTACHMENT_LOAD_OP_LOAD, {});
+}
+
+void RenderGraph::PassBuilder::ReadStorage(RGResource resource)
+{
+    AddAccess(resource, RGAccess::StorageRead, VK_ATTACHMENT_LOAD_OP_LOAD, {});
+}
+
+void RenderGraph::PassBuilder::WriteStorage(RGResource resource)
+{
+    AddAccess(resource, RGAccess::StorageWrite, VK_ATTACHMENT_LOAD_OP_LOAD, {});
+}
+
+void RenderGraph::PassBuilder::ReadTransfer(RGResource resource)
+{
+    AddAccess(resource, RGAccess::TransferSrc, VK_ATTACHMENT_LOAD_OP_LOAD, {});
+}
+
+void RenderGraph::PassBuilder::WriteTransfer(RGResource resource)
+{
+    AddAccess(resource, RGAccess::TransferDst, VK_ATTACHMENT_LOAD_OP_LOAD, {});
+}
+
+void RenderGraph::PassBuilder::SetSideEffects()
+{
+    _graph._passes[_passIndex].sideEffects = true;
+}
+
+void RenderGraph::PassBuilder::SetSecondaryCommandBuffers()
+{
+    _graph._passes[_passIndex].secondaryContents = true;
+}
+
+void RenderGraph::PassBuilder::CollectStatistics()
+{
+    _graph._passes[_passIndex].collectStatistics = true;
+}
+
+void RenderGraph::PassBuilder::AddAccess(RGResource resource, RGAccess access, VkAttachmentLoadOp loadOp,
+                                         VkClearValue clear)
+{
+    Pass& pass = _graph._passes[_passIndex];
+    if (resource >= _graph._resources.size()) {
+        throw std::runtime_error("Error: Render pass '" + pass.name + "' uses an undeclared resource!");
+    }
+    // One access per image and pass keeps barrier derivation unambiguous
+    for (const Access& existing : pass.accesses) {
+        if (existing.resource == resource) {
+            throw std::runtime_error("Error: Render pass '" + pass.name + "' declares '" +
+                                     _graph._resources[resource].name + "' twice!");
+        }
+    }
+    if (IsAttachment(access) && pass.type != RGPassType::Graphics) {
+        throw std::runtime_error("Error: Render pass '" + pass.name + "' uses an attachment outside a graphics pass!");
+    }
+    if (pass.type == RGPassType::Transfer && !(access == RGAccess::TransferSrc || access == RGAccess::TransferDst)) {
+        throw std::runtime_error("Error: Transfer pass '" + pass.name + "' may only use transfer accesses!");
+    }
+    pass.accesses.push_back({resource, access, loadOp, clear});
+}
+
+// --- RenderGraph ---
+
+RenderGraph::RenderGraph(VulkanDevice& device, bool dynamicRendering)
+    : _device(device), _dynamicRendering(dynamicRendering)
+{
+    if (_dynamicRendering && !_device.supportsDynamicRendering()) {
+        throw std::runtime_error("Error: Dynamic rendering requested but not enabled on the device!");
+    }
+}
+
+RenderGraph::~RenderGraph()
+{
+    VkDevice device = _device.getDevice();
+    for (auto& [key, framebuffer] : _framebuffers) {
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
+    for (TransientImage& transient : _transients) {
+        vkDestroyImageView(device, transient.view, nullptr);
+        vkDestroyImage(device, transient.image, nullptr);
+    }
+    for (VulkanAllocation& memory : _transientMemory) {
+        _device.getAllocator().free(memory);
+    }
+    for (auto& [key, renderPass] : _renderPassCache) {
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    }
+}
+
+void RenderGraph::Reset()
+{
+    _passes.clear();
+    _resources.clear();
+}
+
+RGResource RenderGraph::ImportImage(const std::string& name, const RGImportDesc& desc)
+{
+    Resource resource;
+    resource.name = name;
+    resource.imported = true;
+    resource.import = desc;
+    resource.desc.format = desc.format;
+    resource.desc.extent = desc.extent;
+    _resources.push_back(std::move(resource));
+    return static_cast<RGResource>(_resources.size() - 1);
+}
+
+void RenderGraph::AddPass(const std::string& name, RGPassType type, const SetupFunction& setup, ExecuteFunction execute)
+{
+    for (const Pass& pass : _passes) {
+        if (pass.name == name) {
+            throw std::runtime_error("Error: Render pass '" + name + "' declared twice!");
+        }
+    }
+    Pass pass;
+    pass.name = name;
+    pass.type = type;
+    pass.execute = std::move(execute);
+    _passes.push_back(std::move(pass));
+
+    PassBuilder builder(*this, static_cast<uint32_t>(_passes.size() - 1));
+    setup(builder);
+}
+
+// Handles, clear values and recording flags change from frame to frame (e.g.
+// the acquired swap chain image) without changing what has to be compiled, so
+// they are left out and read from the current declaration at execute time
+uint64_t RenderGraph::HashTopology() const
+{
+    TopologyHasher hasher;
+    hasher.Add(_resources.size());
+    for (const Resource& resource : _resources) {
+        hasher.Add(resource.imported);
+        hasher.Add(resource.desc.format);
+        hasher.Add((uint64_t(resource.desc.extent.width) << 32) | resource.desc.extent.height);
+        if (resource.imported) {
+            hasher.Add(resource.import.initialLayout);
+            hasher.Add(resource.import.initialStages);
+            hasher.Add(resource.import.finalLayout);
+            hasher.Add(resource.import.output);
+        }
+    }
+    hasher.Add(_passes.size());
+    for (const Pass& pass : _passes) {
+        hasher.Add(pass.name);
+        hasher.Add(static_cast<uint64_t>(pass.type));
+        hasher.Add(pass.sideEffects);
+        hasher.Add(pass.accesses.size());
+        for (const Access& access : pass.accesses) {
+            hasher.Add((uint64_t(access.resource) << 32) | (uint64_t(access.access) << 8) | uint64_t(access.loadOp));
+        }
+    }
+    return hasher.Get();
+}
+
+void RenderGraph::Compile(DeletionQueue& deletionQueue, uint64_t frameNumber)
+{
+    uint64_t hash = HashTopology();
+    if (_compiled && hash == _compiledHash) {
+        return;
+    }
+    RetireCompiled(deletionQueue, frameNumber);
+
+    std::vector<bool> keep = CullPasses();
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < _passes.size(); i++) {
+        if (keep[i]) {
+            order.push_back(i);
+        }
+    }
+
+    // Attachments: colors in declaration order, then depth
+    for (uint32_t passIndex : order) {
+        CompiledPass compiled;
+        compiled.passIndex = passIndex;
+        const Pass& pass = _passes[passIndex];
+        if (pass.type == RGPassType::Graphics) {
+            const Access* depth = nullptr;
+            for (const Access& access : pass.accesses) {
+                if (access.access == RGAccess::ColorAttachment) {
+                    compiled.attachments.push_back(access.resource);
+                    compiled.clearValues.push_back(access.clear);
+                } else if (IsAttachment(access.access)) {
+                    depth = &access;
+                }
+            }
+            if (depth) {
+                compiled.attachments.push_back(depth->resource);
+                compiled.clearValues.push_back(depth->clear);
+            }
+            for (RGResource attachment : compiled.attachments) {
+                VkExtent2D extent = _resources[attachment].desc.extent;
+                VkExtent2D first = _resources[compiled.attachments[0]].desc.extent;
+                if (extent.width != first.width || extent.height != first.height) {
+                    throw std::runtime_error("Error: Render pass '" + pass.name + "' has attachments of different sizes!");
+                }
+            }
+        }
+        _compiledPasses.push_back(std::move(compiled));
+    }
+
+    CreateTransients(order);
+    DeriveBarriers(order);
+    CreateRenderPasses();
+
+    _compiledHash = hash;
+    _compiled = true;
+    _stats.declaredPasses = static_cast<uint32_t>(_passes.size());
+    _stats.culledPasses = static_cast<uint32_t>(_passes.size() - order.size());
+    _stats.barriers = static_cast<uint32_t>(_finalBarriers.barriers.size());
+    for (const CompiledPass& compiled : _compiledPasses) {
+        _stats.barriers += static_cast<uint32_t>(compiled.before.barriers.size());
+    }
+    _stats.compiles++;
+    std::cout << "Render graph compiled (" << order.size() << " passes, " << _stats.culledPasses << " culled, "
+              << _stats.barriers << " barriers, " << (_stats.transientBytes >> 10) << " KiB transient, "
+              << (_stats.aliasedBytes >> 10) << " KiB saved by aliasing)." << std::endl;
+}
+
+// Walks the passes backwards from the outputs: a pass survives if it has side
+// effects or writes something a later surviving pass (or an output) reads
+std::vector<bool> RenderGraph::CullPasses() const
+{
+    std::vector<bool> needed(_resources.size(), false);
+    for (uint32_t i = 0; i < _resources.size(); i++) {
+        needed[i] = _resources[i].imported && _resources[i].import.output;
+    }
+
+    std::vector<bool> keep(_passes.size(), false);
+    for (size_t p = _passes.size(); p-- > 0;) {
+        const Pass& pass = _passes[p];
+        bool kept = pass.sideEffects;
+        for (const Access& access : pass.accesses) {
+            kept = kept || (GetAccessInfo(access.access, pass.type, access.loadOp).write && needed[access.resource]);
+        }
+        if (!kept) {
+            continue;
+        }
+        keep[p] = true;
+        // Whatever this pass reads (or only partially overwrites) is needed from earlier passes
+        for (const Access& access : pass.accesses) {
+            needed[access.resource] = !OverwritesAll(access.access, access.loadOp);
+        }
+    }
+    return keep;
+}
+
+// Transient images whose lifetimes (first to last use among the surviving
+// passes) don't overlap share a memory slot. Slots are assigned greedily in
+// order of first use and grow to their largest occupant.
+void RenderGraph::CreateTransients(const std::vector<uint32_t>& order)
+{
+    struct Lifetime {
+        RGResource resource;
+        uint32_t first = UINT32_MAX;
+        uint32_t last = 0;
+        VkImageUsageFlags usage = 0;
+    };
+    std::vector<Lifetime> lifetimes(_resources.size());
+    for (uint32_t position = 0; position < order.size(); position++) {
+        for (const Access& access : _passes[order[position]].accesses) {
+            Lifetime& lifetime = lifetimes[access.resource];
+            lifetime.resource = access.resource;
+            lifetime.first = std::min(lifetime.first, position);
+            lifetime.last = std::max(lifetime.last, position);
+            lifetime.usage |= GetImageUsage(access.access);
+        }
+    }
+    std::vector<Lifetime> used;
+    for (const Lifetime& lifetime : lifetimes) {
+        if (lifetime.first != UINT32_MAX && !_resources[lifetime.resource].imported) {
+            used.push_back(lifetime);
+        }
+    }
+    std::sort(used.begin(), used.end(), [](const Lifetime& a, const Lifetime& b) { return a.first < b.first; });
+
+    struct Slot {
+        VkMemoryRequirements requirements;
+        uint32_t lastUse;
+    };
+    std::vector<Slot> slots;
+    VkDevice device = _device.getDevice();
+    _transients.assign(_resources.size(), TransientImage{});
+    VkDeviceSize imageBytes = 0;
+
+    for (const Lifetime& lifetime : used) {
+        const RGImageDesc& desc = _resources[lifetime.resource].desc;
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = desc.format;
+        imageInfo.extent = {desc.extent.width, desc.extent.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = lifetime.usage;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        TransientImage& transient = _transients[lifetime.resource];
+        VkResult result = vkCreateImage(device, &imageInfo, nullptr, &transient.image);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create render graph image '" + _resources[lifetime.resource].name +
+                                     "'! Error: " + std::to_string(result));
+        }
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device, transient.image, &requirements);
+        imageBytes += requirements.size;
+
+        // Best fit among the free, type-compatible slots; otherwise the largest free one grows
+        int32_t chosen = -1;
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            const Slot& slot = slots[i];
+            if (slot.lastUse >= lifetime.first || !(slot.requirements.memoryTypeBits & requirements.memoryTypeBits)) {
+                continue;
+            }
+            if (chosen < 0) {
+                chosen = static_cast<int32_t>(i);
+                continue;
+            }
+            VkDeviceSize chosenSize = slots[chosen].requirements.size;
+            bool fits = slot.requirements.size >= requirements.size;
+            bool chosenFits = chosenSize >= requirements.size;
+            if ((fits && (!chosenFits || slot.requirements.size < chosenSize)) ||
+                (!fits && !chosenFits && slot.requirements.size > chosenSize)) {
+                chosen = static_cast<int32_t>(i);
+            }
+        }
+        if (chosen < 0) {
+            slots.push_back({requirements, lifetime.last});
+            chosen = static_cast<int32_t>(slots.size() - 1);
+        } else {
+            Slot& slot = slots[chosen];
+            slot.requirements.size = std::max(slot.requirements.size, requirements.size);
+            slot.requirements.alignment = std::max(slot.requirements.alignment, requirements.alignment);
+            slot.requirements.memoryTypeBits &= requirements.memoryTypeBits;
+            slot.lastUse = lifetime.last;
+        }
+        transient.slot = static_cast<uint32_t>(chosen);
+    }
+
+    _transientMemory.resize(slots.size());
+    _stats.transientBytes = 0;
+    for (uint32_t i = 0; i < slots.size(); i++) {
+        _transientMemory[i] = _device.getAllocator().allocate(slots[i].requirements, MemoryUsage::GpuOnly,
+                                                              ResourceTiling::Optimal);
+        _stats.transientBytes += slots[i].requirements.size;
+    }
+    _stats.aliasedBytes = imageBytes - _stats.transientBytes;
+
+    for (const Lifetime& lifetime : used) {
+        TransientImage& transient = _transients[lifetime.resource];
+        const VulkanAllocation& memory = _transientMemory[transient.slot];
+        VkResult result = vkBindImageMemory(device, transient.image, memory.memory, memory.offset);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to bind render graph image memory! Error: " + std::to_string(result));
+        }
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = transient.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = _resources[lifetime.resource].desc.format;
+        viewInfo.subresourceRange = {GetAspect(viewInfo.format), 0, 1, 0, 1};
+        result = vkCreateImageView(device, &viewInfo, nullptr, &transient.view);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create render graph image view! Error: " + std::to_string(result));
+        }
+    }
+}
+
+// Replays the surviving passes in order, tracking each image's layout, its
+// last writer and the readers since, and emits the barriers each access needs:
+// writes wait for every earlier access, reads wait for the last write unless
+// their stages were already synchronized with it, and any layout change is a
+// barrier of its own. The first use of an aliased transient waits for the
+// previous occupant of its memory, and the first occupant of a slot waits for
+// the slot's last occupant: every frame in flight reuses the same transients,
+// so that is the previous frame's work on the same memory.
+void RenderGraph::DeriveBarriers(const std::vector<uint32_t>& order)
+{
+    struct State {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStages = 0;  // Last write (or layout transition)
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;   // Reads since then
+        VkPipelineStageFlags syncedStages = 0; // Stages that already waited for the last write
+        bool used = false;
+    };
+    struct SlotState {
+        VkPipelineStageFlags stages = 0;
+        VkAccessFlags writeAccess = 0;
+    };
+
+    std::vector<State> states(_resources.size());
+    for (uint32_t i = 0; i < _resources.size(); i++) {
+        if (_resources[i].imported) {
+            states[i].layout = _resources[i].import.initialLayout;
+            states[i].writeStages = _resources[i].import.initialStages & ~VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        }
+    }
+    std::vector<SlotState> slots(_transientMemory.size());
+    std::vector<bool> occupied(_resources.size(), false);
+    for (uint32_t passIndex : order) {
+        const Pass& pass = _passes[passIndex];
+        for (const Access& access : pass.accesses) {
+            if (_resources[access.resource].imported) {
+                continue;
+            }
+            SlotState& slot = slots[_transients[access.resource].slot];
+            if (!occupied[access.resource]) {
+                occupied[access.resource] = true;
+                slot = SlotState{};
+            }
+            AccessInfo info = GetAccessInfo(access.access, pass.type, access.loadOp);
+            slot.stages |= info.stages;
+            slot.writeAccess |= info.access & WRITE_ACCESS_MASK;
+        }
+    }
+
+    auto addBarrier = [this](BarrierBatch& batch, RGResource resource, VkPipelineStageFlags srcStages,
+                             VkAccessFlags srcAccess, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess,
+                             VkImageLayout oldLayout, VkImageLayout newLayout) {
+        // Legacy stage and access bits have the same values in the 2KHR flags
+        VkImageMemoryBarrier2KHR barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+        barrier.srcStageMask = srcStages;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstStageMask = dstStages;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange = {GetAspect(_resources[resource].desc.format), 0, VK_REMAINING_MIP_LEVELS, 0,
+                                    VK_REMAINING_ARRAY_LAYERS};
+        batch.srcStages |= srcStages;
+        batch.dstStages |= dstStages;
+        batch.barriers.push_back(barrier);
+        batch.resources.push_back(resource);
+    };
+
+    for (uint32_t position = 0; position < order.size(); position++) {
+        const Pass& pass = _passes[order[position]];
+        BarrierBatch& batch = _compiledPasses[position].before;
+        for (const Access& access : pass.accesses) {
+            State& state = states[access.resource];
+            AccessInfo info = GetAccessInfo(access.access, pass.type, access.loadOp);
+            bool transient = !_resources[access.resource].imported;
+            bool layoutChange = state.layout != info.layout;
+            // Contents about to be overwritten need no transition of their own
+            VkImageLayout oldLayout = OverwritesAll(access.access, access.loadOp) ? VK_IMAGE_LAYOUT_UNDEFINED
+                                                                                   : state.layout;
+
+            if (transient && !state.used) {
+                SlotState& slot = slots[_transients[access.resource].slot];
+                addBarrier(batch, access.resource, slot.stages, slot.writeAccess, info.stages, info.access,
+                           VK_IMAGE_LAYOUT_UNDEFINED, info.layout);
+                slot = SlotState{};
+            } else if (info.write) {
+                addBarrier(batch, access.resource, state.writeStages | state.readStages, state.writeAccess,
+                           info.stages, info.access, oldLayout, info.layout);
+            } else if (layoutChange || (state.writeStages != 0 && (info.stages & ~state.syncedStages) != 0)) {
+                addBarrier(batch, access.resource, state.writeStages | (layoutChange ? state.readStages : 0),
+                           state.writeAccess, info.stages, info.access, oldLayout, info.layout);
+                state.syncedStages |= info.stages;
+            }
+
+            if (info.write || layoutChange) {
+                // A layout transition acts like a write for whoever comes next
+                state.writeStages = info.stages;
+                state.writeAccess = info.write ? (info.access & WRITE_ACCESS_MASK) : 0;
+                state.readStages = info.write ? 0 : info.stages;
+                state.syncedStages = info.stages;
+            } else {
+                state.readStages |= info.stages;
+            }
+            state.layout = info.layout;
+            state.used = true;
+
+            if (transient) {
+                SlotState& slot = slots[_transients[access.resource].slot];
+                slot.stages |= info.stages;
+                slot.writeAccess |= info.access & WRITE_ACCESS_MASK;
+            }
+        }
+    }
+
+    // Hand imported images back in the layout their owner expects
+    for (uint32_t i = 0; i < _resources.size(); i++) {
+        const Resource& resource = _resources[i];
+        State& state = states[i];
+        if (!resource.imported || resource.import.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED ||
+            resource.import.finalLayout == state.layout) {
+            continue;
+        }
+        addBarrier(_finalBarriers, i, state.writeStages | state.readStages, state.writeAccess,
+                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, state.layout, resource.import.finalLayout);
+    }
+}
+
+// Attachments stay in their attachment layout for the whole render pass; the
+// graph's barriers do every transition, so no subpass dependencies are needed.
+// An attachment is stored only if a later pass (or the owner of an import) reads it.
+void RenderGraph::CreateRenderPasses()
+{
+    for (size_t position = 0; position < _compiledPasses.size(); position++) {
+        CompiledPass& compiled = _compiledPasses[position];
+        if (compiled.attachments.empty()) {
+            continue;
+        }
+        const Pass& owner = _passes[compiled.passIndex];
+        std::vector<bool> store;
+        for (RGResource attachment : compiled.attachments) {
+            bool keepContents = _resources[attachment].imported;
+            for (size_t later = position + 1; later < _compiledPasses.size() && !keepContents; later++) {
+                const Pass& pass = _passes[_compiledPasses[later].passIndex];
+                auto it = std::find_if(pass.accesses.begin(), pass.accesses.end(),
+                                       [attachment](const Access& access) { return access.resource == attachment; });
+                if (it != pass.accesses.end()) {
+                    keepContents = !OverwritesAll(it->access, it->loadOp);
+                    break;
+                }
+            }
+            store.push_back(keepContents);
+        }
+
+        for (size_t i = 0; i < compiled.attachments.size(); i++) {
+            RGResource resource = compiled.attachments[i];
+            const Access& access = *std::find_if(owner.accesses.begin(), owner.accesses.end(),
+                                                 [resource](const Access& a) { return a.resource == resource; });
+            VkFormat format = _resources[resource].desc.format;
+            if (access.access == RGAccess::ColorAttachment) {
+                compiled.formats.colorFormats.push_back(format);
+            } else {
+                compiled.formats.depthFormat = format;
+                compiled.formats.stencilFormat = HasStencil(format) ? format : VK_FORMAT_UNDEFINED;
+            }
+            if (_dynamicRendering) {
+                VkRenderingAttachmentInfoKHR attachmentInfo{};
+                attachmentInfo.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+                attachmentInfo.imageLayout = GetAccessInfo(access.access, owner.type, access.loadOp).layout;
+                attachmentInfo.resolveMode = VK_RESOLVE_MODE_NONE;
+                attachmentInfo.loadOp = access.loadOp;
+                attachmentInfo.storeOp = store[i] ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                compiled.renderingAttachments.push_back(attachmentInfo);
+            }
+        }
+
+        if (!_dynamicRendering) {
+            compiled.renderPass = GetOrCreateRenderPass(compiled, store);
+        }
+        _graphicsPasses[owner.name] = position;
+    }
+}
+
+VkRenderPass RenderGraph::GetOrCreateRenderPass(const CompiledPass& compiled, const std::vector<bool>& storeAttachments)
+{
+    const Pass& pass = _passes[compiled.passIndex];
+    std::vector<VkAttachmentDescription> attachments;
+    std::vector<VkAttachmentReference> colorReferences;
+    VkAttachmentReference depthReference{};
+    bool hasDepth = false;
+    std::vector<uint32_t> signature;
+
+    for (uint32_t i = 0; i < compiled.attachments.size(); i++) {
+        RGResource resource = compiled.attachments[i];
+        const Access& access = *std::find_if(pass.accesses.begin(), pass.accesses.end(),
+                                             [resource](const Access& a) { return a.resource == resource; });
+        AccessInfo info = GetAccessInfo(access.access, pass.type, access.loadOp);
+        VkFormat format = _resources[resource].desc.format;
+
+        VkAttachmentDescription attachment{};
+        attachment.format = format;
+        attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        attachment.loadOp = access.loadOp;
+        attachment.storeOp = storeAttachments[i] ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.stencilLoadOp = HasStencil(format) ? attachment.loadOp : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.stencilStoreOp = HasStencil(format) ? attachment.storeOp : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.initialLayout = info.layout;
+        attachment.finalLayout = info.layout;
+        attachments.push_back(attachment);
+
+        if (access.access == RGAccess::ColorAttachment) {
+            colorReferences.push_back({i, info.layout});
+        } else {
+            depthReference = {i, info.layout};
+            hasDepth = true;
+        }
+        signature.insert(signature.end(), {static_cast<uint32_t>(access.access), static_cast<uint32_t>(format),
+                                           static_cast<uint32_t>(attachment.loadOp),
+                                           static_cast<uint32_t>(attachment.storeOp)});
+    }
+
+    auto cached = _renderPassCache.find(signature);
+    if (cached != _renderPassCache.end()) {
+        return cached->second;
+    }
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = static_cast<uint32_t>(colorReferences.size());
+    subpass.pColorAttachments = colorReferences.data();
+    subpass.pDepthStencilAttachment = hasDepth ? &depthReference : nullptr;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments = attachments.data();
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkResult result = vkCreateRenderPass(_device.getDevice(), &renderPassInfo, nullptr, &renderPass);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create render pass for '" + pass.name + "'! Error: " + std::to_string(result));
+    }
+    _renderPassCache.emplace(std::move(signature), renderPass);
+    return renderPass;
+}
+
+VkFramebuffer RenderGraph::GetOrCreateFramebuffer(const CompiledPass& compiled)
+{
+    VkExtent2D extent = _resources[compiled.attachments[0]].desc.extent;
+    std::vector<VkImageView> views;
+    std::vector<uint64_t> key{HandleBits(compiled.renderPass), (uint64_t(extent.width) << 32) | extent.height};
+    for (RGResource attachment : compiled.attachments) {
+        views.push_back(GetImageView(attachment));
+        key.push_back(HandleBits(views.back()));
+    }
+
+    auto cached = _framebuffers.find(key);
+    if (cached != _framebuffers.end()) {
+        return cached->second;
+    }
+
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = compiled.renderPass;
+    framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+    framebufferInfo.pAttachments = views.data();
+    framebufferInfo.width = extent.width;
+    framebufferInfo.height = extent.height;
+    framebufferInfo.layers = 1;
+
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    VkResult result = vkCreateFramebuffer(_device.getDevice(), &framebufferInfo, nullptr, &framebuffer);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create framebuffer! Error: " + std::to_string(result));
+    }
+    _framebuffers.emplace(std::move(key), framebuffer);
+    return framebuffer;
+}
+
+void RenderGraph::RetireFramebuffers(DeletionQueue& deletionQueue, uint64_t frameNumber)
+{
+    VkDevice device = _device.getDevice();
+    std::vector<VkFramebuffer> framebuffers;
+    for (auto& [key, framebuffer] : _framebuffers) {
+        framebuffers.push_back(framebuffer);
+    }
+    _framebuffers.clear();
+    deletionQueue.push(frameNumber, [device, framebuffers]() {
+        for (VkFramebuffer framebuffer : framebuffers) {
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
+    });
+}
+
+// Transient images and their memory may still be in use by frames in flight
+void RenderGraph::RetireCompiled(DeletionQueue& deletionQueue, uint64_t frameNumber)
+{
+    RetireFramebuffers(deletionQueue, frameNumber);
+
+    VkDevice device = _device.getDevice();
+    VulkanMemoryAllocator* allocator = &_device.getAllocator();
+    std::vector<TransientImage> transients = std::move(_transients);
+    std::vector<VulkanAllocation> memory = std::move(_transientMemory);
+    deletionQueue.push(frameNumber, [device, allocator, transients, memory]() mutable {
+        for (TransientImage& transient : transients) {
+            vkDestroyImageView(device, transient.view, nullptr);
+            vkDestroyImage(device, transient.image, nullptr);
+        }
+        for (VulkanAllocation& allocation : memory) {
+            allocator->free(allocation);
+        }
+    });
+
+    _transients.clear();
+    _transientMemory.clear();
+    _compiledPasses.clear();
+    _finalBarriers = BarrierBatch{};
+    _graphicsPasses.clear();
+    _stats.transientBytes = 0;
+    _stats.aliasedBytes = 0;
+    _compiled = false;
+}
+
+void RenderGraph::RecordBarriers(VkCommandBuffer commandBuffer, BarrierBatch& batch) const
+{
+    if (batch.barriers.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < batch.barriers.size(); i++) {
+        batch.barriers[i].image = GetImage(batch.resources[i]);
+    }
+
+    if (_device.supportsSynchronization2()) {
+        VkDependencyInfoKHR dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(batch.barriers.size());
+        dependencyInfo.pImageMemoryBarriers = batch.barriers.data();
+        _device.cmdPipelineBarrier2(commandBuffer, dependencyInfo);
+        return;
+    }
+
+    // One legacy call with the union of the stage masks
+    std::vector<VkImageMemoryBarrier> barriers;
+    barriers.reserve(batch.barriers.size());
+    for (const VkImageMemoryBarrier2KHR& barrier2 : batch.barriers) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = static_cast<VkAccessFlags>(barrier2.srcAccessMask);
+        barrier.dstAccessMask = static_cast<VkAccessFlags>(barrier2.dstAccessMask);
+        barrier.oldLayout = barrier2.oldLayout;
+        barrier.newLayout = barrier2.newLayout;
+        barrier.srcQueueFamilyIndex = barrier2.srcQueueFamilyIndex;
+        barrier.dstQueueFamilyIndex = barrier2.dstQueueFamilyIndex;
+        barrier.image = barrier2.image;
+        barrier.subresourceRange = barrier2.subresourceRange;
+        barriers.push_back(barrier);
+    }
+    vkCmdPipelineBarrier(commandBuffer, batch.srcStages ? batch.srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         batch.dstStages, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()),
+                         barriers.data());
+}
+
+void RenderGraph::Execute(VkCommandBuffer commandBuffer, GpuProfiler* profiler)
+{
+    if (!_compiled) {
+        throw std::runtime_error("Error: Render graph executed before it was compiled!");
+    }
+    for (CompiledPass& compiled : _compiledPasses) {
+        Pass& pass = _passes[compiled.passIndex];
+        if (profiler) {
+            profiler->BeginScope(commandBuffer, pass.name.c_str(), pass.collectStatistics);
+        }
+        RecordBarriers(commandBuffer, compiled.before);
+
+        PassContext context;
+        context.commandBuffer = commandBuffer;
+        context.graph = this;
+        if (!compiled.attachments.empty()) {
+            context.attachmentFormats = &compiled.formats;
+            context.extent = _resources[compiled.attachments[0]].desc.extent;
+
+            // Clear values aren't part of the topology, so they come from this frame's declaration
+            for (size_t i = 0; i < compiled.attachments.size(); i++) {
+                for (const Access& access : pass.accesses) {
+                    if (access.resource == compiled.attachments[i]) {
+                        compiled.clearValues[i] = access.clear;
+                    }
+                }
+            }
+        }
+
+        if (!compiled.attachments.empty() && _dynamicRendering) {
+            BeginRendering(commandBuffer, compiled, pass);
+            pass.execute(context);
+            _device.cmdEndRendering(commandBuffer);
+        } else if (!compiled.attachments.empty()) {
+            context.renderPass = compiled.renderPass;
+            context.framebuffer = GetOrCreateFramebuffer(compiled);
+
+            VkRenderPassBeginInfo renderPassInfo{};
+            renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+            renderPassInfo.renderPass = context.renderPass;
+            renderPassInfo.framebuffer = context.framebuffer;
+            renderPassInfo.renderArea.offset = {0, 0};
+            renderPassInfo.renderArea.extent = context.extent;
+            renderPassInfo.clearValueCount = static_cast<uint32_t>(compiled.clearValues.size());
+            renderPassInfo.pClearValues = compiled.clearValues.data();
+            vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
+                                 pass.secondaryContents ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                                                        : VK_SUBPASS_CONTENTS_INLINE);
+            pass.execute(context);
+            vkCmdEndRenderPass(commandBuffer);
+        } else {
+            pass.execute(context);
+        }
+
+        if (profiler) {
+            profiler->EndScope(commandBuffer);
+        }
+    }
+    RecordBarriers(commandBuffer, _finalBarriers);
+}
+
+// No render pass or framebuffer: the views are attached directly, so nothing
+// has to be rebuilt when the imported images change
+void RenderGraph::BeginRendering(VkCommandBuffer commandBuffer, CompiledPass& compiled, const Pass& pass) const
+{
+    const VkRenderingAttachmentInfoKHR* depthAttachment = nullptr;
+    uint32_t colorCount = static_cast<uint32_t>(compiled.formats.colorFormats.size());
+    for (size_t i = 0; i < compiled.attachments.size(); i++) {
+        compiled.renderingAttachments[i].imageView = GetImageView(compiled.attachments[i]);
+        compiled.renderingAttachments[i].clearValue = compiled.clearValues[i];
+        if (i >= colorCount) {
+            depthAttachment = &compiled.renderingAttachments[i];
+        }
+    }
+
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.flags = pass.secondaryContents ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR : 0;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = _resources[compiled.attachments[0]].desc.extent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = colorCount;
+    renderingInfo.pColorAttachments = compiled.renderingAttachments.data();
+    renderingInfo.pDepthAttachment = depthAttachment;
+    renderingInfo.pStencilAttachment = compiled.formats.stencilFormat != VK_FORMAT_UNDEFINED ? depthAttachment : nullptr;
+    _device.cmdBeginRendering(commandBuffer, renderingInfo);
+}
+
+const RenderGraph::CompiledPass& RenderGraph::FindGraphicsPass(const std::string& passName) const
+{
+    auto it = _graphicsPasses.find(passName);
+    if (it == _graphicsPasses.end()) {
+        throw std::runtime_error("Error: Render pass '" + passName + "' is not part of the compiled graph!");
+    }
+    return _compiledPasses[it->second];
+}
+
+VkRenderPass RenderGraph::GetRenderPass(const std::string& passName) const
+{
+    return FindGraphicsPass(passName).renderPass;
+}
+
+const RGAttachmentFormats& RenderGraph::GetAttachmentFormats(const std::string& passName) const
+{
+    return FindGraphicsPass(passName).formats;
+}
+
+RenderGraph::BarrierScope RenderGraph::GetBarrierScope(const std::string& passName) const
+{
+    for (const CompiledPass& compiled : _compiledPasses) {
+        if (_passes[compiled.passIndex].name == passName) {
+            const BarrierBatch& batch = compiled.before;
+            return {batch.srcStages, batch.dstStages, static_cast<uint32_t>(batch.barriers.size())};
+        }
+    }
+    throw std::runtime_error("Error: Render graph has no compiled pass '" + passName + "'!");
+}
+
+VkImage RenderGraph::GetImage(RGResource resource) const
+{
+    if (resource >= _resources.size()) {
+        throw std::runtime_error("Error: Invalid render graph resource!");
+    }
+    return _resources[resource].imported ? _resources[resource].import.image : _transients[resource].image;
+}
+
+VkImageView RenderGraph::GetImageView(RGResource resource) const
+{
+    if (resource >= _resources.size()) {
+        throw std::runtime_error("Error: Invalid render graph resource!");
+    }
+    return _resources[resource].imported ? _resources[resource].import.view : _transients[resource].view;
+}
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "../vulkan/DeletionQueue.h"
+#include "../vulkan/VulkanMemoryAllocator.h"
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+
+namespace VulkanApp::Rendering {
+
+class GpuProfiler;
+
+// Index of an image declared in the current RenderGraph
+using RGResource = uint32_t;
+constexpr RGResource RG_INVALID_RESOURCE = UINT32_MAX;
+
+enum class RGPassType {
+    Graphics, // Gets a render pass over its attachments
+    Compute,
+    Transfer
+};
+
+// How a pass uses an image; each maps to a layout, stages and access mask
+enum class RGAccess {
+    ColorAttachment,
+    DepthAttachment,
+    DepthRead,   // Read-only depth attachment
+    Sampled,
+    StorageRead,
+    StorageWrite,
+    TransferSrc,
+    TransferDst
+};
+
+// An image owned outside the graph (swap chain image, persistent texture)
+struct RGImportDesc {
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent{};
+    VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // Stages that must finish with the image first, e.g. the stage the acquire
+    // semaphore is waited on for a swap chain image
+    VkPipelineStageFlags initialStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED; // UNDEFINED = leave as the last pass left it
+    bool output = false; // Passes producing it are never culled
+};
+
+// A graph-owned image whose memory may alias other transients
+struct RGImageDesc {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent{};
+};
+
+// Attachment formats of a graphics pass, colors in declaration order. What a
+// pipeline or secondary command buffer needs to match a pass without a render pass.
+struct RGAttachmentFormats {
+    std::vector<VkFormat> colorFormats;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    VkFormat stencilFormat = VK_FORMAT_UNDEFINED; // depthFormat if it has a stencil aspect
+};
+
+// Frame graph: passes declare the images they read and write, and Compile
+// derives the order-preserving pipeline barriers and layout transitions
+// between them, culls passes whose results nobody consumes, and places
+// transient images with disjoint lifetimes in the same memory. Declare the
+// graph every frame (Reset, Import/AddPass, Compile, Execute); the compiled
+// result is kept until the declared topology changes, so a steady frame only
+// pays for hashing the declaration. With dynamic rendering, graphics passes
+// begin rendering directly on the attachments' views and no render pass or
+// framebuffer objects exist; otherwise both are created and cached.
+class RenderGraph {
+public:
+    class PassBuilder;
+
+    // Handed to a pass's execute callback. For graphics passes the render
+    // pass (or dynamic rendering) has been begun; record inline or into
+    // secondaries, as declared with SetSecondaryCommandBuffers. Secondaries
+    // inherit renderPass/framebuffer, or with dynamic rendering (both
+    // VK_NULL_HANDLE) the attachmentFormats.
+    struct PassContext {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;
+        const RGAttachmentFormats* attachmentFormats = nullptr; // Graphics passes only
+        VkExtent2D extent{};
+        const RenderGraph* graph = nullptr;
+
+        VkImage GetImage(RGResource resource) const { return graph->GetImage(resource); }
+        VkImageView GetImageView(RGResource resource) const { return graph->GetImageView(resource); }
+    };
+
+    using SetupFunction = std::function<void(PassBuilder&)>;
+    using ExecuteFunction = std::function<void(PassContext&)>;
+
+    class PassBuilder {
+    public:
+        RGResource CreateImage(const std::string& name, const RGImageDesc& desc);
+
+        // loadOp LOAD keeps the previous contents (and so the passes writing them)
+        void WriteColor(RGResource resource, VkAttachmentLoadOp loadOp, VkClearColorValue clear = {});
+        void WriteDepth(RGResource resource, VkAttachmentLoadOp loadOp, VkClearDepthStencilValue clear = {1.0f, 0});
+        void ReadDepth(RGResource resource);
+        void ReadTexture(RGResource resource);
+        void ReadStorage(RGResource resource);
+        void WriteStorage(RGResource resource);
+        void ReadTransfer(RGResource resource);
+        void WriteTransfer(RGResource resource);
+
+        void SetSideEffects();             // Never culled (e.g. writes a buffer read back by the CPU)
+        void SetSecondaryCommandBuffers(); // The render pass contents are recorded into secondaries
+        void CollectStatistics();          // The pass's profiler scope gathers pipeline statistics
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, uint32_t passIndex) : _graph(graph), _passIndex(passIndex) {}
+
+        void AddAccess(RGResource resource, RGAccess access, VkAttachmentLoadOp loadOp, VkClearValue clear);
+
+        RenderGraph& _graph;
+        uint32_t _passIndex;
+    };
+
+    // The barriers recorded before a compiled pass, merged into one stage scope
+    struct BarrierScope {
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        uint32_t barriers = 0;
+    };
+
+    struct Stats {
+        uint32_t declaredPasses = 0;
+        uint32_t culledPasses = 0;
+        uint32_t barriers = 0;           // Image barriers recorded per frame
+        VkDeviceSize transientBytes = 0; // Memory backing the transient images
+        VkDeviceSize aliasedBytes = 0;   // Saved by aliasing (sum of image sizes minus transientBytes)
+        uint32_t compiles = 0;           // Times the topology changed
+    };
+
+    // dynamicRendering requires VulkanDevice::supportsDynamicRendering()
+    explicit RenderGraph(VulkanDevice& device, bool dynamicRendering = false);
+    ~RenderGraph(); // Device must be idle
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // Starts a new declaration; compiled state survives until Compile sees a different topology
+    void Reset();
+
+    RGResource ImportImage(const std::string& name, const RGImportDesc& desc);
+    void AddPass(const std::string& name, RGPassType type, const SetupFunction& setup, ExecuteFunction execute);
+
+    // Recompiles if the declaration's topology (passes, accesses, formats,
+    // extents) differs from the compiled one. Replaced transient images and
+    // framebuffers are retired to deletionQueue under frameNumber.
+    void Compile(DeletionQueue& deletionQueue, uint64_t frameNumber);
+
+    // Records every surviving pass with its barriers, each in a profiler scope named after the pass
+    void Execute(VkCommandBuffer commandBuffer, GpuProfiler* profiler = nullptr);
+
+    // Render pass of a compiled graphics pass, for building pipelines against
+    // (VK_NULL_HANDLE with dynamic rendering: build against the formats).
+    // Render passes live as long as the graph, so the handle stays valid
+    // across recompiles (e.g. a resize).
+    VkRenderPass GetRenderPass(const std::string& passName) const;
+    const RGAttachmentFormats& GetAttachmentFormats(const std::string& passName) const;
+    bool UsesDynamicRendering() const { return _dynamicRendering; }
+
+    // Synchronization derived for a surviving pass, for checking the compiled graph
+    BarrierScope GetBarrierScope(const std::string& passName) const;
+
+    // Imported views are about to be destroyed (swap chain recreation)
+    void RetireFramebuffers(DeletionQueue& deletionQueue, uint64_t frameNumber);
+
+    VkImage GetImage(RGResource resource) const;
+    VkImageView GetImageView(RGResource resource) const;
+
+    const Stats& GetStats() const { return _stats; }
+
+private:
+    struct Access {
+        RGResource resource;
+        RGAccess access;
+        VkAttachmentLoadOp loadOp;
+        VkClearValue clear;
+    };
+
+    struct Pass {
+        std::string name;
+        RGPassType type;
+        std::vector<Access> accesses;
+        ExecuteFunction execute;
+        bool sideEffects = false;
+        bool secondaryContents = false;
+        bool collectStatistics = false;
+    };
+
+    struct Resource {
+        std::string name;
+        bool imported = false;
+        RGImportDesc import; // Imported images only
+        RGImageDesc desc;
+    };
+
+    // Barriers recorded before a pass (or after the last one)
+    // Recorded with one vkCmdPipelineBarrier2KHR when synchronization2 is
+    // enabled, else one legacy call with the union of the stages
+    struct BarrierBatch {
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        std::vector<VkImageMemoryBarrier2KHR> barriers; // Own stages; image filled in at execute time
+        std::vector<RGResource> resources;              // Parallel to barriers
+    };
+
+    struct CompiledPass {
+        uint32_t passIndex;
+        BarrierBatch before;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        std::vector<RGResource> attachments;
+        std::vector<VkClearValue> clearValues;
+        RGAttachmentFormats formats;
+        // Dynamic rendering only, parallel to attachments; view and clear value filled in at execute time
+        std::vector<VkRenderingAttachmentInfoKHR> renderingAttachments;
+    };
+
+    struct TransientImage {
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t slot = 0;
+    };
+
+    uint64_t HashTopology() const;
+    std::vector<bool> CullPasses() const;
+    void CreateTransients(const std::vector<uint32_t>& order);
+    void DeriveBarriers(const std::vector<uint32_t>& order);
+    void CreateRenderPasses(); // Or the dynamic rendering attachment infos
+    void BeginRendering(VkCommandBuffer commandBuffer, CompiledPass& compiled, const Pass& pass) const;
+    const CompiledPass& FindGraphicsPass(const std::string& passName) const;
+    VkRenderPass GetOrCreateRenderPass(const CompiledPass& compiled, const std::vector<bool>& storeAttachments);
+    VkFramebuffer GetOrCreateFramebuffer(const CompiledPass& compiled);
+    void RetireCompiled(DeletionQueue& deletionQueue, uint64_t frameNumber);
+    void RecordBarriers(VkCommandBuffer commandBuffer, BarrierBatch& batch) const;
+
+    VulkanDevice& _device;
+    const bool _dynamicRendering;
+
+    // Current declaration
+    std::vector<Pass> _passes;
+    std::vector<Resource> _resources;
+
+    // Compiled state, valid while the declaration hashes to _compiledHash
+    uint64_t _compiledHash = 0;
+    bool _compiled = false;
+    std::vector<CompiledPass> _compiledPasses;
+    BarrierBatch _finalBarriers;
+    std::vector<TransientImage> _transients; // Indexed by resource, empty entries for imports
+    std::vector<VulkanAllocation> _transientMemory; // One per aliasing slot
+    std::map<std::string, size_t> _graphicsPasses; // Pass name -> index into _compiledPasses
+
+    // Render passes are cached by attachment signature for the graph's lifetime
+    std::map<std::vector<uint32_t>, VkRenderPass> _renderPassCache;
+    // Framebuffers keyed by render pass and views; retired when any view may die
+    std::map<std::vector<uint64_t>, VkFramebuffer> _framebuffers;
+
+    Stats _stats;
+};
+
+} // namespace VulkanApp::Rendering
@@ -1,50 +1,64 @@
 // Include dependent class definitions *before* the namespace
 #include "../vulkan/VulkanDevice.h" 
-#include "../vulkan/VulkanSwapChain.h"
+#include "../vulkan/PresentTarget.h"
+#include "../vulkan/VulkanPipelineCache.h"
+#include "../vulkan/VulkanTimeline.h"
+#include "../core/JobSystem.h"
 
 #include "Renderer.h" // Include own header after dependencies
 
 #include <stdexcept> 
 #include <iostream>
-#include <fstream> 
+#include <algorithm>
 #include <array> // For clear values
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <utility>
 
 namespace VulkanApp::Rendering {
 
-// Helper: Implementation of readFile (static)
-std::vector<char> Renderer::ReadFile(const std::string& filename)
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Below this many draws per slice, a secondary command buffer costs more than it saves
+constexpr uint32_t MIN_DRAWS_PER_SLICE = 256;
+
+// Matches the DrawData uniform block in shader.vert (std140)
+struct DrawConstants {
+    float offsetScale[4]; // xy: NDC offset, z: scale
+    float color[4];
+};
+
+// Draw index of drawCount copies of the triangle: its cell of a square grid
+// covering the target, and a color graded across the grid
+DrawConstants GridCell(uint32_t index, uint32_t drawCount)
 {
-    std::ifstream file(filename, std::ios::ate | std::ios::binary);
-    if (!file.is_open()) {
-        throw std::runtime_error("Failed to open file: " + filename);
-    }
-    size_t fileSize = (size_t)file.tellg();
-    std::vector<char> buffer(fileSize);
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
-    file.close();
-    return buffer;
+    uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(drawCount))));
+    float cell = 2.0f / static_cast<float>(columns);
+    DrawConstants constants{};
+    constants.offsetScale[0] = -1.0f + cell * (static_cast<float>(index % columns) + 0.5f);
+    constants.offsetScale[1] = -1.0f + cell * (static_cast<float>(index / columns) + 0.5f);
+    constants.offsetScale[2] = 1.0f / static_cast<float>(columns);
+    float t = static_cast<float>(index) / static_cast<float>(drawCount);
+    constants.color[0] = 1.0f;
+    constants.color[1] = 0.5f * (1.0f - t) + 0.2f * t;
+    constants.color[2] = 0.6f * t;
+    constants.color[3] = 1.0f;
+    return constants;
 }
 
-// Helper: Implementation of CreateShaderModule
-VkShaderModule Renderer::CreateShaderModule(const std::vector<char>& code)
+double MillisecondsSince(Clock::time_point start)
 {
-    VkShaderModuleCreateInfo createInfo{};
-    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = code.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
-
-    VkShaderModule shaderModule;
-    VkResult result = vkCreateShaderModule(_device.getDevice(), &createInfo, nullptr, &shaderModule);
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error("Renderer::CreateShaderModule failed! Error: " + std::to_string(result));
-    }
-    return shaderModule;
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
 }
+} // namespace
 
 // Constructor: Use types directly
-Renderer::Renderer(VulkanDevice& device, VulkanSwapChain& swapChain)
-    : _device(device), _swapChain(swapChain)
+Renderer::Renderer(VulkanDevice& device, PresentTarget& presentTarget, VulkanPipelineCache& pipelineCache,
+                   JobSystem& jobSystem, const RendererSettings& settings)
+    : _device(device), _presentTarget(presentTarget), _pipelineCache(pipelineCache), _jobSystem(jobSystem),
+      _settings(settings), _maxFramesInFlight(settings.maxFramesInFlight)
 {
     std::cout << "Renderer created." << std::endl;
 }
@@ -59,269 +73,322 @@ Renderer::~Renderer()
 // Init: Call all creation helpers in order
 void Renderer::Init()
 {
-    CreateRenderPass();
+    CreateShaderLibrary();
+    CreateRenderGraph();
+    CreateUploadManager();
+    CreateAssetStreamer();
+    CreateBindlessTable();
+    CreateStressScene();
+    CreateGpuCuller();
+    CreateUniformRing();
+    CreatePipelineLayout();
+    CreatePipelineCompiler();
     CreateGraphicsPipeline();
-    CreateFramebuffers();
-    CreateCommandPool();
+    CreateRecordWorkers();
+    CreateCommandPools();
     CreateCommandBuffers();
     CreateSyncObjects();
+    CreateProfiler();
     std::cout << "Renderer initialized successfully." << std::endl;
 }
 
 // --- Vulkan Object Creation Methods ---
 
-void Renderer::CreateRenderPass()
-{
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = _swapChain.getImageFormat();
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT; 
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; // Ready for presentation
-
-    VkAttachmentReference colorAttachmentRef{};
-    colorAttachmentRef.attachment = 0; // Index into the pAttachments array
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-
-    // Subpass dependency to handle layout transitions
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL; // Implicit subpass before render pass
-    dependency.dstSubpass = 0; // Our first (and only) subpass
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.srcAccessMask = 0;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-    VkRenderPassCreateInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
-
-    VkResult result = vkCreateRenderPass(_device.getDevice(), &renderPassInfo, nullptr, &_renderPass);
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create render pass! Error: " + std::to_string(result));
-    }
-    std::cout << "Vulkan render pass created successfully." << std::endl;
+// The shaders are linked into the executable, so startup reads no shader files
+void Renderer::CreateShaderLibrary()
+{
+    _shaderLibrary = std::make_unique<ShaderLibrary>(
+        _device, Assets::ShaderArchive(GetEmbeddedShaderArchive(), "embedded shader archive"));
 }
 
-void Renderer::CreateGraphicsPipeline()
+// Compiled once up front so the pipeline can be built against the main pass
+void Renderer::CreateRenderGraph()
 {
-    auto vertShaderCode = ReadFile("shaders/vert.spv");
-    auto fragShaderCode = ReadFile("shaders/frag.spv");
-
-    VkShaderModule vertShaderModule = CreateShaderModule(vertShaderCode);
-    VkShaderModule fragShaderModule = CreateShaderModule(fragShaderCode);
-    std::cout << "Shader modules created successfully." << std::endl;
+    const bool dynamicRendering = _settings.dynamicRendering && _device.supportsDynamicRendering();
+    _renderGraph = std::make_unique<RenderGraph>(_device, dynamicRendering);
+    std::cout << "Render graph using " << (dynamicRendering ? "dynamic rendering." : "render pass objects.") << std::endl;
+    DeclareRenderGraph(0, VK_NULL_HANDLE, 1);
+    _renderGraph->Compile(_deletionQueue, _frameNumber);
+}
 
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
+void Renderer::CreateUploadManager()
+{
+    _uploadManager = std::make_unique<UploadManager>(_device);
+}
 
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
+// Assets cancelled mid-upload may still have copies queued in the
+// UploadManager (a deferred Flush holds them past this frame) or running on
+// the transfer queue, so they wait for the last upload accepted so far
+void Renderer::CreateAssetStreamer()
+{
+    _assetStreamer = std::make_unique<Assets::AssetStreamer>();
+    _assetStreamer->SetRetireFunction([this](std::unique_ptr<Assets::StreamedAsset> asset) {
+        _cancelledAssets.push_back({_uploadManager->GetLastTicket(), std::move(asset)});
+    });
+}
 
-    VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
+// Once its copies have finished, a cancelled asset is only referenced by
+// acquire barriers in frames already submitted, so it goes when this one retires
+void Renderer::RetireStreamedAssets()
+{
+    auto done = std::partition(_cancelledAssets.begin(), _cancelledAssets.end(),
+                               [this](const CancelledAsset& cancelled) {
+                                   return cancelled.lastTicket != 0 && !_uploadManager->IsComplete(cancelled.lastTicket);
+                               });
+    for (auto it = done; it != _cancelledAssets.end(); ++it) {
+        std::shared_ptr<Assets::StreamedAsset> retired(std::move(it->asset));
+        _deletionQueue.push(_frameNumber, [retired]() {});
+    }
+    _cancelledAssets.erase(done, _cancelledAssets.end());
+}
 
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 0;
-    vertexInputInfo.vertexAttributeDescriptionCount = 0;
+void Renderer::CreateBindlessTable()
+{
+    if (!_settings.bindless) {
+        return;
+    }
+    if (!BindlessTable::IsSupported(_device)) {
+        std::cout << "Bindless descriptor table unavailable (needs descriptor indexing); "
+                  << "using per-pipeline descriptor sets." << std::endl;
+        return;
+    }
+    _bindlessTable = std::make_unique<BindlessTable>(_device);
+}
 
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
+// Its motion and colors stream to the GPU over the first frames
+void Renderer::CreateStressScene()
+{
+    if (_settings.stressInstances == 0) {
+        return;
+    }
+    _stressScene = std::make_unique<StressScene>(_device, _pipelineCache, *_shaderLibrary, *_uploadManager,
+                                                 _jobSystem, _maxFramesInFlight, _settings.stressInstances,
+                                                 _settings.stressGpuAnimation);
+}
 
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)_swapChain.getExtent().width;
-    viewport.height = (float)_swapChain.getExtent().height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
+// The grid as scene objects; they stream to the GPU over the first frames
+void Renderer::CreateGpuCuller()
+{
+    if (!_settings.gpuCulling || _stressScene) {
+        return;
+    }
+    if (!GpuCuller::IsSupported(_device)) {
+        std::cout << "GPU culling unavailable (needs multiDrawIndirect and drawIndirectFirstInstance); "
+                  << "recording draws on the CPU." << std::endl;
+        return;
+    }
 
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = _swapChain.getExtent();
-
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 0;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-
-    VkResult layoutResult = vkCreatePipelineLayout(_device.getDevice(), &pipelineLayoutInfo, nullptr, &_pipelineLayout);
-    if (layoutResult != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create pipeline layout! Error: " + std::to_string(layoutResult));
+    std::vector<GpuObject> objects(_settings.drawCount);
+    const float boundingRadius = std::sqrt(0.5f); // Farthest triangle vertex, (0.5, 0.5), at scale 1
+    for (uint32_t i = 0; i < _settings.drawCount; i++) {
+        DrawConstants cell = GridCell(i, _settings.drawCount);
+        GpuObject& object = objects[i];
+        object.boundingSphere[0] = cell.offsetScale[0];
+        object.boundingSphere[1] = cell.offsetScale[1];
+        object.boundingSphere[2] = 0.0f;
+        object.boundingSphere[3] = boundingRadius * cell.offsetScale[2];
+        std::copy(std::begin(cell.offsetScale), std::end(cell.offsetScale), object.offsetScale);
+        std::copy(std::begin(cell.color), std::end(cell.color), object.color);
     }
+    _gpuCuller = std::make_unique<GpuCuller>(_device, _pipelineCache, *_shaderLibrary, *_uploadManager,
+                                             _bindlessTable.get(), _maxFramesInFlight, std::move(objects));
+}
+
+// Sized so every draw of a frame gets its own constants without overflowing a
+// partition; indirect and instanced draws read storage buffers instead
+void Renderer::CreateUniformRing()
+{
+    VkDeviceSize perDraw = UniformRing::MAX_UNIFORM_RANGE; // Upper bound on the aligned size of DrawConstants
+    VkDeviceSize drawsPerFrame = _gpuCuller || _stressScene ? 0 : static_cast<VkDeviceSize>(_settings.drawCount) + 1;
+    VkDeviceSize bytesPerFrame = std::max(UniformRing::DEFAULT_BYTES_PER_FRAME, drawsPerFrame * perDraw);
+    _uniformRing = std::make_unique<UniformRing>(_device, _maxFramesInFlight, bytesPerFrame);
+}
+
+// Set 0 is the uniform ring's: its buffers are bound with dynamic offsets,
+// which reflection cannot tell from plain uniform buffers
+void Renderer::CreatePipelineLayout()
+{
+    _pipelineLayout = _shaderLibrary
+                          ->CreatePipelineLayout({"shader.vert", "shader.frag"}, 0,
+                                                 {_uniformRing->GetDescriptorSetLayout()})
+                          .layout;
     std::cout << "Vulkan pipeline layout created successfully." << std::endl;
+}
 
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = nullptr;
-    pipelineInfo.layout = _pipelineLayout;
-    pipelineInfo.renderPass = _renderPass;
-    pipelineInfo.subpass = 0;
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    pipelineInfo.basePipelineIndex = -1;
-
-    VkResult pipelineResult = vkCreateGraphicsPipelines(_device.getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &_graphicsPipeline);
-    if (pipelineResult != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create graphics pipeline! Error: " + std::to_string(pipelineResult));
-    }
-    std::cout << "Vulkan graphics pipeline created successfully." << std::endl;
-
-    vkDestroyShaderModule(_device.getDevice(), fragShaderModule, nullptr);
-    vkDestroyShaderModule(_device.getDevice(), vertShaderModule, nullptr);
-    std::cout << "Shader modules destroyed." << std::endl;
-}
-
-void Renderer::CreateFramebuffers()
-{
-    _swapChainFramebuffers.resize(_swapChain.getImageViews().size());
-
-    for (size_t i = 0; i < _swapChain.getImageViews().size(); i++) {
-        VkImageView attachments[] = {
-            _swapChain.getImageViews()[i]
-        };
-
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = _renderPass;
-        framebufferInfo.attachmentCount = 1;
-        framebufferInfo.pAttachments = attachments;
-        framebufferInfo.width = _swapChain.getExtent().width;
-        framebufferInfo.height = _swapChain.getExtent().height;
-        framebufferInfo.layers = 1;
-
-        VkResult result = vkCreateFramebuffer(_device.getDevice(), &framebufferInfo, nullptr, &_swapChainFramebuffers[i]);
-        if (result != VK_SUCCESS) {
-             throw std::runtime_error("Failed to create framebuffer! Error: " + std::to_string(result));
-        }
+void Renderer::CreatePipelineCompiler()
+{
+    _pipelineCompiler = std::make_unique<PipelineCompiler>(_device, _pipelineCache, *_shaderLibrary,
+                                                           _settings.pipelineCompileThreads);
+}
+
+// Queues the pipeline on the compiler's workers; draws are skipped until it is ready
+void Renderer::CreateGraphicsPipeline()
+{
+    _graphicsPipelineDesc = GraphicsPipelineDesc{};
+    _graphicsPipelineDesc.fragmentShader = "shader.frag";
+    if (_stressScene) {
+        _graphicsPipelineDesc.vertexShader = "stress.vert";
+        _graphicsPipelineDesc.layout = _stressScene->GetDrawPipelineLayout();
+    } else if (_gpuCuller) {
+        _graphicsPipelineDesc.vertexShader = _gpuCuller->UsesBindless() ? "indirect_bindless.vert" : "indirect.vert";
+        _graphicsPipelineDesc.layout = _gpuCuller->GetDrawPipelineLayout();
+    } else {
+        _graphicsPipelineDesc.vertexShader = "shader.vert";
+        _graphicsPipelineDesc.layout = _pipelineLayout;
     }
-     std::cout << "Vulkan swap chain framebuffers created successfully (" << _swapChainFramebuffers.size() << ")." << std::endl;
+    // Null with dynamic rendering, in which case the formats define compatibility
+    _graphicsPipelineDesc.renderPass = _renderGraph->GetRenderPass("MainPass");
+    _graphicsPipelineDesc.subpass = 0;
+    _graphicsPipelineDesc.colorFormats = _renderGraph->GetAttachmentFormats("MainPass").colorFormats;
+    _graphicsPipelineDesc.depthFormat = _renderGraph->GetAttachmentFormats("MainPass").depthFormat;
+
+    _graphicsPipeline = _pipelineCompiler->Request(_graphicsPipelineDesc);
+    std::cout << "Vulkan graphics pipeline queued for compilation." << std::endl;
+}
+
+void Renderer::CreateRecordWorkers()
+{
+    _maxRecordSlices = _jobSystem.GetWorkerCount() + 1;
+    _sliceErrors.resize(_maxRecordSlices);
 }
 
-void Renderer::CreateCommandPool()
+// One pool per frame in flight for the primary buffer, plus one per frame and
+// slice for the secondaries, so each recording thread owns its pool outright
+void Renderer::CreateCommandPools()
 {
-    // Use the type defined in VulkanDevice.h (now included above)
     QueueFamilyIndices queueFamilyIndices = _device.getQueueFamilyIndices();
 
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT; 
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // Reset as a whole every frame
     poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
 
-    VkResult result = vkCreateCommandPool(_device.getDevice(), &poolInfo, nullptr, &_commandPool);
-     if (result != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create command pool! Error: " + std::to_string(result));
+    _commandPools.resize(_maxFramesInFlight);
+    _slicePools.resize(_maxFramesInFlight * _maxRecordSlices);
+    for (auto* pools : {&_commandPools, &_slicePools}) {
+        for (VkCommandPool& pool : *pools) {
+            VkResult result = vkCreateCommandPool(_device.getDevice(), &poolInfo, nullptr, &pool);
+            if (result != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create command pool! Error: " + std::to_string(result));
+            }
+        }
     }
-    std::cout << "Vulkan command pool created successfully." << std::endl;
+    std::cout << "Vulkan command pools created successfully (" << _maxFramesInFlight << " frames x "
+              << _maxRecordSlices << " recording threads)." << std::endl;
 }
 
 void Renderer::CreateCommandBuffers()
 {
-    _commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    _commandBuffers.resize(_maxFramesInFlight);
+    _sliceCommandBuffers.resize(_slicePools.size());
 
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = _commandPool;
+    allocInfo.commandBufferCount = 1;
+
     // Primary buffers can be submitted to a queue, secondary called from primary
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = (uint32_t)_commandBuffers.size();
-
-    VkResult result = vkAllocateCommandBuffers(_device.getDevice(), &allocInfo, _commandBuffers.data());
-    if (result != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate command buffers! Error: " + std::to_string(result));
+    for (size_t i = 0; i < _commandBuffers.size(); i++) {
+        allocInfo.commandPool = _commandPools[i];
+        VkResult result = vkAllocateCommandBuffers(_device.getDevice(), &allocInfo, &_commandBuffers[i]);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate command buffers! Error: " + std::to_string(result));
+        }
+    }
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    for (size_t i = 0; i < _sliceCommandBuffers.size(); i++) {
+        allocInfo.commandPool = _slicePools[i];
+        VkResult result = vkAllocateCommandBuffers(_device.getDevice(), &allocInfo, &_sliceCommandBuffers[i]);
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate secondary command buffers! Error: " + std::to_string(result));
+        }
     }
-    std::cout << "Vulkan command buffers allocated successfully (" << _commandBuffers.size() << ")." << std::endl;
+    std::cout << "Vulkan command buffers allocated successfully (" << _commandBuffers.size() << " primary, "
+              << _sliceCommandBuffers.size() << " secondary)." << std::endl;
 }
 
 void Renderer::CreateSyncObjects()
 {
-    _imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    _imageAvailableSemaphores.resize(_maxFramesInFlight);
+    _renderFinishedSemaphores.resize(_maxFramesInFlight);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // Start signaled so first frame doesn't wait
+    // Starts at 0: no frame has completed, and none needs to have before the first
+    _frameTimeline = std::make_unique<VulkanTimeline>(_device.getDevice());
+    _framePacer = std::make_unique<FramePacer>(_presentTarget, *_frameTimeline, _settings.lowLatency);
 
     VkResult result;
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < _maxFramesInFlight; i++) {
         result = vkCreateSemaphore(_device.getDevice(), &semaphoreInfo, nullptr, &_imageAvailableSemaphores[i]);
         if (result != VK_SUCCESS) throw std::runtime_error("Failed to create imageAvailable semaphore!" + std::to_string(result));
 
         result = vkCreateSemaphore(_device.getDevice(), &semaphoreInfo, nullptr, &_renderFinishedSemaphores[i]);
         if (result != VK_SUCCESS) throw std::runtime_error("Failed to create renderFinished semaphore!" + std::to_string(result));
-
-        result = vkCreateFence(_device.getDevice(), &fenceInfo, nullptr, &_inFlightFences[i]);
-        if (result != VK_SUCCESS) throw std::runtime_error("Failed to create inFlight fence!" + std::to_string(result));
     }
     std::cout << "Vulkan synchronization objects created successfully." << std::endl;
 }
 
+void Renderer::CreateProfiler()
+{
+    _gpuProfiler = std::make_unique<GpuProfiler>(_device, _maxFramesInFlight);
+}
+
 // --- Drawing ---
 
+// The frame is a single pass clearing and drawing into the acquired image,
+// preceded by the culling dispatch on the GPU path, or by the stress scene's
+// animation dispatch when it is animated on the GPU. The image arrives through
+// the acquire semaphore, waited on at color attachment output, and leaves in
+// the layout the present target expects.
+void Renderer::DeclareRenderGraph(uint32_t imageIndex, VkPipeline pipeline, uint32_t slices)
+{
+    RGImportDesc backbuffer{};
+    backbuffer.image = _presentTarget.getImages()[imageIndex];
+    backbuffer.view = _presentTarget.getImageViews()[imageIndex];
+    backbuffer.format = _presentTarget.getImageFormat();
+    backbuffer.extent = _presentTarget.getExtent();
+    backbuffer.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    backbuffer.initialStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    backbuffer.finalLayout = _presentTarget.getFinalLayout(); // PRESENT_SRC, or TRANSFER_SRC when headless
+    backbuffer.output = true;
+
+    _renderGraph->Reset();
+    RGResource target = _renderGraph->ImportImage("Backbuffer", backbuffer);
+
+    // A statistics query may only stay active across vkCmdExecuteCommands with inheritedQueries
+    const bool parallel = slices > 1;
+    const bool inheritQueries = _device.getEnabledFeatures().inheritedQueries;
+    if (_stressScene && _stressScene->GetStats().gpuAnimation) {
+        // Writes buffers the graph doesn't track; the scene records its own barriers
+        _renderGraph->AddPass("Animate", RGPassType::Compute,
+            [](RenderGraph::PassBuilder& pass) { pass.SetSideEffects(); },
+            [this](RenderGraph::PassContext& context) {
+                _stressScene->RecordAnimate(context.commandBuffer, _currentFrame);
+            });
+    }
+    if (_gpuCuller) {
+        // Writes buffers the graph doesn't track; the culler records its own barriers
+        _renderGraph->AddPass("Cull", RGPassType::Compute,
+            [](RenderGraph::PassBuilder& pass) { pass.SetSideEffects(); },
+            [this](RenderGraph::PassContext& context) {
+                _gpuCuller->RecordCull(context.commandBuffer, _currentFrame, _viewProjection);
+            });
+    }
+    _renderGraph->AddPass("MainPass", RGPassType::Graphics,
+        [&](RenderGraph::PassBuilder& pass) {
+            pass.WriteColor(target, VK_ATTACHMENT_LOAD_OP_CLEAR, {{0.1f, 0.1f, 0.1f, 1.0f}}); // Dark grey
+            if (parallel) {
+                pass.SetSecondaryCommandBuffers();
+            }
+            if (!parallel || inheritQueries) {
+                pass.CollectStatistics();
+            }
+        },
+        [this, pipeline, slices](RenderGraph::PassContext& context) { RecordMainPass(context, pipeline, slices); });
+}
+
 void Renderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
 {
     VkCommandBufferBeginInfo beginInfo{};
@@ -334,29 +401,30 @@ void Renderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t image
         throw std::runtime_error("Failed to begin recording command buffer! Error: " + std::to_string(beginResult));
     }
 
-    // --- Start Render Pass ---
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = _renderPass;
-    renderPassInfo.framebuffer = _swapChainFramebuffers[imageIndex]; // Use framebuffer for the acquired image
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = _swapChain.getExtent();
+    // Take ownership of this frame's uploads before anything reads them
+    _uploadManager->RecordAcquireBarriers(commandBuffer);
 
-    // Clear color (set to dark grey)
-    VkClearValue clearColor = {{{0.1f, 0.1f, 0.1f, 1.0f}}};
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
-
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-    // --- Bind Pipeline & Draw ---
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _graphicsPipeline);
-    
-    // Draw the hardcoded triangle (3 vertices, 1 instance, starting at vertex 0, instance 0)
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    // The slot has retired, so last round's queries can be read without stalling
+    if (_gpuProfiler->BeginFrame(commandBuffer, _currentFrame, _frameNumber)) {
+        _lastFrameTimings.gpuMs = _gpuProfiler->GetLatestFrame()->totalMs;
+        _lastFrameTimings.gpuValid = true;
+    }
 
-    // --- End Render Pass ---
-    vkCmdEndRenderPass(commandBuffer);
+    // Split the draws into slices recorded in parallel once there are enough of
+    // them; indirect and instanced draws are a handful of commands whatever the object count
+    VkPipeline pipeline = PipelineCompiler::TryGet(_graphicsPipeline);
+    const bool fewCommands = _gpuCuller || _stressScene;
+    const uint32_t slices = pipeline != VK_NULL_HANDLE && !fewCommands ? GetRecordSliceCount() : 1;
+    _lastFrameTimings.drawsSkipped = (pipeline == VK_NULL_HANDLE);
+    _lastFrameTimings.recordSlices = slices;
+
+    // Barriers, the render pass and its framebuffer come from the graph
+    _gpuProfiler->BeginScope(commandBuffer, "Frame");
+    DeclareRenderGraph(imageIndex, pipeline, slices);
+    _renderGraph->Compile(_deletionQueue, _frameNumber);
+    _renderGraph->Execute(commandBuffer, _gpuProfiler.get());
+    _uniformRing->EndFrame();
+    _gpuProfiler->EndScope(commandBuffer); // Frame
 
     // --- End Recording ---
     VkResult endResult = vkEndCommandBuffer(commandBuffer);
@@ -365,121 +433,389 @@ void Renderer::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t image
     }
 }
 
+// Runs inside the graph's MainPass render pass. While the pipeline is still
+// compiling the frame is only cleared.
+void Renderer::RecordMainPass(RenderGraph::PassContext& context, VkPipeline pipeline, uint32_t slices)
+{
+    VkCommandBuffer commandBuffer = context.commandBuffer;
+    if (slices > 1) {
+        // Timestamps can't be written between secondaries, so "Draws" is covered by MainPass here
+        const bool inheritQueries = _device.getEnabledFeatures().inheritedQueries;
+        VkQueryPipelineStatisticFlags inheritedStatistics = inheritQueries ? _gpuProfiler->GetStatisticsFlags() : 0;
+        auto sliceBegin = [&](uint32_t slice) { return static_cast<uint32_t>(uint64_t(_settings.drawCount) * slice / slices); };
+        JobCounter slicesRecorded;
+        for (uint32_t slice = 1; slice < slices; slice++) {
+            uint32_t first = sliceBegin(slice);
+            uint32_t count = sliceBegin(slice + 1) - first;
+            _jobSystem.Run([=, this]() {
+                try {
+                    RecordDrawSlice(slice, context, pipeline, first, count, inheritedStatistics);
+                } catch (...) {
+                    _sliceErrors[slice] = std::current_exception();
+                }
+            }, &slicesRecorded);
+        }
+
+        // Slice 0 is recorded here, then this thread helps with the others.
+        // Every job must be done with the frame's buffers before anything is rethrown.
+        try {
+            RecordDrawSlice(0, context, pipeline, 0, sliceBegin(1), inheritedStatistics);
+        } catch (...) {
+            _sliceErrors[0] = std::current_exception();
+        }
+        _jobSystem.Wait(slicesRecorded);
+        for (std::exception_ptr& error : _sliceErrors) {
+            if (error) {
+                std::exception_ptr first = std::exchange(error, nullptr);
+                std::fill(_sliceErrors.begin(), _sliceErrors.end(), nullptr);
+                std::rethrow_exception(first);
+            }
+        }
+
+        vkCmdExecuteCommands(commandBuffer, slices, &_sliceCommandBuffers[_currentFrame * _maxRecordSlices]);
+    } else if (pipeline != VK_NULL_HANDLE) {
+        GpuProfiler::Scope drawScope(*_gpuProfiler, commandBuffer, "Draws");
+        if (_stressScene) {
+            BindPipelineState(commandBuffer, pipeline);
+            _stressScene->RecordDraw(commandBuffer, _currentFrame);
+        } else if (_gpuCuller) {
+            BindPipelineState(commandBuffer, pipeline);
+            if (_gpuCuller->UsesBindless()) {
+                _bindlessTable->Bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
+            }
+            _gpuCuller->RecordDraws(commandBuffer, _currentFrame, _viewProjection);
+        } else {
+            RecordDraws(commandBuffer, pipeline, 0, _settings.drawCount);
+        }
+    }
+}
+
+// Binds the pipeline and its dynamic state
+void Renderer::BindPipelineState(VkCommandBuffer commandBuffer, VkPipeline pipeline)
+{
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+    // Dynamic state: always the current target extent
+    VkExtent2D extent = _presentTarget.getExtent();
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float)extent.width;
+    viewport.height = (float)extent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = extent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
+// Binds the pipeline and dynamic state, then draws [firstDraw, firstDraw + drawCount)
+// of the triangle grid. Thread-safe for distinct command buffers.
+void Renderer::RecordDraws(VkCommandBuffer commandBuffer, VkPipeline pipeline, uint32_t firstDraw, uint32_t drawCount)
+{
+    BindPipelineState(commandBuffer, pipeline);
+
+    // Draw the hardcoded triangle (3 vertices, 1 instance, starting at vertex 0, instance 0),
+    // repeated to scale the scene for benchmarking. Each copy gets a cell of a grid
+    // through its own constants; only the dynamic offset changes between binds.
+    VkDescriptorSet descriptorSet = _uniformRing->GetDescriptorSet();
+    for (uint32_t i = firstDraw; i < firstDraw + drawCount; i++) {
+        DrawConstants constants = GridCell(i, _settings.drawCount);
+        uint32_t dynamicOffsets[] = {_uniformRing->Push(constants), _uniformRing->GetFrameBaseOffset()};
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipelineLayout, 0, 1,
+                                &descriptorSet, 2, dynamicOffsets);
+        vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    }
+}
+
+// Runs on a recording thread: resets the slice's pool and records its draws
+// into a secondary command buffer that continues the frame's render pass
+void Renderer::RecordDrawSlice(uint32_t slice, const RenderGraph::PassContext& pass, VkPipeline pipeline,
+                               uint32_t firstDraw, uint32_t drawCount, VkQueryPipelineStatisticFlags inheritedStatistics)
+{
+    uint32_t index = _currentFrame * _maxRecordSlices + slice;
+    vkResetCommandPool(_device.getDevice(), _slicePools[index], 0);
+    VkCommandBuffer commandBuffer = _sliceCommandBuffers[index];
+
+    // With dynamic rendering there is no render pass to inherit, only the attachment formats
+    const RGAttachmentFormats& formats = *pass.attachmentFormats;
+    VkCommandBufferInheritanceRenderingInfoKHR renderingInheritance{};
+    renderingInheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+    renderingInheritance.colorAttachmentCount = static_cast<uint32_t>(formats.colorFormats.size());
+    renderingInheritance.pColorAttachmentFormats = formats.colorFormats.data();
+    renderingInheritance.depthAttachmentFormat = formats.depthFormat;
+    renderingInheritance.stencilAttachmentFormat = formats.stencilFormat;
+    renderingInheritance.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.pNext = pass.renderPass == VK_NULL_HANDLE ? &renderingInheritance : nullptr;
+    inheritanceInfo.renderPass = pass.renderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = pass.framebuffer;
+    inheritanceInfo.pipelineStatistics = inheritedStatistics;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    VkResult result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording secondary command buffer! Error: " + std::to_string(result));
+    }
+    RecordDraws(commandBuffer, pipeline, firstDraw, drawCount);
+    result = vkEndCommandBuffer(commandBuffer);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record secondary command buffer! Error: " + std::to_string(result));
+    }
+}
+
+uint32_t Renderer::GetRecordSliceCount() const
+{
+    return std::clamp(_settings.drawCount / MIN_DRAWS_PER_SLICE, 1u, _maxRecordSlices);
+}
+
 void Renderer::DrawFrame()
 {
-    // --- Wait for the previous frame to finish ---
-    vkWaitForFences(_device.getDevice(), 1, &_inFlightFences[_currentFrame], VK_TRUE, UINT64_MAX);
-    vkResetFences(_device.getDevice(), 1, &_inFlightFences[_currentFrame]); // Reset fence for the current frame
+    FrameTimings& timings = _lastFrameTimings;
+
+    // --- Wait for the frame that last used this slot to finish ---
+    auto stepStart = Clock::now();
+    if (_frameNumber >= _maxFramesInFlight) {
+        _frameTimeline->wait(_frameNumber - _maxFramesInFlight + 1);
+    }
+    timings.fenceWaitMs = MillisecondsSince(stepStart);
+    timings.gpuValid = false; // Set during recording if the profiler reads back a frame
+
+    // Releases whatever every completed frame was the last to use, which may
+    // be more than the slot's frame if the GPU is ahead
+    uint64_t completedFrames = _frameTimeline->getCompletedValue();
+    if (completedFrames > 0) {
+        _deletionQueue.flush(completedFrames - 1);
+    }
+    _uniformRing->BeginFrame(_currentFrame); // The slot's constants are no longer read
 
-    // --- Acquire an image from the swap chain ---
+    // Folds freshly compiled pipelines into the persistent cache once workers are idle
+    _pipelineCompiler->Update();
+
+    if (_resizeRequested) {
+        RecreateSwapChain();
+    }
+
+    // --- Acquire an image from the present target ---
+    // Headless targets have no presentation engine, so no semaphores are involved
+    const bool headless = _presentTarget.isHeadless();
     uint32_t imageIndex;
-    VkResult acquireResult = vkAcquireNextImageKHR(_device.getDevice(), _swapChain.getSwapChain(), UINT64_MAX, 
-                                                 _imageAvailableSemaphores[_currentFrame], VK_NULL_HANDLE, &imageIndex);
+    stepStart = Clock::now();
+    VkResult acquireResult = _presentTarget.acquireNextImage(
+        headless ? VK_NULL_HANDLE : _imageAvailableSemaphores[_currentFrame], imageIndex);
+    timings.acquireMs = MillisecondsSince(stepStart);
 
     if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
-        // Swap chain is incompatible (e.g., window resized). Need to recreate.
-        // TODO: Implement swap chain recreation
-        std::cerr << "Swap chain out of date. Recreation needed." << std::endl;
+        // Swap chain is incompatible (e.g., window resized). Nothing was acquired or
+        // submitted, so rebuild and try again next frame.
+        RecreateSwapChain();
         return;
     } else if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR) {
         throw std::runtime_error("Failed to acquire swap chain image! Error: " + std::to_string(acquireResult));
     }
 
+    // --- Submit pending uploads on the transfer queue ---
+    if (_gpuCuller) {
+        _gpuCuller->StreamObjects();
+    }
+    if (_stressScene) {
+        _stressScene->StreamData();
+    }
+    stepStart = Clock::now();
+    _assetStreamer->Update(_settings.streamBudget);
+    RetireStreamedAssets();
+    timings.streamUpdateMs = MillisecondsSince(stepStart);
+    UploadManager::FrameSync uploadSync = _uploadManager->Flush();
+
+    // --- Animate the stress scene into the retired slot's instance buffer ---
+    if (_stressScene) {
+        stepStart = Clock::now();
+        _stressScene->Update(_currentFrame, _frameNumber);
+        timings.sceneUpdateMs = MillisecondsSince(stepStart);
+    }
+
     // --- Record command buffer ---
-    vkResetCommandBuffer(_commandBuffers[_currentFrame], 0); // Reset buffer before recording
+    stepStart = Clock::now();
+    vkResetCommandPool(_device.getDevice(), _commandPools[_currentFrame], 0); // Slice pools are reset by their recorders
     RecordCommandBuffer(_commandBuffers[_currentFrame], imageIndex);
+    timings.recordMs = MillisecondsSince(stepStart);
 
     // --- Submit the command buffer ---
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    // The upload timeline is waited on only by the stages that consume the
+    // uploads. Values for the binary swap chain semaphores are ignored.
+    std::array<VkSemaphore, 2> waitSemaphores{};
+    std::array<VkPipelineStageFlags, 2> waitStages{};
+    std::array<uint64_t, 2> waitValues{};
+    uint32_t waitCount = 0;
+    if (!headless) {
+        waitSemaphores[waitCount] = _imageAvailableSemaphores[_currentFrame];
+        waitStages[waitCount++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    }
+    if (uploadSync.waitSemaphore != VK_NULL_HANDLE) {
+        waitSemaphores[waitCount] = uploadSync.waitSemaphore;
+        waitValues[waitCount] = uploadSync.waitValue;
+        waitStages[waitCount++] = uploadSync.waitStages;
+    }
 
-    VkSemaphore waitSemaphores[] = {_imageAvailableSemaphores[_currentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    // Frame N signals N + 1 on the frame timeline, plus the binary semaphore present waits on
+    std::array<VkSemaphore, 2> signalSemaphores = {_frameTimeline->getSemaphore(), _renderFinishedSemaphores[_currentFrame]};
+    std::array<uint64_t, 2> signalValues = {_frameNumber + 1, 0};
 
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = waitCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = headless ? 1 : 2;
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &_commandBuffers[_currentFrame];
+    submitInfo.signalSemaphoreCount = headless ? 1 : 2;
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
 
-    VkSemaphore signalSemaphores[] = {_renderFinishedSemaphores[_currentFrame]};
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
-
-    VkResult submitResult = vkQueueSubmit(_device.getGraphicsQueue(), 1, &submitInfo, _inFlightFences[_currentFrame]);
+    stepStart = Clock::now();
+    VkResult submitResult = vkQueueSubmit(_device.getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+    Clock::time_point submitted = Clock::now();
+    timings.submitMs = MillisecondsSince(stepStart);
     if (submitResult != VK_SUCCESS) {
         throw std::runtime_error("Failed to submit draw command buffer! Error: " + std::to_string(submitResult));
     }
 
-    // --- Present the swap chain image ---
-    VkPresentInfoKHR presentInfo{};
-    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-    presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores; // Wait on render finished
-
-    VkSwapchainKHR swapChains[] = {_swapChain.getSwapChain()};
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = swapChains;
-    presentInfo.pImageIndices = &imageIndex;
-    // presentInfo.pResults = nullptr; // Optional: check results for multiple swapchains
-
-    VkResult presentResult = vkQueuePresentKHR(_device.getPresentQueue(), &presentInfo);
+    // --- Present the image ---
+    stepStart = Clock::now();
+    VkResult presentResult = _presentTarget.present(_device.getPresentQueue(), signalSemaphores[1], imageIndex);
+    timings.presentMs = MillisecondsSince(stepStart);
 
     if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
-        // Swap chain incompatible again (e.g., resize between acquire and present)
-        // TODO: Implement swap chain recreation
-        std::cerr << "Swap chain out of date or suboptimal during present. Recreation needed." << std::endl;
+        // Swap chain incompatible again (e.g., resize between acquire and present).
+        // Rebuild at the start of the next frame, after its slot has been waited on.
+        _resizeRequested = true;
     } else if (presentResult != VK_SUCCESS) {
         throw std::runtime_error("Failed to present swap chain image! Error: " + std::to_string(presentResult));
     }
+    _framePacer->FramePresented(_frameNumber, submitted, timings.fenceWaitMs + timings.acquireMs,
+                                timings.gpuValid ? timings.gpuMs : -1.0);
 
     // Advance to the next frame index
-    _currentFrame = (_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    _currentFrame = (_currentFrame + 1) % _maxFramesInFlight;
+    _frameNumber++;
 }
 
-// --- Cleanup ---
+bool Renderer::IsFrameComplete(uint64_t frameNumber) const
+{
+    return _frameTimeline->isComplete(frameNumber + 1);
+}
+
+// --- Frame Pacing ---
 
-// Cleanup resources that depend on the swap chain (for recreation)
-void Renderer::CleanupSwapChainResources()
+void Renderer::PaceFrameStart()
 {
-    for (auto framebuffer : _swapChainFramebuffers) {
-        vkDestroyFramebuffer(_device.getDevice(), framebuffer, nullptr);
+    _lastFrameTimings.pacingWaitMs = _framePacer->WaitForFrameStart();
+    _lastFrameTimings.latencyValid = _framePacer->TakeLatency(_lastFrameTimings.inputLatencyMs);
+}
+
+void Renderer::MarkInputSampled()
+{
+    _framePacer->MarkInputSampled();
+}
+
+// --- Swap Chain Recreation ---
+
+void Renderer::NotifyResized()
+{
+    _resizeRequested = true;
+}
+
+// Rebuilds the swap chain and everything sized to it without draining the GPU:
+// retired objects go to the deletion queue tagged with the current frame number
+// and are destroyed once that frame's slot has been waited on.
+void Renderer::RecreateSwapChain()
+{
+    VkFormat oldFormat = _presentTarget.getImageFormat();
+    if (!_presentTarget.recreate(_deletionQueue, _frameNumber)) {
+        return; // Minimized or fixed-size target; keep the request pending
     }
-    _swapChainFramebuffers.clear();
+    _resizeRequested = false;
+
+    RetireSwapChainResources();
+
+    // Viewport and scissor are dynamic, so the pipeline and render pass are
+    // independent of the extent; the graph recompiles for the new extent on
+    // the next frame and keeps its render passes. Only a format change needs
+    // a different render pass (and every pipeline built against it).
+    if (_presentTarget.getImageFormat() != oldFormat) {
+        _pipelineCompiler->Retire(_graphicsPipelineDesc, _deletionQueue, _frameNumber);
+        DeclareRenderGraph(0, VK_NULL_HANDLE, 1);
+        _renderGraph->Compile(_deletionQueue, _frameNumber);
+        CreateGraphicsPipeline();
+    }
+}
 
-    vkDestroyPipeline(_device.getDevice(), _graphicsPipeline, nullptr);
-    _graphicsPipeline = VK_NULL_HANDLE;
-    vkDestroyPipelineLayout(_device.getDevice(), _pipelineLayout, nullptr);
-    _pipelineLayout = VK_NULL_HANDLE;
-    vkDestroyRenderPass(_device.getDevice(), _renderPass, nullptr);
-    _renderPass = VK_NULL_HANDLE;
-    
-    // Command buffers don't need explicit swapchain cleanup if pool is reused
-    // Sync objects also don't usually depend directly on swapchain details
-    std::cout << "Renderer swap chain resources cleaned up." << std::endl;
+// Framebuffers reference the old image views; the graph rebuilds them on demand
+void Renderer::RetireSwapChainResources()
+{
+    _renderGraph->RetireFramebuffers(_deletionQueue, _frameNumber);
 }
 
+// --- Cleanup ---
+
 // Full cleanup in reverse order of creation
 void Renderer::Cleanup()
 {
     // Wait for device to be idle before destroying anything
     vkDeviceWaitIdle(_device.getDevice());
 
-    CleanupSwapChainResources(); // Clean swap chain dependent resources first
+    _assetStreamer.reset(); // Joins the I/O and decode threads; drops assets still streaming
+    _cancelledAssets.clear();
+    _deletionQueue.flushAll(); // Everything retired during recreation
+
+    _pipelineCompiler.reset(); // Joins the workers and destroys every pipeline
+    _graphicsPipeline = PipelineFuture{};
+    _uniformRing.reset();
+    _gpuCuller.reset(); // Object, draw and count buffers
+    _stressScene.reset(); // Instance, motion and color buffers
+    _bindlessTable.reset(); // After everything registered in it
+    _shaderLibrary.reset(); // Modules and reflected layouts, after every pipeline built from them
+    _pipelineLayout = VK_NULL_HANDLE;
+    _renderGraph.reset(); // Render passes, framebuffers and transient images
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < _maxFramesInFlight; i++) {
         vkDestroySemaphore(_device.getDevice(), _renderFinishedSemaphores[i], nullptr);
         vkDestroySemaphore(_device.getDevice(), _imageAvailableSemaphores[i], nullptr);
-        vkDestroyFence(_device.getDevice(), _inFlightFences[i], nullptr);
     }
     _renderFinishedSemaphores.clear();
     _imageAvailableSemaphores.clear();
-    _inFlightFences.clear();
+    _framePacer.reset();
+    _frameTimeline.reset();
+
+    _gpuProfiler.reset();
+    _uploadManager.reset(); // Staging ring goes back to the device allocator
 
-    vkDestroyCommandPool(_device.getDevice(), _commandPool, nullptr);
-    _commandPool = VK_NULL_HANDLE;
-    // Command buffers are implicitly destroyed with the pool
+    for (auto* pools : {&_commandPools, &_slicePools}) {
+        for (VkCommandPool pool : *pools) {
+            vkDestroyCommandPool(_device.getDevice(), pool, nullptr);
+        }
+        pools->clear();
+    }
+    // Command buffers are implicitly destroyed with their pools
     _commandBuffers.clear();
+    _sliceCommandBuffers.clear();
 
      std::cout << "Renderer resources fully cleaned up." << std::endl;
 }
@@ -2,22 +2,78 @@
 
 #include <vector>
 #include <string>
+#include <exception>
 #include <memory> // For unique_ptr forward declaration if needed
 
 #include <vulkan/vulkan.h>
 
-// Forward declarations are not needed here if full headers are included in Renderer.cpp
+#include "BindlessTable.h"
+#include "FramePacer.h"
+#include "GpuCuller.h"
+#include "GpuProfiler.h"
+#include "PipelineCompiler.h"
+#include "RenderGraph.h"
+#include "ShaderLibrary.h"
+#include "StressScene.h"
+#include "UploadManager.h"
+#include "UniformRing.h"
+#include "../assets/AssetStreamer.h"
+#include "../vulkan/DeletionQueue.h"
+
+// Forward declarations (global namespace); full headers are included in Renderer.cpp
+class VulkanDevice;
+class PresentTarget;
+class VulkanPipelineCache;
+class JobSystem;
+class VulkanTimeline;
 
 namespace VulkanApp::Rendering {
 
-// Forward declare dependent types used as references/pointers if needed
-// class VulkanDevice; // Prefer including full header in .cpp
-// class VulkanSwapChain;
+// Frame loop tuning knobs, fixed for the lifetime of a Renderer
+struct RendererSettings {
+    uint32_t maxFramesInFlight = 2;
+    uint32_t drawCount = 1; // Triangle draws recorded per frame (scene size)
+    uint32_t pipelineCompileThreads = 0; // 0 = hardware threads minus one
+    bool lowLatency = false; // FramePacer delays frame starts to cut input-to-present latency
+    bool dynamicRendering = true; // Use VK_KHR_dynamic_rendering when the device enabled it
+    bool gpuCulling = true; // Cull on the GPU and draw indirectly when the device supports it
+    bool bindless = true; // Global descriptor table (descriptor indexing) when the device supports it
+    uint32_t stressInstances = 0; // > 0 replaces the triangle grid with the instanced stress scene
+    bool stressGpuAnimation = false; // Animate the stress scene in a compute pass instead of on the CPU
+    uint64_t streamBudget = 16ull * 1024 * 1024; // Bytes per frame the AssetStreamer hands to the UploadManager
+};
+
+// Where the time of the last DrawFrame call went, in milliseconds
+struct FrameTimings {
+    double fenceWaitMs = 0.0; // Waiting on the frame timeline for the frame slot to retire
+    double acquireMs = 0.0;   // vkAcquireNextImageKHR (or offscreen ring advance)
+    double sceneUpdateMs = 0.0; // CPU animation of the stress scene
+    double streamUpdateMs = 0.0; // AssetStreamer::Update: streamed assets handed to the UploadManager
+    double recordMs = 0.0;
+    double submitMs = 0.0;
+    double presentMs = 0.0;
+    // GPU duration of the most recently *completed* frame (GpuProfiler root
+    // scopes); arrives maxFramesInFlight frames late so reading it never stalls.
+    // gpuValid is set only on frames where a new result was read back.
+    double gpuMs = 0.0;
+    bool gpuValid = false;
+    bool drawsSkipped = false; // The pipeline was still compiling; the frame was only cleared
+    uint32_t recordSlices = 1; // Secondary command buffers the draws were split into (1 = recorded inline)
+    // Set by PaceFrameStart: time held back before this frame (low-latency
+    // mode), and the input-to-present latency of the most recently finished
+    // frame, valid only when a new frame finished since the previous call
+    double pacingWaitMs = 0.0;
+    double inputLatencyMs = 0.0;
+    bool latencyValid = false;
+};
 
 class Renderer {
 public:
     // Use types directly without global scope resolution
-    Renderer(VulkanDevice& device, VulkanSwapChain& swapChain);
+    // The present target is either a window swap chain or a headless offscreen ring.
+    // Draw recording fans out to the job system's workers.
+    Renderer(VulkanDevice& device, PresentTarget& presentTarget, VulkanPipelineCache& pipelineCache,
+             JobSystem& jobSystem, const RendererSettings& settings = {});
     ~Renderer();
 
     // Prevent copying and moving for simplicity for now
@@ -27,48 +83,149 @@ public:
     Renderer& operator=(Renderer&&) = delete;
 
     void Init(); // Further initialization requiring more setup
+
+    // Frame loop: PaceFrameStart, sample input, MarkInputSampled, DrawFrame.
+    // The pacing calls are optional; without them no latency is measured.
+    void PaceFrameStart();
+    void MarkInputSampled();
     void DrawFrame();
 
+    // The window's framebuffer changed size; the swap chain is rebuilt on the next frame
+    void NotifyResized();
+
+    const FrameTimings& GetLastFrameTimings() const { return _lastFrameTimings; }
+    const RendererSettings& GetSettings() const { return _settings; }
+    const GpuProfiler& GetGpuProfiler() const { return *_gpuProfiler; }
+    const FramePacer& GetFramePacer() const { return *_framePacer; }
+
+    // Frame N (0-based, counted by submits) has finished on the GPU once the
+    // frame timeline reaches N + 1; anything it used may then be reused or
+    // destroyed. Thread-safe.
+    uint64_t GetSubmittedFrameCount() const { return _frameNumber; }
+    bool IsFrameComplete(uint64_t frameNumber) const;
+    const VulkanTimeline& GetFrameTimeline() const { return *_frameTimeline; }
+    // Render thread: destroys what a frame <= lastUsingFrame used once it retires
+    // (GpuTexture::UpdateResidency's old views); push with GetSubmittedFrameCount()
+    DeletionQueue& GetDeletionQueue() { return _deletionQueue; }
+
+    // Worker time spent compiling pipelines so far (startup plus any rebuilds)
+    double GetPipelineCreationMs() const { return _pipelineCompiler->GetTotalCompileMs(); }
+    const PipelineCompiler& GetPipelineCompiler() const { return *_pipelineCompiler; }
+    // Threads that record draw slices, including the calling (main) thread
+    uint32_t GetRecordThreadCount() const { return _maxRecordSlices; }
+
+    // Streams buffer/image data on the transfer queue; uploads queued before a
+    // DrawFrame are visible to that frame's graphics work
+    UploadManager& GetUploadManager() { return *_uploadManager; }
+
+    const RenderGraph& GetRenderGraph() const { return *_renderGraph; }
+    // Null when the draws are recorded one by one on the CPU
+    const GpuCuller* GetGpuCuller() const { return _gpuCuller.get(); }
+    // Null without descriptor indexing or with RendererSettings::bindless off
+    BindlessTable* GetBindlessTable() { return _bindlessTable.get(); }
+    const BindlessTable* GetBindlessTable() const { return _bindlessTable.get(); }
+    // Null unless RendererSettings::stressInstances is set
+    const StressScene* GetStressScene() const { return _stressScene.get(); }
+    // Loads assets on background threads; DrawFrame hands up to
+    // RendererSettings::streamBudget bytes of them to the UploadManager.
+    // Request meshes with StreamedMesh::MakeDecoder and textures with
+    // StreamedTexture::MakeDecoder.
+    Assets::AssetStreamer& GetAssetStreamer() { return *_assetStreamer; }
+    const Assets::AssetStreamer& GetAssetStreamer() const { return *_assetStreamer; }
+
 private:
     // Initialization steps (called by Init or constructor)
-    void CreateRenderPass();
+    void CreateShaderLibrary();
+    void CreateRenderGraph();
+    void CreateUploadManager();
+    void CreateAssetStreamer();
+    void RetireStreamedAssets();
+    void CreateBindlessTable();
+    void CreateStressScene();
+    void CreateGpuCuller();
+    void CreateUniformRing();
+    void CreatePipelineLayout();
+    void CreatePipelineCompiler();
     void CreateGraphicsPipeline();
-    void CreateFramebuffers();
-    void CreateCommandPool();
+    void CreateCommandPools();
     void CreateCommandBuffers();
+    void CreateRecordWorkers();
     void CreateSyncObjects();
+    void CreateProfiler();
 
     // Drawing helpers
+    // Declares this frame's passes; the graph only recompiles when they change shape
+    void DeclareRenderGraph(uint32_t imageIndex, VkPipeline pipeline, uint32_t slices);
     void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    void RecordMainPass(RenderGraph::PassContext& context, VkPipeline pipeline, uint32_t slices);
+    void BindPipelineState(VkCommandBuffer commandBuffer, VkPipeline pipeline);
+    void RecordDraws(VkCommandBuffer commandBuffer, VkPipeline pipeline, uint32_t firstDraw, uint32_t drawCount);
+    void RecordDrawSlice(uint32_t slice, const RenderGraph::PassContext& pass, VkPipeline pipeline,
+                         uint32_t firstDraw, uint32_t drawCount, VkQueryPipelineStatisticFlags inheritedStatistics);
+    uint32_t GetRecordSliceCount() const;
 
-    // Shader helpers
-    static std::vector<char> ReadFile(const std::string& filename);
-    VkShaderModule CreateShaderModule(const std::vector<char>& code);
+    // Swap chain recreation (no device idle wait)
+    void RecreateSwapChain();
+    void RetireSwapChainResources();
 
     // Cleanup
-    void CleanupSwapChainResources(); // For recreation
-    void Cleanup();                 // Full cleanup
+    void Cleanup(); // Full cleanup
 
     // --- Member Variables ---
     // Use types directly
     VulkanDevice& _device;
-    VulkanSwapChain& _swapChain;
+    PresentTarget& _presentTarget;
+    VulkanPipelineCache& _pipelineCache;
+    JobSystem& _jobSystem; // Records slices 1.., the main thread records slice 0 and helps with the rest
 
-    const int MAX_FRAMES_IN_FLIGHT = 2;
+    const RendererSettings _settings;
+    const uint32_t _maxFramesInFlight;
 
     // Vulkan rendering objects
-    VkRenderPass _renderPass = VK_NULL_HANDLE;
-    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
-    VkPipeline _graphicsPipeline = VK_NULL_HANDLE;
-    std::vector<VkFramebuffer> _swapChainFramebuffers;
-    VkCommandPool _commandPool = VK_NULL_HANDLE;
+    std::unique_ptr<RenderGraph> _renderGraph; // Owns the render passes, framebuffers and transient images
+    std::unique_ptr<UniformRing> _uniformRing; // Per-draw constants, set 0 of the pipeline layout
+    std::unique_ptr<BindlessTable> _bindlessTable; // Every bindless resource, bound once per command buffer
+    std::unique_ptr<GpuCuller> _gpuCuller; // Scene objects, culling and indirect draws; null on the CPU path
+    std::unique_ptr<StressScene> _stressScene; // Replaces the grid (and the culler) when set
+    glm::mat4 _viewProjection{1.0f}; // The triangle grid is laid out in clip space
+    std::unique_ptr<ShaderLibrary> _shaderLibrary; // Every shader module, and the layouts reflected from them
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE; // Owned by the shader library
+    std::unique_ptr<PipelineCompiler> _pipelineCompiler;
+    GraphicsPipelineDesc _graphicsPipelineDesc;
+    PipelineFuture _graphicsPipeline; // Not ready until the compiler's worker finishes
+    // Command pools are per frame in flight (and per slice) and reset wholesale
+    // once the frame slot has retired
+    std::vector<VkCommandPool> _commandPools;   // Primary buffers, one per frame
     std::vector<VkCommandBuffer> _commandBuffers;
+    std::vector<VkCommandPool> _slicePools;     // [frame * _maxRecordSlices + slice]
+    std::vector<VkCommandBuffer> _sliceCommandBuffers; // Secondary, same indexing
+    uint32_t _maxRecordSlices = 1;
+    std::vector<std::exception_ptr> _sliceErrors; // Jobs must not throw; failures are rethrown on the main thread
 
-    // Synchronization objects (per frame in flight)
+    // Synchronization: the swap chain needs binary semaphores (per frame in
+    // flight); everything else tracks frames on the graphics queue's timeline
     std::vector<VkSemaphore> _imageAvailableSemaphores;
     std::vector<VkSemaphore> _renderFinishedSemaphores;
-    std::vector<VkFence> _inFlightFences;
+    std::unique_ptr<VulkanTimeline> _frameTimeline; // Reaches N + 1 when frame N completes
+    std::unique_ptr<FramePacer> _framePacer;
     uint32_t _currentFrame = 0;
+    uint64_t _frameNumber = 0; // Monotonic count of submitted frames
+    bool _resizeRequested = false;
+
+    // Objects retired by swap chain recreation, destroyed when their frames retire
+    DeletionQueue _deletionQueue;
+
+    std::unique_ptr<GpuProfiler> _gpuProfiler;
+    std::unique_ptr<UploadManager> _uploadManager;
+    std::unique_ptr<Assets::AssetStreamer> _assetStreamer; // Feeds the UploadManager within streamBudget
+    // Cancelled assets whose copies may still be queued or running on the
+    // transfer queue; moved to the deletion queue once lastTicket completes
+    struct CancelledAsset {
+        UploadTicket lastTicket;
+        std::unique_ptr<Assets::StreamedAsset> asset;
+    };
+    std::vector<CancelledAsset> _cancelledAssets;
+    FrameTimings _lastFrameTimings;
 };
 
 } // namespace VulkanApp::Rendering 
\ No newline at end of file
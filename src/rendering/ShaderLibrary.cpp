@@ -0,0 +1,194 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+
+#include "ShaderLibrary.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+namespace VulkanApp::Rendering {
+
+// The reflection enums are the Vulkan values, so they convert with a cast
+static_assert(static_cast<uint32_t>(Assets::ShaderStage::Vertex) == VK_SHADER_STAGE_VERTEX_BIT);
+static_assert(static_cast<uint32_t>(Assets::ShaderStage::Fragment) == VK_SHADER_STAGE_FRAGMENT_BIT);
+static_assert(static_cast<uint32_t>(Assets::ShaderStage::Compute) == VK_SHADER_STAGE_COMPUTE_BIT);
+static_assert(static_cast<uint32_t>(Assets::DescriptorType::CombinedImageSampler) ==
+              VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+static_assert(static_cast<uint32_t>(Assets::DescriptorType::StorageTexelBuffer) ==
+              VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER);
+static_assert(static_cast<uint32_t>(Assets::DescriptorType::StorageBuffer) == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+
+ShaderLibrary::ShaderLibrary(VulkanDevice& device, const Assets::ShaderArchive& archive)
+    : _device(device)
+{
+    auto start = std::chrono::steady_clock::now();
+    try {
+        for (const Assets::ShaderArchiveEntry& entry : archive.GetShaders()) {
+            std::span<const uint32_t> code = archive.GetCode(entry);
+            VkShaderModuleCreateInfo createInfo{};
+            createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            createInfo.codeSize = code.size_bytes();
+            createInfo.pCode = code.data();
+
+            Shader shader;
+            shader.reflection = archive.GetReflection(entry);
+            VkResult result = vkCreateShaderModule(_device.getDevice(), &createInfo, nullptr, &shader.module);
+            if (result != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create shader module " + std::string(entry.name) +
+                                         "! Error: " + std::to_string(result));
+            }
+            _shaders.emplace(entry.name, std::move(shader));
+        }
+    } catch (...) {
+        for (auto& [name, shader] : _shaders) {
+            vkDestroyShaderModule(_device.getDevice(), shader.module, nullptr);
+        }
+        throw;
+    }
+    _createMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Shader library created " << _shaders.size() << " shader modules from " << archive.GetName()
+              << " (" << archive.GetSize() / 1024 << " KiB) in " << _createMs << " ms." << std::endl;
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+    VkDevice device = _device.getDevice();
+    for (VkPipelineLayout layout : _pipelineLayouts) {
+        vkDestroyPipelineLayout(device, layout, nullptr);
+    }
+    for (VkDescriptorSetLayout layout : _setLayouts) {
+        vkDestroyDescriptorSetLayout(device, layout, nullptr);
+    }
+    for (auto& [name, shader] : _shaders) {
+        vkDestroyShaderModule(device, shader.module, nullptr);
+    }
+}
+
+const ShaderLibrary::Shader& ShaderLibrary::Find(std::string_view name) const
+{
+    auto it = _shaders.find(name);
+    if (it == _shaders.end()) {
+        throw std::runtime_error("Error: the shader archive has no shader " + std::string(name) + "!");
+    }
+    return it->second;
+}
+
+VkShaderModule ShaderLibrary::GetModule(std::string_view name) const
+{
+    return Find(name).module;
+}
+
+VkPipelineShaderStageCreateInfo ShaderLibrary::GetStageInfo(std::string_view name) const
+{
+    const Shader& shader = Find(name);
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.stage = static_cast<VkShaderStageFlagBits>(shader.reflection.stage);
+    stageInfo.module = shader.module;
+    stageInfo.pName = shader.reflection.entryPoint.c_str(); // Lives as long as the library
+    return stageInfo;
+}
+
+const Assets::ShaderReflection& ShaderLibrary::GetReflection(std::string_view name) const
+{
+    return Find(name).reflection;
+}
+
+ReflectedPipelineLayout ShaderLibrary::CreatePipelineLayout(std::initializer_list<std::string_view> shaders,
+                                                            uint32_t pushConstantSize,
+                                                            std::initializer_list<VkDescriptorSetLayout> externalSets)
+{
+    ReflectedPipelineLayout reflected;
+    uint32_t setCount = static_cast<uint32_t>(externalSets.size());
+    for (std::string_view name : shaders) {
+        const Assets::ShaderReflection& reflection = Find(name).reflection;
+        for (const Assets::ShaderBinding& binding : reflection.bindings) {
+            setCount = std::max(setCount, binding.set + 1);
+        }
+        // One range shared by every stage with a block, so each must match the C++ struct
+        if (reflection.pushConstantSize > 0) {
+            if (reflection.pushConstantSize != pushConstantSize) {
+                throw std::runtime_error("Error: the push constants of " + std::string(name) + " are " +
+                                         std::to_string(reflection.pushConstantSize) + " bytes, expected " +
+                                         std::to_string(pushConstantSize) + "!");
+            }
+            reflected.pushConstants.stageFlags |= static_cast<VkShaderStageFlags>(reflection.stage);
+        }
+    }
+    if (pushConstantSize > 0 && reflected.pushConstants.stageFlags == 0) {
+        throw std::runtime_error("Error: expected " + std::to_string(pushConstantSize) +
+                                 " bytes of push constants, but no shader declares them!");
+    }
+    reflected.pushConstants.size = pushConstantSize;
+
+    const std::vector<std::string_view> names(shaders);
+    for (uint32_t set = 0; set < setCount; set++) {
+        VkDescriptorSetLayout external = set < externalSets.size() ? externalSets.begin()[set] : VK_NULL_HANDLE;
+        reflected.setLayouts.push_back(external != VK_NULL_HANDLE ? external : CreateSetLayout(set, names));
+    }
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = setCount;
+    layoutInfo.pSetLayouts = reflected.setLayouts.data();
+    layoutInfo.pushConstantRangeCount = pushConstantSize > 0 ? 1 : 0;
+    layoutInfo.pPushConstantRanges = &reflected.pushConstants;
+    VkResult result = vkCreatePipelineLayout(_device.getDevice(), &layoutInfo, nullptr, &reflected.layout);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create reflected pipeline layout! Error: " + std::to_string(result));
+    }
+    _pipelineLayouts.push_back(reflected.layout);
+    return reflected;
+}
+
+// Bindings of the set from every shader, merged; a set no shader uses gets an
+// empty layout, since every set below the highest must have one
+VkDescriptorSetLayout ShaderLibrary::CreateSetLayout(uint32_t set, std::span<const std::string_view> shaders)
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    for (std::string_view name : shaders) {
+        const Assets::ShaderReflection& reflection = Find(name).reflection;
+        for (const Assets::ShaderBinding& binding : reflection.bindings) {
+            if (binding.set != set) {
+                continue;
+            }
+            if (binding.count == 0) {
+                throw std::runtime_error("Error: " + std::string(name) + " set " + std::to_string(set) +
+                                         " has a runtime-sized array and needs an external set layout!");
+            }
+            auto it = std::find_if(bindings.begin(), bindings.end(), [&](const VkDescriptorSetLayoutBinding& b) {
+                return b.binding == binding.binding;
+            });
+            if (it == bindings.end()) {
+                VkDescriptorSetLayoutBinding layoutBinding{};
+                layoutBinding.binding = binding.binding;
+                layoutBinding.descriptorType = static_cast<VkDescriptorType>(binding.type);
+                layoutBinding.descriptorCount = binding.count;
+                bindings.push_back(layoutBinding);
+                it = bindings.end() - 1;
+            } else if (it->descriptorType != static_cast<VkDescriptorType>(binding.type) ||
+                       it->descriptorCount != binding.count) {
+                throw std::runtime_error("Error: " + std::string(name) + " declares set " + std::to_string(set) +
+                                         " binding " + std::to_string(binding.binding) +
+                                         " differently from another stage!");
+            }
+            it->stageFlags |= static_cast<VkShaderStageFlags>(reflection.stage);
+        }
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkResult result = vkCreateDescriptorSetLayout(_device.getDevice(), &layoutInfo, nullptr, &setLayout);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create reflected descriptor set layout! Error: " + std::to_string(result));
+    }
+    _setLayouts.push_back(setLayout);
+    return setLayout;
+}
+
+} // namespace VulkanApp::Rendering
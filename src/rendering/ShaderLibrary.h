@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "../assets/ShaderArchive.h"
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+
+namespace VulkanApp::Rendering {
+
+// The .vkshaders archive ShaderPacker generates from shaders/ at build time,
+// linked into the executable (defined in the generated EmbeddedShaders.cpp)
+std::span<const std::byte> GetEmbeddedShaderArchive();
+
+// A pipeline layout derived from shader reflection
+struct ReflectedPipelineLayout {
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSetLayout> setLayouts; // Indexed by set number, external ones included
+    VkPushConstantRange pushConstants{};           // size 0 without a push constant block
+};
+
+// Every shader of the application, loaded once: the archive is validated and
+// a VkShaderModule created for each shader in one pass at startup, so pipeline
+// compiles neither touch the file system nor rebuild modules. Pipeline layouts
+// are derived from the reflection the archive carries instead of being written
+// out by hand next to each shader.
+//
+// Lookups are read-only after construction and safe from compile workers;
+// CreatePipelineLayout is for the render thread.
+class ShaderLibrary {
+public:
+    // The archive is only read here; modules and reflection are copied out of it
+    ShaderLibrary(VulkanDevice& device, const Assets::ShaderArchive& archive);
+    ~ShaderLibrary(); // Destroys the modules and every layout created here; device must be idle
+
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    // Throw std::runtime_error for a name the archive does not hold
+    VkShaderModule GetModule(std::string_view name) const;
+    // Stage, module and entry point of the shader, ready for a pipeline create info
+    VkPipelineShaderStageCreateInfo GetStageInfo(std::string_view name) const;
+    const Assets::ShaderReflection& GetReflection(std::string_view name) const;
+
+    // One set layout per descriptor set the shaders use, each binding visible to
+    // the stages that declare it, and one push constant range over the stages
+    // with a push constant block. externalSets[set], when not VK_NULL_HANDLE,
+    // replaces the derived layout of that set: dynamic-offset buffers and
+    // runtime-sized arrays cannot be told from SPIR-V alone. Throws if a push
+    // constant block is not pushConstantSize bytes, the size of the C++ struct
+    // filling it. The layouts are owned by the library.
+    ReflectedPipelineLayout CreatePipelineLayout(std::initializer_list<std::string_view> shaders,
+                                                 uint32_t pushConstantSize,
+                                                 std::initializer_list<VkDescriptorSetLayout> externalSets = {});
+
+    uint32_t GetShaderCount() const { return static_cast<uint32_t>(_shaders.size()); }
+    double GetCreateMs() const { return _createMs; } // Spent creating the shader modules
+
+private:
+    struct Shader {
+        VkShaderModule module = VK_NULL_HANDLE;
+        Assets::ShaderReflection reflection;
+    };
+
+    const Shader& Find(std::string_view name) const;
+    VkDescriptorSetLayout CreateSetLayout(uint32_t set, std::span<const std::string_view> shaders);
+
+    VulkanDevice& _device;
+    std::map<std::string, Shader, std::less<>> _shaders;
+    std::vector<VkDescriptorSetLayout> _setLayouts;
+    std::vector<VkPipelineLayout> _pipelineLayouts;
+    double _createMs = 0.0;
+};
+
+} // namespace VulkanApp::Rendering
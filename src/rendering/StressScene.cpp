@@ -0,0 +1,390 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+#include "../vulkan/VulkanPipelineCache.h"
+#include "../core/JobSystem.h"
+#include "ShaderLibrary.h"
+
+#include "StressScene.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+constexpr float PI = 3.14159265f;
+constexpr float TWO_PI = 6.28318531f;
+constexpr float HALF_PI = 1.57079633f;
+
+// Matches the Scene push constant block in stress.vert
+struct DrawConstants {
+    float scale;
+    uint32_t stride;
+};
+
+// Matches the Animate push constant block in stress.comp
+struct AnimateConstants {
+    float time;
+    float orbitRadius;
+    uint32_t instanceCount;
+    uint32_t stride;
+};
+
+// Integer hash (lowbias32), so the scene is the same on every platform
+uint32_t Hash(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+float Unit(uint32_t seed)
+{
+    return static_cast<float>(Hash(seed) >> 8) * (1.0f / 16777216.0f); // [0, 1)
+}
+
+// sin(x) to within 2e-4. Branch-free (truncation instead of floor, min and
+// copysign instead of conditionals) so loops calling it vectorize without a
+// vector math library.
+inline float FastSin(float x)
+{
+    float turns = x * (1.0f / TWO_PI);
+    x -= TWO_PI * static_cast<float>(static_cast<int32_t>(turns + std::copysign(0.5f, turns))); // [-pi, pi]
+    float a = std::fabs(x);
+    a = std::min(a, PI - a); // [0, pi/2], same sine
+    float a2 = a * a;
+    return std::copysign(a * (1.0f + a2 * (-1.0f / 6.0f + a2 * (1.0f / 120.0f + a2 * (-1.0f / 5040.0f)))), x);
+}
+} // namespace
+
+StressScene::StressScene(VulkanDevice& device, VulkanPipelineCache& pipelineCache, ShaderLibrary& shaderLibrary,
+                         UploadManager& uploadManager, JobSystem& jobSystem, uint32_t framesInFlight,
+                         uint32_t instanceCount, bool gpuAnimation)
+    : _device(device),
+      _pipelineCache(pipelineCache),
+      _shaderLibrary(shaderLibrary),
+      _uploadManager(uploadManager),
+      _jobSystem(jobSystem),
+      _gpuAnimation(gpuAnimation),
+      _instanceCount(instanceCount),
+      _stride((std::max(instanceCount, 1u) + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE * WORKGROUP_SIZE),
+      _frames(framesInFlight)
+{
+    VkDeviceSize instanceBytes = 3ull * _stride * sizeof(float);
+    VkDeviceSize motionBytes = 4ull * _stride * sizeof(float);
+    if (std::max(instanceBytes, motionBytes) > device.getProperties().limits.maxStorageBufferRange) {
+        throw std::runtime_error("Error: stress scene buffers exceed maxStorageBufferRange (" +
+                                 std::to_string(_instanceCount) + " instances)!");
+    }
+    _stats.instances = _instanceCount;
+    _stats.gpuAnimation = _gpuAnimation;
+    _stats.bytesPerFrame = _gpuAnimation ? 0 : 3ull * _instanceCount * sizeof(float);
+
+    GenerateInstances();
+
+    _colorBuffer = CreateBuffer(static_cast<VkDeviceSize>(_stride) * sizeof(uint32_t),
+                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                MemoryUsage::GpuOnly, _colorMemory);
+    if (_gpuAnimation) {
+        _motionBuffer = CreateBuffer(motionBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                     MemoryUsage::GpuOnly, _motionMemory);
+    }
+    for (FrameResources& frame : _frames) {
+        frame.instanceBuffer = CreateBuffer(instanceBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                            _gpuAnimation ? MemoryUsage::GpuOnly : MemoryUsage::CpuToGpu,
+                                            frame.instanceMemory);
+    }
+
+    // Queued in chunks so any scene size fits through the staging ring
+    auto queueUpload = [&](VkBuffer buffer, const void* data, VkDeviceSize size) {
+        for (VkDeviceSize offset = 0; offset < size; offset += BYTES_PER_UPLOAD) {
+            _pendingUploads.push_back({buffer, offset, static_cast<const char*>(data) + offset,
+                                       std::min(BYTES_PER_UPLOAD, size - offset)});
+        }
+    };
+    queueUpload(_colorBuffer, _colors.data(), _colors.size() * sizeof(uint32_t));
+    if (_gpuAnimation) {
+        queueUpload(_motionBuffer, _motion.data(), _motion.size() * sizeof(float));
+    }
+
+    CreateLayouts();
+    CreateDescriptors();
+    CreatePipelines();
+    std::cout << "Stress scene ready (" << _instanceCount << " instances, "
+              << (_gpuAnimation ? "GPU" : "CPU") << " animation)." << std::endl;
+}
+
+StressScene::~StressScene()
+{
+    VkDevice device = _device.getDevice();
+    vkDestroyPipeline(device, _animatePipeline, nullptr);
+    // The descriptor sets are freed with their pool; the layouts belong to the shader library
+    vkDestroyDescriptorPool(device, _descriptorPool, nullptr);
+
+    VulkanMemoryAllocator& allocator = _device.getAllocator();
+    for (FrameResources& frame : _frames) {
+        allocator.destroyBuffer(frame.instanceBuffer, frame.instanceMemory);
+    }
+    if (_motionBuffer != VK_NULL_HANDLE) {
+        allocator.destroyBuffer(_motionBuffer, _motionMemory);
+    }
+    allocator.destroyBuffer(_colorBuffer, _colorMemory);
+}
+
+// Each instance orbits the center of its cell of a square grid covering the
+// target, at its own phase and speed, with a color spread over the hue circle
+void StressScene::GenerateInstances()
+{
+    uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(std::max(_instanceCount, 1u)))));
+    float cell = 2.0f / static_cast<float>(columns);
+    _scale = 0.5f * cell;
+    _orbitRadius = 0.25f * cell;
+
+    _motion.assign(4ull * _stride, 0.0f);
+    _colors.assign(_stride, 0);
+    float* baseX = _motion.data();
+    float* baseY = baseX + _stride;
+    float* phase = baseY + _stride;
+    float* speed = phase + _stride;
+    for (uint32_t i = 0; i < _instanceCount; i++) {
+        baseX[i] = -1.0f + cell * (static_cast<float>(i % columns) + 0.5f);
+        baseY[i] = -1.0f + cell * (static_cast<float>(i / columns) + 0.5f);
+        phase[i] = TWO_PI * Unit(i * 4 + 0);
+        float magnitude = 0.5f + 1.5f * Unit(i * 4 + 1); // Radians per second
+        speed[i] = (Hash(i * 4 + 2) & 1) ? magnitude : -magnitude;
+
+        float hue = Unit(i * 4 + 3);
+        uint32_t color = 0xFF000000u; // Opaque
+        for (uint32_t c = 0; c < 3; c++) {
+            float channel = 0.5f + 0.5f * std::cos(TWO_PI * (hue - static_cast<float>(c) / 3.0f));
+            color |= static_cast<uint32_t>(channel * 255.0f + 0.5f) << (8 * c); // unpackUnorm4x8 order
+        }
+        _colors[i] = color;
+    }
+}
+
+VkBuffer StressScene::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, MemoryUsage memoryUsage,
+                                   VulkanAllocation& allocation)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    return _device.getAllocator().createBuffer(bufferInfo, memoryUsage, allocation);
+}
+
+// Derived from the shaders' reflection, checked against the constants structs
+// and, for the animation pass, the workgroup size the stride is padded to
+void StressScene::CreateLayouts()
+{
+    ReflectedPipelineLayout draw =
+        _shaderLibrary.CreatePipelineLayout({"stress.vert", "shader.frag"}, sizeof(DrawConstants));
+    _drawPipelineLayout = draw.layout;
+    _drawSetLayout = draw.setLayouts[0];
+    if (!_gpuAnimation) {
+        return;
+    }
+
+    if (_shaderLibrary.GetReflection("stress.comp").localSize[0] != WORKGROUP_SIZE) {
+        throw std::runtime_error("Error: stress.comp's local_size_x does not match StressScene::WORKGROUP_SIZE!");
+    }
+    ReflectedPipelineLayout animate = _shaderLibrary.CreatePipelineLayout({"stress.comp"}, sizeof(AnimateConstants));
+    _animatePipelineLayout = animate.layout;
+    _animateSetLayout = animate.setLayouts[0];
+}
+
+// Written once: per frame slot a draw set (instances, colors) and, with GPU
+// animation, an animation set (motion, instances)
+void StressScene::CreateDescriptors()
+{
+    const uint32_t frameCount = static_cast<uint32_t>(_frames.size());
+    const uint32_t setsPerFrame = _gpuAnimation ? 2 : 1;
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, frameCount * setsPerFrame * 2};
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = frameCount * setsPerFrame;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    VkResult result = vkCreateDescriptorPool(_device.getDevice(), &poolInfo, nullptr, &_descriptorPool);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create stress scene descriptor pool! Error: " + std::to_string(result));
+    }
+
+    std::vector<VkDescriptorSetLayout> setLayouts;
+    for (uint32_t i = 0; i < frameCount; i++) {
+        setLayouts.push_back(_drawSetLayout);
+        if (_gpuAnimation) {
+            setLayouts.push_back(_animateSetLayout);
+        }
+    }
+    std::vector<VkDescriptorSet> sets(setLayouts.size());
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(setLayouts.size());
+    allocInfo.pSetLayouts = setLayouts.data();
+    result = vkAllocateDescriptorSets(_device.getDevice(), &allocInfo, sets.data());
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate stress scene descriptor sets! Error: " + std::to_string(result));
+    }
+
+    VkDescriptorBufferInfo colorInfo{_colorBuffer, 0, VK_WHOLE_SIZE};
+    VkDescriptorBufferInfo motionInfo{_motionBuffer, 0, VK_WHOLE_SIZE};
+    std::vector<VkDescriptorBufferInfo> instanceInfos;
+    instanceInfos.reserve(frameCount);
+    std::vector<VkWriteDescriptorSet> writes;
+    auto addWrite = [&](VkDescriptorSet set, uint32_t binding, const VkDescriptorBufferInfo* info) {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = info;
+        writes.push_back(write);
+    };
+    for (uint32_t i = 0; i < frameCount; i++) {
+        FrameResources& frame = _frames[i];
+        frame.drawSet = sets[i * setsPerFrame];
+        instanceInfos.push_back({frame.instanceBuffer, 0, VK_WHOLE_SIZE});
+        addWrite(frame.drawSet, 0, &instanceInfos[i]);
+        addWrite(frame.drawSet, 1, &colorInfo);
+        if (_gpuAnimation) {
+            frame.animateSet = sets[i * setsPerFrame + 1];
+            addWrite(frame.animateSet, 0, &motionInfo);
+            addWrite(frame.animateSet, 1, &instanceInfos[i]);
+        }
+    }
+    vkUpdateDescriptorSets(_device.getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+void StressScene::CreatePipelines()
+{
+    if (!_gpuAnimation) {
+        return;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = _shaderLibrary.GetStageInfo("stress.comp");
+    pipelineInfo.layout = _animatePipelineLayout;
+    VkResult result = vkCreateComputePipelines(_device.getDevice(), _pipelineCache.getCache(), 1, &pipelineInfo,
+                                               nullptr, &_animatePipeline);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create stress animation pipeline! Error: " + std::to_string(result));
+    }
+    _pipelineCache.markDirty();
+}
+
+void StressScene::StreamData()
+{
+    while (_queuedUploads < _pendingUploads.size()) {
+        const PendingUpload& upload = _pendingUploads[_queuedUploads];
+        UploadTicket ticket = _uploadManager.UploadBuffer(
+            upload.buffer, upload.offset, upload.data, upload.size,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+        if (ticket == 0) {
+            return; // Staging ring full; the rest follows on later frames
+        }
+        _lastTicket = ticket;
+        _queuedUploads++;
+    }
+    if (!_pendingUploads.empty()) {
+        // Everything is in the staging ring; the CPU animation still reads _motion
+        _pendingUploads = {};
+        _queuedUploads = 0;
+        _colors = {};
+        if (_gpuAnimation) {
+            _motion = {};
+        }
+    }
+}
+
+void StressScene::Update(uint32_t frameSlot, uint64_t frameNumber)
+{
+    _stats.resident = _pendingUploads.empty() && _uploadManager.IsReady(_lastTicket);
+    _time = static_cast<float>(static_cast<double>(frameNumber) * SECONDS_PER_FRAME);
+    if (_gpuAnimation || !_stats.resident) {
+        return;
+    }
+
+    // The slot's previous frame has completed, so its instances can be overwritten
+    FrameResources& frame = _frames[frameSlot];
+    float* instances = static_cast<float*>(frame.instanceMemory.mappedData);
+    JobCounter updated;
+    _jobSystem.ParallelFor(_instanceCount, INSTANCES_PER_JOB,
+                           [this, instances](uint32_t begin, uint32_t end) { AnimateRange(instances, begin, end); },
+                           updated);
+    _jobSystem.Wait(updated);
+    _device.getAllocator().flush(frame.instanceMemory);
+}
+
+// Same math as stress.comp. Straight-line SoA loads and stores, so the
+// compiler vectorizes the loop.
+void StressScene::AnimateRange(float* instances, uint32_t begin, uint32_t end) const
+{
+    const float* baseX = _motion.data();
+    const float* baseY = baseX + _stride;
+    const float* phase = baseY + _stride;
+    const float* speed = phase + _stride;
+    float* x = instances;
+    float* y = x + _stride;
+    float* rotation = y + _stride;
+    const float time = _time;
+    const float orbitRadius = _orbitRadius;
+    for (uint32_t i = begin; i < end; i++) {
+        float angle = phase[i] + speed[i] * time;
+        x[i] = baseX[i] + orbitRadius * FastSin(angle + HALF_PI);
+        y[i] = baseY[i] + orbitRadius * FastSin(angle);
+        rotation[i] = angle * SPIN;
+    }
+}
+
+void StressScene::RecordAnimate(VkCommandBuffer commandBuffer, uint32_t frameSlot)
+{
+    if (!_gpuAnimation || !_stats.resident) {
+        return;
+    }
+    FrameResources& frame = _frames[frameSlot];
+
+    // The slot's previous frame has completed: its instances carry no pending accesses
+    _barriers.TrackBuffer(frame.instanceBuffer);
+    _barriers.UseBuffer(frame.instanceBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR);
+    _barriers.Flush(commandBuffer, _device);
+
+    AnimateConstants constants{_time, _orbitRadius, _instanceCount, _stride};
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _animatePipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _animatePipelineLayout, 0, 1,
+                            &frame.animateSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, _animatePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants),
+                       &constants);
+    vkCmdDispatch(commandBuffer, _stride / WORKGROUP_SIZE, 1, 1);
+
+    _barriers.UseBuffer(frame.instanceBuffer, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR,
+                        VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR);
+    _barriers.Flush(commandBuffer, _device);
+}
+
+void StressScene::RecordDraw(VkCommandBuffer commandBuffer, uint32_t frameSlot)
+{
+    if (!_stats.resident || _instanceCount == 0) {
+        return;
+    }
+    const FrameResources& frame = _frames[frameSlot];
+    DrawConstants constants{_scale, _stride};
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _drawPipelineLayout, 0, 1,
+                            &frame.drawSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, _drawPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants),
+                       &constants);
+    vkCmdDraw(commandBuffer, 3, _instanceCount, 0, 0);
+}
+
+} // namespace VulkanApp::Rendering
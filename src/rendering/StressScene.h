@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "BarrierBatcher.h"
+#include "UploadManager.h"
+#include "../vulkan/VulkanMemoryAllocator.h"
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+class VulkanPipelineCache;
+class JobSystem;
+
+namespace VulkanApp::Rendering {
+
+class ShaderLibrary;
+
+// Reproducible load generator: N triangles drawn with one instanced draw, each
+// orbiting its own point of a grid and spinning. Per-instance state is kept as
+// structure-of-arrays, sections of GetStride() floats each, so both the CPU
+// update and the shaders stream through contiguous arrays:
+//   instances (per frame in flight): x | y | rotation
+//   motion:                          base x | base y | phase | angular speed
+//   colors:                          RGBA8
+// With CPU animation the instances are written every frame into host-visible
+// memory by a vectorizable loop spread over the JobSystem, which makes the
+// scene an upload-bandwidth load (12 bytes per instance per frame). With GPU
+// animation a compute pass (stress.comp) writes them into device-local memory
+// instead. Motion and colors stream through the UploadManager once. Time
+// advances a fixed step per frame, so runs are comparable frame for frame.
+class StressScene {
+public:
+    static constexpr uint32_t WORKGROUP_SIZE = 64;          // local_size_x in stress.comp; also the stride granule
+    static constexpr uint32_t INSTANCES_PER_JOB = 16384;    // CPU update grain
+    static constexpr VkDeviceSize BYTES_PER_UPLOAD = 4ull * 1024 * 1024; // Chunks through the staging ring
+    static constexpr double SECONDS_PER_FRAME = 1.0 / 60.0;
+    static constexpr float SPIN = 2.0f; // Turns of the triangle per orbit; matches stress.comp
+
+    struct Stats {
+        uint32_t instances = 0;
+        bool gpuAnimation = false;
+        bool resident = false;         // Motion and colors uploaded; instances are drawn
+        uint64_t bytesPerFrame = 0;    // Instance data written by the CPU each frame (0 with GPU animation)
+    };
+
+    // shaderLibrary must outlive the scene
+    StressScene(VulkanDevice& device, VulkanPipelineCache& pipelineCache, ShaderLibrary& shaderLibrary,
+                UploadManager& uploadManager, JobSystem& jobSystem, uint32_t framesInFlight, uint32_t instanceCount,
+                bool gpuAnimation);
+    ~StressScene(); // Device must be idle
+
+    StressScene(const StressScene&) = delete;
+    StressScene& operator=(const StressScene&) = delete;
+
+    // Render thread, before UploadManager::Flush: queues the chunks the
+    // staging ring did not accept yet
+    void StreamData();
+
+    // Render thread, once the slot's previous frame has completed: advances
+    // the scene to frameNumber and, with CPU animation, writes the slot's instances
+    void Update(uint32_t frameSlot, uint64_t frameNumber);
+
+    // GPU animation only: records the animation dispatch for frameSlot after
+    // Update; outside a render pass. Leaves the instances ready for the vertex shader.
+    void RecordAnimate(VkCommandBuffer commandBuffer, uint32_t frameSlot);
+
+    // Inside the render pass, with a pipeline built against GetDrawPipelineLayout() bound
+    void RecordDraw(VkCommandBuffer commandBuffer, uint32_t frameSlot);
+
+    // Set 0: the slot's instances and the colors (vertex stage); push constants: scale and stride
+    VkPipelineLayout GetDrawPipelineLayout() const { return _drawPipelineLayout; }
+
+    uint32_t GetStride() const { return _stride; }
+    const Stats& GetStats() const { return _stats; }
+
+private:
+    struct FrameResources {
+        VkBuffer instanceBuffer = VK_NULL_HANDLE;
+        VulkanAllocation instanceMemory; // Mapped with CPU animation
+        VkDescriptorSet drawSet = VK_NULL_HANDLE;
+        VkDescriptorSet animateSet = VK_NULL_HANDLE; // GPU animation only
+    };
+
+    // A piece of the motion or color arrays still to be handed to the UploadManager
+    struct PendingUpload {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        const void* data;
+        VkDeviceSize size;
+    };
+
+    void GenerateInstances();
+    VkBuffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, MemoryUsage memoryUsage,
+                          VulkanAllocation& allocation);
+    void CreateLayouts();
+    void CreateDescriptors();
+    void CreatePipelines();
+    void AnimateRange(float* instances, uint32_t begin, uint32_t end) const;
+
+    VulkanDevice& _device;
+    VulkanPipelineCache& _pipelineCache;
+    ShaderLibrary& _shaderLibrary;
+    UploadManager& _uploadManager;
+    JobSystem& _jobSystem;
+    const bool _gpuAnimation;
+    const uint32_t _instanceCount;
+    const uint32_t _stride; // Elements per section, a multiple of WORKGROUP_SIZE
+
+    // CPU copy of the motion sections (base x, base y, phase, speed), in one
+    // array laid out like the motion buffer, and of the colors
+    std::vector<float> _motion;
+    std::vector<uint32_t> _colors;
+    float _scale = 1.0f;       // Triangle size in clip space
+    float _orbitRadius = 0.0f;
+    float _time = 0.0f;        // Seconds, set by Update
+
+    std::vector<PendingUpload> _pendingUploads; // Not yet accepted, in order
+    size_t _queuedUploads = 0;
+    UploadTicket _lastTicket = 0; // Resident once ready; tickets complete in order
+
+    VkBuffer _motionBuffer = VK_NULL_HANDLE; // GPU animation only
+    VulkanAllocation _motionMemory;
+    VkBuffer _colorBuffer = VK_NULL_HANDLE;
+    VulkanAllocation _colorMemory;
+    std::vector<FrameResources> _frames;
+
+    // Layouts are reflected from the shaders and owned by the ShaderLibrary
+    VkDescriptorSetLayout _drawSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout _animateSetLayout = VK_NULL_HANDLE; // GPU animation only
+    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    VkPipelineLayout _drawPipelineLayout = VK_NULL_HANDLE;
+    VkPipelineLayout _animatePipelineLayout = VK_NULL_HANDLE;
+    VkPipeline _animatePipeline = VK_NULL_HANDLE;
+
+    BarrierBatcher _barriers; // Tracks the per-frame instance buffers under GPU animation
+    Stats _stats;
+};
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,143 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+
+#include "UniformRing.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+UniformRing::UniformRing(VulkanDevice& device, uint32_t framesInFlight, VkDeviceSize bytesPerFrame)
+    : _device(device), _framesInFlight(framesInFlight)
+{
+    // Every allocation may be bound through either binding
+    const VkPhysicalDeviceLimits& limits = device.getProperties().limits;
+    _alignment = std::max(limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment);
+    _bytesPerFrame = AlignUp(bytesPerFrame, _alignment);
+
+    VkDeviceSize totalSize = _bytesPerFrame * _framesInFlight;
+    if (totalSize > UINT32_MAX) {
+        throw std::runtime_error("Error: Uniform ring exceeds the 32-bit dynamic offset range!");
+    }
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = totalSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    _buffer = _device.getAllocator().createBuffer(bufferInfo, MemoryUsage::CpuToGpu, _memory);
+
+    CreateDescriptors();
+    std::cout << "Uniform ring created (" << _framesInFlight << " x " << (_bytesPerFrame >> 10) << " KiB, "
+              << _alignment << "-byte offsets)." << std::endl;
+}
+
+UniformRing::~UniformRing()
+{
+    // The descriptor set is freed with its pool
+    vkDestroyDescriptorPool(_device.getDevice(), _descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(_device.getDevice(), _setLayout, nullptr);
+    _device.getAllocator().destroyBuffer(_buffer, _memory);
+}
+
+// Written once: the dynamic offsets select the data, so the set never changes
+void UniformRing::CreateDescriptors()
+{
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    VkResult result = vkCreateDescriptorSetLayout(_device.getDevice(), &layoutInfo, nullptr, &_setLayout);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create uniform ring descriptor set layout! Error: " + std::to_string(result));
+    }
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0] = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1};
+    poolSizes[1] = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    result = vkCreateDescriptorPool(_device.getDevice(), &poolInfo, nullptr, &_descriptorPool);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create uniform ring descriptor pool! Error: " + std::to_string(result));
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_setLayout;
+    result = vkAllocateDescriptorSets(_device.getDevice(), &allocInfo, &_descriptorSet);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate uniform ring descriptor set! Error: " + std::to_string(result));
+    }
+
+    const VkPhysicalDeviceLimits& limits = _device.getProperties().limits;
+    VkDescriptorBufferInfo uniformInfo{_buffer, 0, std::min<VkDeviceSize>(MAX_UNIFORM_RANGE, limits.maxUniformBufferRange)};
+    VkDescriptorBufferInfo storageInfo{_buffer, 0, std::min<VkDeviceSize>(_bytesPerFrame, limits.maxStorageBufferRange)};
+
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    for (uint32_t i = 0; i < writes.size(); i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = _descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = bindings[i].descriptorType;
+    }
+    writes[0].pBufferInfo = &uniformInfo;
+    writes[1].pBufferInfo = &storageInfo;
+    vkUpdateDescriptorSets(_device.getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+void UniformRing::BeginFrame(uint32_t frameSlot)
+{
+    _frameBase = static_cast<VkDeviceSize>(frameSlot % _framesInFlight) * _bytesPerFrame;
+    _frameOffset = 0;
+}
+
+void UniformRing::EndFrame()
+{
+    VkDeviceSize used = std::min(_frameOffset.load(), _bytesPerFrame);
+    _peakBytesUsed = std::max(_peakBytesUsed, used);
+    if (used > 0) {
+        _device.getAllocator().flush(_memory, _frameBase, used);
+    }
+}
+
+uint32_t UniformRing::Allocate(VkDeviceSize size, void** mapped)
+{
+    // Sizes are rounded to the alignment, so every offset handed out stays aligned
+    VkDeviceSize offset = _frameOffset.fetch_add(AlignUp(size, _alignment), std::memory_order_relaxed);
+    // Binding 0 reads MAX_UNIFORM_RANGE bytes from the offset, so that much must stay in bounds
+    if (offset + std::max(size, MAX_UNIFORM_RANGE) > _bytesPerFrame) {
+        throw std::runtime_error("Error: Uniform ring partition exhausted (" + std::to_string(_bytesPerFrame) +
+                                 " bytes per frame)!");
+    }
+    *mapped = static_cast<char*>(_memory.mappedData) + _frameBase + offset;
+    return static_cast<uint32_t>(_frameBase + offset);
+}
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <vulkan/vulkan.h>
+
+#include "../vulkan/VulkanMemoryAllocator.h"
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+
+namespace VulkanApp::Rendering {
+
+// Per-frame constants for shaders, written straight into one persistently
+// mapped buffer split into one partition per frame in flight. A partition is
+// rewound by BeginFrame once that frame slot's previous frame has completed, so the
+// steady state does no allocation and no descriptor writes: a single
+// descriptor set is written at creation and draws select their data with
+// dynamic offsets.
+//   binding 0: UNIFORM_BUFFER_DYNAMIC, MAX_UNIFORM_RANGE bytes per draw
+//   binding 1: STORAGE_BUFFER_DYNAMIC, the whole frame partition
+class UniformRing {
+public:
+    static constexpr VkDeviceSize DEFAULT_BYTES_PER_FRAME = 4ull * 1024 * 1024;
+    static constexpr VkDeviceSize MAX_UNIFORM_RANGE = 256; // Largest struct bound through binding 0
+
+    UniformRing(VulkanDevice& device, uint32_t framesInFlight, VkDeviceSize bytesPerFrame = DEFAULT_BYTES_PER_FRAME);
+    ~UniformRing();
+
+    UniformRing(const UniformRing&) = delete;
+    UniformRing& operator=(const UniformRing&) = delete;
+
+    // Rewinds the frame slot's partition; the slot's previous frame must have completed
+    void BeginFrame(uint32_t frameSlot);
+    // Makes the frame's writes visible to the device (no-op on coherent memory)
+    void EndFrame();
+
+    // Reserves size bytes in the current partition and returns the dynamic
+    // offset for binding 0 (also valid as an absolute buffer offset). Throws
+    // if the partition is exhausted. Lock-free, so recording threads can share
+    // a partition between BeginFrame and EndFrame.
+    uint32_t Allocate(VkDeviceSize size, void** mapped);
+
+    template <typename T>
+    uint32_t Push(const T& value)
+    {
+        static_assert(sizeof(T) <= MAX_UNIFORM_RANGE, "Uniform block larger than the binding range");
+        void* mapped = nullptr;
+        uint32_t offset = Allocate(sizeof(T), &mapped);
+        std::memcpy(mapped, &value, sizeof(T));
+        return offset;
+    }
+
+    VkDescriptorSetLayout GetDescriptorSetLayout() const { return _setLayout; }
+    VkDescriptorSet GetDescriptorSet() const { return _descriptorSet; }
+    // Dynamic offset for binding 1: the start of the current partition
+    uint32_t GetFrameBaseOffset() const { return static_cast<uint32_t>(_frameBase); }
+    VkBuffer GetBuffer() const { return _buffer; }
+
+    VkDeviceSize GetBytesPerFrame() const { return _bytesPerFrame; }
+    VkDeviceSize GetFrameBytesUsed() const { return _frameOffset.load(std::memory_order_relaxed); }
+    VkDeviceSize GetPeakBytesUsed() const { return _peakBytesUsed; }
+
+private:
+    void CreateDescriptors();
+
+    VulkanDevice& _device;
+    const uint32_t _framesInFlight;
+    VkDeviceSize _alignment;
+    VkDeviceSize _bytesPerFrame; // Rounded up to _alignment
+
+    VkBuffer _buffer = VK_NULL_HANDLE;
+    VulkanAllocation _memory;
+
+    VkDescriptorSetLayout _setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet _descriptorSet = VK_NULL_HANDLE;
+
+    VkDeviceSize _frameBase = 0;   // Start of the current partition
+    std::atomic<VkDeviceSize> _frameOffset = 0; // Bytes used in it so far
+    VkDeviceSize _peakBytesUsed = 0;
+};
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,356 @@
+// Include dependent class definitions *before* the namespace
+#include "../vulkan/VulkanDevice.h"
+#include "../vulkan/VulkanTimeline.h"
+
+#include "UploadManager.h" // Include own header after dependencies
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace VulkanApp::Rendering {
+
+namespace {
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+UploadManager::UploadManager(VulkanDevice& device, VkDeviceSize stagingSize)
+    : _device(device),
+      _ownershipTransfer(device.getTransferFamily() != device.getQueueFamilyIndices().graphicsFamily.value()),
+      _transferFamily(device.getTransferFamily()),
+      _graphicsFamily(device.getQueueFamilyIndices().graphicsFamily.value()),
+      _stagingSize(stagingSize)
+{
+    // 16 covers every texel block size, and the 4-byte rule for buffer copies
+    _copyAlignment = std::max<VkDeviceSize>(16, device.getProperties().limits.optimalBufferCopyOffsetAlignment);
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = _stagingSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    _stagingBuffer = _device.getAllocator().createBuffer(bufferInfo, MemoryUsage::CpuToGpu, _stagingMemory);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = _transferFamily;
+    VkResult result = vkCreateCommandPool(_device.getDevice(), &poolInfo, nullptr, &_commandPool);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload command pool! Error: " + std::to_string(result));
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = _commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    for (Batch& batch : _batches) {
+        result = vkAllocateCommandBuffers(_device.getDevice(), &allocInfo, &batch.commandBuffer);
+        if (result != VK_SUCCESS) throw std::runtime_error("Failed to allocate upload command buffer! Error: " + std::to_string(result));
+    }
+    _timeline = std::make_unique<VulkanTimeline>(_device.getDevice());
+
+    std::cout << "Upload manager created (" << (_stagingSize >> 20) << " MiB staging ring, queue family "
+              << _transferFamily << (_ownershipTransfer ? ", ownership transfers" : "") << ")." << std::endl;
+}
+
+UploadManager::~UploadManager()
+{
+    VkDevice device = _device.getDevice();
+    _timeline->wait(_lastFlushedBatch); // Batches complete in submission order
+    _timeline.reset();
+    vkDestroyCommandPool(device, _commandPool, nullptr); // Frees the batch command buffers
+    _device.getAllocator().destroyBuffer(_stagingBuffer, _stagingMemory);
+}
+
+// --- Producer side (any thread) ---
+
+// Reserves contiguous ring space; a request that would straddle the end skips
+// to the start instead. Fails (without blocking) while in-flight data is in the way.
+bool UploadManager::AllocateStaging(VkDeviceSize size, VkDeviceSize& offset)
+{
+    if (size == 0 || size > _stagingSize) {
+        return false;
+    }
+    uint64_t head = AlignUp(_ringHead, _copyAlignment);
+    VkDeviceSize position = head % _stagingSize;
+    if (position + size > _stagingSize) {
+        head += _stagingSize - position;
+        position = 0;
+    }
+    if (head + size - _ringTail > _stagingSize) {
+        return false;
+    }
+    _ringHead = head + size;
+    offset = position;
+    return true;
+}
+
+UploadTicket UploadManager::UploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size,
+                                         VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    VkDeviceSize stagingOffset = 0;
+    if (!AllocateStaging(size, stagingOffset)) {
+        _stats.rejectedUploads++;
+        return 0;
+    }
+    std::memcpy(static_cast<char*>(_stagingMemory.mappedData) + stagingOffset, data, size);
+    _device.getAllocator().flush(_stagingMemory, stagingOffset, size);
+
+    BufferCopy copy{};
+    copy.dst = dst;
+    copy.region.srcOffset = stagingOffset;
+    copy.region.dstOffset = dstOffset;
+    copy.region.size = size;
+    copy.dstStage = dstStage;
+    copy.dstAccess = dstAccess;
+    _bufferCopies.push_back(copy);
+
+    _stats.uploads++;
+    _stats.bytesUploaded += size;
+    return _nextBatchId;
+}
+
+UploadTicket UploadManager::UploadImage(VkImage dst, VkImageAspectFlags aspect, uint32_t mipLevel, uint32_t arrayLayer,
+                                        VkExtent3D extent, const void* data, VkDeviceSize size,
+                                        VkImageLayout finalLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    VkDeviceSize stagingOffset = 0;
+    if (!AllocateStaging(size, stagingOffset)) {
+        _stats.rejectedUploads++;
+        return 0;
+    }
+    std::memcpy(static_cast<char*>(_stagingMemory.mappedData) + stagingOffset, data, size);
+    _device.getAllocator().flush(_stagingMemory, stagingOffset, size);
+
+    ImageCopy copy{};
+    copy.dst = dst;
+    copy.region.bufferOffset = stagingOffset;
+    copy.region.bufferRowLength = 0; // Tightly packed
+    copy.region.bufferImageHeight = 0;
+    copy.region.imageSubresource = {aspect, mipLevel, arrayLayer, 1};
+    copy.region.imageOffset = {0, 0, 0};
+    copy.region.imageExtent = extent;
+    copy.finalLayout = finalLayout;
+    copy.dstStage = dstStage;
+    copy.dstAccess = dstAccess;
+    _imageCopies.push_back(copy);
+
+    _stats.uploads++;
+    _stats.bytesUploaded += size;
+    return _nextBatchId;
+}
+
+// --- Render thread ---
+
+// Batches on one queue retire in submission order, so the ring tail only moves forward
+void UploadManager::ReclaimCompletedBatches()
+{
+    uint64_t completed = _timeline->getCompletedValue();
+    for (const Batch& batch : _batches) {
+        if (batch.timelineValue != 0 && batch.timelineValue <= completed) {
+            _ringTail = std::max(_ringTail, batch.ringHead);
+        }
+    }
+}
+
+UploadManager::FrameSync UploadManager::Flush()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ReclaimCompletedBatches();
+
+    // Anything not recorded by now was for a frame that never got submitted
+    _acquireBufferBarriers.clear();
+    _acquireImageBarriers.clear();
+    _acquireStages = 0;
+
+    if (_bufferCopies.empty() && _imageCopies.empty()) {
+        return {};
+    }
+
+    // Timeline waits never consume anything, so a completed batch can be reused
+    // even while the frame that waited on it is still in flight
+    auto slot = std::find_if(_batches.begin(), _batches.end(),
+                             [this](const Batch& batch) { return _timeline->isComplete(batch.timelineValue); });
+    if (slot == _batches.end()) {
+        _stats.deferredFlushes++; // Copies stay queued until a batch retires
+        return {};
+    }
+    Batch& batch = *slot;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkResetCommandBuffer(batch.commandBuffer, 0);
+    VkResult result = vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin upload command buffer! Error: " + std::to_string(result));
+    }
+
+    // Uploaded subresources are overwritten whole, so their old contents can be discarded
+    std::vector<VkImageMemoryBarrier> toTransfer;
+    toTransfer.reserve(_imageCopies.size());
+    for (const ImageCopy& copy : _imageCopies) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = copy.dst;
+        barrier.subresourceRange = {copy.region.imageSubresource.aspectMask, copy.region.imageSubresource.mipLevel, 1,
+                                    copy.region.imageSubresource.baseArrayLayer, 1};
+        toTransfer.push_back(barrier);
+    }
+    if (!toTransfer.empty()) {
+        vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                             0, nullptr, 0, nullptr, static_cast<uint32_t>(toTransfer.size()), toTransfer.data());
+    }
+
+    for (const BufferCopy& copy : _bufferCopies) {
+        vkCmdCopyBuffer(batch.commandBuffer, _stagingBuffer, copy.dst, 1, &copy.region);
+    }
+    for (const ImageCopy& copy : _imageCopies) {
+        vkCmdCopyBufferToImage(batch.commandBuffer, _stagingBuffer, copy.dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+    }
+
+    // Release: with separate families this is the first half of the ownership
+    // transfer (the graphics queue acquires in RecordAcquireBarriers). Either way
+    // the timeline signal/wait makes the copies visible to the waiting stages.
+    uint32_t srcFamily = _ownershipTransfer ? _transferFamily : VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dstFamily = _ownershipTransfer ? _graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+    std::vector<VkBufferMemoryBarrier> releaseBuffers;
+    std::vector<VkImageMemoryBarrier> releaseImages;
+    for (const BufferCopy& copy : _bufferCopies) {
+        _acquireStages |= copy.dstStage;
+        if (!_ownershipTransfer) {
+            continue; // Nothing to hand over, and no layout to change
+        }
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0; // Ignored on the releasing queue
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        barrier.buffer = copy.dst;
+        barrier.offset = copy.region.dstOffset;
+        barrier.size = copy.region.size;
+        releaseBuffers.push_back(barrier);
+
+        barrier.srcAccessMask = 0; // Ignored on the acquiring queue
+        barrier.dstAccessMask = copy.dstAccess;
+        _acquireBufferBarriers.push_back(barrier);
+    }
+    for (size_t i = 0; i < _imageCopies.size(); i++) {
+        const ImageCopy& copy = _imageCopies[i];
+        _acquireStages |= copy.dstStage;
+        VkImageMemoryBarrier barrier = toTransfer[i];
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = copy.finalLayout;
+        barrier.srcQueueFamilyIndex = srcFamily;
+        barrier.dstQueueFamilyIndex = dstFamily;
+        releaseImages.push_back(barrier);
+
+        if (_ownershipTransfer) {
+            // Both halves must describe the same layout transition
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = copy.dstAccess;
+            _acquireImageBarriers.push_back(barrier);
+        }
+    }
+    if (!releaseBuffers.empty() || !releaseImages.empty()) {
+        vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                             0, nullptr, static_cast<uint32_t>(releaseBuffers.size()), releaseBuffers.data(),
+                             static_cast<uint32_t>(releaseImages.size()), releaseImages.data());
+    }
+
+    result = vkEndCommandBuffer(batch.commandBuffer);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record upload command buffer! Error: " + std::to_string(result));
+    }
+
+    // The batch id doubles as its timeline value
+    uint64_t signalValue = _nextBatchId;
+    VkSemaphore timeline = _timeline->getSemaphore();
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &timeline;
+
+    // Only the render thread submits, so a transfer queue shared with graphics needs no lock
+    result = vkQueueSubmit(_device.getTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit upload batch! Error: " + std::to_string(result));
+    }
+
+    batch.ringHead = _ringHead;
+    batch.timelineValue = signalValue;
+    _bufferCopies.clear();
+    _imageCopies.clear();
+    _lastFlushedBatch = _nextBatchId++;
+    _stats.batchesSubmitted++;
+
+    if (_acquireStages == 0) {
+        _acquireStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+    return {timeline, signalValue, _acquireStages};
+}
+
+void UploadManager::RecordAcquireBarriers(VkCommandBuffer commandBuffer)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_acquireBufferBarriers.empty() && _acquireImageBarriers.empty()) {
+        return;
+    }
+    // The source stages match the semaphore wait stages so the acquire chains after it
+    vkCmdPipelineBarrier(commandBuffer, _acquireStages, _acquireStages, 0, 0, nullptr,
+                         static_cast<uint32_t>(_acquireBufferBarriers.size()), _acquireBufferBarriers.data(),
+                         static_cast<uint32_t>(_acquireImageBarriers.size()), _acquireImageBarriers.data());
+    _acquireBufferBarriers.clear();
+    _acquireImageBarriers.clear();
+}
+
+bool UploadManager::IsReady(UploadTicket ticket) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return ticket != 0 && ticket <= _lastFlushedBatch;
+}
+
+bool UploadManager::IsComplete(UploadTicket ticket) const
+{
+    return ticket != 0 && _timeline->isComplete(ticket);
+}
+
+UploadTicket UploadManager::GetLastTicket() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _bufferCopies.empty() && _imageCopies.empty() ? _lastFlushedBatch : _nextBatchId;
+}
+
+UploadStats UploadManager::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "../vulkan/VulkanMemoryAllocator.h"
+
+// Forward declarations (global namespace)
+class VulkanDevice;
+class VulkanTimeline;
+
+namespace VulkanApp::Rendering {
+
+// Identifies the batch an upload went into, which is also the value the
+// transfer timeline reaches when the batch completes; 0 = not accepted
+using UploadTicket = uint64_t;
+
+struct UploadStats {
+    uint64_t bytesUploaded = 0;
+    uint64_t uploads = 0;
+    uint64_t batchesSubmitted = 0;
+    uint64_t rejectedUploads = 0;  // Staging ring full, caller retries
+    uint64_t deferredFlushes = 0;  // Every batch slot busy at Flush
+};
+
+// Streams data to device-local buffers and images on the transfer queue.
+// Upload* copies into a persistently mapped staging ring (any thread); the
+// render thread's Flush() records the queued copies into one batch and submits
+// it to the transfer queue, which signals the batch's value on the transfer
+// timeline; the next graphics submit waits for that value. With a dedicated
+// transfer family, resources are released by the transfer queue and acquired
+// by RecordAcquireBarriers on the graphics queue.
+// Nothing here waits on the GPU; a full ring rejects uploads instead.
+class UploadManager {
+public:
+    static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 32ull * 1024 * 1024;
+    static constexpr uint32_t MAX_BATCHES_IN_FLIGHT = 4;
+
+    // Timeline wait for the graphics submit that consumes a flush
+    struct FrameSync {
+        VkSemaphore waitSemaphore = VK_NULL_HANDLE; // The transfer timeline, or null if nothing was flushed
+        uint64_t waitValue = 0;
+        VkPipelineStageFlags waitStages = 0;
+    };
+
+    UploadManager(VulkanDevice& device, VkDeviceSize stagingSize = DEFAULT_STAGING_SIZE);
+    ~UploadManager(); // Waits for batches still on the GPU
+
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+
+    // Thread-safe. dstStage/dstAccess describe the first graphics use. The
+    // destination must be VK_SHARING_MODE_EXCLUSIVE and not in use by the GPU.
+    UploadTicket UploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size,
+                              VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+    // Uploads one mip level / array layer (tightly packed texels). The
+    // subresource ends up in finalLayout.
+    UploadTicket UploadImage(VkImage dst, VkImageAspectFlags aspect, uint32_t mipLevel, uint32_t arrayLayer,
+                             VkExtent3D extent, const void* data, VkDeviceSize size,
+                             VkImageLayout finalLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+    // Render thread, once per frame before recording. Submits everything
+    // queued since the last flush; the frame's graphics submit must wait for
+    // the returned timeline value (nothing to wait for if the semaphore is null).
+    FrameSync Flush();
+
+    // Render thread: records the acquire half of the ownership transfers from
+    // the last Flush into the frame's graphics command buffer
+    void RecordAcquireBarriers(VkCommandBuffer commandBuffer);
+
+    // True once the ticket's data is visible to graphics work recorded after
+    // the Flush/RecordAcquireBarriers that carried it
+    bool IsReady(UploadTicket ticket) const;
+    // True once the ticket's copies have finished on the transfer queue. Thread-safe.
+    bool IsComplete(UploadTicket ticket) const;
+    // Ticket that completes once every upload accepted so far has finished,
+    // including copies a deferred Flush still holds; 0 if there were none
+    UploadTicket GetLastTicket() const;
+
+    const VulkanTimeline& GetTimeline() const { return *_timeline; }
+    // Largest single upload the ring can ever accept
+    VkDeviceSize GetStagingSize() const { return _stagingSize; }
+
+    UploadStats GetStats() const;
+
+private:
+    struct BufferCopy {
+        VkBuffer dst;
+        VkBufferCopy region;
+        VkPipelineStageFlags dstStage;
+        VkAccessFlags dstAccess;
+    };
+    struct ImageCopy {
+        VkImage dst;
+        VkBufferImageCopy region;
+        VkImageLayout finalLayout;
+        VkPipelineStageFlags dstStage;
+        VkAccessFlags dstAccess;
+    };
+    struct Batch {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        uint64_t timelineValue = 0; // Signaled when the batch completes; 0 = never submitted
+        uint64_t ringHead = 0;      // Ring position after this batch's data
+    };
+
+    bool AllocateStaging(VkDeviceSize size, VkDeviceSize& offset);
+    void ReclaimCompletedBatches();
+
+    VulkanDevice& _device;
+    const bool _ownershipTransfer; // Transfer and graphics families differ
+    const uint32_t _transferFamily;
+    const uint32_t _graphicsFamily;
+
+    // Staging ring: monotonic byte counters, position = counter % size
+    VkBuffer _stagingBuffer = VK_NULL_HANDLE;
+    VulkanAllocation _stagingMemory;
+    VkDeviceSize _stagingSize;
+    VkDeviceSize _copyAlignment;
+    uint64_t _ringHead = 0;
+    uint64_t _ringTail = 0;
+
+    VkCommandPool _commandPool = VK_NULL_HANDLE;
+    std::array<Batch, MAX_BATCHES_IN_FLIGHT> _batches;
+    std::unique_ptr<VulkanTimeline> _timeline; // Counts completed batches
+
+    // Queued since the last Flush
+    std::vector<BufferCopy> _bufferCopies;
+    std::vector<ImageCopy> _imageCopies;
+
+    // Acquire barriers for the graphics queue from the last Flush
+    std::vector<VkBufferMemoryBarrier> _acquireBufferBarriers;
+    std::vector<VkImageMemoryBarrier> _acquireImageBarriers;
+    VkPipelineStageFlags _acquireStages = 0;
+
+    uint64_t _nextBatchId = 1;      // Ticket handed to uploads queued now
+    uint64_t _lastFlushedBatch = 0; // Last value submitted to the timeline
+    UploadStats _stats;
+
+    mutable std::mutex _mutex;
+};
+
+} // namespace VulkanApp::Rendering
@@ -0,0 +1,150 @@
+// MeshConverter: offline import of source meshes into .vkmesh files (see
+// src/assets/MeshFile.h), so the engine never parses text at load time.
+// Meshes are optimized for the vertex caches on the way (MeshOptimizer.h) and
+// optionally quantized; the cache statistics before and after are printed.
+
+#include "assets/MeshFile.h"
+#include "assets/MeshOptimizer.h"
+#include "assets/ObjParser.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+void PrintConverterUsage(const std::string& programName)
+{
+  std::cerr << "Usage: " << programName << " [options] INPUT.obj OUTPUT.vkmesh\n"
+            << "Converts a Wavefront OBJ (v/vt/vn/f, o/g/usemtl submeshes) to the engine's mapped mesh format.\n"
+            << "Options:\n"
+            << "  --no-optimize           Keep the source's triangle and vertex order\n"
+            << "  --quantize              Half positions and texcoords, octahedral normals, 10-bit tangents\n"
+            << "  --float-positions       With --quantize, keep 32-bit float positions (large meshes)\n";
+}
+
+void PrintCacheStats(const char* label, const VulkanApp::Assets::MeshCacheStats& stats)
+{
+  std::cout << "  " << label << std::fixed << std::setprecision(3) << ": ACMR " << stats.acmr << ", ATVR "
+            << stats.atvr << ", overfetch " << stats.overfetch << std::defaultfloat << std::endl;
+}
+
+uint32_t BytesPerVertex(const VulkanApp::Assets::MeshData& mesh)
+{
+  uint32_t size = 0;
+  for (const VulkanApp::Assets::MeshData::Stream& stream : mesh.streams)
+  {
+    size += VulkanApp::Assets::GetVertexFormatSize(stream.format);
+  }
+  return size;
+}
+
+std::string Extension(const std::string& path)
+{
+  std::string extension = std::filesystem::path(path).extension().string();
+  for (char& c : extension)
+  {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return extension;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  using namespace VulkanApp::Assets;
+
+  bool optimize = true;
+  bool quantize = false;
+  QuantizeOptions quantizeOptions;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--no-optimize")
+    {
+      optimize = false;
+    }
+    else if (arg == "--quantize")
+    {
+      quantize = true;
+    }
+    else if (arg == "--float-positions")
+    {
+      quantizeOptions.positions = false;
+    }
+    else if (arg.starts_with("--"))
+    {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      PrintConverterUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    else
+    {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.size() != 2)
+  {
+    PrintConverterUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  const std::string input = paths[0];
+  const std::string output = paths[1];
+
+  try
+  {
+    const std::string extension = Extension(input);
+    if (extension != ".obj")
+    {
+      // glTF import needs a JSON parser, which the project does not depend on yet
+      throw std::runtime_error("Unsupported input format '" + extension + "' (only .obj is supported)");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MeshData mesh = LoadObj(input);
+    const MeshCacheStats before = AnalyzeMesh(mesh);
+    const uint32_t bytesBefore = BytesPerVertex(mesh);
+    if (optimize)
+    {
+      OptimizeMesh(mesh);
+    }
+    const MeshCacheStats after = AnalyzeMesh(mesh);
+    if (quantize)
+    {
+      QuantizeMesh(mesh, quantizeOptions);
+    }
+    WriteMeshFile(mesh, output);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Re-open the result so a bad write fails here rather than at load time
+    MeshFile file(output);
+    std::cout << input << " -> " << output << ": " << file.GetVertexCount() << " vertices, "
+              << file.GetIndexCount() / 3 << " triangles, " << file.GetSubmeshes().size() << " submeshes, "
+              << (file.GetIndexType() == IndexType::Uint16 ? 16 : 32) << "-bit indices, " << file.GetFileSize()
+              << " bytes (" << ms << " ms)" << std::endl;
+    PrintCacheStats("source", before);
+    if (optimize)
+    {
+      PrintCacheStats("optimized", after);
+    }
+    for (const MeshStreamDesc& stream : file.GetStreams())
+    {
+      std::cout << "  " << GetVertexSemanticName(static_cast<VertexSemantic>(stream.semantic)) << ": "
+                << GetVertexFormatName(static_cast<VertexFormat>(stream.format)) << std::endl;
+    }
+    std::cout << "  " << bytesBefore << " -> " << BytesPerVertex(mesh) << " bytes per vertex" << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "FATAL ERROR: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
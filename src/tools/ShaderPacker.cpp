@@ -0,0 +1,184 @@
+// ShaderPacker: build-time packing of the compiled SPIR-V into one .vkshaders
+// archive (see src/assets/ShaderArchive.h), reflected on the way so pipeline
+// layouts can be derived from the shaders. With --embed it also writes a C++
+// source holding the archive, which the renderer links in instead of reading
+// shader files at startup.
+
+#include "assets/ShaderArchive.h"
+#include "assets/SpirvReflection.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+void PrintPackerUsage(const std::string& programName)
+{
+  std::cerr << "Usage: " << programName << " [options] OUTPUT.vkshaders NAME=INPUT.spv...\n"
+            << "Packs compiled shaders into an indexed archive, looked up by NAME (e.g. shader.vert=vert.spv).\n"
+            << "Options:\n"
+            << "  --embed OUTPUT.cpp      Also write the archive as C++ data for GetEmbeddedShaderArchive()\n";
+}
+
+std::vector<uint32_t> ReadSpirv(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+  {
+    throw std::runtime_error("Failed to open file: " + path);
+  }
+  const std::streamsize size = file.tellg();
+  if (size <= 0 || size % sizeof(uint32_t) != 0)
+  {
+    throw std::runtime_error(path + " is not SPIR-V (size is not a multiple of 4 bytes)");
+  }
+  std::vector<uint32_t> code(static_cast<size_t>(size) / sizeof(uint32_t));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(code.data()), size);
+  if (!file)
+  {
+    throw std::runtime_error("Failed to read file: " + path);
+  }
+  return code;
+}
+
+// Only rewrites the file when its content changes, so an unchanged archive
+// does not recompile and relink everything that embeds it
+void WriteIfChanged(const std::string& path, const std::string& content)
+{
+  {
+    std::ifstream existing(path, std::ios::binary);
+    std::ostringstream current;
+    current << existing.rdbuf();
+    if (existing && current.str() == content)
+    {
+      return;
+    }
+  }
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file << content;
+  file.close();
+  if (!file)
+  {
+    throw std::runtime_error("Failed to write file: " + path);
+  }
+}
+
+std::string EmbedArchive(const std::vector<std::byte>& archive, size_t shaderCount)
+{
+  std::ostringstream source;
+  source << "// Generated by ShaderPacker from " << shaderCount << " shaders. Do not edit.\n\n"
+         << "#include <cstddef>\n#include <span>\n\n"
+         << "namespace VulkanApp::Rendering {\n\n"
+         << "namespace {\n"
+         << "// Aligned for the archive's in-place tables\n"
+         << "alignas(16) constexpr unsigned char SHADER_ARCHIVE[" << archive.size() << "] = {";
+  for (size_t i = 0; i < archive.size(); i++)
+  {
+    source << (i % 16 == 0 ? "\n    " : " ") << "0x" << std::hex << std::setw(2) << std::setfill('0')
+           << static_cast<unsigned>(archive[i]) << ",";
+  }
+  source << std::dec << "\n};\n} // namespace\n\n"
+         << "// Declared in src/rendering/ShaderLibrary.h\n"
+         << "std::span<const std::byte> GetEmbeddedShaderArchive()\n{\n"
+         << "    return std::as_bytes(std::span(SHADER_ARCHIVE));\n}\n\n"
+         << "} // namespace VulkanApp::Rendering\n";
+  return source.str();
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+  using namespace VulkanApp::Assets;
+
+  std::string embedPath;
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--embed" && i + 1 < argc)
+    {
+      embedPath = argv[++i];
+    }
+    else if (arg.starts_with("--"))
+    {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      PrintPackerUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    else
+    {
+      args.push_back(arg);
+    }
+  }
+  if (args.size() < 2)
+  {
+    PrintPackerUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  const std::string output = args[0];
+
+  try
+  {
+    std::vector<ShaderSource> shaders;
+    for (size_t i = 1; i < args.size(); i++)
+    {
+      const size_t separator = args[i].find('=');
+      if (separator == 0 || separator == std::string::npos)
+      {
+        throw std::runtime_error("Expected NAME=INPUT.spv, got '" + args[i] + "'");
+      }
+      const std::string input = args[i].substr(separator + 1);
+      try
+      {
+        shaders.push_back({args[i].substr(0, separator), ReadSpirv(input)});
+        ReflectSpirv(shaders.back().code);
+      }
+      catch (const std::exception& e)
+      {
+        throw std::runtime_error(input + ": " + e.what());
+      }
+    }
+
+    const std::vector<std::byte> archive = BuildShaderArchive(std::move(shaders));
+    WriteShaderArchive(archive, output);
+    if (!embedPath.empty())
+    {
+      WriteIfChanged(embedPath, EmbedArchive(archive, args.size() - 1));
+    }
+
+    // Re-open the result so a bad write fails the build rather than startup
+    ShaderArchive file(output);
+    std::cout << output << ": " << file.GetShaders().size() << " shaders, " << file.GetSize() << " bytes"
+              << std::endl;
+    for (const ShaderArchiveEntry& shader : file.GetShaders())
+    {
+      const ShaderReflection reflection = file.GetReflection(shader);
+      std::cout << "  " << shader.name << " (" << GetShaderStageName(reflection.stage) << ", " << shader.codeSize
+                << " bytes): " << reflection.bindings.size() << " bindings, " << reflection.pushConstantSize
+                << " push constant bytes" << std::endl;
+      for (const ShaderBinding& binding : reflection.bindings)
+      {
+        std::cout << "    set " << binding.set << " binding " << binding.binding << ": "
+                  << GetDescriptorTypeName(binding.type);
+        if (binding.count != 1)
+        {
+          std::cout << (binding.count == 0 ? "[]" : "[" + std::to_string(binding.count) + "]");
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << "FATAL ERROR: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
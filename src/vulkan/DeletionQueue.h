@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+// Deferred destruction of Vulkan objects that in-flight frames may still use.
+// Each entry is tagged with the last frame number that may reference it and is
+// destroyed once that frame is known to have completed on the GPU (the
+// Renderer's frame timeline has passed it), so retiring resources (e.g. on
+// swap chain recreation) never needs vkDeviceWaitIdle.
+class DeletionQueue
+{
+public:
+  DeletionQueue() = default;
+  ~DeletionQueue() { flushAll(); }
+
+  DeletionQueue(const DeletionQueue&) = delete;
+  DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+  // Entries must be pushed with non-decreasing frame numbers
+  void push(uint64_t lastUsingFrame, std::function<void()> deleter)
+  {
+    _entries.push_back({lastUsingFrame, std::move(deleter)});
+  }
+
+  // Destroys everything last used by a frame <= completedFrame
+  void flush(uint64_t completedFrame)
+  {
+    while (!_entries.empty() && _entries.front().lastUsingFrame <= completedFrame)
+    {
+      auto deleter = std::move(_entries.front().deleter);
+      _entries.pop_front();
+      deleter();
+    }
+  }
+
+  // Only safe once the device is idle
+  void flushAll()
+  {
+    while (!_entries.empty())
+    {
+      auto deleter = std::move(_entries.front().deleter);
+      _entries.pop_front();
+      deleter();
+    }
+  }
+
+  size_t size() const { return _entries.size(); }
+
+private:
+  struct Entry
+  {
+    uint64_t lastUsingFrame;
+    std::function<void()> deleter;
+  };
+  std::deque<Entry> _entries;
+};
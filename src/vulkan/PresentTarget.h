@@ -0,0 +1,47 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <vector>
+
+class DeletionQueue;
+
+// Common interface for anything the Renderer can draw into and "present".
+// Implemented by VulkanSwapChain (window surface) and VulkanOffscreenTarget
+// (headless image ring, no surface or display server required).
+class PresentTarget
+{
+public:
+  virtual ~PresentTarget() = default;
+
+  // Image properties used to build render passes and framebuffers
+  virtual VkFormat getImageFormat() const = 0;
+  virtual VkExtent2D getExtent() const = 0;
+  virtual const std::vector<VkImage>& getImages() const = 0;
+  virtual const std::vector<VkImageView>& getImageViews() const = 0;
+
+  // Layout the images must be left in at the end of the frame
+  virtual VkImageLayout getFinalLayout() const = 0;
+
+  // Headless targets neither signal the acquire semaphore nor wait on the
+  // render-finished semaphore, so the Renderer must not submit them.
+  virtual bool isHeadless() const = 0;
+
+  // Returns VK_SUCCESS, VK_SUBOPTIMAL_KHR or VK_ERROR_OUT_OF_DATE_KHR like vkAcquireNextImageKHR
+  virtual VkResult acquireNextImage(VkSemaphore imageAvailable, uint32_t& imageIndex) = 0;
+  virtual VkResult present(VkQueue presentQueue, VkSemaphore renderFinished, uint32_t imageIndex) = 0;
+
+  // Frame pacing. Presents are numbered 1, 2, ...; getLastPresentId is 0 before
+  // the first one. waitForPresent returns VK_SUCCESS once that present is on
+  // screen, VK_TIMEOUT if it is not yet (a zero timeout polls). Only usable
+  // when supportsPresentWait() is true.
+  virtual bool supportsPresentWait() const = 0;
+  virtual uint64_t getLastPresentId() const = 0;
+  virtual VkResult waitForPresent(uint64_t presentId, uint64_t timeoutNs) = 0;
+
+  // Rebuilds the images after a resize/out-of-date. The retired images and
+  // views are handed to the deletion queue instead of waiting for the GPU.
+  // Returns false if nothing was rebuilt (e.g. minimized window, fixed-size target).
+  virtual bool recreate(DeletionQueue& retired, uint64_t lastUsingFrame) = 0;
+};
@@ -0,0 +1,349 @@
+#include "TlsfAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+TlsfAllocator::TlsfAllocator(uint64_t size) : _size(size)
+{
+  if (size == 0)
+  {
+    throw std::runtime_error("TlsfAllocator size must be non-zero!");
+  }
+  for (auto& heads : _freeHeads)
+  {
+    std::fill(std::begin(heads), std::end(heads), NIL);
+  }
+
+  uint32_t first = newBlock();
+  _blocks[first].offset = 0;
+  _blocks[first].size = size;
+  insertFree(first);
+}
+
+// Size class of a block. Sizes below SL_COUNT map exactly into level 0;
+// larger sizes use their top SL_LOG2 + 1 bits.
+void TlsfAllocator::mapping(uint64_t size, uint32_t& fl, uint32_t& sl)
+{
+  if (size < SL_COUNT)
+  {
+    fl = 0;
+    sl = static_cast<uint32_t>(size);
+    return;
+  }
+  uint32_t msb = 63 - static_cast<uint32_t>(std::countl_zero(size));
+  fl = msb - SL_LOG2 + 1;
+  sl = static_cast<uint32_t>(size >> (msb - SL_LOG2)) - SL_COUNT;
+}
+
+// Smallest free block guaranteed to hold size bytes (good fit, not best fit)
+uint32_t TlsfAllocator::findFreeBlock(uint64_t size) const
+{
+  // Round up to the next size class so every block in the found list fits
+  if (size >= SL_COUNT)
+  {
+    uint32_t msb = 63 - static_cast<uint32_t>(std::countl_zero(size));
+    uint64_t roundUp = (1ull << (msb - SL_LOG2)) - 1;
+    if (size > UINT64_MAX - roundUp)
+    {
+      return NIL;
+    }
+    size += roundUp;
+  }
+
+  uint32_t fl, sl;
+  mapping(size, fl, sl);
+  if (fl >= FL_COUNT)
+  {
+    return NIL;
+  }
+
+  uint32_t slMap = _slBitmaps[fl] & (~0u << sl);
+  if (slMap == 0)
+  {
+    uint64_t flMap = (fl + 1 < 64) ? (_flBitmap & (~0ull << (fl + 1))) : 0;
+    if (flMap == 0)
+    {
+      return NIL;
+    }
+    fl = static_cast<uint32_t>(std::countr_zero(flMap));
+    slMap = _slBitmaps[fl];
+  }
+  sl = static_cast<uint32_t>(std::countr_zero(slMap));
+  return _freeHeads[fl][sl];
+}
+
+uint32_t TlsfAllocator::allocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+  if (size == 0)
+  {
+    return INVALID_HANDLE;
+  }
+  alignment = std::max<uint64_t>(alignment, 1);
+
+  // Try the natural size class first; only pay for worst-case padding if the
+  // found block cannot absorb it
+  uint32_t index = findFreeBlock(size);
+  if (index != NIL)
+  {
+    const Block& block = _blocks[index];
+    uint64_t aligned = (block.offset + alignment - 1) & ~(alignment - 1);
+    if (aligned + size > block.offset + block.size)
+    {
+      index = NIL;
+    }
+  }
+  if (index == NIL && alignment > 1)
+  {
+    index = findFreeBlock(size + alignment - 1);
+  }
+  if (index == NIL)
+  {
+    return INVALID_HANDLE;
+  }
+
+  removeFree(index);
+  uint64_t blockOffset = _blocks[index].offset;
+  uint64_t blockEnd = blockOffset + _blocks[index].size;
+  uint64_t aligned = (blockOffset + alignment - 1) & ~(alignment - 1);
+
+  // Leading padding becomes its own free block (the previous physical block
+  // is never free, free neighbours are always merged)
+  if (aligned > blockOffset)
+  {
+    uint32_t padding = newBlock();
+    Block& pad = _blocks[padding];
+    Block& block = _blocks[index];
+    pad.offset = blockOffset;
+    pad.size = aligned - blockOffset;
+    pad.prevPhysical = block.prevPhysical;
+    pad.nextPhysical = index;
+    if (pad.prevPhysical != NIL)
+    {
+      _blocks[pad.prevPhysical].nextPhysical = padding;
+    }
+    block.prevPhysical = padding;
+    block.offset = aligned;
+    block.size = blockEnd - aligned;
+    insertFree(padding);
+  }
+
+  // Trailing remainder goes back to the free lists
+  if (_blocks[index].size > size)
+  {
+    uint32_t remainder = newBlock();
+    Block& rest = _blocks[remainder];
+    Block& block = _blocks[index];
+    rest.offset = block.offset + size;
+    rest.size = block.size - size;
+    rest.prevPhysical = index;
+    rest.nextPhysical = block.nextPhysical;
+    if (rest.nextPhysical != NIL)
+    {
+      _blocks[rest.nextPhysical].prevPhysical = remainder;
+    }
+    block.nextPhysical = remainder;
+    block.size = size;
+    insertFree(remainder);
+  }
+
+  _blocks[index].free = false;
+  _usedBytes += size;
+  _allocationCount++;
+  offset = aligned;
+  return index;
+}
+
+void TlsfAllocator::free(uint32_t handle)
+{
+  if (handle >= _blocks.size() || _blocks[handle].free)
+  {
+    throw std::runtime_error("TlsfAllocator::free called with an invalid handle!");
+  }
+
+  _usedBytes -= _blocks[handle].size;
+  _allocationCount--;
+
+  // Merge with free physical neighbours
+  uint32_t prev = _blocks[handle].prevPhysical;
+  if (prev != NIL && _blocks[prev].free)
+  {
+    removeFree(prev);
+    Block& block = _blocks[handle];
+    block.offset = _blocks[prev].offset;
+    block.size += _blocks[prev].size;
+    block.prevPhysical = _blocks[prev].prevPhysical;
+    if (block.prevPhysical != NIL)
+    {
+      _blocks[block.prevPhysical].nextPhysical = handle;
+    }
+    releaseBlock(prev);
+  }
+
+  uint32_t next = _blocks[handle].nextPhysical;
+  if (next != NIL && _blocks[next].free)
+  {
+    removeFree(next);
+    Block& block = _blocks[handle];
+    block.size += _blocks[next].size;
+    block.nextPhysical = _blocks[next].nextPhysical;
+    if (block.nextPhysical != NIL)
+    {
+      _blocks[block.nextPhysical].prevPhysical = handle;
+    }
+    releaseBlock(next);
+  }
+
+  insertFree(handle);
+}
+
+TlsfAllocator::Stats TlsfAllocator::getStats() const
+{
+  Stats stats;
+  stats.totalSize = _size;
+  stats.usedBytes = _usedBytes;
+  stats.allocationCount = _allocationCount;
+
+  uint64_t flMap = _flBitmap;
+  while (flMap != 0)
+  {
+    uint32_t fl = static_cast<uint32_t>(std::countr_zero(flMap));
+    flMap &= flMap - 1;
+    uint32_t slMap = _slBitmaps[fl];
+    while (slMap != 0)
+    {
+      uint32_t sl = static_cast<uint32_t>(std::countr_zero(slMap));
+      slMap &= slMap - 1;
+      for (uint32_t i = _freeHeads[fl][sl]; i != NIL; i = _blocks[i].nextFree)
+      {
+        stats.freeBlockCount++;
+        stats.largestFreeBlock = std::max(stats.largestFreeBlock, _blocks[i].size);
+      }
+    }
+  }
+  return stats;
+}
+
+bool TlsfAllocator::validate() const
+{
+  // Find the first physical block
+  uint32_t first = NIL;
+  for (uint32_t i = 0; i < _blocks.size(); i++)
+  {
+    if (_blocks[i].size != 0 && _blocks[i].offset == 0)
+    {
+      first = i;
+      break;
+    }
+  }
+  if (first == NIL || _blocks[first].prevPhysical != NIL)
+  {
+    return false;
+  }
+
+  uint64_t expectedOffset = 0;
+  uint64_t used = 0;
+  uint64_t allocations = 0;
+  uint64_t freeBlocks = 0;
+  bool previousFree = false;
+  for (uint32_t i = first, prev = NIL; i != NIL; prev = i, i = _blocks[i].nextPhysical)
+  {
+    const Block& block = _blocks[i];
+    if (block.offset != expectedOffset || block.size == 0 || block.prevPhysical != prev)
+    {
+      return false;
+    }
+    if (block.free)
+    {
+      uint32_t fl, sl;
+      mapping(block.size, fl, sl);
+      if (previousFree || (_slBitmaps[fl] & (1u << sl)) == 0)
+      {
+        return false; // Unmerged neighbours or a free block missing from its list
+      }
+      freeBlocks++;
+    }
+    else
+    {
+      used += block.size;
+      allocations++;
+    }
+    previousFree = block.free;
+    expectedOffset += block.size;
+  }
+
+  Stats stats = getStats();
+  return expectedOffset == _size && used == _usedBytes && allocations == _allocationCount &&
+         freeBlocks == stats.freeBlockCount;
+}
+
+// --- Block bookkeeping ---
+
+uint32_t TlsfAllocator::newBlock()
+{
+  if (!_unusedBlocks.empty())
+  {
+    uint32_t index = _unusedBlocks.back();
+    _unusedBlocks.pop_back();
+    _blocks[index] = Block{};
+    return index;
+  }
+  _blocks.push_back(Block{});
+  return static_cast<uint32_t>(_blocks.size() - 1);
+}
+
+void TlsfAllocator::releaseBlock(uint32_t index)
+{
+  _blocks[index] = Block{}; // size 0 marks it unused for validate()
+  _unusedBlocks.push_back(index);
+}
+
+void TlsfAllocator::insertFree(uint32_t index)
+{
+  Block& block = _blocks[index];
+  uint32_t fl, sl;
+  mapping(block.size, fl, sl);
+
+  block.free = true;
+  block.prevFree = NIL;
+  block.nextFree = _freeHeads[fl][sl];
+  if (block.nextFree != NIL)
+  {
+    _blocks[block.nextFree].prevFree = index;
+  }
+  _freeHeads[fl][sl] = index;
+  _flBitmap |= 1ull << fl;
+  _slBitmaps[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::removeFree(uint32_t index)
+{
+  Block& block = _blocks[index];
+  uint32_t fl, sl;
+  mapping(block.size, fl, sl);
+
+  if (block.prevFree != NIL)
+  {
+    _blocks[block.prevFree].nextFree = block.nextFree;
+  }
+  else
+  {
+    _freeHeads[fl][sl] = block.nextFree;
+  }
+  if (block.nextFree != NIL)
+  {
+    _blocks[block.nextFree].prevFree = block.prevFree;
+  }
+  if (_freeHeads[fl][sl] == NIL)
+  {
+    _slBitmaps[fl] &= ~(1u << sl);
+    if (_slBitmaps[fl] == 0)
+    {
+      _flBitmap &= ~(1ull << fl);
+    }
+  }
+
+  block.free = false;
+  block.prevFree = NIL;
+  block.nextFree = NIL;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Two-level segregated fit (TLSF) placement over an abstract range [0, size).
+// Knows nothing about Vulkan: VulkanMemoryAllocator runs one per VkDeviceMemory
+// block. Allocation and free are O(1): the first level indexes power-of-two
+// size classes, the second splits each class into SL_COUNT linear sub-ranges,
+// and bitmaps find the smallest non-empty list that fits.
+class TlsfAllocator
+{
+public:
+  static constexpr uint32_t INVALID_HANDLE = UINT32_MAX;
+
+  struct Stats
+  {
+    uint64_t totalSize = 0;
+    uint64_t usedBytes = 0;
+    uint64_t allocationCount = 0;
+    uint64_t freeBlockCount = 0;
+    uint64_t largestFreeBlock = 0;
+
+    // 0 = all free space is one contiguous range, approaching 1 = badly split
+    double fragmentation() const
+    {
+      uint64_t freeBytes = totalSize - usedBytes;
+      return freeBytes == 0 ? 0.0 : 1.0 - static_cast<double>(largestFreeBlock) / static_cast<double>(freeBytes);
+    }
+  };
+
+  explicit TlsfAllocator(uint64_t size);
+
+  // Returns a handle and the aligned offset, or INVALID_HANDLE if nothing fits.
+  // alignment must be a power of two.
+  uint32_t allocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+  void free(uint32_t handle);
+
+  uint64_t getSize() const { return _size; }
+  bool isEmpty() const { return _allocationCount == 0; }
+  Stats getStats() const;
+
+  // Walks the physical block list and checks every invariant (used by the
+  // allocator benchmark suite and in debug builds)
+  bool validate() const;
+
+private:
+  static constexpr uint32_t SL_LOG2 = 5;
+  static constexpr uint32_t SL_COUNT = 1u << SL_LOG2;
+  static constexpr uint32_t FL_COUNT = 64 - SL_LOG2 + 1;
+  static constexpr uint32_t NIL = UINT32_MAX;
+
+  struct Block
+  {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t prevPhysical = NIL;
+    uint32_t nextPhysical = NIL;
+    uint32_t prevFree = NIL;
+    uint32_t nextFree = NIL;
+    bool free = false;
+  };
+
+  static void mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+  uint32_t findFreeBlock(uint64_t size) const;
+  uint32_t newBlock();
+  void releaseBlock(uint32_t index);
+  void insertFree(uint32_t index);
+  void removeFree(uint32_t index);
+
+  uint64_t _size;
+  uint64_t _usedBytes = 0;
+  uint64_t _allocationCount = 0;
+
+  std::vector<Block> _blocks;
+  std::vector<uint32_t> _unusedBlocks; // Recycled entries of _blocks
+
+  uint64_t _flBitmap = 0;
+  uint32_t _slBitmaps[FL_COUNT] = {};
+  uint32_t _freeHeads[FL_COUNT][SL_COUNT];
+};
@@ -1,5 +1,6 @@
 #include "VulkanDevice.h"
 #include "VulkanInstance.h" // Need access to VkInstance and VkSurfaceKHR
+#include "VulkanMemoryAllocator.h"
 
 #include <cstring>   // For strcmp
 #include <iostream>
@@ -15,10 +16,12 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance)
 {
   pickPhysicalDevice();
   createLogicalDevice();
+  _allocator = std::make_unique<VulkanMemoryAllocator>(_physicalDevice, _device);
 }
 
 VulkanDevice::~VulkanDevice()
 {
+  _allocator.reset(); // Frees its memory blocks while the device is still alive
   if (_device != VK_NULL_HANDLE)
   {
     vkDestroyDevice(_device, nullptr);
@@ -29,6 +32,22 @@ VulkanDevice::~VulkanDevice()
 
 // --- Public Methods --- (Accessors are inline in header)
 
+uint32_t VulkanDevice::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(_physicalDevice, &memProperties);
+
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+  {
+    if ((typeFilter & (1u << i)) &&
+        (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+    {
+      return i;
+    }
+  }
+  throw std::runtime_error("Failed to find suitable memory type!");
+}
+
 // --- Private Methods ---
 
 void VulkanDevice::pickPhysicalDevice()
@@ -55,6 +74,7 @@ void VulkanDevice::pickPhysicalDevice()
     if (isDeviceSuitable(device))
     {
       _physicalDevice = device;
+      _properties = properties;
       _indices = findQueueFamilies(_physicalDevice); // Store indices for selected device
        std::cout << " (Selected)" << std::endl;
       break; 
@@ -84,7 +104,22 @@ bool VulkanDevice::isDeviceSuitable(VkPhysicalDevice device)
      swapChainAdequate = true; // Simplified check for device suitability phase
   }
 
-  return indices.isComplete() && extensionsSupported && swapChainAdequate;
+  // Frame pacing, uploads and deferred deletion are tracked with timeline semaphores (core in 1.2)
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(device, &properties);
+  bool timelineSupported = false;
+  if (properties.apiVersion >= VK_API_VERSION_1_2)
+  {
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &vulkan12Features;
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+    timelineSupported = vulkan12Features.timelineSemaphore == VK_TRUE;
+  }
+
+  return indices.isComplete() && extensionsSupported && swapChainAdequate && timelineSupported;
 }
 
 QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device)
@@ -95,27 +130,51 @@ QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device)
   std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
   vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
+  std::optional<uint32_t> computeFamily; // Transfer-capable, no graphics
   int i = 0;
   for (const auto& queueFamily : queueFamilies)
   {
-    if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+    if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.graphicsFamily.has_value())
     {
       indices.graphicsFamily = i;
     }
 
     VkBool32 presentSupport = false;
-    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, _surface, &presentSupport);
-    if (presentSupport)
+    if (_surface != VK_NULL_HANDLE)
+    {
+      vkGetPhysicalDeviceSurfaceSupportKHR(device, i, _surface, &presentSupport);
+    }
+    else if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+    {
+      // Headless: nothing is presented, the graphics queue doubles as "present" queue
+      presentSupport = true;
+    }
+    if (presentSupport && !indices.presentFamily.has_value())
     {
       indices.presentFamily = i;
     }
 
-    if (indices.isComplete())
+    // Compute queues support transfers implicitly, even without the flag
+    bool transfer = (queueFamily.queueFlags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT)) != 0;
+    bool graphics = (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+    bool compute = (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) != 0;
+    if (transfer && !graphics)
     {
-      break;
+      if (!compute && !indices.transferFamily.has_value())
+      {
+        indices.transferFamily = i; // Dedicated DMA queue: best for uploads
+      }
+      else if (compute && !computeFamily.has_value())
+      {
+        computeFamily = i;
+      }
     }
     i++;
   }
+  if (!indices.transferFamily.has_value())
+  {
+    indices.transferFamily = computeFamily;
+  }
   return indices;
 }
 
@@ -126,7 +185,8 @@ bool VulkanDevice::checkDeviceExtensionSupport(VkPhysicalDevice device)
   std::vector<VkExtensionProperties> availableExtensions(extensionCount);
   vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-  std::set<std::string> requiredDevExtensionsSet(deviceExtensions.begin(), deviceExtensions.end());
+  std::vector<const char*> requiredExtensions = getRequiredDeviceExtensions();
+  std::set<std::string> requiredDevExtensionsSet(requiredExtensions.begin(), requiredExtensions.end());
 
   bool requiresPortabilitySubset = false;
   for (const auto& extension : availableExtensions) {
@@ -148,6 +208,15 @@ bool VulkanDevice::checkDeviceExtensionSupport(VkPhysicalDevice device)
   return requiredDevExtensionsSet.empty();
 }
 
+std::vector<const char*> VulkanDevice::getRequiredDeviceExtensions() const
+{
+  // Headless rendering never creates a swap chain
+  if (isHeadless())
+  {
+    return {};
+  }
+  return deviceExtensions;
+}
 
 void VulkanDevice::createLogicalDevice()
 {
@@ -159,7 +228,8 @@ void VulkanDevice::createLogicalDevice()
   std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
   std::set<uint32_t> uniqueQueueFamilies = {
       _indices.graphicsFamily.value(), 
-      _indices.presentFamily.value()
+      _indices.presentFamily.value(),
+      getTransferFamily()
   };
 
   float queuePriority = 1.0f;
@@ -173,25 +243,80 @@ void VulkanDevice::createLogicalDevice()
     queueCreateInfos.push_back(queueCreateInfo);
   }
 
-  VkPhysicalDeviceFeatures deviceFeatures{}; // Request no special features for now
-
-  VkDeviceCreateInfo createInfo{};
-  createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-  createInfo.pQueueCreateInfos = queueCreateInfos.data();
-  createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
-  createInfo.pEnabledFeatures = &deviceFeatures;
+  // Enable optional features only where supported; consumers check getEnabledFeatures()
+  VkPhysicalDeviceFeatures supportedFeatures;
+  vkGetPhysicalDeviceFeatures(_physicalDevice, &supportedFeatures);
+
+  VkPhysicalDeviceFeatures deviceFeatures{};
+  deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery; // GPU profiler
+  deviceFeatures.inheritedQueries = supportedFeatures.inheritedQueries; // Profiler scopes around secondary command buffers
+  deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect; // GPU culling: one indirect call for every draw
+  deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance; // GPU culling: object index
+  deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC; // GpuTexture: BCn without a CPU decode
+
+  // Required; checked by isDeviceSuitable
+  VkPhysicalDeviceVulkan12Features vulkan12Features{};
+  vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+  vulkan12Features.timelineSemaphore = VK_TRUE;
+
+  // Optional 1.2 feature: the GPU culling pass writes the draw count itself
+  VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+  supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+  VkPhysicalDeviceFeatures2 supportedFeatures2{};
+  supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  supportedFeatures2.pNext = &supportedVulkan12Features;
+  vkGetPhysicalDeviceFeatures2(_physicalDevice, &supportedFeatures2);
+  vulkan12Features.drawIndirectCount = supportedVulkan12Features.drawIndirectCount;
+
+  // Optional 1.2 descriptor indexing subset for the bindless descriptor table:
+  // runtime-sized, partially bound arrays of sampled images, samplers and
+  // storage buffers, updated after being bound and indexed per invocation
+  const bool descriptorIndexingSupported =
+      supportedFeatures.shaderSampledImageArrayDynamicIndexing == VK_TRUE &&
+      supportedFeatures.shaderStorageBufferArrayDynamicIndexing == VK_TRUE &&
+      supportedVulkan12Features.runtimeDescriptorArray == VK_TRUE &&
+      supportedVulkan12Features.descriptorBindingPartiallyBound == VK_TRUE &&
+      supportedVulkan12Features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+      supportedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+      supportedVulkan12Features.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE &&
+      supportedVulkan12Features.shaderSampledImageArrayNonUniformIndexing == VK_TRUE &&
+      supportedVulkan12Features.shaderStorageBufferArrayNonUniformIndexing == VK_TRUE;
+  if (descriptorIndexingSupported)
+  {
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+    deviceFeatures.shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
+    vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+    vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+    vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+    std::cout << "Enabling descriptor indexing (bindless descriptor table)." << std::endl;
+  }
 
   // Enable required device extensions, including portability if needed
-  std::vector<const char*> requiredDevExtensionsVec = deviceExtensions; 
+  std::vector<const char*> requiredDevExtensionsVec = getRequiredDeviceExtensions();
   uint32_t extCount;
   vkEnumerateDeviceExtensionProperties(_physicalDevice, nullptr, &extCount, nullptr);
   std::vector<VkExtensionProperties> availableExts(extCount);
   vkEnumerateDeviceExtensionProperties(_physicalDevice, nullptr, &extCount, availableExts.data());
   bool portabilityRequired = false;
+  bool presentIdAvailable = false;
+  bool presentWaitAvailable = false;
+  bool dynamicRenderingAvailable = false;
+  bool synchronization2Available = false;
   for (const auto& ext : availableExts) {
       if (strcmp(ext.extensionName, "VK_KHR_portability_subset") == 0) {
           portabilityRequired = true;
-          break;
+      } else if (strcmp(ext.extensionName, VK_KHR_PRESENT_ID_EXTENSION_NAME) == 0) {
+          presentIdAvailable = true;
+      } else if (strcmp(ext.extensionName, VK_KHR_PRESENT_WAIT_EXTENSION_NAME) == 0) {
+          presentWaitAvailable = true;
+      } else if (strcmp(ext.extensionName, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) == 0) {
+          dynamicRenderingAvailable = true;
+      } else if (strcmp(ext.extensionName, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) == 0) {
+          synchronization2Available = true;
       }
   }
   if (portabilityRequired) {
@@ -199,6 +324,83 @@ void VulkanDevice::createLogicalDevice()
        std::cout << "Enabling VK_KHR_portability_subset for logical device." << std::endl;
   }
 
+  // Optional: present IDs + waiting on them let the frame pacer block until a
+  // frame is actually on screen (only meaningful with a surface)
+  VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+  presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+  presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+  if (!isHeadless() && presentIdAvailable && presentWaitAvailable)
+  {
+    presentIdFeatures.pNext = &presentWaitFeatures;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &presentIdFeatures;
+    vkGetPhysicalDeviceFeatures2(_physicalDevice, &features2);
+    _presentWaitEnabled = presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE;
+  }
+
+  // Optional: begin rendering directly on image views, without render pass
+  // and framebuffer objects. Its dependencies (create_renderpass2,
+  // depth_stencil_resolve) are core in Vulkan 1.2.
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+  dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+  if (dynamicRenderingAvailable)
+  {
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &dynamicRenderingFeatures;
+    vkGetPhysicalDeviceFeatures2(_physicalDevice, &features2);
+    _dynamicRenderingEnabled = dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+  }
+
+  // Optional: 64-bit stage/access masks and one vkCmdPipelineBarrier2 for
+  // image and buffer barriers with per-barrier stages (BarrierBatcher)
+  VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+  synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+  if (synchronization2Available)
+  {
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &synchronization2Features;
+    vkGetPhysicalDeviceFeatures2(_physicalDevice, &features2);
+    _synchronization2Enabled = synchronization2Features.synchronization2 == VK_TRUE;
+  }
+
+  // Chain the enabled optional feature structs behind the required 1.2 features
+  void** featureChainTail = &vulkan12Features.pNext;
+  if (_presentWaitEnabled)
+  {
+    *featureChainTail = &presentIdFeatures; // Already chained to presentWaitFeatures
+    featureChainTail = &presentWaitFeatures.pNext;
+    requiredDevExtensionsVec.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    requiredDevExtensionsVec.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    std::cout << "Enabling VK_KHR_present_id and VK_KHR_present_wait." << std::endl;
+  }
+  if (_dynamicRenderingEnabled)
+  {
+    dynamicRenderingFeatures.pNext = nullptr;
+    *featureChainTail = &dynamicRenderingFeatures;
+    featureChainTail = &dynamicRenderingFeatures.pNext;
+    requiredDevExtensionsVec.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    std::cout << "Enabling VK_KHR_dynamic_rendering." << std::endl;
+  }
+  if (_synchronization2Enabled)
+  {
+    synchronization2Features.pNext = nullptr;
+    *featureChainTail = &synchronization2Features;
+    featureChainTail = &synchronization2Features.pNext;
+    requiredDevExtensionsVec.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+    std::cout << "Enabling VK_KHR_synchronization2." << std::endl;
+  }
+
+  VkDeviceCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+  createInfo.pNext = &vulkan12Features;
+  createInfo.pQueueCreateInfos = queueCreateInfos.data();
+  createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+  createInfo.pEnabledFeatures = &deviceFeatures;
+
   createInfo.enabledExtensionCount = static_cast<uint32_t>(requiredDevExtensionsVec.size());
   createInfo.ppEnabledExtensionNames = requiredDevExtensionsVec.data();
 
@@ -222,10 +424,34 @@ void VulkanDevice::createLogicalDevice()
     throw std::runtime_error("Failed to create logical device! Error code: " +
                              std::to_string(result));
   }
+  _enabledFeatures = deviceFeatures;
+  _drawIndirectCountEnabled = vulkan12Features.drawIndirectCount == VK_TRUE;
+  _descriptorIndexingEnabled = descriptorIndexingSupported;
+
+  if (_dynamicRenderingEnabled)
+  {
+    _cmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+        vkGetDeviceProcAddr(_device, "vkCmdBeginRenderingKHR"));
+    _cmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+        vkGetDeviceProcAddr(_device, "vkCmdEndRenderingKHR"));
+    if (_cmdBeginRendering == nullptr || _cmdEndRendering == nullptr)
+    {
+      _dynamicRenderingEnabled = false;
+    }
+  }
+  if (_synchronization2Enabled)
+  {
+    _cmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(
+        vkGetDeviceProcAddr(_device, "vkCmdPipelineBarrier2KHR"));
+    _synchronization2Enabled = _cmdPipelineBarrier2 != nullptr;
+  }
   std::cout << "Vulkan logical device created successfully." << std::endl;
 
   // Get the queue handles
   vkGetDeviceQueue(_device, _indices.graphicsFamily.value(), 0, &_graphicsQueue);
   vkGetDeviceQueue(_device, _indices.presentFamily.value(), 0, &_presentQueue);
-  std::cout << "Graphics and present queue handles obtained." << std::endl;
+  vkGetDeviceQueue(_device, getTransferFamily(), 0, &_transferQueue);
+  std::cout << "Graphics and present queue handles obtained"
+            << (hasDedicatedTransferQueue() ? " (dedicated transfer queue family " + std::to_string(getTransferFamily()) + ")" : "")
+            << "." << std::endl;
 } 
\ No newline at end of file
@@ -4,11 +4,13 @@
 #include <GLFW/glfw3.h>
 #include <vector>
 #include <optional>
+#include <memory>
 
 // Forward declarations
 class VulkanInstance;
+class VulkanMemoryAllocator;
 
-// Required device extensions
+// Required device extensions (only when presenting to a surface)
 const std::vector<const char*> deviceExtensions = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
     // Portability subset added dynamically if needed
@@ -19,6 +21,9 @@ struct QueueFamilyIndices
 {
   std::optional<uint32_t> graphicsFamily;
   std::optional<uint32_t> presentFamily;
+  // Optional: a family with transfer but no graphics (DMA engine), or failing
+  // that an async-compute family. Empty = uploads share the graphics queue.
+  std::optional<uint32_t> transferFamily;
 
   bool isComplete() const
   {
@@ -41,20 +46,68 @@ public:
   // Accessors
   VkPhysicalDevice getPhysicalDevice() const { return _physicalDevice; }
   VkDevice getDevice() const { return _device; }
+  const VkPhysicalDeviceProperties& getProperties() const { return _properties; }
+  const VkPhysicalDeviceFeatures& getEnabledFeatures() const { return _enabledFeatures; }
   VkQueue getGraphicsQueue() const { return _graphicsQueue; }
   VkQueue getPresentQueue() const { return _presentQueue; }
+  // The graphics queue when no separate transfer family exists
+  VkQueue getTransferQueue() const { return _transferQueue; }
+  uint32_t getTransferFamily() const { return _indices.transferFamily.value_or(_indices.graphicsFamily.value()); }
+  bool hasDedicatedTransferQueue() const { return _indices.transferFamily.has_value(); }
   const QueueFamilyIndices& getQueueFamilyIndices() const { return _indices; }
+  bool isHeadless() const { return _surface == VK_NULL_HANDLE; }
+  // VK_KHR_present_id + VK_KHR_present_wait were both supported and enabled
+  bool supportsPresentWait() const { return _presentWaitEnabled; }
+  // VK_KHR_dynamic_rendering was supported and enabled; the entry points below
+  // may only be called when it was
+  bool supportsDynamicRendering() const { return _dynamicRenderingEnabled; }
+  void cmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfoKHR& renderingInfo) const
+  {
+    _cmdBeginRendering(commandBuffer, &renderingInfo);
+  }
+  void cmdEndRendering(VkCommandBuffer commandBuffer) const { _cmdEndRendering(commandBuffer); }
+  // VK_KHR_synchronization2 was supported and enabled
+  bool supportsSynchronization2() const { return _synchronization2Enabled; }
+  void cmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfoKHR& dependencyInfo) const
+  {
+    _cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+  }
+
+  // Vulkan 1.2 drawIndirectCount was supported and enabled (vkCmdDrawIndexedIndirectCount)
+  bool supportsDrawIndirectCount() const { return _drawIndirectCountEnabled; }
+  // The Vulkan 1.2 descriptor indexing features BindlessTable needs were
+  // supported and enabled (update-after-bind, partially bound runtime arrays)
+  bool supportsDescriptorIndexing() const { return _descriptorIndexingEnabled; }
+
+  // Finds a memory type index matching the filter bits and property flags
+  uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+
+  // Sub-allocator for buffer and image memory; prefer it over vkAllocateMemory
+  VulkanMemoryAllocator& getAllocator() const { return *_allocator; }
 
 private:
   VkPhysicalDevice _physicalDevice = VK_NULL_HANDLE;
+  VkPhysicalDeviceProperties _properties{}; // Limits, timestamp period, IDs of the selected device
+  VkPhysicalDeviceFeatures _enabledFeatures{}; // Optional features turned on at device creation
+  bool _presentWaitEnabled = false;
+  bool _dynamicRenderingEnabled = false;
+  PFN_vkCmdBeginRenderingKHR _cmdBeginRendering = nullptr;
+  PFN_vkCmdEndRenderingKHR _cmdEndRendering = nullptr;
+  bool _synchronization2Enabled = false;
+  bool _drawIndirectCountEnabled = false;
+  bool _descriptorIndexingEnabled = false;
+  PFN_vkCmdPipelineBarrier2KHR _cmdPipelineBarrier2 = nullptr;
   VkDevice _device = VK_NULL_HANDLE;
   VkQueue _graphicsQueue = VK_NULL_HANDLE;
   VkQueue _presentQueue = VK_NULL_HANDLE;
+  VkQueue _transferQueue = VK_NULL_HANDLE;
 
   const VulkanInstance& _instanceRef; // Keep reference to instance
-  VkSurfaceKHR _surface; // Copy surface handle from instance
+  VkSurfaceKHR _surface; // Copy surface handle from instance (VK_NULL_HANDLE when headless)
   QueueFamilyIndices _indices;
 
+  std::unique_ptr<VulkanMemoryAllocator> _allocator; // Destroyed before the logical device
+
   void pickPhysicalDevice();
   void createLogicalDevice();
 
@@ -62,4 +115,5 @@ private:
   bool isDeviceSuitable(VkPhysicalDevice device);
   QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
   bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+  std::vector<const char*> getRequiredDeviceExtensions() const;
 }; 
\ No newline at end of file
@@ -8,11 +8,14 @@
 
 // --- Constructor / Destructor ---
 
-VulkanInstance::VulkanInstance(const Window& window) : _windowRef(window)
+VulkanInstance::VulkanInstance(const Window* window) : _window(window)
 {
   createInstance();
   setupDebugMessenger();
-  createSurface(); // Surface depends on instance and window
+  if (!isHeadless())
+  {
+    createSurface(); // Surface depends on instance and window
+  }
 }
 
 VulkanInstance::~VulkanInstance()
@@ -54,7 +57,7 @@ void VulkanInstance::createInstance()
   appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
   appInfo.pEngineName = "No Engine";
   appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-  appInfo.apiVersion = VK_API_VERSION_1_0;
+  appInfo.apiVersion = VK_API_VERSION_1_2; // Timeline semaphores
 
   VkInstanceCreateInfo createInfo{};
   createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -79,7 +82,10 @@ void VulkanInstance::createInstance()
     createInfo.pNext = nullptr;
   }
 
-  createInfo.flags |= VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
+  if (isInstanceExtensionAvailable(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME))
+  {
+    createInfo.flags |= VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
+  }
 
   VkResult result = vkCreateInstance(&createInfo, nullptr, &_instance);
   if (result != VK_SUCCESS)
@@ -109,7 +115,7 @@ void VulkanInstance::setupDebugMessenger()
 void VulkanInstance::createSurface()
 {
   // Use the referenced window object to create the surface
-  VkResult result = glfwCreateWindowSurface(_instance, _windowRef.getGLFWwindow(), nullptr, &_surface);
+  VkResult result = glfwCreateWindowSurface(_instance, _window->getGLFWwindow(), nullptr, &_surface);
   if (result != VK_SUCCESS)
   {
     throw std::runtime_error("Failed to create window surface! Error code: " +
@@ -150,16 +156,26 @@ bool VulkanInstance::checkValidationLayerSupport()
 
 std::vector<const char*> VulkanInstance::getRequiredExtensions()
 {
-  uint32_t glfwExtensionCount = 0;
-  const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-  if (glfwExtensions == nullptr)
+  std::vector<const char*> extensions;
+
+  // Surface extensions are only needed when presenting to a window
+  if (!isHeadless())
   {
-    throw std::runtime_error("GLFW required extensions unavailable.");
+    uint32_t glfwExtensionCount = 0;
+    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    if (glfwExtensions == nullptr)
+    {
+      throw std::runtime_error("GLFW required extensions unavailable.");
+    }
+    extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
   }
-  std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
 
-  // MoltenVK portability requirements
-  extensions.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
+  // MoltenVK portability requirements. Software implementations used for
+  // headless runs (e.g. lavapipe) may not expose portability enumeration.
+  if (isInstanceExtensionAvailable(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME))
+  {
+    extensions.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
+  }
   extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 
   if (enableValidationLayers)
@@ -174,6 +190,23 @@ std::vector<const char*> VulkanInstance::getRequiredExtensions()
   return extensions;
 }
 
+bool VulkanInstance::isInstanceExtensionAvailable(const char* extensionName)
+{
+  uint32_t extensionCount = 0;
+  vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+  std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+  vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
+
+  for (const auto& extension : availableExtensions)
+  {
+    if (strcmp(extension.extensionName, extensionName) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanInstance::debugCallback(
     VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
     VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -23,7 +23,8 @@ const bool enableValidationLayers = true;
 class VulkanInstance
 {
 public:
-  VulkanInstance(const Window& window);
+  // Pass nullptr for headless rendering: no GLFW extensions and no surface
+  explicit VulkanInstance(const Window* window);
   ~VulkanInstance();
 
   // Delete copy/move semantics
@@ -35,12 +36,13 @@ public:
   // Accessors
   VkInstance getInstance() const { return _instance; }
   VkSurfaceKHR getSurface() const { return _surface; }
+  bool isHeadless() const { return _window == nullptr; }
 
 private:
   VkInstance _instance = VK_NULL_HANDLE;
   VkDebugUtilsMessengerEXT _debugMessenger = VK_NULL_HANDLE;
   VkSurfaceKHR _surface = VK_NULL_HANDLE; // Surface is tightly coupled to instance
-  const Window& _windowRef; // Reference to window for surface creation
+  const Window* _window; // Window for surface creation (nullptr when headless)
 
   void createInstance();
   void setupDebugMessenger();
@@ -49,6 +51,7 @@ private:
   // Helpers
   bool checkValidationLayerSupport();
   std::vector<const char*> getRequiredExtensions();
+  static bool isInstanceExtensionAvailable(const char* extensionName);
   void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
 
   // Static Debug Callback
@@ -0,0 +1,471 @@
+#include "VulkanMemoryAllocator.h"
+#include "TlsfAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+// --- Constructor / Destructor ---
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device,
+                                             VkDeviceSize preferredBlockSize)
+    : _device(device), _preferredBlockSize(preferredBlockSize)
+{
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &_memoryProperties);
+
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+  _bufferImageGranularity = std::max<VkDeviceSize>(properties.limits.bufferImageGranularity, 1);
+  _nonCoherentAtomSize = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+  _maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+
+  _types.resize(_memoryProperties.memoryTypeCount);
+  std::cout << "Vulkan memory allocator created (" << _memoryProperties.memoryTypeCount << " memory types, "
+            << "bufferImageGranularity " << _bufferImageGranularity << ")." << std::endl;
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator()
+{
+  uint64_t leaked = 0;
+  for (uint32_t typeIndex = 0; typeIndex < _types.size(); typeIndex++)
+  {
+    MemoryTypeState& type = _types[typeIndex];
+    leaked += type.dedicatedCount;
+    for (auto& block : type.blocks)
+    {
+      if (!block)
+      {
+        continue;
+      }
+      leaked += block->tlsf->getStats().allocationCount;
+      freeDeviceMemory(block->memory, block->mapped != nullptr);
+    }
+    type.blocks.clear();
+  }
+  if (leaked > 0)
+  {
+    std::cerr << "Warning: " << leaked << " device memory allocations were not freed." << std::endl;
+  }
+  std::cout << "Vulkan memory allocator destroyed." << std::endl;
+}
+
+// --- Public Methods ---
+
+uint32_t VulkanMemoryAllocator::findMemoryTypeIndex(uint32_t typeBits, MemoryUsage usage) const
+{
+  VkMemoryPropertyFlags required = 0;
+  VkMemoryPropertyFlags preferred = 0;
+  switch (usage)
+  {
+    case MemoryUsage::GpuOnly:
+      preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+      break;
+    case MemoryUsage::CpuToGpu:
+      required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+      preferred = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+      break;
+    case MemoryUsage::GpuToCpu:
+      required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+      preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+      break;
+  }
+
+  // Most preferred bits first, then fewest unrequested bits (e.g. avoid
+  // HOST_VISIBLE device memory for GpuOnly, it is often a scarce BAR heap)
+  uint32_t best = UINT32_MAX;
+  int bestScore = -1;
+  for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; i++)
+  {
+    VkMemoryPropertyFlags flags = _memoryProperties.memoryTypes[i].propertyFlags;
+    if (!(typeBits & (1u << i)) || (flags & required) != required)
+    {
+      continue;
+    }
+    int score = 16 * std::popcount(static_cast<uint32_t>(flags & preferred)) -
+                std::popcount(static_cast<uint32_t>(flags & ~(required | preferred)));
+    if (score > bestScore)
+    {
+      best = i;
+      bestScore = score;
+    }
+  }
+  if (best == UINT32_MAX)
+  {
+    throw std::runtime_error("Failed to find suitable memory type!");
+  }
+  return best;
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocate(const VkMemoryRequirements& requirements, MemoryUsage usage,
+                                                 ResourceTiling tiling, bool dedicated)
+{
+  uint32_t typeIndex = findMemoryTypeIndex(requirements.memoryTypeBits, usage);
+  VkDeviceSize blockSize = blockSizeFor(typeIndex);
+
+  VkDeviceSize size = requirements.size;
+  VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+  if (isHostVisible(typeIndex) && !isCoherent(typeIndex))
+  {
+    // Flush/invalidate ranges are rounded to nonCoherentAtomSize
+    alignment = std::max(alignment, _nonCoherentAtomSize);
+    size = AlignUp(size, _nonCoherentAtomSize);
+  }
+  if (tiling == ResourceTiling::Optimal && _bufferImageGranularity > 1)
+  {
+    // Give optimal images whole granularity pages so no linear resource can
+    // land on the same page
+    alignment = std::max(alignment, _bufferImageGranularity);
+    size = AlignUp(size, _bufferImageGranularity);
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  MemoryTypeState& type = _types[typeIndex];
+
+  VulkanAllocation allocation;
+  allocation.memoryTypeIndex = typeIndex;
+  allocation.size = requirements.size;
+
+  // Large resources would mostly waste a shared block
+  if (dedicated || size > blockSize / 2)
+  {
+    void* mapped = nullptr;
+    allocation.memory = allocateDeviceMemory(size, typeIndex, &mapped); // Rounded size keeps flush ranges in bounds
+    allocation.mappedData = mapped;
+    allocation.dedicated = true;
+    type.dedicatedCount++;
+    type.dedicatedBytes += requirements.size;
+    return allocation;
+  }
+
+  auto subAllocate = [&](uint32_t blockIndex) {
+    MemoryBlock& block = *type.blocks[blockIndex];
+    VkDeviceSize offset = 0;
+    uint32_t handle = block.tlsf->allocate(size, alignment, offset);
+    if (handle == TlsfAllocator::INVALID_HANDLE)
+    {
+      return false;
+    }
+    allocation.memory = block.memory;
+    allocation.offset = offset;
+    allocation.blockIndex = blockIndex;
+    allocation.handle = handle;
+    allocation.mappedData = block.mapped ? static_cast<char*>(block.mapped) + offset : nullptr;
+    return true;
+  };
+
+  // Try the existing blocks first
+  uint32_t freeSlot = static_cast<uint32_t>(type.blocks.size());
+  for (uint32_t blockIndex = 0; blockIndex < type.blocks.size(); blockIndex++)
+  {
+    if (!type.blocks[blockIndex])
+    {
+      freeSlot = std::min(freeSlot, blockIndex);
+      continue;
+    }
+    if (subAllocate(blockIndex))
+    {
+      return allocation;
+    }
+  }
+
+  // Open a new block (size > blockSize / 2 went dedicated above, so it always fits)
+  auto block = std::make_unique<MemoryBlock>();
+  block->memory = allocateDeviceMemory(blockSize, typeIndex, &block->mapped);
+  block->tlsf = std::make_unique<TlsfAllocator>(blockSize);
+  if (freeSlot == type.blocks.size())
+  {
+    type.blocks.push_back(std::move(block));
+  }
+  else
+  {
+    type.blocks[freeSlot] = std::move(block);
+  }
+  if (!subAllocate(freeSlot))
+  {
+    throw std::runtime_error("Failed to sub-allocate device memory!");
+  }
+  return allocation;
+}
+
+void VulkanMemoryAllocator::free(VulkanAllocation& allocation)
+{
+  if (!allocation.isValid())
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  MemoryTypeState& type = _types[allocation.memoryTypeIndex];
+  if (allocation.dedicated)
+  {
+    freeDeviceMemory(allocation.memory, allocation.mappedData != nullptr);
+    type.dedicatedCount--;
+    type.dedicatedBytes -= allocation.size;
+  }
+  else
+  {
+    auto& block = type.blocks[allocation.blockIndex];
+    block->tlsf->free(allocation.handle);
+
+    // Keep one empty block per type around to avoid allocate/free churn
+    if (block->tlsf->isEmpty())
+    {
+      size_t liveBlocks = std::count_if(type.blocks.begin(), type.blocks.end(),
+                                        [](const auto& b) { return b != nullptr; });
+      if (liveBlocks > 1)
+      {
+        freeDeviceMemory(block->memory, block->mapped != nullptr);
+        block.reset();
+      }
+    }
+  }
+  allocation = VulkanAllocation{};
+}
+
+VkBuffer VulkanMemoryAllocator::createBuffer(const VkBufferCreateInfo& createInfo, MemoryUsage usage,
+                                             VulkanAllocation& allocation)
+{
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VkResult result = vkCreateBuffer(_device, &createInfo, nullptr, &buffer);
+  if (result != VK_SUCCESS)
+  {
+    throw std::runtime_error("Failed to create buffer! Error code: " + std::to_string(result));
+  }
+
+  VkMemoryRequirements requirements;
+  vkGetBufferMemoryRequirements(_device, buffer, &requirements);
+  try
+  {
+    allocation = allocate(requirements, usage, ResourceTiling::Linear);
+  }
+  catch (...)
+  {
+    vkDestroyBuffer(_device, buffer, nullptr);
+    throw;
+  }
+
+  result = vkBindBufferMemory(_device, buffer, allocation.memory, allocation.offset);
+  if (result != VK_SUCCESS)
+  {
+    destroyBuffer(buffer, allocation);
+    throw std::runtime_error("Failed to bind buffer memory! Error code: " + std::to_string(result));
+  }
+  return buffer;
+}
+
+void VulkanMemoryAllocator::destroyBuffer(VkBuffer buffer, VulkanAllocation& allocation)
+{
+  if (buffer != VK_NULL_HANDLE)
+  {
+    vkDestroyBuffer(_device, buffer, nullptr);
+  }
+  free(allocation);
+}
+
+VkImage VulkanMemoryAllocator::createImage(const VkImageCreateInfo& createInfo, MemoryUsage usage,
+                                           VulkanAllocation& allocation)
+{
+  VkImage image = VK_NULL_HANDLE;
+  VkResult result = vkCreateImage(_device, &createInfo, nullptr, &image);
+  if (result != VK_SUCCESS)
+  {
+    throw std::runtime_error("Failed to create image! Error code: " + std::to_string(result));
+  }
+
+  VkMemoryRequirements requirements;
+  vkGetImageMemoryRequirements(_device, image, &requirements);
+  ResourceTiling tiling = createInfo.tiling == VK_IMAGE_TILING_LINEAR ? ResourceTiling::Linear : ResourceTiling::Optimal;
+  // Render targets are large and long-lived; drivers often prefer them dedicated
+  bool dedicated = (createInfo.usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) != 0;
+  try
+  {
+    allocation = allocate(requirements, usage, tiling, dedicated);
+  }
+  catch (...)
+  {
+    vkDestroyImage(_device, image, nullptr);
+    throw;
+  }
+
+  result = vkBindImageMemory(_device, image, allocation.memory, allocation.offset);
+  if (result != VK_SUCCESS)
+  {
+    destroyImage(image, allocation);
+    throw std::runtime_error("Failed to bind image memory! Error code: " + std::to_string(result));
+  }
+  return image;
+}
+
+void VulkanMemoryAllocator::destroyImage(VkImage image, VulkanAllocation& allocation)
+{
+  if (image != VK_NULL_HANDLE)
+  {
+    vkDestroyImage(_device, image, nullptr);
+  }
+  free(allocation);
+}
+
+void VulkanMemoryAllocator::flush(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+{
+  if (!allocation.isValid() || isCoherent(allocation.memoryTypeIndex))
+  {
+    return;
+  }
+  VkMappedMemoryRange range = makeRange(allocation, offset, size);
+  vkFlushMappedMemoryRanges(_device, 1, &range);
+}
+
+void VulkanMemoryAllocator::invalidate(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const
+{
+  if (!allocation.isValid() || isCoherent(allocation.memoryTypeIndex))
+  {
+    return;
+  }
+  VkMappedMemoryRange range = makeRange(allocation, offset, size);
+  vkInvalidateMappedMemoryRanges(_device, 1, &range);
+}
+
+MemoryStats VulkanMemoryAllocator::getStats() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  MemoryStats stats;
+  stats.deviceMemoryCount = _deviceMemoryCount;
+  for (uint32_t typeIndex = 0; typeIndex < _types.size(); typeIndex++)
+  {
+    const MemoryTypeState& type = _types[typeIndex];
+    MemoryTypeStats typeStats;
+    typeStats.memoryTypeIndex = typeIndex;
+    typeStats.propertyFlags = _memoryProperties.memoryTypes[typeIndex].propertyFlags;
+    typeStats.dedicatedCount = type.dedicatedCount;
+    typeStats.dedicatedBytes = type.dedicatedBytes;
+    for (const auto& block : type.blocks)
+    {
+      if (!block)
+      {
+        continue;
+      }
+      TlsfAllocator::Stats blockStats = block->tlsf->getStats();
+      typeStats.blockCount++;
+      typeStats.blockBytes += blockStats.totalSize;
+      typeStats.usedBytes += blockStats.usedBytes;
+      typeStats.allocationCount += blockStats.allocationCount;
+      typeStats.largestFreeRange = std::max(typeStats.largestFreeRange, blockStats.largestFreeBlock);
+      typeStats.fragmentation = std::max(typeStats.fragmentation, blockStats.fragmentation());
+    }
+    if (typeStats.blockCount == 0 && typeStats.dedicatedCount == 0)
+    {
+      continue;
+    }
+    stats.reservedBytes += typeStats.blockBytes + typeStats.dedicatedBytes;
+    stats.usedBytes += typeStats.usedBytes + typeStats.dedicatedBytes;
+    stats.types.push_back(typeStats);
+  }
+  return stats;
+}
+
+void VulkanMemoryAllocator::printStats() const
+{
+  MemoryStats stats = getStats();
+  constexpr double MiB = 1024.0 * 1024.0;
+  std::cout << "Device memory: " << stats.deviceMemoryCount << " allocations, "
+            << std::fixed << std::setprecision(2) << stats.usedBytes / MiB << " / "
+            << stats.reservedBytes / MiB << " MiB used" << std::endl;
+  for (const MemoryTypeStats& type : stats.types)
+  {
+    std::cout << "  type " << type.memoryTypeIndex << ": " << type.blockCount << " blocks, "
+              << type.allocationCount << " sub-allocations (" << type.usedBytes / MiB << " / "
+              << type.blockBytes / MiB << " MiB), " << type.dedicatedCount << " dedicated ("
+              << type.dedicatedBytes / MiB << " MiB), fragmentation " << type.fragmentation << std::endl;
+  }
+  std::cout.unsetf(std::ios::fixed);
+}
+
+// --- Private Methods ---
+
+VkDeviceSize VulkanMemoryAllocator::blockSizeFor(uint32_t memoryTypeIndex) const
+{
+  // Small heaps (e.g. a 256 MiB BAR window) get proportionally smaller blocks
+  uint32_t heapIndex = _memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+  VkDeviceSize heapSize = _memoryProperties.memoryHeaps[heapIndex].size;
+  VkDeviceSize size = std::min(_preferredBlockSize, std::bit_floor(std::max<VkDeviceSize>(heapSize / 8, 1)));
+  return std::max<VkDeviceSize>(size, 1024 * 1024);
+}
+
+bool VulkanMemoryAllocator::isHostVisible(uint32_t memoryTypeIndex) const
+{
+  return (_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+bool VulkanMemoryAllocator::isCoherent(uint32_t memoryTypeIndex) const
+{
+  return (_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+VkDeviceMemory VulkanMemoryAllocator::allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, void** mapped)
+{
+  if (_maxAllocationCount != 0 && _deviceMemoryCount >= _maxAllocationCount)
+  {
+    throw std::runtime_error("Failed to allocate device memory: maxMemoryAllocationCount (" +
+                             std::to_string(_maxAllocationCount) + ") reached!");
+  }
+
+  VkMemoryAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = size;
+  allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkResult result = vkAllocateMemory(_device, &allocInfo, nullptr, &memory);
+  if (result != VK_SUCCESS)
+  {
+    throw std::runtime_error("Failed to allocate device memory! Error code: " + std::to_string(result));
+  }
+  _deviceMemoryCount++;
+
+  *mapped = nullptr;
+  if (isHostVisible(memoryTypeIndex))
+  {
+    result = vkMapMemory(_device, memory, 0, VK_WHOLE_SIZE, 0, mapped);
+    if (result != VK_SUCCESS)
+    {
+      freeDeviceMemory(memory, false);
+      throw std::runtime_error("Failed to map device memory! Error code: " + std::to_string(result));
+    }
+  }
+  return memory;
+}
+
+void VulkanMemoryAllocator::freeDeviceMemory(VkDeviceMemory memory, bool mapped)
+{
+  if (mapped)
+  {
+    vkUnmapMemory(_device, memory);
+  }
+  vkFreeMemory(_device, memory, nullptr);
+  _deviceMemoryCount--;
+}
+
+VkMappedMemoryRange VulkanMemoryAllocator::makeRange(const VulkanAllocation& allocation, VkDeviceSize offset,
+                                                     VkDeviceSize size) const
+{
+  VkDeviceSize begin = allocation.offset + offset;
+  VkDeviceSize end = (size == VK_WHOLE_SIZE) ? allocation.offset + allocation.size : begin + size;
+
+  VkMappedMemoryRange range{};
+  range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+  range.memory = allocation.memory;
+  range.offset = begin & ~(_nonCoherentAtomSize - 1);
+  range.size = AlignUp(end, _nonCoherentAtomSize) - range.offset;
+  return range;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class TlsfAllocator;
+
+// What the memory is used for; picks the memory type
+enum class MemoryUsage
+{
+  GpuOnly,  // Prefers DEVICE_LOCAL; never mapped
+  CpuToGpu, // HOST_VISIBLE, prefers HOST_COHERENT (staging, uniforms)
+  GpuToCpu  // HOST_VISIBLE, prefers HOST_CACHED (readback)
+};
+
+// Linear resources (buffers, linear images) and optimal-tiling images must not
+// share a bufferImageGranularity page
+enum class ResourceTiling
+{
+  Linear,
+  Optimal
+};
+
+// A range of device memory handed out by VulkanMemoryAllocator
+struct VulkanAllocation
+{
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+  void* mappedData = nullptr; // Persistently mapped pointer to offset, if host-visible
+  uint32_t memoryTypeIndex = 0;
+  bool dedicated = false;
+
+  // Owner bookkeeping
+  uint32_t blockIndex = UINT32_MAX;
+  uint32_t handle = UINT32_MAX;
+
+  bool isValid() const { return memory != VK_NULL_HANDLE; }
+};
+
+struct MemoryTypeStats
+{
+  uint32_t memoryTypeIndex = 0;
+  VkMemoryPropertyFlags propertyFlags = 0;
+  uint32_t blockCount = 0;
+  VkDeviceSize blockBytes = 0;        // Reserved in shared blocks
+  VkDeviceSize usedBytes = 0;         // Sub-allocated from shared blocks
+  uint64_t allocationCount = 0;       // Sub-allocations
+  uint32_t dedicatedCount = 0;
+  VkDeviceSize dedicatedBytes = 0;
+  VkDeviceSize largestFreeRange = 0;
+  double fragmentation = 0.0;         // Worst block, see TlsfAllocator::Stats
+};
+
+struct MemoryStats
+{
+  std::vector<MemoryTypeStats> types; // Only types that have memory allocated
+  uint32_t deviceMemoryCount = 0;     // Live vkAllocateMemory objects
+  VkDeviceSize reservedBytes = 0;
+  VkDeviceSize usedBytes = 0;
+};
+
+// Sub-allocates buffers and images from large VkDeviceMemory blocks (one list
+// per memory type) with TLSF placement, so resources no longer cost one
+// vkAllocateMemory each. Large or explicitly requested resources get a
+// dedicated allocation. Host-visible blocks stay mapped for their lifetime.
+// Thread-safe.
+class VulkanMemoryAllocator
+{
+public:
+  static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+  VulkanMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device,
+                        VkDeviceSize preferredBlockSize = DEFAULT_BLOCK_SIZE);
+  ~VulkanMemoryAllocator(); // Frees all blocks; reports leaked allocations
+
+  // Delete copy/move semantics
+  VulkanMemoryAllocator(const VulkanMemoryAllocator&) = delete;
+  VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+  VulkanMemoryAllocator(VulkanMemoryAllocator&&) = delete;
+  VulkanMemoryAllocator& operator=(VulkanMemoryAllocator&&) = delete;
+
+  // Throws std::runtime_error when no memory type fits or the device is out of memory
+  VulkanAllocation allocate(const VkMemoryRequirements& requirements, MemoryUsage usage,
+                            ResourceTiling tiling, bool dedicated = false);
+  void free(VulkanAllocation& allocation); // Resets the allocation
+
+  // Create the resource, allocate its memory and bind it
+  VkBuffer createBuffer(const VkBufferCreateInfo& createInfo, MemoryUsage usage, VulkanAllocation& allocation);
+  void destroyBuffer(VkBuffer buffer, VulkanAllocation& allocation);
+  VkImage createImage(const VkImageCreateInfo& createInfo, MemoryUsage usage, VulkanAllocation& allocation);
+  void destroyImage(VkImage image, VulkanAllocation& allocation);
+
+  // Required after CPU writes / before CPU reads of non-coherent memory; no-ops otherwise
+  void flush(const VulkanAllocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+  void invalidate(const VulkanAllocation& allocation, VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
+
+  // Best memory type for the usage among typeBits (from VkMemoryRequirements)
+  uint32_t findMemoryTypeIndex(uint32_t typeBits, MemoryUsage usage) const;
+
+  MemoryStats getStats() const;
+  void printStats() const;
+
+private:
+  struct MemoryBlock
+  {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    std::unique_ptr<TlsfAllocator> tlsf;
+    void* mapped = nullptr;
+  };
+
+  struct MemoryTypeState
+  {
+    std::vector<std::unique_ptr<MemoryBlock>> blocks; // Null slots are reused
+    uint32_t dedicatedCount = 0;
+    VkDeviceSize dedicatedBytes = 0;
+  };
+
+  VkDeviceSize blockSizeFor(uint32_t memoryTypeIndex) const;
+  bool isHostVisible(uint32_t memoryTypeIndex) const;
+  bool isCoherent(uint32_t memoryTypeIndex) const;
+  VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, void** mapped);
+  void freeDeviceMemory(VkDeviceMemory memory, bool mapped);
+  VkMappedMemoryRange makeRange(const VulkanAllocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
+  VkDevice _device;
+  VkPhysicalDeviceMemoryProperties _memoryProperties{};
+  VkDeviceSize _bufferImageGranularity = 1;
+  VkDeviceSize _nonCoherentAtomSize = 1;
+  uint32_t _maxAllocationCount = 0;
+  VkDeviceSize _preferredBlockSize;
+
+  mutable std::mutex _mutex;
+  std::vector<MemoryTypeState> _types; // Indexed by memory type
+  uint32_t _deviceMemoryCount = 0;
+};
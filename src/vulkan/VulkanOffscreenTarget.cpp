@@ -0,0 +1,115 @@
+#include "VulkanOffscreenTarget.h"
+#include "VulkanDevice.h" // For VkDevice and the memory allocator
+
+#include <stdexcept>
+#include <iostream> // For logging
+
+// --- Constructor / Destructor ---
+
+VulkanOffscreenTarget::VulkanOffscreenTarget(const VulkanDevice& device, VkExtent2D extent,
+                                             uint32_t imageCount, VkFormat format)
+    : _format(format),
+      _extent(extent),
+      _deviceRef(device),
+      _logicalDevice(device.getDevice()) // Cache logical device handle
+{
+  if (imageCount == 0)
+  {
+    throw std::runtime_error("Offscreen target needs at least one image!");
+  }
+  createImages(imageCount);
+  createImageViews();
+}
+
+VulkanOffscreenTarget::~VulkanOffscreenTarget()
+{
+  for (auto imageView : _imageViews)
+  {
+    vkDestroyImageView(_logicalDevice, imageView, nullptr);
+  }
+  for (size_t i = 0; i < _images.size(); i++)
+  {
+    _deviceRef.getAllocator().destroyImage(_images[i], _imageMemory[i]);
+  }
+  std::cout << "Vulkan offscreen target destroyed." << std::endl;
+}
+
+// --- Public Methods ---
+
+VkResult VulkanOffscreenTarget::acquireNextImage(VkSemaphore /*imageAvailable*/, uint32_t& imageIndex)
+{
+  // Images are handed out round-robin. The ring is sized to the number of
+  // frames in flight, so the Renderer's wait on its frame timeline already
+  // guarantees the GPU is done with an image before it comes around again.
+  imageIndex = _nextImage;
+  _nextImage = (_nextImage + 1) % static_cast<uint32_t>(_images.size());
+  return VK_SUCCESS;
+}
+
+VkResult VulkanOffscreenTarget::present(VkQueue /*presentQueue*/, VkSemaphore /*renderFinished*/,
+                                        uint32_t /*imageIndex*/)
+{
+  // Nothing to show; the rendered image stays in TRANSFER_SRC layout for readback
+  return VK_SUCCESS;
+}
+
+// --- Private Methods ---
+
+void VulkanOffscreenTarget::createImages(uint32_t imageCount)
+{
+  _images.resize(imageCount);
+  _imageMemory.resize(imageCount);
+
+  for (uint32_t i = 0; i < imageCount; i++)
+  {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = _format;
+    imageInfo.extent = {_extent.width, _extent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    // Created, allocated (dedicated: it is a render target) and bound in one call
+    _images[i] = _deviceRef.getAllocator().createImage(imageInfo, MemoryUsage::GpuOnly, _imageMemory[i]);
+  }
+  std::cout << "Vulkan offscreen images created successfully (" << imageCount << ", "
+            << _extent.width << "x" << _extent.height << ")." << std::endl;
+}
+
+void VulkanOffscreenTarget::createImageViews()
+{
+  _imageViews.resize(_images.size());
+
+  for (size_t i = 0; i < _images.size(); i++)
+  {
+    VkImageViewCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    createInfo.image = _images[i];
+    createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    createInfo.format = _format;
+    createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+    createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    createInfo.subresourceRange.baseMipLevel = 0;
+    createInfo.subresourceRange.levelCount = 1;
+    createInfo.subresourceRange.baseArrayLayer = 0;
+    createInfo.subresourceRange.layerCount = 1;
+
+    VkResult result = vkCreateImageView(_logicalDevice, &createInfo, nullptr, &_imageViews[i]);
+    if (result != VK_SUCCESS)
+    {
+      throw std::runtime_error("Failed to create offscreen image view " + std::to_string(i) +
+                               "! Error code: " + std::to_string(result));
+    }
+  }
+  std::cout << "Vulkan offscreen image views created successfully ("
+            << _imageViews.size() << ")." << std::endl;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <vector>
+
+#include "PresentTarget.h"
+#include "VulkanMemoryAllocator.h"
+
+// Forward declarations
+class VulkanDevice;
+
+// Headless presentation target: a ring of device-local color images that the
+// Renderer draws into instead of swap chain images. "Presenting" simply
+// advances the ring, so no window, surface or display server is needed.
+class VulkanOffscreenTarget : public PresentTarget
+{
+public:
+  VulkanOffscreenTarget(const VulkanDevice& device, VkExtent2D extent, uint32_t imageCount,
+                        VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
+  ~VulkanOffscreenTarget();
+
+  // Delete copy/move semantics
+  VulkanOffscreenTarget(const VulkanOffscreenTarget&) = delete;
+  VulkanOffscreenTarget& operator=(const VulkanOffscreenTarget&) = delete;
+  VulkanOffscreenTarget(VulkanOffscreenTarget&&) = delete;
+  VulkanOffscreenTarget& operator=(VulkanOffscreenTarget&&) = delete;
+
+  // PresentTarget
+  const std::vector<VkImage>& getImages() const override { return _images; }
+  VkFormat getImageFormat() const override { return _format; }
+  VkExtent2D getExtent() const override { return _extent; }
+  const std::vector<VkImageView>& getImageViews() const override { return _imageViews; }
+  VkImageLayout getFinalLayout() const override { return VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL; }
+  bool isHeadless() const override { return true; }
+  VkResult acquireNextImage(VkSemaphore imageAvailable, uint32_t& imageIndex) override;
+  VkResult present(VkQueue presentQueue, VkSemaphore renderFinished, uint32_t imageIndex) override;
+  // Nothing reaches a display; the frame pacer falls back to the frame timeline
+  bool supportsPresentWait() const override { return false; }
+  uint64_t getLastPresentId() const override { return 0; }
+  VkResult waitForPresent(uint64_t /*presentId*/, uint64_t /*timeoutNs*/) override { return VK_ERROR_FEATURE_NOT_PRESENT; }
+  bool recreate(DeletionQueue& /*retired*/, uint64_t /*lastUsingFrame*/) override { return false; } // Fixed size
+
+private:
+  std::vector<VkImage> _images;
+  std::vector<VulkanAllocation> _imageMemory; // From the device's allocator
+  std::vector<VkImageView> _imageViews;
+  VkFormat _format;
+  VkExtent2D _extent;
+  uint32_t _nextImage = 0;
+
+  const VulkanDevice& _deviceRef;
+  VkDevice _logicalDevice; // Copy logical device handle
+
+  void createImages(uint32_t imageCount);
+  void createImageViews();
+};
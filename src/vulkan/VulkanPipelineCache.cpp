@@ -0,0 +1,298 @@
+#include "VulkanPipelineCache.h"
+#include "VulkanDevice.h" // For device properties and handles
+
+#include <cstring>    // For memcmp/memcpy
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+constexpr uint32_t CACHE_FILE_MAGIC = 0x43504B56; // "VKPC"
+constexpr uint32_t CACHE_FILE_VERSION = 1;
+
+uint64_t HashBytes(const char* data, size_t size)
+{
+  // FNV-1a, 64 bit: cheap corruption check, not a security measure
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+} // namespace
+
+// --- Constructor / Destructor ---
+
+VulkanPipelineCache::VulkanPipelineCache(const VulkanDevice& device, std::string path)
+    : _deviceRef(device),
+      _logicalDevice(device.getDevice()),
+      _path(std::move(path)),
+      _lastSave(std::chrono::steady_clock::now())
+{
+  std::vector<char> initialData = loadValidatedBlob();
+
+  VkPipelineCacheCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  createInfo.initialDataSize = initialData.size();
+  createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+  VkResult result = vkCreatePipelineCache(_logicalDevice, &createInfo, nullptr, &_cache);
+  if (result != VK_SUCCESS && !initialData.empty())
+  {
+    // The driver rejected a blob that passed our checks; fall back to a cold cache
+    std::cerr << "Driver rejected pipeline cache blob, starting cold. Error code: " << result << std::endl;
+    createInfo.initialDataSize = 0;
+    createInfo.pInitialData = nullptr;
+    result = vkCreatePipelineCache(_logicalDevice, &createInfo, nullptr, &_cache);
+    initialData.clear();
+  }
+  if (result != VK_SUCCESS)
+  {
+    throw std::runtime_error("Failed to create pipeline cache! Error code: " + std::to_string(result));
+  }
+
+  _loadedFromDisk = !initialData.empty();
+  std::cout << "Vulkan pipeline cache created (" << (_loadedFromDisk ? "warm, " : "cold, ")
+            << initialData.size() << " bytes loaded)." << std::endl;
+}
+
+VulkanPipelineCache::~VulkanPipelineCache()
+{
+  if (_cache != VK_NULL_HANDLE)
+  {
+    save();
+    vkDestroyPipelineCache(_logicalDevice, _cache, nullptr);
+    std::cout << "Vulkan pipeline cache destroyed." << std::endl;
+  }
+}
+
+// --- Public Methods ---
+
+void VulkanPipelineCache::markDirty()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _dirty = true;
+}
+
+VkPipelineCache VulkanPipelineCache::createWorkerCache()
+{
+  std::vector<char> seed;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(_logicalDevice, _cache, &dataSize, nullptr) == VK_SUCCESS && dataSize > 0)
+    {
+      seed.resize(dataSize);
+      if (vkGetPipelineCacheData(_logicalDevice, _cache, &dataSize, seed.data()) != VK_SUCCESS)
+      {
+        seed.clear();
+      }
+      seed.resize(seed.empty() ? 0 : dataSize);
+    }
+  }
+
+  VkPipelineCacheCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  createInfo.initialDataSize = seed.size();
+  createInfo.pInitialData = seed.empty() ? nullptr : seed.data();
+
+  VkPipelineCache workerCache = VK_NULL_HANDLE;
+  VkResult result = vkCreatePipelineCache(_logicalDevice, &createInfo, nullptr, &workerCache);
+  if (result != VK_SUCCESS)
+  {
+    throw std::runtime_error("Failed to create worker pipeline cache! Error code: " + std::to_string(result));
+  }
+  return workerCache;
+}
+
+void VulkanPipelineCache::mergeWorkerCaches(const std::vector<VkPipelineCache>& workerCaches, bool destroyAfterMerge)
+{
+  if (workerCaches.empty())
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  VkResult result = vkMergePipelineCaches(_logicalDevice, _cache,
+                                          static_cast<uint32_t>(workerCaches.size()), workerCaches.data());
+  if (result != VK_SUCCESS)
+  {
+    std::cerr << "Failed to merge worker pipeline caches. Error code: " << result << std::endl;
+  }
+  else
+  {
+    _dirty = true;
+  }
+
+  if (destroyAfterMerge)
+  {
+    for (VkPipelineCache workerCache : workerCaches)
+    {
+      vkDestroyPipelineCache(_logicalDevice, workerCache, nullptr);
+    }
+  }
+}
+
+bool VulkanPipelineCache::save()
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _lastSave = std::chrono::steady_clock::now();
+  if (!_dirty || _path.empty())
+  {
+    return true;
+  }
+
+  size_t dataSize = 0;
+  VkResult result = vkGetPipelineCacheData(_logicalDevice, _cache, &dataSize, nullptr);
+  if (result != VK_SUCCESS || dataSize == 0)
+  {
+    return false;
+  }
+  std::vector<char> blob(dataSize);
+  result = vkGetPipelineCacheData(_logicalDevice, _cache, &dataSize, blob.data());
+  if (result != VK_SUCCESS)
+  {
+    return false;
+  }
+  blob.resize(dataSize);
+
+  FileHeader header = makeHeader(blob);
+
+  // Write to a temporary file and rename over the old one, so a crash mid-write
+  // never leaves a truncated cache behind
+  std::string tempPath = _path + ".tmp";
+  {
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+      std::cerr << "Failed to open " << tempPath << " for writing." << std::endl;
+      return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+    if (!file.good())
+    {
+      std::cerr << "Failed to write pipeline cache to " << tempPath << std::endl;
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(tempPath, _path, error);
+  if (error)
+  {
+    std::cerr << "Failed to replace pipeline cache " << _path << ": " << error.message() << std::endl;
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+
+  _dirty = false;
+  std::cout << "Pipeline cache saved (" << blob.size() << " bytes) to " << _path << std::endl;
+  return true;
+}
+
+void VulkanPipelineCache::saveIfDue(std::chrono::steady_clock::duration interval)
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_dirty || std::chrono::steady_clock::now() - _lastSave < interval)
+    {
+      return;
+    }
+  }
+  save();
+}
+
+// --- Private Methods ---
+
+VulkanPipelineCache::FileHeader VulkanPipelineCache::makeHeader(const std::vector<char>& blob) const
+{
+  const VkPhysicalDeviceProperties& properties = _deviceRef.getProperties();
+
+  FileHeader header{};
+  header.magic = CACHE_FILE_MAGIC;
+  header.fileVersion = CACHE_FILE_VERSION;
+  header.vendorID = properties.vendorID;
+  header.deviceID = properties.deviceID;
+  header.driverVersion = properties.driverVersion;
+  std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+  header.dataSize = blob.size();
+  header.dataHash = HashBytes(blob.data(), blob.size());
+  return header;
+}
+
+std::vector<char> VulkanPipelineCache::loadValidatedBlob() const
+{
+  if (_path.empty())
+  {
+    return {};
+  }
+
+  std::ifstream file(_path, std::ios::binary | std::ios::ate);
+  if (!file.is_open())
+  {
+    std::cout << "No pipeline cache at " << _path << ", starting cold." << std::endl;
+    return {};
+  }
+
+  size_t fileSize = static_cast<size_t>(file.tellg());
+  if (fileSize < sizeof(FileHeader))
+  {
+    std::cerr << "Pipeline cache " << _path << " is truncated, ignoring." << std::endl;
+    return {};
+  }
+  file.seekg(0);
+
+  FileHeader header{};
+  file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+  const VkPhysicalDeviceProperties& properties = _deviceRef.getProperties();
+  if (header.magic != CACHE_FILE_MAGIC || header.fileVersion != CACHE_FILE_VERSION)
+  {
+    std::cerr << "Pipeline cache " << _path << " has an unknown format, ignoring." << std::endl;
+    return {};
+  }
+  if (header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+      header.driverVersion != properties.driverVersion ||
+      std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+  {
+    std::cout << "Pipeline cache was written by a different device or driver, starting cold." << std::endl;
+    return {};
+  }
+  if (header.dataSize != fileSize - sizeof(FileHeader))
+  {
+    std::cerr << "Pipeline cache " << _path << " size mismatch, ignoring." << std::endl;
+    return {};
+  }
+
+  std::vector<char> blob(header.dataSize);
+  file.read(blob.data(), static_cast<std::streamsize>(blob.size()));
+  if (!file.good() || HashBytes(blob.data(), blob.size()) != header.dataHash || !isBlobCompatible(blob))
+  {
+    std::cerr << "Pipeline cache " << _path << " is corrupt, ignoring." << std::endl;
+    return {};
+  }
+  return blob;
+}
+
+bool VulkanPipelineCache::isBlobCompatible(const std::vector<char>& blob) const
+{
+  // Cross-check the driver's own header (VkPipelineCacheHeaderVersionOne)
+  VkPipelineCacheHeaderVersionOne driverHeader{};
+  if (blob.size() < sizeof(driverHeader))
+  {
+    return false;
+  }
+  std::memcpy(&driverHeader, blob.data(), sizeof(driverHeader));
+
+  const VkPhysicalDeviceProperties& properties = _deviceRef.getProperties();
+  return driverHeader.headerSize >= sizeof(driverHeader) &&
+         driverHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         driverHeader.vendorID == properties.vendorID &&
+         driverHeader.deviceID == properties.deviceID &&
+         std::memcmp(driverHeader.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
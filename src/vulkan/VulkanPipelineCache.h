@@ -0,0 +1,75 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class VulkanDevice;
+
+// Persistent VkPipelineCache. The blob is loaded at startup and only accepted
+// if it was written for the same vendor, device, driver version and pipeline
+// cache UUID; anything else (or a corrupt file) starts a cold cache. The blob is
+// written back atomically (temp file + rename) at shutdown or periodically.
+class VulkanPipelineCache
+{
+public:
+  // An empty path keeps the cache in memory only
+  VulkanPipelineCache(const VulkanDevice& device, std::string path);
+  ~VulkanPipelineCache(); // Saves if anything changed
+
+  // Delete copy/move semantics
+  VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+  VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+  VulkanPipelineCache(VulkanPipelineCache&&) = delete;
+  VulkanPipelineCache& operator=(VulkanPipelineCache&&) = delete;
+
+  // Accessors
+  VkPipelineCache getCache() const { return _cache; }
+  bool isWarm() const { return _loadedFromDisk; } // A valid blob was loaded
+
+  // Call after creating pipelines with getCache() so the next save writes them out
+  void markDirty();
+
+  // Worker threads compile into their own caches (no contention on the main
+  // cache) and merge them back here when done. Worker caches start as a copy
+  // of the main cache so warm entries still hit.
+  VkPipelineCache createWorkerCache();
+  void mergeWorkerCaches(const std::vector<VkPipelineCache>& workerCaches, bool destroyAfterMerge = true);
+
+  // Writes the blob if dirty. Returns false on I/O failure.
+  bool save();
+  // Periodic save from the frame loop; cheap when nothing changed
+  void saveIfDue(std::chrono::steady_clock::duration interval);
+
+private:
+  // On-disk header preceding the driver's blob
+  struct FileHeader
+  {
+    uint32_t magic;
+    uint32_t fileVersion;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;
+    uint64_t dataHash;
+  };
+
+  std::vector<char> loadValidatedBlob() const;
+  bool isBlobCompatible(const std::vector<char>& blob) const;
+  FileHeader makeHeader(const std::vector<char>& blob) const;
+
+  const VulkanDevice& _deviceRef;
+  VkDevice _logicalDevice;
+  std::string _path;
+  VkPipelineCache _cache = VK_NULL_HANDLE;
+  bool _loadedFromDisk = false;
+  bool _dirty = false;
+
+  std::mutex _mutex; // Guards merges (dst cache is externally synchronized) and saves
+  std::chrono::steady_clock::time_point _lastSave;
+};
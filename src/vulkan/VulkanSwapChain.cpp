@@ -1,5 +1,6 @@
 #include "VulkanSwapChain.h"
 #include "VulkanDevice.h"     // For QueueFamilyIndices, VkDevice, VkPhysicalDevice
+#include "DeletionQueue.h"
 #include "../platform/Window.h" // For getting framebuffer size
 
 #include <algorithm> // For std::clamp
@@ -10,12 +11,20 @@
 
 // --- Constructor / Destructor ---
 
-VulkanSwapChain::VulkanSwapChain(const VulkanDevice& device, const Window& window, VkSurfaceKHR surface)
-    : _deviceRef(device),
+VulkanSwapChain::VulkanSwapChain(const VulkanDevice& device, const Window& window, VkSurfaceKHR surface,
+                                 VkPresentModeKHR preferredPresentMode, uint32_t desiredImageCount)
+    : _preferredPresentMode(preferredPresentMode),
+      _desiredImageCount(desiredImageCount),
+      _deviceRef(device),
       _windowRef(window),
       _surface(surface),
       _logicalDevice(device.getDevice()) // Cache logical device handle
 {
+  if (device.supportsPresentWait())
+  {
+    _waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+        vkGetDeviceProcAddr(_logicalDevice, "vkWaitForPresentKHR"));
+  }
   createSwapChain();
   createImageViews();
 }
@@ -42,9 +51,90 @@ VulkanSwapChain::~VulkanSwapChain()
 
 // --- Public Methods --- (Accessors are inline in header)
 
+VkResult VulkanSwapChain::acquireNextImage(VkSemaphore imageAvailable, uint32_t& imageIndex)
+{
+  return vkAcquireNextImageKHR(_logicalDevice, _swapChain, UINT64_MAX,
+                               imageAvailable, VK_NULL_HANDLE, &imageIndex);
+}
+
+VkResult VulkanSwapChain::present(VkQueue presentQueue, VkSemaphore renderFinished, uint32_t imageIndex)
+{
+  VkPresentInfoKHR presentInfo{};
+  presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+  presentInfo.waitSemaphoreCount = 1;
+  presentInfo.pWaitSemaphores = &renderFinished; // Wait on render finished
+  presentInfo.swapchainCount = 1;
+  presentInfo.pSwapchains = &_swapChain;
+  presentInfo.pImageIndices = &imageIndex;
+
+  // Tag the present so the frame pacer can wait until it reaches the screen
+  uint64_t presentId = _lastPresentId + 1;
+  VkPresentIdKHR presentIdInfo{};
+  presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+  presentIdInfo.swapchainCount = 1;
+  presentIdInfo.pPresentIds = &presentId;
+  if (supportsPresentWait())
+  {
+    presentInfo.pNext = &presentIdInfo;
+  }
+
+  VkResult result = vkQueuePresentKHR(presentQueue, &presentInfo);
+  _lastPresentId = presentId;
+  return result;
+}
+
+VkResult VulkanSwapChain::waitForPresent(uint64_t presentId, uint64_t timeoutNs)
+{
+  if (!supportsPresentWait())
+  {
+    return VK_ERROR_FEATURE_NOT_PRESENT;
+  }
+  // Presents to a retired chain are never reported by the new one; waiting on
+  // them would block until a later present reaches the screen
+  if (presentId < _firstChainPresentId)
+  {
+    return VK_SUCCESS;
+  }
+  return _waitForPresent(_logicalDevice, _swapChain, presentId, timeoutNs);
+}
+
+bool VulkanSwapChain::recreate(DeletionQueue& retired, uint64_t lastUsingFrame)
+{
+  // A minimized window has a zero-sized framebuffer; try again once it is restored
+  if (_windowRef.isMinimized())
+  {
+    return false;
+  }
+
+  // Keep presenting from the old chain's in-flight images while the new one is
+  // built: it is passed as oldSwapchain and only destroyed once the frames that
+  // used it have retired.
+  VkSwapchainKHR oldSwapChain = _swapChain;
+  std::vector<VkImageView> oldImageViews = std::move(_swapChainImageViews);
+  _swapChainImageViews.clear();
+  _swapChainImages.clear();
+
+  createSwapChain(oldSwapChain);
+  createImageViews();
+  _firstChainPresentId = _lastPresentId + 1;
+
+  VkDevice logicalDevice = _logicalDevice;
+  retired.push(lastUsingFrame, [logicalDevice, oldSwapChain, oldImageViews]() {
+    for (auto imageView : oldImageViews)
+    {
+      vkDestroyImageView(logicalDevice, imageView, nullptr);
+    }
+    vkDestroySwapchainKHR(logicalDevice, oldSwapChain, nullptr);
+  });
+
+  std::cout << "Vulkan swap chain recreated (" << _swapChainExtent.width << "x"
+            << _swapChainExtent.height << "), old chain retired." << std::endl;
+  return true;
+}
+
 // --- Private Methods ---
 
-void VulkanSwapChain::createSwapChain()
+void VulkanSwapChain::createSwapChain(VkSwapchainKHR oldSwapChain)
 {
   SwapChainSupportDetails swapChainSupport = querySwapChainSupport(_deviceRef.getPhysicalDevice());
 
@@ -52,7 +142,13 @@ void VulkanSwapChain::createSwapChain()
   VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
   VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
+  // One more than the minimum lets the CPU acquire while the presentation
+  // engine holds the rest; fewer images means less queued latency
   uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+  if (_desiredImageCount != 0)
+  {
+    imageCount = std::max(_desiredImageCount, swapChainSupport.capabilities.minImageCount);
+  }
   if (swapChainSupport.capabilities.maxImageCount > 0 &&
       imageCount > swapChainSupport.capabilities.maxImageCount)
   {
@@ -92,7 +188,7 @@ void VulkanSwapChain::createSwapChain()
   createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
   createInfo.presentMode = presentMode;
   createInfo.clipped = VK_TRUE;
-  createInfo.oldSwapchain = VK_NULL_HANDLE;
+  createInfo.oldSwapchain = oldSwapChain;
 
   VkResult result = vkCreateSwapchainKHR(_logicalDevice, &createInfo, nullptr, &_swapChain);
   if (result != VK_SUCCESS)
@@ -106,9 +202,10 @@ void VulkanSwapChain::createSwapChain()
   _swapChainImages.resize(imageCount);
   vkGetSwapchainImagesKHR(_logicalDevice, _swapChain, &imageCount, _swapChainImages.data());
 
-  // Store format and extent
+  // Store format, extent and present mode
   _swapChainImageFormat = surfaceFormat.format;
   _swapChainExtent = extent;
+  _presentMode = presentMode;
 }
 
 void VulkanSwapChain::createImageViews()
@@ -190,9 +287,9 @@ VkPresentModeKHR VulkanSwapChain::chooseSwapPresentMode(
 {
   for (const auto& availablePresentMode : availablePresentModes)
   {
-    if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+    if (availablePresentMode == _preferredPresentMode)
     {
-         std::cout << "Swap Present Mode: Mailbox" << std::endl;
+      std::cout << "Swap Present Mode: Preferred (" << availablePresentMode << ")" << std::endl;
       return availablePresentMode;
     }
   }
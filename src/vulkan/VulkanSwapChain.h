@@ -4,6 +4,8 @@
 #include <GLFW/glfw3.h>
 #include <vector>
 
+#include "PresentTarget.h"
+
 // Forward declarations
 class VulkanDevice;
 class Window;
@@ -17,10 +19,14 @@ struct SwapChainSupportDetails
   std::vector<VkPresentModeKHR> presentModes;
 };
 
-class VulkanSwapChain 
+class VulkanSwapChain : public PresentTarget
 {
 public:
-  VulkanSwapChain(const VulkanDevice& device, const Window& window, VkSurfaceKHR surface);
+  // The preferred present mode is used when supported, otherwise FIFO (always available).
+  // desiredImageCount is clamped to the surface limits; 0 = minImageCount + 1.
+  VulkanSwapChain(const VulkanDevice& device, const Window& window, VkSurfaceKHR surface,
+                  VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR,
+                  uint32_t desiredImageCount = 0);
   ~VulkanSwapChain();
 
   // Delete copy/move semantics
@@ -31,9 +37,21 @@ public:
 
   // Accessors
   VkSwapchainKHR getSwapChain() const { return _swapChain; }
-  VkFormat getImageFormat() const { return _swapChainImageFormat; }
-  VkExtent2D getExtent() const { return _swapChainExtent; }
-  const std::vector<VkImageView>& getImageViews() const { return _swapChainImageViews; }
+  VkFormat getImageFormat() const override { return _swapChainImageFormat; }
+  VkExtent2D getExtent() const override { return _swapChainExtent; }
+  VkPresentModeKHR getPresentMode() const { return _presentMode; }
+  const std::vector<VkImage>& getImages() const override { return _swapChainImages; }
+  const std::vector<VkImageView>& getImageViews() const override { return _swapChainImageViews; }
+
+  // PresentTarget
+  VkImageLayout getFinalLayout() const override { return VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; }
+  bool isHeadless() const override { return false; }
+  VkResult acquireNextImage(VkSemaphore imageAvailable, uint32_t& imageIndex) override;
+  VkResult present(VkQueue presentQueue, VkSemaphore renderFinished, uint32_t imageIndex) override;
+  bool supportsPresentWait() const override { return _waitForPresent != nullptr; }
+  uint64_t getLastPresentId() const override { return _lastPresentId; }
+  VkResult waitForPresent(uint64_t presentId, uint64_t timeoutNs) override;
+  bool recreate(DeletionQueue& retired, uint64_t lastUsingFrame) override;
 
 private:
   VkSwapchainKHR _swapChain = VK_NULL_HANDLE;
@@ -41,13 +59,21 @@ private:
   VkFormat _swapChainImageFormat;
   VkExtent2D _swapChainExtent;
   std::vector<VkImageView> _swapChainImageViews;
+  VkPresentModeKHR _preferredPresentMode;
+  VkPresentModeKHR _presentMode = VK_PRESENT_MODE_FIFO_KHR;
+  uint32_t _desiredImageCount;
+
+  // VK_KHR_present_wait entry point; null when the device did not enable it
+  PFN_vkWaitForPresentKHR _waitForPresent = nullptr;
+  uint64_t _lastPresentId = 0;
+  uint64_t _firstChainPresentId = 1; // Ids below this went to a retired swap chain
 
   const VulkanDevice& _deviceRef; // Reference to logical device
   const Window& _windowRef;       // Reference to window for extent
   VkSurfaceKHR _surface;          // Copy surface handle
   VkDevice _logicalDevice;       // Copy logical device handle
 
-  void createSwapChain();
+  void createSwapChain(VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE);
   void createImageViews();
 
   // Helpers
@@ -0,0 +1,80 @@
+#include "VulkanTimeline.h"
+
+#include <stdexcept>
+#include <string>
+
+VulkanTimeline::VulkanTimeline(VkDevice device, uint64_t initialValue)
+    : _device(device), _completedValue(initialValue)
+{
+  VkSemaphoreTypeCreateInfo typeInfo{};
+  typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  typeInfo.initialValue = initialValue;
+
+  VkSemaphoreCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  createInfo.pNext = &typeInfo;
+
+  VkResult result = vkCreateSemaphore(_device, &createInfo, nullptr, &_semaphore);
+  if (result != VK_SUCCESS)
+  {
+    throw std::runtime_error("Failed to create timeline semaphore! Error code: " + std::to_string(result));
+  }
+}
+
+VulkanTimeline::~VulkanTimeline()
+{
+  vkDestroySemaphore(_device, _semaphore, nullptr);
+}
+
+uint64_t VulkanTimeline::getCompletedValue() const
+{
+  uint64_t value = 0;
+  VkResult result = vkGetSemaphoreCounterValue(_device, _semaphore, &value);
+  if (result != VK_SUCCESS)
+  {
+    throw std::runtime_error("Failed to query timeline semaphore! Error code: " + std::to_string(result));
+  }
+  return observe(value);
+}
+
+bool VulkanTimeline::isComplete(uint64_t value) const
+{
+  return _completedValue.load(std::memory_order_relaxed) >= value || getCompletedValue() >= value;
+}
+
+bool VulkanTimeline::wait(uint64_t value, uint64_t timeoutNs) const
+{
+  if (_completedValue.load(std::memory_order_relaxed) >= value)
+  {
+    return true;
+  }
+
+  VkSemaphoreWaitInfo waitInfo{};
+  waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &_semaphore;
+  waitInfo.pValues = &value;
+
+  VkResult result = vkWaitSemaphores(_device, &waitInfo, timeoutNs);
+  if (result == VK_TIMEOUT)
+  {
+    return false;
+  }
+  if (result != VK_SUCCESS)
+  {
+    throw std::runtime_error("Failed to wait on timeline semaphore! Error code: " + std::to_string(result));
+  }
+  observe(value);
+  return true;
+}
+
+// Values only grow; keeps the largest one seen so concurrent callers never go backwards
+uint64_t VulkanTimeline::observe(uint64_t value) const
+{
+  uint64_t cached = _completedValue.load(std::memory_order_relaxed);
+  while (value > cached && !_completedValue.compare_exchange_weak(cached, value, std::memory_order_relaxed))
+  {
+  }
+  return value > cached ? value : cached;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <cstdint>
+
+// Timeline semaphore owned by one queue. Its owner signals monotonically
+// increasing values with each submit (the Renderer signals frame N + 1 when
+// frame N's commands complete); anyone else asks whether a value has been
+// reached instead of keeping a fence per resource. Other queues can wait on a
+// value directly in their submits.
+class VulkanTimeline
+{
+public:
+  explicit VulkanTimeline(VkDevice device, uint64_t initialValue = 0);
+  ~VulkanTimeline();
+
+  // Delete copy/move semantics
+  VulkanTimeline(const VulkanTimeline&) = delete;
+  VulkanTimeline& operator=(const VulkanTimeline&) = delete;
+  VulkanTimeline(VulkanTimeline&&) = delete;
+  VulkanTimeline& operator=(VulkanTimeline&&) = delete;
+
+  VkSemaphore getSemaphore() const { return _semaphore; }
+
+  // Thread-safe. Queries the device only while the cached value is behind.
+  uint64_t getCompletedValue() const;
+  bool isComplete(uint64_t value) const;
+
+  // Blocks until value is reached; returns false on timeout
+  bool wait(uint64_t value, uint64_t timeoutNs = UINT64_MAX) const;
+
+private:
+  uint64_t observe(uint64_t value) const;
+
+  VkDevice _device;
+  VkSemaphore _semaphore = VK_NULL_HANDLE;
+  mutable std::atomic<uint64_t> _completedValue; // Last value observed reached
+};